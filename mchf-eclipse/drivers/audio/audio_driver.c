@@ -29,6 +29,7 @@
 
 #include "audio_driver.h"
 #include "audio_nr.h"
+#include "audio_fblms.h"
 #include "audio_management.h"
 #include "radio_management.h"
 #include "usbd_audio_if.h"
@@ -41,10 +42,7 @@
 #include "psk.h"
 #include "cw_decoder.h"
 #include "freedv_uhsdr.h"
-
-#ifdef USE_CONVOLUTION
 #include "audio_convolution.h"
-#endif
 
 typedef struct
 {
@@ -53,11 +51,11 @@ typedef struct
 	//#define MAX_N_TAU           (8)
 	//#define MAX_TAU_ATTACK      (0.01)
 	//#define RB_SIZE       (int) (MAX_SAMPLE_RATE * MAX_N_TAU * MAX_TAU_ATTACK + 1)
-#define AGC_WDSP_RB_SIZE 192
+#define AGC_WDSP_RB_SIZE 192 // longest look-ahead: n_tau * tau_attack at 48ksps
+// the gain is calculated once per sub-block and ramped linearly over its samples
+#define AGC_WDSP_SUB_BLOCK 8
 	//int8_t AGC_mode = 2;
 	int pmode;// = 1; // if 0, calculate magnitude by max(|I|, |Q|), if 1, calculate sqrtf(I*I+Q*Q)
-	float32_t out_sample[2];
-	float32_t abs_out_sample;
 	float32_t tau_attack;
 	float32_t tau_decay;
 	int n_tau;
@@ -74,13 +72,17 @@ typedef struct
 	float32_t hangtime;
 	float32_t hang_thresh;
 	float32_t tau_hang_decay;
-	float32_t ring[2 * AGC_WDSP_RB_SIZE]; //192]; //96];
-	float32_t abs_ring[AGC_WDSP_RB_SIZE];// 192 //96]; // abs_ring is half the size of ring
-	//assign constants
-	int ring_buffsize; // = 96;
+	// look-ahead delay lines: the last attack_buffsize input samples followed by the current block
+	float32_t delay[NUM_AUDIO_CHANNELS][AGC_WDSP_RB_SIZE + IQ_BLOCK_SIZE];
+	// peak and mean magnitude of each sub-block in the delay lines, the larger of both channels in stereo
+	float32_t peak_delay[(AGC_WDSP_RB_SIZE + IQ_BLOCK_SIZE) / AGC_WDSP_SUB_BLOCK];
+	float32_t mean_delay[(AGC_WDSP_RB_SIZE + IQ_BLOCK_SIZE) / AGC_WDSP_SUB_BLOCK];
+	float32_t ramp[AGC_WDSP_SUB_BLOCK]; // 1, 2, ... AGC_WDSP_SUB_BLOCK
+	int delay_buffsize; // the look-ahead the delay lines have been filled with
+	bool delay_stereo; // the second delay line has been filled
+	float32_t gain; // applied to the last output sample
 	//do one-time initialization
-	int out_index; // = -1;
-	float32_t ring_max; // = 0.0;
+	float32_t ring_max; // = 0.0; peak of the look-ahead window
 	float32_t volts; // = 0.0;
 	float32_t save_volts; // = 0.0;
 	float32_t fast_backaverage; // = 0.0;
@@ -89,7 +91,6 @@ typedef struct
 	uint8_t decay_type; // = 0;
 	uint8_t state; // = 0;
 	int attack_buffsize;
-	uint32_t in_index;
 	float32_t attack_mult;
 	float32_t decay_mult;
 	float32_t fast_decay_mult;
@@ -107,6 +108,10 @@ typedef struct
 	float32_t hang_decay_mult;
 } agc_variables_t;
 
+// the smallest RX block after decimation has to consist of whole sub-blocks
+_Static_assert((IQ_BLOCK_SIZE / RX_DECIMATION_RATE_12KHZ) % AGC_WDSP_SUB_BLOCK == 0, "AGC sub-block does not fit the audio block size");
+_Static_assert(AGC_WDSP_RB_SIZE % AGC_WDSP_SUB_BLOCK == 0, "AGC look-ahead has to consist of whole sub-blocks");
+
 agc_variables_t agc_wdsp;
 
 // SSB filters - now handled in ui_driver to allow I/Q phase adjustment
@@ -136,18 +141,6 @@ typedef struct
 
 #define LMS2_NOTCH_STATE_ARRAY_SIZE (DSP_NOTCH_NUMTAPS_MAX + IQ_BLOCK_SIZE)
 
-#ifdef USE_LMS_AUTONOTCH
-typedef struct
-{
-    float32_t   errsig2[IQ_BLOCK_SIZE];
-    arm_lms_norm_instance_f32	lms2Norm_instance;
-    arm_lms_instance_f32	    lms2_instance;
-    float32_t	                lms2StateF32[LMS2_NOTCH_STATE_ARRAY_SIZE];
-    float32_t	                lms2NormCoeff_f32[DSP_NOTCH_NUMTAPS_MAX];
-    float32_t	                lms2_nr_delay[DSP_NOTCH_BUFLEN_MAX];
-} LMSData;
-#endif
-
 static float32_t	__MCHF_SPECIALMEM audio_delay_buffer	[AUDIO_DELAY_BUFSIZE];
 
 static void AudioDriver_ClearAudioDelayBuffer()
@@ -174,16 +167,6 @@ float log10f_fast(float X) {
     return(Y * 0.3010299956639812f);
 }
 
-//
-// Audio RX - Decimator
-//static  arm_fir_decimate_instance_f32   DECIMATE_RX_I;
-arm_fir_decimate_instance_f32   DECIMATE_RX_I;
-float32_t           __MCHF_SPECIALMEM decimState_I[FIR_RXAUDIO_BLOCK_SIZE + 83];
-// Audio RX - Decimator in Q-path
-//static  arm_fir_decimate_instance_f32   DECIMATE_RX_Q;
-arm_fir_decimate_instance_f32   DECIMATE_RX_Q;
-float32_t           __MCHF_SPECIALMEM decimState_Q[FIR_RXAUDIO_BLOCK_SIZE + 83];
-
 // Decimator for Zoom FFT
 static	arm_fir_decimate_instance_f32	DECIMATE_ZOOM_FFT_I;
 float32_t			__MCHF_SPECIALMEM decimZoomFFTIState[FIR_RXAUDIO_BLOCK_SIZE + FIR_RXAUDIO_NUM_TAPS];
@@ -192,10 +175,6 @@ float32_t			__MCHF_SPECIALMEM decimZoomFFTIState[FIR_RXAUDIO_BLOCK_SIZE + FIR_RX
 static	arm_fir_decimate_instance_f32	DECIMATE_ZOOM_FFT_Q;
 float32_t			__MCHF_SPECIALMEM decimZoomFFTQState[FIR_RXAUDIO_BLOCK_SIZE + FIR_RXAUDIO_NUM_TAPS];
 
-// Audio RX - Interpolator
-static	arm_fir_interpolate_instance_f32 INTERPOLATE_RX[NUM_AUDIO_CHANNELS];
-float32_t			__MCHF_SPECIALMEM interpState[NUM_AUDIO_CHANNELS][FIR_RXAUDIO_BLOCK_SIZE + FIR_RXAUDIO_NUM_TAPS];
-
 
 
 #define NR_INTERPOLATE_NO_TAPS 40
@@ -206,13 +185,111 @@ static	arm_fir_interpolate_instance_f32 INTERPOLATE_NR;
 float32_t			interplNRState[FIR_RXAUDIO_BLOCK_SIZE + NR_INTERPOLATE_NO_TAPS];
 
 #define IIR_RX_STATE_ARRAY_SIZE    (IIR_RXAUDIO_BLOCK_SIZE + IIR_RXAUDIO_NUM_STAGES_MAX)
-// variables for RX IIR filters
-static float32_t		iir_rx_state[NUM_AUDIO_CHANNELS][IIR_RX_STATE_ARRAY_SIZE];
-static arm_iir_lattice_instance_f32	IIR_PreFilter[NUM_AUDIO_CHANNELS];
 
-// variables for RX antialias IIR filter
-static float32_t		iir_aa_state[NUM_AUDIO_CHANNELS][IIR_RX_STATE_ARRAY_SIZE];
-static arm_iir_lattice_instance_f32	IIR_AntiAlias[NUM_AUDIO_CHANNELS];
+#define FIR_RX_HILBERT_STATE_SIZE (IQ_RX_NUM_TAPS_MAX + IQ_RX_BLOCK_SIZE)
+
+#ifdef USE_RX_IIR_BIQUAD
+// the audio IIR filters of the filter paths run as cascaded biquads, which are generated from the lattice filters
+typedef arm_biquad_cascade_df2T_instance_f32 RxIir_t;
+#define RX_IIR_STATE_SIZE (2 * IIR_RX_BIQUAD_NUM_STAGES_MAX)
+#define RX_IIR_STATE_LEN(iir) (2 * (iir)->numStages)
+#else
+typedef arm_iir_lattice_instance_f32 RxIir_t;
+#define RX_IIR_STATE_SIZE IIR_RX_STATE_ARRAY_SIZE
+#define RX_IIR_STATE_LEN(iir) ((iir)->numStages)
+#endif
+
+#ifdef USE_RX_IIR_DESIGNER
+#if !defined(USE_RX_IIR_BIQUAD) || IIR_DESIGN_NUM_STAGES_MAX > IIR_RX_BIQUAD_NUM_STAGES_MAX
+#error "USE_RX_IIR_DESIGNER needs USE_RX_IIR_BIQUAD and room for IIR_DESIGN_NUM_STAGES_MAX biquads"
+#endif
+// an RX audio IIR filter designed by AudioDriver_RxIirDesign()
+typedef struct
+{
+    const IIR_DesignSpec* spec;     // NULL if nothing has been designed yet
+    uint32_t sample_rate;
+    uint8_t numStages;
+    float32_t coeffs[5 * IIR_DESIGN_NUM_STAGES_MAX];
+} RxIirDesign_t;
+#endif
+
+// all RX filters which depend on the selected filter path, see AudioDriver_SetupRxFilterPath()
+typedef struct
+{
+    uint16_t filter_path;   // 0 if not set up yet
+    uint8_t dmod_mode;
+    bool decimated_iq;      // the IQ signal is decimated before the Hilbert transform
+    bool use_conv;          // the convolution filter replaces Hilbert transform, demodulation and audio bandpass
+
+    // RX Hilbert transform (90 degree) FIR filters, in AM/SAM the coefficients are used for the IQ decimation instead
+    arm_fir_instance_f32 hilbert_i;
+    arm_fir_instance_f32 hilbert_q;
+    bool hilbert_mirrored;  // true if the Q coefficients are the I coefficients in reversed order
+    arm_fir_decimate_instance_f32 sam_dec_i;
+    arm_fir_decimate_instance_f32 sam_dec_q;
+
+    // audio decimation, the Q instance is used for the second audio channel after demodulation
+    arm_fir_decimate_instance_f32 dec_i;
+    arm_fir_decimate_instance_f32 dec_q;
+    RxIir_t pre[NUM_AUDIO_CHANNELS];                                // audio bandpass
+    arm_fir_interpolate_instance_f32 interp[NUM_AUDIO_CHANNELS];   // includes the antialias lowpass
+
+    // fresh copies of the Hilbert coefficients in fast RAM, this speeds up processing on the STM32F4
+    float32_t hilbert_taps_i[IQ_RX_NUM_TAPS_MAX];
+    float32_t hilbert_taps_q[IQ_RX_NUM_TAPS_MAX];
+    // state of the Hilbert transform, in AM/SAM of the IQ decimation
+    float32_t iq_state_i[FIR_RX_HILBERT_STATE_SIZE];
+    float32_t iq_state_q[FIR_RX_HILBERT_STATE_SIZE];
+    float32_t dec_state_i[FIR_RXAUDIO_BLOCK_SIZE + 83];
+    float32_t dec_state_q[FIR_RXAUDIO_BLOCK_SIZE + 83];
+    float32_t pre_state[NUM_AUDIO_CHANNELS][RX_IIR_STATE_SIZE];
+    float32_t interp_state[NUM_AUDIO_CHANNELS][FIR_RXAUDIO_BLOCK_SIZE + FIR_RX_INTERPOLATE_PHASE_LEN_MAX];
+#ifdef USE_RX_IIR_DESIGNER
+    // the coefficients of pre, shared by both channels and kept while the slot is used for the same filter
+    RxIirDesign_t pre_design;
+#endif
+} RxFilterPath_t;
+
+// one filter path is used by the RX processor, one may still be faded out and one may wait to be activated
+#define RX_FILTER_PATH_SLOTS 3
+// after a filter path change the old filters stay audible for RX_FILTER_WARMUP_LEN samples (at IQ_SAMPLE_RATE)
+// while the new ones settle, then the audio is crossfaded to the new filters within RX_FILTER_XFADE_LEN samples
+#define RX_FILTER_WARMUP_LEN 256
+#define RX_FILTER_XFADE_LEN 256
+
+#ifdef USE_CONVOLUTION
+// lowest audio frequency passed by the convolution filter, the LPF filter paths start at 0Hz
+#define RX_CONV_F_LOW_MIN 100.0
+// passband gain of the convolution filter: the sum of I and Q after the Hilbert transform has twice the
+// amplitude of the real part of the filtered IQ signal, this keeps the audio level of the other filters
+#define RX_CONV_GAIN 2.0
+#endif
+
+// filter stages of the RX processor which depend on the filter path
+enum
+{
+    RX_FILTER_STAGE_IQ = 0, // Hilbert transform or AM/SAM IQ decimation including the IQ decimation ahead of it
+    RX_FILTER_STAGE_DECIMATE,
+    RX_FILTER_STAGE_PRE,
+    RX_FILTER_STAGE_INTERPOLATE,
+};
+
+// about 4.7k per slot, too much for the CCM of the STM32F4
+static RxFilterPath_t rx_filter_paths[RX_FILTER_PATH_SLOTS];
+// the filter path used by the RX processor
+static RxFilterPath_t* volatile rxf = &rx_filter_paths[0];
+// a filter path prepared by AudioDriver_RxFilterPathChange(), picked up by the RX processor at the next block
+static RxFilterPath_t* volatile rxf_next;
+
+static struct
+{
+    RxFilterPath_t* volatile old;   // the previous filter path while it is faded out, NULL otherwise
+    uint16_t pos;                   // samples since the change
+    uint8_t shared;                 // bit mask of the filter stages whose coefficients did not change
+    float32_t gain_start;           // gain of the new filters at the start and end of the current block
+    float32_t gain_end;
+    float32_t buffer[2][IQ_BLOCK_SIZE];    // output of the old filters
+} rxf_fade;
 
 // static float32_t Koeff[20];
 // variables for RX manual notch, manual peak & bass shelf IIR biquad filter
@@ -554,6 +631,46 @@ static float32_t* FreeDV_coeffs[1] =
 static float32_t	iir_squelch_rx_state[IIR_RX_STATE_ARRAY_SIZE];
 static arm_iir_lattice_instance_f32	IIR_Squelch_HPF;
 
+// FM demodulator de-emphasis (integrating low-pass) and differentiating high-pass, each a single first order biquad stage
+// y[n] = b0 * x[n] + b1 * x[n-1] + a1 * y[n-1]
+static arm_biquad_casd_df1_inst_f32 IIR_FM_Deemphasis =
+{
+        .numStages = 1,
+        .pCoeffs = (float32_t *)(float32_t [])
+        {
+            FM_RX_LPF_ALPHA, 0, 0, 1 - FM_RX_LPF_ALPHA, 0
+        }, // 1 x 5 = 5 coefficients
+
+        .pState = (float32_t *)(float32_t [])
+        {
+            0,0,0,0
+        } // 1 x 4 = 4 state variables
+};
+
+static arm_biquad_casd_df1_inst_f32 IIR_FM_HPF =
+{
+        .numStages = 1,
+        .pCoeffs = (float32_t *)(float32_t [])
+        {
+            FM_RX_HPF_ALPHA, -FM_RX_HPF_ALPHA, 0, FM_RX_HPF_ALPHA, 0
+        }, // 1 x 5 = 5 coefficients
+
+        .pState = (float32_t *)(float32_t [])
+        {
+            0,0,0,0
+        } // 1 x 4 = 4 state variables
+};
+
+// SAM sideband separation: state of the four 7 stage Hilbert allpass chains a, b, c and d,
+// x[n-1], x[n-2], y[n-1], y[n-2] per stage as in the CMSIS biquad state layout
+#define SAM_ALLPASS_A 0
+#define SAM_ALLPASS_B 1
+#define SAM_ALLPASS_C 2
+#define SAM_ALLPASS_D 3
+#define SAM_ALLPASS_NUM 4
+
+static float32_t sam_allpass_state[SAM_ALLPASS_NUM][4 * SAM_PLL_HILBERT_STAGES];
+
 // variables for TX IIR filter
 float32_t		iir_tx_state[IIR_RX_STATE_ARRAY_SIZE];
 arm_iir_lattice_instance_f32	IIR_TXFilter;
@@ -574,11 +691,6 @@ AudioDriverBuffer  __MCHF_SPECIALMEM adb;
 LMSData            __MCHF_SPECIALMEM lmsData;
 #endif
 
-#ifdef USE_LMS_AUTONOTCH
-LMSData            __MCHF_SPECIALMEM lmsData;
-//LMSData            lmsData;
-#endif
-
 #ifdef USE_LEAKY_LMS
 lLMS leakyLMS;
 #endif
@@ -609,6 +721,14 @@ int32_t AudioDriver_GetTranslateFreq()
     return fdelta;
 }
 
+/**
+ * @returns frequency shift in Hz which the RX applies to the IQ data, i.e. the translate frequency plus the offset tuned by the DSP NCO
+ */
+int32_t AudioDriver_GetRxShiftFreq()
+{
+    return AudioDriver_GetTranslateFreq() + ts.rx_nco_offset;
+}
+
 static void AudioDriver_InitFilters(void);
 void AudioDriver_SetupAgcWdsp(void);
 //
@@ -706,29 +826,14 @@ void AudioDriver_Init(void)
     AudioDriver_InitFilters();
 
 #ifdef USE_LEAKY_LMS
-    /////////////////////// LEAKY LMS noise reduction
-    leakyLMS.n_taps =     64; //64;                       // taps
-    leakyLMS.delay =    16; //16;                       // delay
-    leakyLMS.dline_size = LEAKYLMSDLINE_SIZE;
-    //int ANR_buff_size = FFT_length / 2.0;
-    leakyLMS.position = 0;
-    leakyLMS.two_mu =   0.0001;                     // two_mu --> "gain"
+    /////////////////////// LMS noise reduction, see audio_fblms.c
+    leakyLMS.n_taps =     64;                       // taps
+    leakyLMS.delay =    16;                       // delay
+    leakyLMS.two_mu =   0.01;                     // two_mu --> "gain", normalized step size
     leakyLMS.two_mu_int = 100;
     leakyLMS.gamma =    0.1;                      // gamma --> "leakage"
     leakyLMS.gamma_int = 100;
-    leakyLMS.lidx =     120.0;                      // lidx
-    leakyLMS.lidx_min = 0.0;                      // lidx_min
-    leakyLMS.lidx_max = 200.0;                      // lidx_max
-    leakyLMS.ngamma =   0.001;                      // ngamma
-    leakyLMS.den_mult = 6.25e-10;                   // den_mult
-    leakyLMS.lincr =    1.0;                      // lincr
-    leakyLMS.ldecr =    3.0;                     // ldecr
-    //int leakyLMS.mask = leakyLMS.dline_size - 1;
-    leakyLMS.mask = LEAKYLMSDLINE_SIZE - 1;
-    leakyLMS.in_idx = 0;
-    leakyLMS.on = 0;
-    leakyLMS.notch = 0;
-    /////////////////////// LEAKY LMS END
+    /////////////////////// LMS noise reduction END
 #endif
 
     ts.codec_present = Codec_Reset(ts.samp_rate,word_size) == HAL_OK;
@@ -802,6 +907,8 @@ void AudioDriver_SetRxAudioProcessingSAM(uint8_t dmod_mode)
     adb.c1[5] = -0.996959189310611;
     adb.c1[6] = -0.999282492800792;
 
+    memset(sam_allpass_state, 0, sizeof(sam_allpass_state));
+
     // these change during operation
     adb.M_c1 = 0.0;
     adb.M_c2 = 1.0;
@@ -962,7 +1069,7 @@ void AudioDriver_CalcBandpass(float32_t coeffs[5], float32_t f0, float32_t FS)
 void AudioDriver_CalcHighShelf(float32_t coeffs[5], float32_t f0, float32_t S, float32_t gain, float32_t FS)
 {
     float32_t w0 = 2 * PI * f0 / FS;
-    float32_t A = pow10f(gain/40.0); // gain ranges from -20 to 5
+    float32_t A = powf(10.0f, gain/40.0f); // gain ranges from -20 to 5
     float32_t alpha = sinf(w0) / 2 * sqrtf( (A + 1/A) * (1/S - 1) + 2 );
     float32_t cosw0 = cosf(w0);
     float32_t twoAa = 2 * sqrtf(A) * alpha;
@@ -990,7 +1097,7 @@ void AudioDriver_CalcLowShelf(float32_t coeffs[5], float32_t f0, float32_t S, fl
 {
 
     float32_t w0 = 2 * PI * f0 / FS;
-    float32_t A = pow10f(gain/40.0); // gain ranges from -20 to 5
+    float32_t A = powf(10.0f, gain/40.0f); // gain ranges from -20 to 5
 
     float32_t alpha = sinf(w0) / 2 * sqrtf( (A + 1/A) * (1/S - 1) + 2 );
     float32_t cosw0 = cosf(w0);
@@ -1074,11 +1181,7 @@ void AudioDriver_SetRxTxAudioProcessingAudioFilters()
 
     AudioDriver_SetBiquadCoeffsAllInstances(IIR_biquad_1, 0, coeffs_ptr);
 
-    // this is an auto-notch-filter detected by the NR algorithm
-    // biquad 1, 4th stage
-    //    if(0) // temporarily deactivated
-    //    if((ts.dsp_active & DSP_NOTCH_ENABLE) && (FilterPathInfo[ts.filter_path].sample_rate_dec == RX_DECIMATION_RATE_12KHZ))
-
+    // biquad 1, 4th stage is unused, the automatic notch of the spectral NR has its own cascade (audio_nr.c)
     AudioDriver_SetBiquadCoeffsAllInstances(IIR_biquad_1, 15, biquad_passthrough);
 
     // the peak filter is in biquad 1 and works at the decimated sample rate FSdec
@@ -1120,69 +1223,387 @@ void AudioDriver_SetRxTxAudioProcessingAudioFilters()
 }
 
 
+#ifdef USE_RX_IIR_DESIGNER
 /**
- * @brief configures filters/dsp etc. so that audio processing works according to the current configuration
- * @param dmod_mode needs to know the demodulation mode
- * @param reset_dsp_nr whether it is supposed to reset also DSP related filters (in most cases false is to be used here)
+ * @brief designs an RX audio IIR filter into design, unless it or another filter path slot holds the design already
  */
-void AudioDriver_SetRxAudioProcessing(uint8_t dmod_mode, bool reset_dsp_nr)
+static void AudioDriver_RxIirDesign(RxIirDesign_t* design, const IIR_DesignSpec* spec, uint32_t sample_rate)
+{
+    if (design->spec != spec || design->sample_rate != sample_rate)
+    {
+        const RxIirDesign_t* found = NULL;
+        for (int idx = 0; idx < RX_FILTER_PATH_SLOTS && found == NULL; idx++)
+        {
+            if (rx_filter_paths[idx].pre_design.spec == spec && rx_filter_paths[idx].pre_design.sample_rate == sample_rate)
+            {
+                found = &rx_filter_paths[idx].pre_design;
+            }
+        }
+
+        if (found != NULL)
+        {
+            *design = *found;
+        }
+        else
+        {
+            // support/host/iir_design_check makes sure that every specification of FilterPathInfo can be designed
+            design->numStages = AudioIirDesign_Biquads(spec, sample_rate, design->coeffs);
+            design->spec = spec;
+            design->sample_rate = sample_rate;
+        }
+    }
+}
+#endif
+
+/**
+ * @brief sets up the audio IIR filter of a filter path for all channels and clears their states,
+ * the filter is turned off if filter is NULL
+ *
+ * With USE_RX_IIR_BIQUAD the biquad version of the lattice filter is used, see iir_rx_biquad.c,
+ * with USE_RX_IIR_DESIGNER the biquads are designed from the specification of the filter, see iir_rx_design.c
+ */
+static void AudioDriver_SetupRxIir(RxFilterPath_t* path, const IIR_RxFilter* filter, uint32_t sample_rate)
+{
+    RxIir_t* iir = path->pre;
+    float32_t (*state)[RX_IIR_STATE_SIZE] = path->pre_state;
+    uint8_t numStages = 0;
+#ifdef USE_RX_IIR_BIQUAD
+    float32_t* pCoeffs = NULL;
+#endif
+
+    if (filter != NULL)
+    {
+#if defined(USE_RX_IIR_DESIGNER)
+        AudioDriver_RxIirDesign(&path->pre_design, filter, sample_rate);
+        pCoeffs = path->pre_design.coeffs;
+        numStages = path->pre_design.numStages;
+#elif defined(USE_RX_IIR_BIQUAD)
+        // support/host/iir_biquad_check makes sure that every lattice filter of FilterPathInfo is found here
+        for (int idx = 0; idx < IirRxBiquadInfo_num; idx++)
+        {
+            if (IirRxBiquadInfo[idx].lattice == filter)
+            {
+                pCoeffs = (float32_t*)IirRxBiquadInfo[idx].pCoeffs;
+                numStages = IirRxBiquadInfo[idx].numStages;
+                break;
+            }
+        }
+#else
+        numStages = filter->numStages;
+#endif
+    }
+
+    for (int chan = 0; chan < NUM_AUDIO_CHANNELS; chan++)
+    {
+        // if we turn off a filter, set the number of members to 0 first
+        iir[chan].numStages = 0;
+        arm_fill_f32(0.0, state[chan], RX_IIR_STATE_SIZE);
+        iir[chan].pState = state[chan];
+
+        if (filter != NULL)
+        {
+#ifdef USE_RX_IIR_BIQUAD
+            iir[chan].pCoeffs = pCoeffs;
+#else
+            iir[chan].pkCoeffs = filter->pkCoeffs; // point to reflection coefficients
+            iir[chan].pvCoeffs = filter->pvCoeffs; // point to ladder coefficients
+#endif
+            // if we turn on a filter, set the number of members to the number of elements last
+            iir[chan].numStages = numStages;
+        }
+    }
+}
+
+/**
+ * @brief the noise reduction runs at half the decimated sample rate (6ksps) for filter paths up to 2k7
+ */
+bool AudioDriver_NrDecimation(uint16_t filter_path)
+{
+    return ts.NR_decimation_enable && FilterInfo[FilterPathInfo[filter_path].id].width < 2701;
+}
+
+/**
+ * @brief (re)starts the decimation by two in front of the noise reduction and the interpolation behind it
+ */
+static void AudioDriver_SetupNrDecimation()
+{
+    // should be a very light lowpass @2k7
+    arm_fir_decimate_init_f32(&DECIMATE_NR, 4, 2, NR_decimate_coeffs, decimNRState, FIR_RXAUDIO_BLOCK_SIZE);
+    arm_fir_interpolate_init_f32(&INTERPOLATE_NR, 2, NR_INTERPOLATE_NO_TAPS, NR_interpolate_coeffs, interplNRState, FIR_RXAUDIO_BLOCK_SIZE);
+}
+
+/**
+ * @brief sets up all filters of a filter path for the given demodulation mode and clears their states
+ *
+ * Does not touch anything the RX processor uses, as long as path is not the active filter path.
+ * The Hilbert coefficients are only copied if the slot does not hold the coefficients of this filter path already.
+ */
+static void AudioDriver_SetupRxFilterPath(RxFilterPath_t* path, uint8_t dmod_mode, uint16_t filter_path)
 {
     // WARNING:  You CANNOT reliably use the built-in IIR and FIR "init" functions when using CONST-based coefficient tables!  If you do so, you risk filters
     //  not initializing properly!  If you use the "init" functions, you MUST copy CONST-based coefficient tables to RAM first!
     //  This information is from recommendations by online references for using ARM math/DSP functions
-    ts.dsp_inhibit++;
-    ads.af_disabled++;
+    const FilterPathDescriptor* fp = &FilterPathInfo[filter_path];
 
-    // make sure we have a proper filter path for the given mode
+    AudioDriver_SetupRxIir(path, fp->pre_instance, IQ_SAMPLE_RATE / fp->sample_rate_dec);
 
-    // the commented out part made the code  only look at last used/selected filter path if the current filter path is not applicable
-    // with it commented out the filter path is ALWAYS loaded from the last used/selected memory
-    // I.e. setting the ts.filter_path anywere else in the code is useless. You have to call AudioFilter_NextApplicableFilterPath in order to
-    // select a new filter path as this sets the last used/selected memory for a demod mode.
+    // Set up RX decimation/filter, also used ahead of the convolution filter
+    if (fp->dec != NULL)
+    {
+        const arm_fir_decimate_instance_f32* dec = fp->dec;
 
-    ts.filter_path = AudioFilter_NextApplicableFilterPath(PATH_ALL_APPLICABLE|PATH_LAST_USED_IN_MODE,AudioFilter_GetFilterModeFromDemodMode(dmod_mode),ts.filter_path);
+#if defined(STM32F4) && defined(USE_LMS_AUTONOTCH)
+        // FIXME: Better solution (e.g. improve graphics performance, better data structures ... )
+        // this code is a hack to reduce processor load for STM32F4 && SPI display
+        // which causes UI lag
+        // in this case we simply use a less power-eating filter (lower number of taps)
+        // one problem is that we use the not so good filter
+        // even if the autonotch / nr is not active and we could use the good filter
+        if (dec == &FirRxDecimate_sideband_supp && ts.display->use_spi == true)
+        {
+        	// TODO: this is wrong! For higher bandwidth filters this has to be
+        	// changed, see filter list in audio_filter.c
+            dec = &FirRxDecimate;
+            //dec = &FirRxDecimate_sideband_supp;
+        }
+#endif
+
+        arm_fir_decimate_init_f32(&path->dec_i,
+
+                dec->numTaps,      // Number of taps in FIR filter
+                fp->sample_rate_dec,
+                dec->pCoeffs,       // Filter coefficients
+                path->dec_state_i,            // Filter state variables
+                FIR_RXAUDIO_BLOCK_SIZE);
+
+        arm_fir_decimate_init_f32(&path->dec_q,
+                dec->numTaps,      // Number of taps in FIR filter
+                fp->sample_rate_dec,
+                dec->pCoeffs,       // Filter coefficients
+                path->dec_state_q,            // Filter state variables
+                FIR_RXAUDIO_BLOCK_SIZE);
+    }
+    else
+    {
+        path->dec_i.numTaps = 0;
+        path->dec_i.pCoeffs = NULL;
+        path->dec_q.numTaps = 0;
+        path->dec_q.pCoeffs = NULL;
+    }
 
+    // Set up RX interpolation/filter
+    // NOTE:  Phase Length MUST be an INTEGER and is the number of taps divided by the decimation rate, and it must be greater than 1.
+    // It must not exceed FIR_RX_INTERPOLATE_PHASE_LEN_MAX, the size of interp_state.
     for (int chan = 0; chan < NUM_AUDIO_CHANNELS; chan++)
     {
-        if (FilterPathInfo[ts.filter_path].pre_instance != NULL)
+        if (fp->interpolate != NULL)
         {
-            // if we turn on a filter, set the number of members to the number of elements last
-            IIR_PreFilter[chan].pkCoeffs = FilterPathInfo[ts.filter_path].pre_instance->pkCoeffs; // point to reflection coefficients
-            IIR_PreFilter[chan].pvCoeffs = FilterPathInfo[ts.filter_path].pre_instance->pvCoeffs; // point to ladder coefficients
-            IIR_PreFilter[chan].numStages = FilterPathInfo[ts.filter_path].pre_instance->numStages;        // number of stages
+            arm_fir_interpolate_init_f32(&path->interp[chan],
+                    fp->sample_rate_dec,
+                    fp->interpolate->phaseLength,
+                    fp->interpolate->pCoeffs,
+                    path->interp_state[chan], IQ_BLOCK_SIZE);
         }
         else
         {
-            // if we turn off a filter, set the number of members to 0 first
-            IIR_PreFilter[chan].numStages = 0;        // number of stages
-            IIR_PreFilter[chan].pkCoeffs = NULL; // point to reflection coefficients
-            IIR_PreFilter[chan].pvCoeffs = NULL; // point to ladder coefficients
+            path->interp[chan].phaseLength = 0;
+            path->interp[chan].pCoeffs = NULL;
+        }
+    }
+
+    // new filter_path method
+    // take all info from FilterPathInfo
+    // phase adjustment is now done in audio_driver.c audio_rx_processor
+    const uint32_t rx_iq_num_taps = fp->FIR_numTaps;
+
+    if (path->filter_path != filter_path)
+    {
+        // in FilterPathInfo, we have stored the coefficients already, so no if . . . necessary
+        // also applicable for FM case !
+        // NOTE:  We are assuming that the I and Q filters are of the same length!
+        for(int i = 0; i < rx_iq_num_taps; i++)
+        {
+            path->hilbert_taps_i[i] = fp->FIR_I_coeff_file[i];
+            path->hilbert_taps_q[i] = fp->FIR_Q_coeff_file[i];
         }
 
-        // Initialize IIR filter state buffer
-        arm_fill_f32(0.0,iir_rx_state[chan],IIR_RX_STATE_ARRAY_SIZE);
+        // the +/-45 degree pairs (e.g. i_rx_new_coeffs/q_rx_new_coeffs) are mirror images of each other,
+        // this allows the RX processor to run I and Q with a single pass over the coefficients
+        path->hilbert_mirrored = rx_iq_num_taps > 0;
+        for(int i = 0; i < rx_iq_num_taps; i++)
+        {
+            if (path->hilbert_taps_q[i] != path->hilbert_taps_i[rx_iq_num_taps - 1 - i])
+            {
+                path->hilbert_mirrored = false;
+                break;
+            }
+        }
+    }
 
-        IIR_PreFilter[chan].pState = iir_rx_state[chan];					// point to state array for IIR filter
+    // Initialization of the FIR/Hilbert filters
+    arm_fir_init_f32(&path->hilbert_i, rx_iq_num_taps, path->hilbert_taps_i, path->iq_state_i, IQ_RX_BLOCK_SIZE); // load "I" with "I" coefficients
+    arm_fir_init_f32(&path->hilbert_q, rx_iq_num_taps, path->hilbert_taps_q, path->iq_state_q, IQ_RX_BLOCK_SIZE); // load "Q" with "Q" coefficients
 
-        // Initialize IIR antialias filter state buffer
-        if (FilterPathInfo[ts.filter_path].iir_instance != NULL)
+    // Set up RX SAM decimation/filter
+    if (dmod_mode == DEMOD_SAM || dmod_mode == DEMOD_AM)
+    {
+        if (rx_iq_num_taps != 0)
         {
-            // if we turn on a filter, set the number of members to the number of elements last
-            IIR_AntiAlias[chan].pkCoeffs = FilterPathInfo[ts.filter_path].iir_instance->pkCoeffs; // point to reflection coefficients
-            IIR_AntiAlias[chan].pvCoeffs = FilterPathInfo[ts.filter_path].iir_instance->pvCoeffs; // point to ladder coefficients
-            IIR_AntiAlias[chan].numStages = FilterPathInfo[ts.filter_path].iir_instance->numStages;        // number of stages
+            path->sam_dec_i.numTaps = rx_iq_num_taps;      // Number of taps in FIR filter
+            path->sam_dec_q.numTaps = rx_iq_num_taps;      // Number of taps in FIR filter
+            path->sam_dec_i.pCoeffs = path->hilbert_taps_i;       // Filter coefficients
+            path->sam_dec_q.pCoeffs = path->hilbert_taps_q;       // Filter coefficients
         }
         else
         {
-            // if we turn off a filter, set the number of members to 0 first
-            IIR_AntiAlias[chan].numStages = 0;
-            IIR_AntiAlias[chan].pkCoeffs = NULL;
-            IIR_AntiAlias[chan].pvCoeffs = NULL;
+            path->sam_dec_i.numTaps = 0;
+            path->sam_dec_q.numTaps = 0;
+            path->sam_dec_i.pCoeffs = NULL;
+            path->sam_dec_q.pCoeffs = NULL;
+        }
+
+        path->sam_dec_i.M = fp->sample_rate_dec;
+        path->sam_dec_q.M = fp->sample_rate_dec;
+        path->sam_dec_i.pState = path->iq_state_i;            // Filter state variables
+        path->sam_dec_q.pState = path->iq_state_q;
+
+        arm_fill_f32(0.0, path->iq_state_i, FIR_RX_HILBERT_STATE_SIZE);
+        arm_fill_f32(0.0, path->iq_state_q, FIR_RX_HILBERT_STATE_SIZE);
+    }
+
+    path->decimated_iq =
+            fp->FIR_I_coeff_file == i_rx_new_coeffs // lower than 3k8 bandwidth: new filters with excellent sideband suppression
+            && dmod_mode != DEMOD_FM
+            && dmod_mode != DEMOD_SAM
+            && dmod_mode != DEMOD_AM;
+
+    path->use_conv = false;
+#ifdef USE_CONVOLUTION
+    if ((ts.flags2 & FLAGS2_RX_CONV_FILTER) && path->decimated_iq
+            && (dmod_mode == DEMOD_USB || dmod_mode == DEMOD_LSB || dmod_mode == DEMOD_CW || dmod_mode == DEMOD_DIGI))
+    {
+        // the passband of the filter path as shown on the spectrum display, without the lowest audio frequencies
+        const float32_t width = FilterInfo[fp->id].width;
+        const float32_t center = fp->offset != 0 ? fp->offset : width / 2;
+        const float32_t f_low = center - width / 2 < RX_CONV_F_LOW_MIN ? RX_CONV_F_LOW_MIN : center - width / 2;
+        // the narrow CW filters keep the IIR filters, the convolution filter would not be flat in the passband.
+        // The filter is activated by the RX processor when it starts to use this filter path.
+        path->use_conv = AudioConv_Design(f_low, center + width / 2, IQ_SAMPLE_RATE_F / fp->sample_rate_dec, CONV_TAPS_MAX, RX_CONV_GAIN);
+    }
+#endif
+    path->dmod_mode = dmod_mode;
+    path->filter_path = filter_path;
+}
+
+/**
+ * @brief hands a new filter path over to the RX processor without interrupting the audio
+ *
+ * The filter path is set up in a free slot outside of the audio interrupt. The RX processor picks it up
+ * at the start of its next block and crossfades from the old to the new filters (AudioDriver_RxFilterPathUpdate()).
+ * This is only possible if the processing structure stays the same, i.e. same demodulation mode, decimation rate
+ * and kind of IQ filtering. A change which waits for the end of a running crossfade is replaced by the new one.
+ *
+ * @return true if the change was handed over, false if a full reconfiguration of the RX processing is required
+ */
+static bool AudioDriver_RxFilterPathChange(uint8_t dmod_mode, uint16_t filter_path)
+{
+    bool retval = false;
+
+    if (ads.af_disabled == 0)
+    {
+        // a pending filter path is taken back, the RX processor only starts to use a slot through rxf_next,
+        // so the slot is free afterwards. Without a pending filter path the RX processor does not change
+        // rxf and only releases rxf_fade.old, the slots read below stay in use until they are replaced.
+        RxFilterPath_t* const pending = __atomic_exchange_n(&rxf_next, NULL, __ATOMIC_ACQ_REL);
+        RxFilterPath_t* const active = rxf;
+        RxFilterPath_t* const fading = rxf_fade.old;
+
+        if (pending != NULL && active->filter_path == filter_path && active->dmod_mode == dmod_mode)
+        {
+            // back to the filter path the RX processor uses
+            retval = true;
+        }
+        else if (active->filter_path != 0 && (pending != NULL || active->filter_path != filter_path) && active->dmod_mode == dmod_mode)
+        {
+            const FilterPathDescriptor* fp = &FilterPathInfo[filter_path];
+            const FilterPathDescriptor* fp_active = &FilterPathInfo[active->filter_path];
+
+            if (fp->sample_rate_dec == fp_active->sample_rate_dec
+                    && (fp->FIR_I_coeff_file == i_rx_new_coeffs) == (fp_active->FIR_I_coeff_file == i_rx_new_coeffs)
+                    && (fp->FIR_numTaps != 0) == (fp_active->FIR_numTaps != 0)
+                    && (fp->dec != NULL) == (fp_active->dec != NULL)
+                    && (fp->interpolate != NULL) == (fp_active->interpolate != NULL))
+            {
+                // one of the slots is neither active nor faded out, preferably one which has been set up for this filter path before
+                RxFilterPath_t* slot = NULL;
+                for (int idx = 0; idx < RX_FILTER_PATH_SLOTS; idx++)
+                {
+                    RxFilterPath_t* candidate = &rx_filter_paths[idx];
+                    if (candidate != active && candidate != fading
+                            && (slot == NULL || candidate->filter_path == filter_path))
+                    {
+                        slot = candidate;
+                    }
+                }
+
+                AudioDriver_SetupRxFilterPath(slot, dmod_mode, filter_path);
+
+                // the single pass decimation and Hilbert transform needs mirrored coefficients,
+                // the convolution filter replaces the whole IQ processing and decimates with the filter of the active path
+                if (slot->hilbert_mirrored == active->hilbert_mirrored && slot->use_conv == active->use_conv
+                        && (slot->use_conv == false || fp->dec == fp_active->dec))
+                {
+                    if (AudioDriver_NrDecimation(filter_path) != AudioDriver_NrDecimation(active->filter_path))
+                    {
+                        // the noise reduction changes its sample rate
+                        ts.nr_first_time = 1;
+                    }
+                    __DMB(); // the filter path has to be complete before the RX processor can see it
+                    rxf_next = slot;
+                    retval = true;
+                }
+            }
         }
+    }
+    return retval;
+}
 
-        arm_fill_f32(0.0,iir_aa_state[chan],IIR_RX_STATE_ARRAY_SIZE);
-        IIR_AntiAlias[chan].pState = iir_aa_state[chan];					// point to state array for IIR filter
+/**
+ * @brief configures filters/dsp etc. so that audio processing works according to the current configuration
+ * @param dmod_mode needs to know the demodulation mode
+ * @param reset_dsp_nr whether it is supposed to reset also DSP related filters (in most cases false is to be used here)
+ */
+void AudioDriver_SetRxAudioProcessing(uint8_t dmod_mode, bool reset_dsp_nr)
+{
+    // make sure we have a proper filter path for the given mode
+
+    // the commented out part made the code  only look at last used/selected filter path if the current filter path is not applicable
+    // with it commented out the filter path is ALWAYS loaded from the last used/selected memory
+    // I.e. setting the ts.filter_path anywere else in the code is useless. You have to call AudioFilter_NextApplicableFilterPath in order to
+    // select a new filter path as this sets the last used/selected memory for a demod mode.
+
+    ts.filter_path = AudioFilter_NextApplicableFilterPath(PATH_ALL_APPLICABLE|PATH_LAST_USED_IN_MODE,AudioFilter_GetFilterModeFromDemodMode(dmod_mode),ts.filter_path);
+
+    if (reset_dsp_nr == false && AudioDriver_RxFilterPathChange(dmod_mode, ts.filter_path) == true)
+    {
+        // only the filter path changed, everything else depends only on the mode and the decimation rate
+        return;
+    }
+
+    ts.dsp_inhibit++;
+    ads.af_disabled++;
+
+    // a pending filter path change is dropped and the active filter path is set up again
+    rxf_next = NULL;
+    rxf_fade.old = NULL;
+    AudioDriver_SetupRxFilterPath(rxf, dmod_mode, ts.filter_path);
+#ifdef USE_CONVOLUTION
+    AudioConv_Reset();
+    if (rxf->use_conv)
+    {
+        AudioConv_Activate();
     }
+#endif
 
     // TODO: We only have to do this, if the audio signal filter configuration changes
     // RX+ TX Bass, Treble, Peak, Notch
@@ -1311,26 +1732,20 @@ void AudioDriver_SetRxAudioProcessing(uint8_t dmod_mode, bool reset_dsp_nr)
 
 #ifdef USE_LMS_AUTONOTCH
     // AUTO NOTCH INIT START
-    // LMS instance 2 - Automatic Notch Filter
+    if((ts.dsp_notch_delay > DSP_NOTCH_DELAY_MAX) || (ts.dsp_notch_delay < DSP_NOTCH_DELAY_MIN))
+    {
+        ts.dsp_notch_delay = DSP_NOTCH_DELAY_DEFAULT;
+    }
 
     // Calculate "mu" (convergence rate) from user "Notch ConvRate" setting
     float32_t  mu_calc = log10f(((ts.dsp_notch_mu + 1.0)/1500.0) + 1.0);		// get user setting (0 = slowest)
 
-    // use "canned" init to initialize the filter coefficients
-    arm_lms_norm_init_f32(&lmsData.lms2Norm_instance, ts.dsp_notch_numtaps, lmsData.lms2NormCoeff_f32, lmsData.lms2StateF32, mu_calc, IQ_BLOCK_SIZE);
+    AudioFblms_Init(FBLMS_NOTCH, ts.dsp_notch_numtaps, ts.dsp_notch_delay, mu_calc, 0.0, reset_dsp_nr);
+    // AUTO NOTCH INIT END
+#endif
 
-    arm_fill_f32(0.0,lmsData.lms2_nr_delay,DSP_NOTCH_BUFLEN_MAX);
-
-    if(reset_dsp_nr)             // are we to reset the coefficient buffer as well?
-    {
-        arm_fill_f32(0.0,lmsData.lms2NormCoeff_f32,DSP_NOTCH_NUMTAPS_MAX);      // yes - zero coefficient buffers
-    }
-
-    if((ts.dsp_notch_delaybuf_len > DSP_NOTCH_BUFLEN_MAX) || (ts.dsp_notch_delaybuf_len < DSP_NOTCH_BUFLEN_MIN))
-    {
-        ts.dsp_nr_delaybuf_len = DSP_NOTCH_DELAYBUF_DEFAULT;
-    }
-    // AUTO NOTCH INIT END
+#ifdef USE_LEAKY_LMS
+    AudioFblms_Init(FBLMS_NR, leakyLMS.n_taps, leakyLMS.delay, leakyLMS.two_mu, leakyLMS.gamma * LEAKY_LMS_LEAK_SCALE, reset_dsp_nr);
 #endif
 
 
@@ -1341,11 +1756,6 @@ void AudioDriver_SetRxAudioProcessing(uint8_t dmod_mode, bool reset_dsp_nr)
     //    ts.nr_alpha = 0.899 + ((float32_t)ts.dsp_nr_strength / 1000.0);
     ts.nr_alpha = 0.799 + ((float32_t)ts.dsp_nr_strength / 1000.0);
 
-// NEW AUTONOTCH
-    // not yet working !
-    // set to passthrough
-    //AudioNr_ActivateAutoNotch(0, 0);
-
     // Adjust decimation rate based on selected filter
     ads.decimation_rate = FilterPathInfo[ts.filter_path].sample_rate_dec;
 
@@ -1373,97 +1783,7 @@ void AudioDriver_SetRxAudioProcessing(uint8_t dmod_mode, bool reset_dsp_nr)
             decimZoomFFTQState,            // Filter state variables
             FIR_RXAUDIO_BLOCK_SIZE);
 
-    // Set up RX decimation/filter
-    // this filter instance is also used for Convolution !
-#ifdef USE_CONVOLUTION
-// TODO: insert decimation filter settings for convolution filter HERE
-#else
-    if (FilterPathInfo[ts.filter_path].dec != NULL)
-    {
-        const arm_fir_decimate_instance_f32* dec = FilterPathInfo[ts.filter_path].dec;
-
-#if defined(STM32F4) && defined(USE_LMS_AUTONOTCH)
-        // FIXME: Better solution (e.g. improve graphics performance, better data structures ... )
-        // this code is a hack to reduce processor load for STM32F4 && SPI display
-        // which causes UI lag
-        // in this case we simply use a less power-eating filter (lower number of taps)
-        // one problem is that we use the not so good filter
-        // even if the autonotch / nr is not active and we could use the good filter
-        if (dec == &FirRxDecimate_sideband_supp && ts.display->use_spi == true)
-        {
-        	// TODO: this is wrong! For higher bandwidth filters this has to be
-        	// changed, see filter list in audio_filter.c
-            dec = &FirRxDecimate;
-            //dec = &FirRxDecimate_sideband_supp;
-        }
-#endif
-
-        arm_fir_decimate_init_f32(&DECIMATE_RX_I,
-
-                dec->numTaps,      // Number of taps in FIR filter
-                ads.decimation_rate,
-                dec->pCoeffs,       // Filter coefficients
-                decimState_I,            // Filter state variables
-                FIR_RXAUDIO_BLOCK_SIZE);
-
-        arm_fir_decimate_init_f32(&DECIMATE_RX_Q,
-                dec->numTaps,      // Number of taps in FIR filter
-                ads.decimation_rate,
-                dec->pCoeffs,       // Filter coefficients
-                decimState_Q,            // Filter state variables
-                FIR_RXAUDIO_BLOCK_SIZE);
-    }
-    else
-    {
-        DECIMATE_RX_I.numTaps = 0;
-        DECIMATE_RX_I.pCoeffs = NULL;
-        DECIMATE_RX_Q.numTaps = 0;
-        DECIMATE_RX_Q.pCoeffs = NULL;
-    }
-#endif
-
-    // this filter instance is also used for Convolution !
-#ifdef USE_CONVOLUTION
-// TODO: insert interpolation filter settings for convolution filter HERE
-#else
-    // Set up RX interpolation/filter
-    // NOTE:  Phase Length MUST be an INTEGER and is the number of taps divided by the decimation rate, and it must be greater than 1.
-    for (int chan = 0; chan < NUM_AUDIO_CHANNELS; chan++)
-    {
-        if (FilterPathInfo[ts.filter_path].interpolate != NULL)
-        {
-            arm_fir_interpolate_init_f32(&INTERPOLATE_RX[chan],
-                    ads.decimation_rate,
-                    FilterPathInfo[ts.filter_path].interpolate->phaseLength,
-                    FilterPathInfo[ts.filter_path].interpolate->pCoeffs,
-                    interpState[chan], IQ_BLOCK_SIZE);
-        }
-        else
-        {
-            INTERPOLATE_RX[chan].phaseLength = 0;
-            INTERPOLATE_RX[chan].pCoeffs = NULL;
-        }
-    }
-#endif
-
-#ifdef USE_CONVOLUTION
-    // Convolution Filter
-    // calculate coeffs
-    // for first trial, use hard-coded USB filter from 250Hz to 2700Hz
-    // hardcoded sample rate and Blackman-Harris 4th term
-    cbs.size = 128; // 128 samples processed at one time, this defines the latency:
-    // latency = cbs.size / sample rate = 128/48000 = 2.7ms
-    cbs.nc = 1024; // use 1024 coefficients
-    cbs.nfor = cbs.nc / cbs.size; // number of blocks used for the uniformly partitioned convolution
-    cbs.buffidx = 0; // needs to be reset to zero each time new coeffs are being calculated
-    AudioDriver_CalcConvolutionFilterCoeffs (cbs.nc, 250.0, 2700.0, IQ_SAMPLE_RATE_F, 0, 1, 1.0);
-#endif
-
-    arm_fir_decimate_init_f32(&DECIMATE_NR, 4, 2, NR_decimate_coeffs, decimNRState, FIR_RXAUDIO_BLOCK_SIZE);
-    // should be a very light lowpass @2k7
-
-    arm_fir_interpolate_init_f32(&INTERPOLATE_NR, 2, NR_INTERPOLATE_NO_TAPS, NR_interpolate_coeffs, interplNRState, FIR_RXAUDIO_BLOCK_SIZE);
-    // should be a very light lowpass @2k7
+    AudioDriver_SetupNrDecimation();
 
     ads.dsp_zero_count = 0;		// initialize "zero" count to detect if DSP has crashed
 
@@ -1472,8 +1792,6 @@ void AudioDriver_SetRxAudioProcessing(uint8_t dmod_mode, bool reset_dsp_nr)
         AudioDriver_SetRxAudioProcessingSAM(dmod_mode);
     }
 
-    AudioFilter_InitRxHilbertFIR(dmod_mode); // this switches the Hilbert/FIR-filters
-
     AudioDriver_SetupAgcWdsp();
 
     // Unlock - re-enable filtering
@@ -1541,73 +1859,217 @@ static void AudioDriver_InitFilters(void)
 
 }
 
-#if 0
+_Static_assert(NB_ADVANCE <= IQ_BLOCK_SIZE, "NB_ADVANCE has to fit into the audio block");
+#if NB_RAMP_LEN != 8
+#error "nb_ramp_gain has to be adjusted to NB_RAMP_LEN"
+#endif
+
+// raised cosine gain ramp of the noise blanker, 0.5 - 0.5 * cos(PI * n / NB_RAMP_LEN)
+static const float32_t nb_ramp_gain[NB_RAMP_LEN + 1] =
+{
+    0.0, 0.03806023, 0.14644661, 0.30865828, 0.5, 0.69134172, 0.85355339, 0.96193977, 1.0
+};
+
+typedef struct
+{
+    float32_t delay_i[IQ_BLOCK_SIZE];   // look-ahead delay line, the previous block
+    float32_t delay_q[IQ_BLOCK_SIZE];
+    uint8_t blank[2 * IQ_BLOCK_SIZE];   // 1 = blank the sample, first half: delay line, second half: current block
+    bool blank_any[2];                  // any sample of the half marked in blank
+    float32_t avg_pow;                  // average signal power, pulses excluded
+    uint16_t hang_left;                 // samples still to be blanked in the next block
+    uint8_t ramp;                       // gain ramp position, 0 = blanked ... NB_RAMP_LEN = full gain
+    bool active;
+} NoiseBlanker_t;
+
+static NoiseBlanker_t nb;
+
 //*----------------------------------------------------------------------------
-//* Function Name       : audio_rx_noise_blanker [KA7OEI]
-//* Object              : noise blanker
-//* Object              :
-//* Input Parameters    : I/Q 16 bit audio data, size of buffer
-//* Output Parameters   :
+//* Function Name       : AudioDriver_RxNoiseBlanker
+//* Object              : impulse noise blanker working on the 48ksps IQ samples,
+//* Object              : replaces the int16 noise blanker by KA7OEI
+//* Object              : The pulse detection compares the envelope of the incoming block with the
+//* Object              : average signal power, the output is delayed by one block, so that the gain can be
+//* Object              : ramped down smoothly before a pulse and up again after it.
+//* Object              : Blocks with more than 1/4 of the samples above the threshold are taken as
+//* Object              : a change of the signal level, not as pulses.
+//* Object              : Runs after the frequency conversion, which does not change the envelope.
+//* Input Parameters    : adb.i_buffer, adb.q_buffer after IQ correction
+//* Output Parameters   : adb.i_buffer, adb.q_buffer
 //* Functions called    :
 //*----------------------------------------------------------------------------
-#define AUDIO_RX_NB_DELAY_BUFFER_ITEMS (16)
-#define AUDIO_RX_NB_DELAY_BUFFER_SIZE (AUDIO_RX_NB_DELAY_BUFFER_ITEMS*2)
-
-static void AudioDriver_NoiseBlanker(AudioSample_t * const src, int16_t blockSize)
+static void AudioDriver_RxNoiseBlanker(const uint16_t blockSize)
 {
-    static int16_t	delay_buf[AUDIO_RX_NB_DELAY_BUFFER_SIZE];
-    static uchar	delbuf_inptr = 0, delbuf_outptr = 2;
-    ulong	i;
-    float	sig;
-    float  nb_short_setting;
-    //	static float avg_sig;
-    static	uchar	nb_delay = 0;
-    static float	nb_agc = 0;
+    static float32_t mag2[IQ_BLOCK_SIZE];
 
-    if((ts.nb_setting > 0) &&  (ts.dsp_active & DSP_NB_ENABLE)
-            //            && (ts.dmod_mode != DEMOD_AM && ts.dmod_mode != DEMOD_FM)
-            && (ts.dmod_mode != DEMOD_FM))
-        //        && (FilterPathInfo[ts.filter_path].sample_rate_dec != RX_DECIMATION_RATE_24KHZ ))
+    assert(blockSize <= IQ_BLOCK_SIZE && blockSize >= NB_ADVANCE);
 
-        // bail out if noise blanker disabled, in AM/FM mode, or set to 10 kHz
+    if (ts.nb_setting == 0 || (ts.dsp_active & DSP_NB_ENABLE) == 0 || ts.dmod_mode == DEMOD_FM)
     {
-        nb_short_setting = ts.nb_setting;		// convert and rescale NB1 setting for higher resolution in adjustment
-        nb_short_setting /= 2;
+        nb.active = false;
+        return;
+    }
 
-        for(i = 0; i < blockSize; i++)	 		// Noise blanker function
-        {
-            sig = fabs(src[i].l);		// get signal amplitude.  We need only look at one of the two audio channels since they will be the same.
-            sig /= ads.codec_gain_calc;	// Scale for codec A/D gain adjustment
-            //		avg_sig = (avg_sig * NB_AVG_WEIGHT) + ((float)(*src) * NB_SIG_WEIGHT);	// IIR-filtered short-term average signal level (e.g. low-pass audio)
-            delay_buf[delbuf_inptr++] = src[i].l;	    // copy first byte into delay buffer
-            delay_buf[delbuf_inptr++] = src[i].r;	// copy second byte into delay buffer
+    // envelope (power) of the incoming block
+    for (uint16_t k = 0; k < blockSize; k++)
+    {
+        mag2[k] = adb.i_buffer[k] * adb.i_buffer[k] + adb.q_buffer[k] * adb.q_buffer[k];
+    }
 
-            nb_agc = (ads.nb_agc_filt * nb_agc) + (ads.nb_sig_filt * sig);		// IIR-filtered "AGC" of current overall signal level
+    if (nb.active == false)
+    {
+        // the average is not updated while the blanker is off, start again from the level of this block.
+        // The delay line starts with this block too, so the block delay is added by repeating
+        // one block instead of inserting a block of silence
+        memset(&nb, 0, sizeof(nb));
+        arm_mean_f32(mag2, blockSize, &nb.avg_pow);
+        arm_copy_f32(adb.i_buffer, nb.delay_i, blockSize);
+        arm_copy_f32(adb.q_buffer, nb.delay_q, blockSize);
+        nb.ramp = NB_RAMP_LEN;
+        nb.active = true;
+    }
+
+    // same scaling of the setting as the int16 noise blanker, the threshold is compared with the power
+    const float32_t factor = ((MAX_NB_SETTING/2) + 1.75) - (float32_t)ts.nb_setting / 2;
+    const float32_t threshold = factor * factor * nb.avg_pow;
 
-            if(((sig) > (nb_agc * (((MAX_NB_SETTING/2) + 1.75) - nb_short_setting))) && (nb_delay == 0))	 	// did a pulse exceed the threshold?
+    uint16_t pulse_count = 0;
+    for (uint16_t k = 0; k < blockSize; k++)
+    {
+        pulse_count += mag2[k] > threshold;
+    }
+
+    // a pulse from the previous block still has to be blanked
+    uint8_t* const blank_new = &nb.blank[blockSize];
+    const uint16_t hang = nb.hang_left < blockSize ? nb.hang_left : blockSize;
+    memset(blank_new, 1, hang);
+    memset(&blank_new[hang], 0, blockSize - hang);
+    nb.blank_any[1] = hang > 0;
+    nb.hang_left -= hang;
+
+    if (pulse_count == 0 || pulse_count > blockSize / 4)
+    {
+        float32_t mean;
+        arm_mean_f32(mag2, blockSize, &mean);
+        nb.avg_pow += (mean - nb.avg_pow) * (blockSize / (NB_AVG_TAU * IQ_SAMPLE_RATE_F));
+    }
+    else
+    {
+        for (uint16_t k = 0; k < blockSize; k++)
+        {
+            if (mag2[k] > threshold)
             {
-                nb_delay = AUDIO_RX_NB_DELAY_BUFFER_ITEMS;		// yes - set the blanking duration counter
+                const uint16_t start = blockSize + k - NB_ADVANCE;
+                const uint16_t end = blockSize + k + NB_HANG;   // last blanked sample
+                const uint16_t last = end < 2 * blockSize ? end : 2 * blockSize - 1;
+
+                memset(&nb.blank[start], 1, last - start + 1);
+                if (start < blockSize)
+                {
+                    nb.blank_any[0] = true;
+                }
+                nb.blank_any[1] = true;
+                if (end >= 2 * blockSize && end - (2 * blockSize - 1) > nb.hang_left)
+                {
+                    nb.hang_left = end - (2 * blockSize - 1);
+                }
             }
+        }
+    }
 
-            if(!nb_delay)	 		// blank counter not active
+    // output the delay line and put the incoming block into it
+    if (nb.blank_any[0] == false && nb.ramp == NB_RAMP_LEN)
+    {
+        for (uint16_t k = 0; k < blockSize; k++)
+        {
+            const float32_t i_val = adb.i_buffer[k];
+            const float32_t q_val = adb.q_buffer[k];
+            adb.i_buffer[k] = nb.delay_i[k];
+            adb.q_buffer[k] = nb.delay_q[k];
+            nb.delay_i[k] = i_val;
+            nb.delay_q[k] = q_val;
+        }
+    }
+    else
+    {
+        uint8_t ramp = nb.ramp;
+        for (uint16_t k = 0; k < blockSize; k++)
+        {
+            if (nb.blank[k])
             {
-                src[i].l = delay_buf[delbuf_outptr++];		// pass through delayed audio, unchanged
-                src[i].r = delay_buf[delbuf_outptr++];
+                ramp = ramp > 0 ? ramp - 1 : 0;
             }
-            else	 	// It is within the blanking pulse period
+            else
             {
-                src[i].l = 0; // (int16_t)avg_sig;		// set the audio buffer to "mute" during the blanking period
-                src[i].r = 0; //(int16_t)avg_sig;
-                nb_delay--;						// count down the number of samples that we are to blank
+                ramp = ramp < NB_RAMP_LEN ? ramp + 1 : NB_RAMP_LEN;
             }
+            const float32_t gain = nb_ramp_gain[ramp];
+            const float32_t i_val = adb.i_buffer[k];
+            const float32_t q_val = adb.q_buffer[k];
+            adb.i_buffer[k] = nb.delay_i[k] * gain;
+            adb.q_buffer[k] = nb.delay_q[k] * gain;
+            nb.delay_i[k] = i_val;
+            nb.delay_q[k] = q_val;
+        }
+        nb.ramp = ramp;
+    }
+
+    memcpy(nb.blank, blank_new, blockSize);
+    nb.blank_any[0] = nb.blank_any[1];
+}
 
-            // RINGBUFFER
-            delbuf_outptr %= AUDIO_RX_NB_DELAY_BUFFER_SIZE;
-            delbuf_inptr %= AUDIO_RX_NB_DELAY_BUFFER_SIZE;
+// keeps the generated data for frequency conversion
+static float32_t                   Osc_I_buffer[IQ_BLOCK_SIZE];
+static float32_t                   Osc_Q_buffer[IQ_BLOCK_SIZE];
+
+// phase accumulator NCO for frequency conversion by arbitrary frequencies, see AudioDriver_RxNcoPrepare
+static soft_dds_t                  rx_nco;
+static int32_t                     rx_nco_freq;
+
+/**
+ * @brief Pre-calculates the quadrature oscillator for the +/-6kHz frequency conversion if the conversion mode has changed
+ * @param blockSize length of the oscillator buffers, the oscillator has to complete an integer number of cycles in it
+ */
+static void AudioDriver_FreqConversionPrepareOsc(int16_t blockSize)
+{
+    static bool recalculate_Osc = false;
+
+    assert(blockSize <= IQ_BLOCK_SIZE);
+
+    // Pre-calculate quadrature sine wave(s) ONCE for the conversion
+    // ts.multi is the number of oscillator cycles per block, i.e. 4 for 6kHz (Fs/8) with 32 samples per block
+    //
+    switch(ts.iq_freq_mode)
+    {
+    case FREQ_IQ_CONV_P6KHZ:
+    case FREQ_IQ_CONV_M6KHZ:
+        if (ts.multi != blockSize/8)
+        {
+            ts.multi = blockSize/8; 		// 6 kHz offset
+            recalculate_Osc = true;
+        }
+        break;
+    case FREQ_IQ_CONV_P12KHZ:
+    case FREQ_IQ_CONV_M12KHZ:
+        if (ts.multi != blockSize/4)
+        {
+            ts.multi = blockSize/4; 		// 12 kHz offset
+            recalculate_Osc = true;
         }
     }
+
+    if(recalculate_Osc == true)	 		// have we already calculated the sine wave?
+    {
+        float32_t multiplier = (ts.multi * PI * 2) / ((float32_t)blockSize);
+
+        for(int i = 0; i < blockSize; i++)	 		// No, let's do it!
+        {
+            float32_t rad_calc = (float32_t)i * multiplier;
+            sincosf(rad_calc, &Osc_I_buffer[i], &Osc_Q_buffer[i]);
+        }
+        recalculate_Osc = false;	// signal that once we have generated the quadrature sine waves, we shall not do it again
+    }
 }
-#endif
 
 //
 //*----------------------------------------------------------------------------
@@ -1620,13 +2082,6 @@ static void AudioDriver_NoiseBlanker(AudioSample_t * const src, int16_t blockSiz
 //*----------------------------------------------------------------------------
 void AudioDriver_FreqConversion(float32_t* i_buffer, float32_t* q_buffer, int16_t blockSize, int16_t dir)
 {
-    static bool recalculate_Osc = false;
-    // keeps the generated data for frequency conversion
-    static float32_t                   Osc_I_buffer[IQ_BLOCK_SIZE];
-    static float32_t                   Osc_Q_buffer[IQ_BLOCK_SIZE];
-
-    assert(blockSize <= IQ_BLOCK_SIZE);
-
 
     //
     // Below is the "on-the-fly" version of the frequency translator, generating a "live" version of the oscillator (NCO), which can be any
@@ -1661,38 +2116,7 @@ void AudioDriver_FreqConversion(float32_t* i_buffer, float32_t* q_buffer, int16_
     // multiple of the sample frequency.  This pre-calculation eliminates the processor overhead required to generate a sine wave on the fly.
     // This also makes extensive use of the optimized ARM vector instructions for the calculation of the final I/Q vectors
     //
-    // Pre-calculate quadrature sine wave(s) ONCE for the conversion
-    //
-    switch(ts.iq_freq_mode)
-    {
-    case FREQ_IQ_CONV_P6KHZ:
-    case FREQ_IQ_CONV_M6KHZ:
-        if (ts.multi != 4)
-        {
-            ts.multi = 4; 		//(4 = 6 kHz offset)
-            recalculate_Osc = true;
-        }
-        break;
-    case FREQ_IQ_CONV_P12KHZ:
-    case FREQ_IQ_CONV_M12KHZ:
-        if (ts.multi != 8)
-        {
-            ts.multi = 8; 		// (8 = 12 kHz offset)
-            recalculate_Osc = true;
-        }
-    }
-
-    if(recalculate_Osc == true)	 		// have we already calculated the sine wave?
-    {
-        float32_t multiplier = (ts.multi * PI * 2) / ((float32_t)blockSize);
-
-        for(int i = 0; i < blockSize; i++)	 		// No, let's do it!
-        {
-            float32_t rad_calc = (float32_t)i * multiplier;
-            sincosf(rad_calc, &Osc_I_buffer[i], &Osc_Q_buffer[i]);
-        }
-        recalculate_Osc = false;	// signal that once we have generated the quadrature sine waves, we shall not do it again
-    }
+    AudioDriver_FreqConversionPrepareOsc(blockSize);
 
 
     if(ts.iq_freq_mode == FREQ_IQ_CONV_P12KHZ || ts.iq_freq_mode == FREQ_IQ_CONV_M12KHZ)
@@ -1840,14 +2264,14 @@ static bool AudioDriver_RxProcessorFreeDV (AudioSample_t * const src, float32_t
             }
         }
 
-        modulus_NF += 4; //  shift modulus to not loose any data while overlapping
+        modulus_NF += 6 - blockSize % 6; //  shift modulus to not loose any data while overlapping (+4 for 32 samples per block)
         modulus_NF %= 6;//  reset modulus to 0 at modulus = 12
 
         if (trans_count_in == FDV_BUFFER_SIZE) //yes, we really hit exactly 320 - don't worry
         {
             //we have enough samples ready to start the FreeDV encoding
 
-            fdv_iq_buffer_add(&mmb.fdv_iq_buff[FDV_TX_fill_in_pt]);
+            FdvIqBufferRing_Put(&fdv_iq_ring, &mmb.fdv_iq_buff[FDV_TX_fill_in_pt]);
             //handshake to external function in ui.driver_thread
             trans_count_in = 0;
 
@@ -1859,9 +2283,9 @@ static bool AudioDriver_RxProcessorFreeDV (AudioSample_t * const src, float32_t
         // we wait for availability of at least 2 buffers
         // so that in theory we have uninterrupt flow of audio
         // albeit with a delay of 80ms
-        if (out_buffer == NULL && fdv_audio_has_data() > 1)
+        if (out_buffer == NULL && FdvAudioBufferRing_Fill(&fdv_audio_ring) > 1)
         {
-            fdv_audio_buffer_peek(&out_buffer);
+            FdvAudioBufferRing_Peek(&fdv_audio_ring, &out_buffer);
         }
 
         if (out_buffer != NULL) // freeDV encode has finished (running in ui_driver.c)?
@@ -1936,10 +2360,10 @@ static bool AudioDriver_RxProcessorFreeDV (AudioSample_t * const src, float32_t
         if (outbuff_count >= FDV_BUFFER_SIZE)
         {
             outbuff_count = 0;
-            fdv_audio_buffer_remove(&out_buffer);
+            FdvAudioBufferRing_Get(&fdv_audio_ring, &out_buffer);
             // ok, this one is done with
             out_buffer = NULL;
-            fdv_audio_buffer_peek(&out_buffer);
+            FdvAudioBufferRing_Peek(&fdv_audio_ring, &out_buffer);
             // we may or may not get a buffer here
             // if not and we have a stall the code somewhere up
             // produces silence until 2 out buffers are available
@@ -2017,9 +2441,9 @@ static bool AudioDriver_RxProcessorFreeDV (AudioSample_t * const src, float32_t
         History[2] = out_buffer->samples[FDV_BUFFER_SIZE-1]; // block overlapping region
 
         // ok, let us free the old buffer
-        fdv_audio_buffer_remove(&out_buffer);
+        FdvAudioBufferRing_Get(&fdv_audio_ring, &out_buffer);
         out_buffer = NULL;
-        fdv_audio_buffer_peek(&out_buffer);
+        FdvAudioBufferRing_Peek(&fdv_audio_ring, &out_buffer);
 
     }
 
@@ -2051,6 +2475,19 @@ static void AudioDriver_RxProcessor_Bpsk(float32_t * const src, int16_t blockSiz
     }
 }
 
+/**
+ * @brief empties the look-ahead delay lines, the audio restarts from silence
+ */
+static void AudioDriver_AgcWdspClearDelay()
+{
+	for(int ch = 0; ch < NUM_AUDIO_CHANNELS; ch++)
+	{
+		arm_fill_f32(0.0, agc_wdsp.delay[ch], AGC_WDSP_RB_SIZE + IQ_BLOCK_SIZE);
+	}
+	arm_fill_f32(0.0, agc_wdsp.peak_delay, (AGC_WDSP_RB_SIZE + IQ_BLOCK_SIZE) / AGC_WDSP_SUB_BLOCK);
+	arm_fill_f32(0.0, agc_wdsp.mean_delay, (AGC_WDSP_RB_SIZE + IQ_BLOCK_SIZE) / AGC_WDSP_SUB_BLOCK);
+}
+
 void AudioDriver_SetupAgcWdsp()
 {
     static bool initialised = false;
@@ -2061,9 +2498,7 @@ void AudioDriver_SetupAgcWdsp()
     // this is a quick and dirty hack
     // it initialises the AGC variables once again,
     // if the decimation rate is changed
-    // this should prevent confusion between the distance of in_index and out_index variables
-    // because these are freshly initialised
-    // in_index and out_index have a distance of 48 (sample rate 12000) or 96 (sample rate 24000)
+    // this clears the look-ahead delay lines, their length is 48 (sample rate 12000) or 96 (sample rate 24000) samples
     // so that has to be defined very well when filter from 4k8 to 5k0 (changing decimation rate from 4 to 2)
     if(decimation_rate_old != ads.decimation_rate)
     {
@@ -2115,10 +2550,9 @@ loadWcpAGC(a);
     	 *
     	 * */
 
-    	agc_wdsp.ring_buffsize = AGC_WDSP_RB_SIZE; //192; //96;
 		//do one-time initialization
-    	agc_wdsp.out_index = -1; //agc_wdsp.ring_buffsize; // or -1 ??
     	agc_wdsp.fixed_gain = 1.0;
+    	agc_wdsp.gain = 0.0;
     	agc_wdsp.ring_max = 0.0;
     	agc_wdsp.volts = 0.0;
     	agc_wdsp.save_volts = 0.0;
@@ -2127,11 +2561,10 @@ loadWcpAGC(a);
 		agc_wdsp.hang_counter = 0;
 		agc_wdsp.decay_type = 0;
 		agc_wdsp.state = 0;
-		for(int idx = 0; idx < AGC_WDSP_RB_SIZE; idx++)
+		AudioDriver_AgcWdspClearDelay();
+		for(int idx = 0; idx < AGC_WDSP_SUB_BLOCK; idx++)
 		{
-			agc_wdsp.ring[idx * 2 + 0] = 0.0;
-			agc_wdsp.ring[idx * 2 + 1] = 0.0;
-			agc_wdsp.abs_ring[idx] = 0.0;
+			agc_wdsp.ramp[idx] = idx + 1;
 		}
 
 
@@ -2216,15 +2649,24 @@ loadWcpAGC(a);
     agc_wdsp.fixed_gain = agc_wdsp.max_gain / 10.0;
     // attack_buff_size is 48 for sample rate == 12000 and
     // 96 for sample rate == 24000
-    agc_wdsp.attack_buffsize = (int)ceil(sample_rate * agc_wdsp.n_tau * agc_wdsp.tau_attack);
-
-    agc_wdsp.in_index = agc_wdsp.attack_buffsize + agc_wdsp.out_index; // attack_buffsize + out_index can be more than 2x ring_bufsize !!!
-    agc_wdsp.in_index %= agc_wdsp.ring_buffsize; // need to keep this within the index boundaries
+    // rounded to whole sub-blocks
+    agc_wdsp.attack_buffsize = (int)roundf(sample_rate * agc_wdsp.n_tau * agc_wdsp.tau_attack / AGC_WDSP_SUB_BLOCK) * AGC_WDSP_SUB_BLOCK;
+    if (agc_wdsp.attack_buffsize < AGC_WDSP_SUB_BLOCK)
+    {
+        agc_wdsp.attack_buffsize = AGC_WDSP_SUB_BLOCK;
+    }
+    if (agc_wdsp.attack_buffsize > AGC_WDSP_RB_SIZE)
+    {
+        agc_wdsp.attack_buffsize = AGC_WDSP_RB_SIZE;
+    }
 
-    agc_wdsp.attack_mult = 1.0 - expf(-1.0 / (sample_rate * agc_wdsp.tau_attack));
-    agc_wdsp.decay_mult = 1.0 - expf(-1.0 / (sample_rate * agc_wdsp.tau_decay));
-    agc_wdsp.fast_decay_mult = 1.0 - expf(-1.0 / (sample_rate * agc_wdsp.tau_fast_decay));
-    agc_wdsp.fast_backmult = 1.0 - expf(-1.0 / (sample_rate * agc_wdsp.tau_fast_backaverage));
+    // the gain state machine runs once per sub-block, so all multipliers cover AGC_WDSP_SUB_BLOCK samples:
+    // 1 - (1 - m)^AGC_WDSP_SUB_BLOCK for the per sample multiplier m
+    const float32_t sub_block_rate = sample_rate / AGC_WDSP_SUB_BLOCK;
+    agc_wdsp.attack_mult = 1.0 - expf(-1.0 / (sub_block_rate * agc_wdsp.tau_attack));
+    agc_wdsp.decay_mult = 1.0 - expf(-1.0 / (sub_block_rate * agc_wdsp.tau_decay));
+    agc_wdsp.fast_decay_mult = 1.0 - expf(-1.0 / (sub_block_rate * agc_wdsp.tau_fast_decay));
+    agc_wdsp.fast_backmult = 1.0 - expf(-1.0 / (sub_block_rate * agc_wdsp.tau_fast_backaverage));
     agc_wdsp.onemfast_backmult = 1.0 - agc_wdsp.fast_backmult;
 
     agc_wdsp.out_target = agc_wdsp.out_targ * (1.0 - expf(-(float32_t)agc_wdsp.n_tau)) * 0.9999;
@@ -2261,10 +2703,10 @@ loadWcpAGC(a);
     agc_wdsp.hang_level = (agc_wdsp.max_input * tmp + (agc_wdsp.out_target /
             (agc_wdsp.var_gain * agc_wdsp.max_gain)) * (1.0 - tmp)) * 0.637;
 
-    agc_wdsp.hang_backmult = 1.0 - expf(-1.0 / (sample_rate * agc_wdsp.tau_hang_backmult));
+    agc_wdsp.hang_backmult = 1.0 - expf(-1.0 / (sub_block_rate * agc_wdsp.tau_hang_backmult));
     agc_wdsp.onemhang_backmult = 1.0 - agc_wdsp.hang_backmult;
 
-    agc_wdsp.hang_decay_mult = 1.0 - expf(-1.0 / (sample_rate * agc_wdsp.tau_hang_decay));
+    agc_wdsp.hang_decay_mult = 1.0 - expf(-1.0 / (sub_block_rate * agc_wdsp.tau_hang_decay));
 }
 
 #ifdef USE_TWO_CHANNEL_AUDIO
@@ -2276,69 +2718,69 @@ void AudioDriver_RxAgcWdsp(int16_t blockSize, float32_t *agcbuffer1)
 #ifdef USE_TWO_CHANNEL_AUDIO
     const uint8_t dmod_mode = ts.dmod_mode;
     const bool use_stereo = (dmod_mode == DEMOD_IQ || dmod_mode == DEMOD_SSBSTEREO || (dmod_mode == DEMOD_SAM && ads.sam_sideband == SAM_SIDEBAND_STEREO));
+#else
+    const bool use_stereo = false;
 #endif
     // Be careful: the original source code has no comments,
     // all comments added by DD4WH, February 2017: comments could be wrong, misinterpreting or highly misleading!
     //
     if (ts.agc_wdsp_mode == 5)  // AGC OFF
     {
-        for (uint16_t i = 0; i < blockSize; i++)
-        {
-        	//            adb.a_buffer[i] = adb.a_buffer[i] * agc_wdsp.fixed_gain;
-            agcbuffer1[i] = agcbuffer1[i] * agc_wdsp.fixed_gain;
+        arm_scale_f32(agcbuffer1, agc_wdsp.fixed_gain, agcbuffer1, blockSize);
 #ifdef USE_TWO_CHANNEL_AUDIO
-            {
-                agcbuffer2[i] = agcbuffer2[i] * agc_wdsp.fixed_gain;
-            }
+        arm_scale_f32(agcbuffer2, agc_wdsp.fixed_gain, agcbuffer2, blockSize);
 #endif
-        }
         return;
     }
 
-    for (uint16_t i = 0; i < blockSize; i++)
+    // look-ahead: output sample i is delay[i], the gain for it follows the peak of the next attack_buffsize samples
+    const uint16_t look_ahead = agc_wdsp.attack_buffsize;
+    const uint16_t look_ahead_sub = look_ahead / AGC_WDSP_SUB_BLOCK;
+
+    // the delay lines hold the samples of another look-ahead length or the second one is stale from an earlier stereo mode
+    if (agc_wdsp.delay_buffsize != look_ahead || agc_wdsp.delay_stereo != use_stereo)
     {
-        if (++agc_wdsp.out_index >= agc_wdsp.ring_buffsize)
-        {
-            agc_wdsp.out_index -= agc_wdsp.ring_buffsize;
-        }
-        if (++agc_wdsp.in_index >= agc_wdsp.ring_buffsize)
-        {
-            agc_wdsp.in_index -= agc_wdsp.ring_buffsize;
-        }
+        AudioDriver_AgcWdspClearDelay();
+        agc_wdsp.delay_buffsize = look_ahead;
+        agc_wdsp.delay_stereo = use_stereo;
+    }
+    float32_t abs_in[IQ_BLOCK_SIZE];
+    float32_t gain[IQ_BLOCK_SIZE];
 
-//        agc_wdsp.out_sample[0] = agc_wdsp.ring[agc_wdsp.out_index];
-        agc_wdsp.out_sample[0] = agc_wdsp.ring[2 * agc_wdsp.out_index];
-#ifdef USE_TWO_CHANNEL_AUDIO
-        if(use_stereo)
-        	{
-        		agc_wdsp.out_sample[1] = agc_wdsp.ring[2 * agc_wdsp.out_index + 1];
-        	}
-#endif
-        agc_wdsp.abs_out_sample = agc_wdsp.abs_ring[agc_wdsp.out_index];
-        //        agc_wdsp.ring[agc_wdsp.in_index] = adb.a_buffer[i];
-        //        agc_wdsp.abs_ring[agc_wdsp.in_index] = fabsf(adb.a_buffer[i]);
-//        agc_wdsp.ring[agc_wdsp.in_index] = agcbuffer[i];
-        agc_wdsp.ring[2 * agc_wdsp.in_index] = agcbuffer1[i];
+    arm_copy_f32(agcbuffer1, &agc_wdsp.delay[0][look_ahead], blockSize);
+    arm_abs_f32(agcbuffer1, abs_in, blockSize);
 #ifdef USE_TWO_CHANNEL_AUDIO
-        if(use_stereo)
-        	{
-        		agc_wdsp.ring[2 * agc_wdsp.in_index + 1] = agcbuffer2[i];
-        	}
-#endif
-        //        agc_wdsp.abs_ring[agc_wdsp.in_index] = fabsf(agcbuffer[i]);
-        agc_wdsp.abs_ring[agc_wdsp.in_index] = fabsf(agcbuffer1[i]);
-#ifdef USE_TWO_CHANNEL_AUDIO
-        if(use_stereo)
+    if(use_stereo)
+    {
+        arm_copy_f32(agcbuffer2, &agc_wdsp.delay[1][look_ahead], blockSize);
+        for (uint16_t i = 0; i < blockSize; i++)
         {
-			if(agc_wdsp.abs_ring[agc_wdsp.in_index] < fabsf(agcbuffer2[i]))
-			{
-				agc_wdsp.abs_ring[agc_wdsp.in_index] = fabsf(agcbuffer2[i]);
-			}
+            const float32_t abs2 = fabsf(agcbuffer2[i]);
+            if (abs_in[i] < abs2)
+            {
+                abs_in[i] = abs2;
+            }
         }
+    }
 #endif
+    for (uint16_t sub = 0; sub < blockSize; sub += AGC_WDSP_SUB_BLOCK)
+    {
+        uint32_t max_idx;
+        const uint16_t slot = look_ahead_sub + sub / AGC_WDSP_SUB_BLOCK;
+        arm_max_f32(&abs_in[sub], AGC_WDSP_SUB_BLOCK, &agc_wdsp.peak_delay[slot], &max_idx);
+        arm_mean_f32(&abs_in[sub], AGC_WDSP_SUB_BLOCK, &agc_wdsp.mean_delay[slot]);
+    }
 
-        agc_wdsp.fast_backaverage = agc_wdsp.fast_backmult * agc_wdsp.abs_out_sample + agc_wdsp.onemfast_backmult * agc_wdsp.fast_backaverage;
-        agc_wdsp.hang_backaverage = agc_wdsp.hang_backmult * agc_wdsp.abs_out_sample + agc_wdsp.onemhang_backmult * agc_wdsp.hang_backaverage;
+    for (uint16_t sub = 0; sub < blockSize; sub += AGC_WDSP_SUB_BLOCK)
+    {
+        // the envelope is the peak of the sub-block and of the look-ahead following it
+        uint32_t max_idx;
+        const uint16_t slot = sub / AGC_WDSP_SUB_BLOCK;
+        const float32_t abs_out_mean = agc_wdsp.mean_delay[slot];
+        arm_max_f32(&agc_wdsp.peak_delay[slot], look_ahead_sub + 1, &agc_wdsp.ring_max, &max_idx);
+
+        agc_wdsp.fast_backaverage = agc_wdsp.fast_backmult * abs_out_mean + agc_wdsp.onemfast_backmult * agc_wdsp.fast_backaverage;
+        agc_wdsp.hang_backaverage = agc_wdsp.hang_backmult * abs_out_mean + agc_wdsp.onemhang_backmult * agc_wdsp.hang_backaverage;
         if(agc_wdsp.hang_backaverage > agc_wdsp.hang_level)
         {
             ts.agc_wdsp_hang_action = 1;
@@ -2348,31 +2790,13 @@ void AudioDriver_RxAgcWdsp(int16_t blockSize, float32_t *agcbuffer1)
             ts.agc_wdsp_hang_action = 0;
         }
 
-        if ((agc_wdsp.abs_out_sample >= agc_wdsp.ring_max) && (agc_wdsp.abs_out_sample > 0.0))
-        {
-            agc_wdsp.ring_max = 0.0;
-            int k = agc_wdsp.out_index;
-
-            for (uint16_t j = 0; j < agc_wdsp.attack_buffsize; j++)
-            {
-                if (++k == agc_wdsp.ring_buffsize)
-                {
-                    k = 0;
-                }
-                if (agc_wdsp.abs_ring[k] > agc_wdsp.ring_max)
-                {
-                    agc_wdsp.ring_max = agc_wdsp.abs_ring[k];
-                }
-            }
-        }
-        if (agc_wdsp.abs_ring[agc_wdsp.in_index] > agc_wdsp.ring_max)
+        if (agc_wdsp.hang_counter > AGC_WDSP_SUB_BLOCK)
         {
-            agc_wdsp.ring_max = agc_wdsp.abs_ring[agc_wdsp.in_index];
+            agc_wdsp.hang_counter -= AGC_WDSP_SUB_BLOCK;
         }
-
-        if (agc_wdsp.hang_counter > 0)
+        else
         {
-            --agc_wdsp.hang_counter;
+            agc_wdsp.hang_counter = 0;
         }
 
         switch (agc_wdsp.state)
@@ -2508,15 +2932,26 @@ void AudioDriver_RxAgcWdsp(int16_t blockSize, float32_t *agcbuffer1)
             vo = 0.0;
         }
 
-        float32_t mult = (agc_wdsp.out_target - agc_wdsp.slope_constant * vo) / agc_wdsp.volts;
-        agcbuffer1[i] = agc_wdsp.out_sample[0] * mult;
+        const float32_t mult = (agc_wdsp.out_target - agc_wdsp.slope_constant * vo) / agc_wdsp.volts;
+
+        // linear ramp from the gain of the previous sub-block to the new one
+        arm_scale_f32(agc_wdsp.ramp, (mult - agc_wdsp.gain) / AGC_WDSP_SUB_BLOCK, &gain[sub], AGC_WDSP_SUB_BLOCK);
+        arm_offset_f32(&gain[sub], agc_wdsp.gain, &gain[sub], AGC_WDSP_SUB_BLOCK);
+        agc_wdsp.gain = mult;
+    }
+
+    const uint16_t block_sub = blockSize / AGC_WDSP_SUB_BLOCK;
+    arm_mult_f32(agc_wdsp.delay[0], gain, agcbuffer1, blockSize);
+    memmove(agc_wdsp.delay[0], &agc_wdsp.delay[0][blockSize], look_ahead * sizeof(float32_t));
+    memmove(agc_wdsp.peak_delay, &agc_wdsp.peak_delay[block_sub], look_ahead_sub * sizeof(float32_t));
+    memmove(agc_wdsp.mean_delay, &agc_wdsp.mean_delay[block_sub], look_ahead_sub * sizeof(float32_t));
 #ifdef USE_TWO_CHANNEL_AUDIO
-        if(use_stereo)
-        {
-        	agcbuffer2[i] = agc_wdsp.out_sample[1] * mult;
-        }
-#endif
+    if(use_stereo)
+    {
+        arm_mult_f32(agc_wdsp.delay[1], gain, agcbuffer2, blockSize);
+        memmove(agc_wdsp.delay[1], &agc_wdsp.delay[1][blockSize], look_ahead * sizeof(float32_t));
     }
+#endif
 
     if(ts.dmod_mode == DEMOD_AM || ts.dmod_mode == DEMOD_SAM)
     {
@@ -2664,10 +3099,10 @@ static void AudioDriver_RxAgcProcessor(int16_t blockSize, float32_t *agcbuffer)
 static void AudioDriver_DemodFM(const int16_t blockSize)
 {
 
-	float r, s, angle, x, y, a, b;
+	float r, s, b;
 	float32_t goertzel_buf[blockSize], squelch_buf[blockSize];
 	bool tone_det_enabled;
-	static float i_prev, q_prev, lpf_prev, hpf_prev_a, hpf_prev_b;// used in FM detection and low/high pass processing
+	static float i_prev, q_prev;// used in FM detection
 
 	static float subdet = 0;				// used for tone detection
 	static uchar count = 0, tdet = 0;// used for squelch processing and debouncing tone detection, respectively
@@ -2678,112 +3113,36 @@ static void AudioDriver_DemodFM(const int16_t blockSize)
 
 		tone_det_enabled = ts.fm_subaudible_tone_det_select ? 1 : 0;// set a quick flag for checking to see if tone detection is enabled
 
-		for (uint16_t i = 0; i < blockSize; i++)
+		// first, calculate "x" and "y" for the arctan2, comparing the vectors of present data with previous data
+		// the first sample of the block uses the last one of the previous block
+		squelch_buf[0] = AudioDriver_FastAtan2((i_prev * adb.q_buffer[0]) - (adb.i_buffer[0] * q_prev),
+				(i_prev * adb.i_buffer[0]) + (adb.q_buffer[0] * q_prev));
+
+		for (uint16_t i = 1; i < blockSize; i++)
 		{
-			// first, calculate "x" and "y" for the arctan2, comparing the vectors of present data with previous data
-
-			y = (i_prev * adb.q_buffer[i]) - (adb.i_buffer[i] * q_prev);
-			x = (i_prev * adb.i_buffer[i]) + (adb.q_buffer[i] * q_prev);
-
-			/*        //
-			  we do not use this approximation any more, because it does not contribute significantly to saving processor cycles,
-			  and does not deliver as clean audio as we would expect.
-			  with atan2f the audio (and especially the hissing noise!) is much cleaner, DD4WH
-
-			 // What follows is adapted from "Fixed-Point Atan2 With Self Normalization", public domain code by "Jim Shima".
-			 // The result is "approximate" - but plenty good enough for speech-grade communications!
-			 //
-			 // Do calculation of arc-tangent (with quadrant preservation) of of I and Q channels, comparing with previous sample.
-			 // Because the result is absolute (we are using ratios!) there is no need to apply any sort of amplitude limiting
-			 //
-			 abs_y = fabs(y) + 2e-16;		// prevent us from taking "zero divided by zero" (indeterminate value) by setting this to be ALWAYS at least slightly higher than zero
-			 //
-			 if(x >= 0)	 					// Quadrant 1 or 4
-			 {
-			 r = (x - abs_y) / (x + abs_y);
-			 angle = FM_DEMOD_COEFF1 - FM_DEMOD_COEFF1 * r;
-			 }
-			 else	 						// Quadrant 2 or 3
-			 {
-			 r = (x + abs_y) / abs_y - x;
-			 angle = FM_DEMOD_COEFF2 - FM_DEMOD_COEFF1 * r;
-			 }
-			 //
-			 if (y < 0)						// Quadrant 3 or 4 - flip sign
-			 {
-			 angle = -angle;
-			 }
-
-			 */
-			angle = atan2f(y, x);
-
-			// we now have our audio in "angle"
-			squelch_buf[i] = angle;	// save audio in "d" buffer for squelch noise filtering/detection - done later
-
-			// Now do integrating low-pass filter to do FM de-emphasis
-			a = lpf_prev + (FM_RX_LPF_ALPHA * (angle - lpf_prev));	//
-			lpf_prev = a;			// save "[n-1]" sample for next iteration
-
-			goertzel_buf[i] = a;	// save in "c" for subaudible tone detection
-
-			if (((!ads.fm_squelched) && (!tone_det_enabled))
-					|| ((ads.fm_subaudible_tone_detected) && (tone_det_enabled))
-					|| ((!ts.fm_sql_threshold)))// high-pass audio only if we are un-squelched (to save processor time)
-			{
+			const float32_t y = (adb.i_buffer[i-1] * adb.q_buffer[i]) - (adb.i_buffer[i] * adb.q_buffer[i-1]);
+			const float32_t x = (adb.i_buffer[i-1] * adb.i_buffer[i]) + (adb.q_buffer[i] * adb.q_buffer[i-1]);
 
-				// Do differentiating high-pass filter to attenuate very low frequency audio components, namely subadible tones and other "speaker-rattling" components - and to remove any DC that might be present.
-				b = FM_RX_HPF_ALPHA * (hpf_prev_b + a - hpf_prev_a);// do differentiation
-				hpf_prev_a = a;		// save "[n-1]" samples for next iteration
-				hpf_prev_b = b;
-				//
-				adb.a_buffer[0][i] = b;// save demodulated and filtered audio in main audio processing buffer
-			}
-			else if ((ads.fm_squelched)
-					|| ((!ads.fm_subaudible_tone_detected) && (tone_det_enabled)))// were we squelched or tone NOT detected?
-			{
-				adb.a_buffer[0][i] = 0;// do not filter receive audio - fill buffer with zeroes to mute it
-			}
+			// we now have our audio in "angle", saved in the squelch buffer for squelch noise filtering/detection - done later
+			squelch_buf[i] = AudioDriver_FastAtan2(y, x);
+		}
+		q_prev = adb.q_buffer[blockSize-1];// save "previous" value of each channel to allow detection of the change of angle in next go-around
+		i_prev = adb.i_buffer[blockSize-1];
+
+		// Now do integrating low-pass filter to do FM de-emphasis, result is also used for subaudible tone detection
+		arm_biquad_cascade_df1_f32(&IIR_FM_Deemphasis, squelch_buf, goertzel_buf, blockSize);
 
-			q_prev = adb.q_buffer[i];// save "previous" value of each channel to allow detection of the change of angle in next go-around
-			i_prev = adb.i_buffer[i];
+		if (((!ads.fm_squelched) && (!tone_det_enabled))
+				|| ((ads.fm_subaudible_tone_detected) && (tone_det_enabled))
+				|| ((!ts.fm_sql_threshold)))// high-pass audio only if we are un-squelched (to save processor time)
+		{
+			// Do differentiating high-pass filter to attenuate very low frequency audio components, namely subadible tones and other "speaker-rattling" components - and to remove any DC that might be present.
+			arm_biquad_cascade_df1_f32(&IIR_FM_HPF, goertzel_buf, adb.a_buffer[0], blockSize);
 		}
-#if 0
-		if (!ts.agc_wdsp)
+		else	// we are squelched or tone NOT detected
 		{
-			//
-			ads.am_fm_agc = sqrtf(
-					(q_prev * q_prev) + (i_prev * i_prev)) * FM_AGC_SCALING;// calculate amplitude of carrier to use for AGC indication only (we need it for nothing else!)
-			//
-			// Do "AGC" on FM signal:  Calculate/smooth signal level ONLY - no need for audio scaling
-			//
-			ads.agc_calc = ads.am_fm_agc * ads.agc_val;
-			//
-			if (ads.agc_calc < ads.agc_knee)// is audio below AGC "knee" value?
-			{
-				ads.agc_var = ads.agc_knee - ads.agc_calc;// calculate difference between agc value and "knee" value
-				ads.agc_var /= ads.agc_knee;// calculate ratio of difference between knee value and this value
-				ads.agc_val += ads.agc_val * AGC_DECAY_FM * ads.agc_var;// Yes - Increase gain for AGC DECAY (always fast in FM)
-			}
-			else
-			{
-				ads.agc_var = ads.agc_calc - ads.agc_knee;// calculate difference between agc value and "knee" value
-				ads.agc_var /= ads.agc_knee;// calculate ratio of difference between knee value and this value
-				ads.agc_val -= ads.agc_val * AGC_ATTACK_FM * ads.agc_var;// Fast attack to increase attenuation (do NOT scale w/decimation or else oscillation results)
-				if (ads.agc_val <= AGC_VAL_MIN)	// Prevent zero or "negative" gain values
-				{
-					ads.agc_val = AGC_VAL_MIN;
-				}
-			}
-			if (ads.agc_val >= ads.agc_rf_gain)	// limit AGC to reasonable values when low/no signals present
-			{
-				ads.agc_val = ads.agc_rf_gain;
-				if (ads.agc_val >= ads.agc_val_max)	// limit maximum gain under no-signal conditions
-				{
-					ads.agc_val = ads.agc_val_max;
-				}
-			}
+			arm_fill_f32(0, adb.a_buffer[0], blockSize);// do not filter receive audio - fill buffer with zeroes to mute it
 		}
-#endif
 
 		// *** Squelch Processing ***
 		arm_iir_lattice_f32(&IIR_Squelch_HPF, squelch_buf, squelch_buf,
@@ -2871,18 +3230,22 @@ static void AudioDriver_DemodFM(const int16_t blockSize)
 			//
 			gcount++;// this counter is used for the accumulation of data over multiple cycles
 			//
-			for (uint16_t i = 0; i < blockSize; i++)
+			// the tones are below 300 Hz, so the detectors run on decimated data. The boxcar average used as decimation
+			// filter has its zeros right on the frequencies which would alias into the tone range
+			for (uint16_t i = 0; i < blockSize; i += FM_GOERTZEL_DECIMATION)
 			{
+				float32_t decimated;
+				arm_mean_f32(&goertzel_buf[i], FM_GOERTZEL_DECIMATION, &decimated);
 
 				// Detect above target frequency
-				AudioFilter_GoertzelInput(&ads.fm_goertzel[FM_HIGH],goertzel_buf[i]);
+				AudioFilter_GoertzelInput(&ads.fm_goertzel[FM_HIGH],decimated);
 				// Detect energy below target frequency
-				AudioFilter_GoertzelInput(&ads.fm_goertzel[FM_LOW],goertzel_buf[i]);
+				AudioFilter_GoertzelInput(&ads.fm_goertzel[FM_LOW],decimated);
 				// Detect on-frequency energy
-				AudioFilter_GoertzelInput(&ads.fm_goertzel[FM_CTR],goertzel_buf[i]);
+				AudioFilter_GoertzelInput(&ads.fm_goertzel[FM_CTR],decimated);
 			}
 
-			if (gcount >= FM_SUBAUDIBLE_GOERTZEL_WINDOW)// have we accumulated enough samples to do the final energy calculation?
+			if (gcount >= FM_SUBAUDIBLE_GOERTZEL_BLOCKS)// have we accumulated enough samples to do the final energy calculation?
 			{
 				s = AudioFilter_GoertzelEnergy(&ads.fm_goertzel[FM_HIGH]) + AudioFilter_GoertzelEnergy(&ads.fm_goertzel[FM_LOW]);
 				// sum +/- energy levels:
@@ -2926,7 +3289,7 @@ static void AudioDriver_DemodFM(const int16_t blockSize)
 	}
 }
 
-#if defined (OBSOLETE_NR) || defined (USE_LMS_AUTONOTCH)
+#ifdef OBSOLETE_NR
 //
 //
 //*----------------------------------------------------------------------------
@@ -2941,9 +3304,17 @@ static void AudioDriver_NotchFilter(int16_t blockSize, float32_t *notchbuffer)
 {
     static ulong		lms2_inbuf = 0;
     static ulong		lms2_outbuf = 0;
+    // the delay buffer length is set in steps of 8, larger audio blocks need a multiple of their size
+    const ulong			lms2_buflen = ts.dsp_notch_delaybuf_len - ts.dsp_notch_delaybuf_len % blockSize;
 
     // DSP Automatic Notch Filter using LMS (Least Mean Squared) algorithm
     //
+    if (lms2_inbuf >= lms2_buflen || lms2_outbuf >= lms2_buflen)
+    {
+        // buffer length was changed
+        lms2_inbuf = 0;
+        lms2_outbuf = blockSize;
+    }
     arm_copy_f32(notchbuffer, &lmsData.lms2_nr_delay[lms2_inbuf], blockSize);	// put new data into the delay buffer
     //
     arm_lms_norm_f32(&lmsData.lms2Norm_instance, notchbuffer, &lmsData.lms2_nr_delay[lms2_outbuf], lmsData.errsig2, notchbuffer, blockSize);	// do automatic notch
@@ -2951,8 +3322,8 @@ static void AudioDriver_NotchFilter(int16_t blockSize, float32_t *notchbuffer)
     //
     lms2_inbuf += blockSize;				// update circular de-correlation delay buffer
     lms2_outbuf = lms2_inbuf + blockSize;
-    lms2_inbuf %= ts.dsp_notch_delaybuf_len;
-    lms2_outbuf %= ts.dsp_notch_delaybuf_len;
+    lms2_inbuf %= lms2_buflen;
+    lms2_outbuf %= lms2_buflen;
     //
 }
 #endif
@@ -3035,31 +3406,6 @@ static void AudioDriver_IQPhaseAdjust(uint16_t txrx_mode, float32_t* i_buffer, f
 }
 
 
-void AudioDriver_SpectrumNoZoomProcessSamples(const uint16_t blockSize)
-{
-
-    if(sd.reading_ringbuffer == false && sd.fft_iq_len > 0)
-    {
-        if(sd.magnify == 0)        //
-        {
-            for(int i = 0; i < blockSize; i++)
-            {
-                // Collect I/Q samples // why are the I & Q buffers filled with I & Q, the FFT buffers are filled with Q & I?
-                sd.FFT_RingBuffer[sd.samp_ptr] = adb.q_buffer[i];    // get floating point data for FFT for spectrum scope/waterfall display
-                sd.samp_ptr++;
-                sd.FFT_RingBuffer[sd.samp_ptr] = adb.i_buffer[i];
-                sd.samp_ptr++;
-
-                // On obtaining enough samples for spectrum scope/waterfall, update state machine, reset pointer and wait until we process what we have
-                if(sd.samp_ptr >= sd.fft_iq_len-1) //*2)
-                {
-                    sd.samp_ptr = 0;
-                }
-            }
-            sd.FFT_frequency = (ts.tune_freq); // spectrum shows all, LO is center frequency;
-        }
-    }
-}
 void AudioDriver_SpectrumZoomProcessSamples(const uint16_t blockSize)
 {
     if(sd.reading_ringbuffer == false && sd.fft_iq_len > 0)
@@ -3118,7 +3464,7 @@ void AudioDriver_SpectrumZoomProcessSamples(const uint16_t blockSize)
                     sd.samp_ptr = 0;
                 }
             } // end for
-            sd.FFT_frequency = (ts.tune_freq) + AudioDriver_GetTranslateFreq(); // spectrum shows center at translate frequency, LO + Translate Freq  is center frequency;
+            sd.FFT_frequency = (ts.tune_freq - ts.rx_nco_offset) + AudioDriver_GetTranslateFreq(); // spectrum shows center at translate frequency, LO + Translate Freq  is center frequency;
 
 
             // TODO: also insert sample collection for snap carrier here
@@ -3160,53 +3506,361 @@ bool AudioDriver_RxProcessorDigital(AudioSample_t * const src, float32_t * const
 #endif
 
 
-static float32_t AudioDriver_FadeLeveler(int chan, float32_t audio, float32_t corr)
+// "fade leveler", taken from Warren Pratts WDSP / HPSDR, 2016
+// http://svn.tapr.org/repos_sdr_hpsdr/trunk/W5WC/PowerSDR_HPSDR_mRX_PS/Source/wdsp/
+// replaces the dc part of the audio by the (slowly averaged) carrier level corr, corr == NULL means no carrier
+static void AudioDriver_FadeLeveler(int chan, float32_t* audio, const float32_t* corr, int16_t blockSize)
 {
     assert (chan < NUM_AUDIO_CHANNELS);
 
     static float32_t dc27[NUM_AUDIO_CHANNELS]; // static will be initialized with 0
     static float32_t dc_insert[NUM_AUDIO_CHANNELS];
 
-    dc27[chan] = adb.mtauR * dc27[chan] + adb.onem_mtauR * audio;
-    dc_insert[chan] = adb.mtauI * dc_insert[chan] + adb.onem_mtauI * corr;
-    audio = audio + dc_insert[chan] - dc27[chan];
+    float32_t dc = dc27[chan];
+    float32_t dc_ins = dc_insert[chan];
+
+    for (int i = 0; i < blockSize; i++)
+    {
+        dc = adb.mtauR * dc + adb.onem_mtauR * audio[i];
+        dc_ins = adb.mtauI * dc_ins + (corr != NULL ? adb.onem_mtauI * corr[i] : 0);
+        audio[i] = audio[i] + dc_ins - dc;
+    }
+
+    dc27[chan] = dc;
+    dc_insert[chan] = dc_ins;
+}
+
+/**
+ * rotates the SAM PLL oscillator phasor by the angle delta (rad), this replaces sin/cos of the accumulated phase
+ * sine and cosine of delta / 2 are taken from their Taylor series and then doubled, the error stays
+ * below 1e-4 rad up to the largest PLL locking range (|delta| < 4.2) and is corrected by the PLL itself
+ */
+static inline void AudioDriver_SamRotateOscillator(float32_t* Cos, float32_t* Sin, const float32_t delta)
+{
+    const float32_t h = 0.5f * delta;
+    const float32_t h2 = h * h;
+    const float32_t sin_h = h * (1.0f + h2 * (-1.0f/6.0f + h2 * (1.0f/120.0f + h2 * (-1.0f/5040.0f + h2 * (1.0f/362880.0f)))));
+    const float32_t cos_h = 1.0f + h2 * (-1.0f/2.0f + h2 * (1.0f/24.0f + h2 * (-1.0f/720.0f + h2 * (1.0f/40320.0f))));
+    const float32_t rot_cos = cos_h * cos_h - sin_h * sin_h;
+    const float32_t rot_sin = 2.0f * sin_h * cos_h;
+
+    const float32_t c = *Cos * rot_cos - *Sin * rot_sin;
+    const float32_t s = *Sin * rot_cos + *Cos * rot_sin;
+
+    // one newton step keeps the amplitude of the phasor at 1.0
+    const float32_t gain = 1.5f - 0.5f * (c * c + s * s);
+    *Cos = c * gain;
+    *Sin = s * gain;
+}
+
+/**
+ * runs a block through one of the SAM Hilbert allpass chains, in place
+ * each stage y[n] = c * (x[n] - y[n-2]) + x[n-2] is a biquad {c, 0, 1, 0, -c}, only the non zero terms
+ * are calculated. The block is processed stage by stage with the state kept in registers, two samples
+ * per loop so that the n-1 / n-2 state does not need to be shifted. blockSize has to be even.
+ */
+static void AudioDriver_SamAllpassChain(const float32_t* coeffs, float32_t* state, float32_t* buffer, int16_t blockSize)
+{
+    for (int j = 0; j < SAM_PLL_HILBERT_STAGES; j++)
+    {
+        const float32_t c = coeffs[j];
+        float32_t* stage = &state[4 * j];
+        float32_t x1 = stage[0], x2 = stage[1], y1 = stage[2], y2 = stage[3];
+
+        for (int i = 0; i < blockSize; i += 2)
+        {
+            const float32_t x0a = buffer[i];
+            const float32_t x0b = buffer[i + 1];
+            const float32_t y0a = c * (x0a - y2) + x2;
+            const float32_t y0b = c * (x0b - y1) + x1;
+            buffer[i] = y0a;
+            buffer[i + 1] = y0b;
+            x2 = x0a;
+            y2 = y0a;
+            x1 = x0b;
+            y1 = y0b;
+        }
+
+        stage[0] = x1;
+        stage[1] = x2;
+        stage[2] = y1;
+        stage[3] = y2;
+    }
+}
+
+/**
+ * @brief gain of the new filter path during a filter path change
+ * @param pos samples since the change
+ */
+static float32_t AudioDriver_RxFilterPathGain(const uint16_t pos)
+{
+    float32_t gain = 0;
+
+    if (pos >= RX_FILTER_WARMUP_LEN + RX_FILTER_XFADE_LEN)
+    {
+        gain = 1;
+    }
+    else if (pos > RX_FILTER_WARMUP_LEN)
+    {
+        // raised cosine from 0 to 1
+        gain = 0.5 - 0.5 * arm_cos_f32(PI * (pos - RX_FILTER_WARMUP_LEN) / RX_FILTER_XFADE_LEN);
+    }
+    return gain;
+}
+
+/**
+ * @brief lets the new filter path continue where the old one stopped for all filters whose coefficients did not change
+ *
+ * The states are copied, afterwards these filters of the old and the new filter path would deliver identical results,
+ * so the RX processor runs these stages only once.
+ */
+static void AudioDriver_RxFilterPathTakeOver(RxFilterPath_t* path, RxFilterPath_t* old)
+{
+    const FilterPathDescriptor* fp = &FilterPathInfo[path->filter_path];
+    const FilterPathDescriptor* fp_old = &FilterPathInfo[old->filter_path];
+    bool iq_shared = false;
+    bool dec_shared = false;
+
+    rxf_fade.shared = 0;
+
+    if (fp->FIR_I_coeff_file == fp_old->FIR_I_coeff_file && fp->FIR_Q_coeff_file == fp_old->FIR_Q_coeff_file && fp->FIR_numTaps == fp_old->FIR_numTaps)
+    {
+        // the same number of taps for the Hilbert transform and the AM/SAM IQ decimation
+        if (path->hilbert_i.numTaps > 0)
+        {
+            arm_copy_f32(old->iq_state_i, path->iq_state_i, path->hilbert_i.numTaps - 1);
+            arm_copy_f32(old->iq_state_q, path->iq_state_q, path->hilbert_q.numTaps - 1);
+        }
+        iq_shared = true;
+    }
+
+    if (path->dec_i.pCoeffs == old->dec_i.pCoeffs && path->dec_i.numTaps == old->dec_i.numTaps)
+    {
+        if (path->dec_i.numTaps > 0)
+        {
+            arm_copy_f32(old->dec_state_i, path->dec_state_i, path->dec_i.numTaps - 1);
+            arm_copy_f32(old->dec_state_q, path->dec_state_q, path->dec_q.numTaps - 1);
+        }
+        dec_shared = true;
+    }
+
+    if (iq_shared && (dec_shared || path->decimated_iq == false))
+    {
+        rxf_fade.shared |= 1 << RX_FILTER_STAGE_IQ;
+    }
+    if (dec_shared)
+    {
+        rxf_fade.shared |= 1 << RX_FILTER_STAGE_DECIMATE;
+    }
+
+    // same filter at the same sample rate, the decimation rate of both filter paths is the same
+    if (fp->pre_instance == fp_old->pre_instance)
+    {
+        for (int chan = 0; chan < NUM_AUDIO_CHANNELS; chan++)
+        {
+            arm_copy_f32(old->pre_state[chan], path->pre_state[chan], RX_IIR_STATE_LEN(&path->pre[chan]));
+        }
+        rxf_fade.shared |= 1 << RX_FILTER_STAGE_PRE;
+    }
+
+    if (path->interp[0].pCoeffs == old->interp[0].pCoeffs && path->interp[0].phaseLength == old->interp[0].phaseLength)
+    {
+        for (int chan = 0; chan < NUM_AUDIO_CHANNELS; chan++)
+        {
+            if (path->interp[chan].phaseLength > 0)
+            {
+                arm_copy_f32(old->interp_state[chan], path->interp_state[chan], path->interp[chan].phaseLength - 1);
+            }
+        }
+        rxf_fade.shared |= 1 << RX_FILTER_STAGE_INTERPOLATE;
+    }
+}
+
+/**
+ * @brief called by the RX processor at the start of each block, activates a filter path handed over
+ * by AudioDriver_RxFilterPathChange() and advances a running crossfade
+ */
+static void AudioDriver_RxFilterPathUpdate(const uint16_t blockSize)
+{
+    if (rxf_fade.old != NULL && rxf_fade.pos >= RX_FILTER_WARMUP_LEN + RX_FILTER_XFADE_LEN)
+    {
+        // crossfade is complete, the old filter path is no longer used
+        rxf_fade.old = NULL;
+    }
+
+    if (rxf_fade.old == NULL && rxf_next != NULL)
+    {
+        AudioDriver_RxFilterPathTakeOver(rxf_next, rxf);
+        rxf_fade.old = rxf;
+        rxf = rxf_next;
+        rxf_next = NULL;
+        rxf_fade.pos = 0;
+#ifdef USE_CONVOLUTION
+        if (rxf->use_conv)
+        {
+            // both convolution filters work on the same input history, the new one is settled at once
+            AudioConv_Activate();
+            rxf_fade.old = NULL;
+        }
+#endif
+        // the noise reduction may change its sample rate with the filter width, the decimation starts
+        // from scratch as after a full reconfiguration
+        AudioDriver_SetupNrDecimation();
+    }
+
+    if (rxf_fade.old != NULL)
+    {
+        rxf_fade.gain_start = AudioDriver_RxFilterPathGain(rxf_fade.pos);
+        rxf_fade.pos += blockSize;
+        rxf_fade.gain_end = AudioDriver_RxFilterPathGain(rxf_fade.pos);
+    }
+}
 
-    return audio;
+/**
+ * @brief mixes the output of the old filter path into the output of the new one
+ *
+ * The gain of the new filters ramps from rxf_fade.gain_start to rxf_fade.gain_end within the block.
+ *
+ * @param buffer output of the new filters, on return the mixed output
+ * @param old_buffer output of the old filters
+ * @param len number of samples
+ */
+static void AudioDriver_RxFilterPathCrossfade(float32_t* buffer, float32_t* old_buffer, const uint16_t len)
+{
+    if (rxf_fade.gain_end == 0)
+    {
+        // the new filters are still settling
+        arm_copy_f32(old_buffer, buffer, len);
+    }
+    else
+    {
+        const float32_t gain_step = (rxf_fade.gain_end - rxf_fade.gain_start) / len;
+        float32_t gain = rxf_fade.gain_start;
+
+        for (uint16_t idx = 0; idx < len; idx++)
+        {
+            gain += gain_step;
+            buffer[idx] = old_buffer[idx] + gain * (buffer[idx] - old_buffer[idx]);
+        }
+    }
+}
+
+typedef void (*RxFilterStage_t)(RxFilterPath_t* path, int chan, float32_t* in, float32_t* out, uint16_t len);
+typedef void (*RxFilterStageIQ_t)(RxFilterPath_t* path, float32_t* i_buffer, float32_t* q_buffer, uint16_t blockSize);
+
+/**
+ * @brief runs an audio filter stage of the active filter path, during a filter path change also
+ * the one of the old filter path on the same input, and mixes the results
+ *
+ * @param stage the filter function, has to accept in == out and must not modify in otherwise
+ * @param stage_id RX_FILTER_STAGE_...
+ * @param chan audio channel
+ * @param len number of input samples
+ * @param outLen number of output samples
+ */
+static void AudioDriver_RxFilterStage(RxFilterStage_t stage, uint8_t stage_id, int chan, float32_t* in, float32_t* out, uint16_t len, uint16_t outLen)
+{
+    const bool fade = rxf_fade.old != NULL && (rxf_fade.shared & (1 << stage_id)) == 0;
+
+    if (fade)
+    {
+        stage(rxf_fade.old, chan, in, rxf_fade.buffer[0], len);
+    }
+    stage(rxf, chan, in, out, len);
+    if (fade)
+    {
+        AudioDriver_RxFilterPathCrossfade(out, rxf_fade.buffer[0], outLen);
+    }
+}
+
+/**
+ * @brief same as AudioDriver_RxFilterStage() for a filter stage processing I and Q in place
+ */
+static void AudioDriver_RxFilterStageIQ(RxFilterStageIQ_t stage, float32_t* i_buffer, float32_t* q_buffer, uint16_t blockSize, uint16_t outLen)
+{
+    const bool fade = rxf_fade.old != NULL && (rxf_fade.shared & (1 << RX_FILTER_STAGE_IQ)) == 0;
+
+    if (fade)
+    {
+        arm_copy_f32(i_buffer, rxf_fade.buffer[0], blockSize);
+        arm_copy_f32(q_buffer, rxf_fade.buffer[1], blockSize);
+        stage(rxf_fade.old, rxf_fade.buffer[0], rxf_fade.buffer[1], blockSize);
+    }
+    stage(rxf, i_buffer, q_buffer, blockSize);
+    if (fade)
+    {
+        AudioDriver_RxFilterPathCrossfade(i_buffer, rxf_fade.buffer[0], outLen);
+        AudioDriver_RxFilterPathCrossfade(q_buffer, rxf_fade.buffer[1], outLen);
+    }
+}
+
+static void AudioDriver_RxStageDecimate(RxFilterPath_t* path, int chan, float32_t* in, float32_t* out, uint16_t len)
+{
+    arm_fir_decimate_f32(chan == 0 ? &path->dec_i : &path->dec_q, in, out, len);      // LPF built into decimation (Yes, you can decimate-in-place!)
+}
+
+static inline void AudioDriver_RxIir(RxIir_t* iir, float32_t* in, float32_t* out, uint16_t len)
+{
+#ifdef USE_RX_IIR_BIQUAD
+    arm_biquad_cascade_df2T_f32(iir, in, out, len);
+#else
+    arm_iir_lattice_f32(iir, in, out, len);
+#endif
+}
+
+static void AudioDriver_RxStagePreFilter(RxFilterPath_t* path, int chan, float32_t* in, float32_t* out, uint16_t len)
+{
+    if (path->pre[chan].numStages > 0)
+    {
+        AudioDriver_RxIir(&path->pre[chan], in, out, len);
+    }
+    else if (in != out)
+    {
+        arm_copy_f32(in, out, len);
+    }
+}
+
+static void AudioDriver_RxStageInterpolate(RxFilterPath_t* path, int chan, float32_t* in, float32_t* out, uint16_t len)
+{
+    arm_fir_interpolate_f32(&path->interp[chan], in, out, len);
+}
+
+static void AudioDriver_RxStageSamDecimate(RxFilterPath_t* path, float32_t* i_buffer, float32_t* q_buffer, uint16_t blockSize)
+{
+    arm_fir_decimate_f32(&path->sam_dec_i, i_buffer, i_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
+    arm_fir_decimate_f32(&path->sam_dec_q, q_buffer, q_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
 }
 
 //*----------------------------------------------------------------------------
 //* Function Name       : SAM_demodulation [DD4WH, december 2016]
 //* Object              : real synchronous AM demodulation with phase detector and PLL
-//* Object              :
+//* Object              : the PLL runs per decimated sample, the sideband separation
+//* Object              : and the fade leveler are processed blockwise afterwards
 //* Input Parameters    : adb.i_buffer, adb.q_buffer
 //* Output Parameters   : adb.a_buffer[0]
 //* Functions called    :
 //*----------------------------------------------------------------------------
 static void AudioDriver_DemodSAM(int16_t blockSize)
 {
-    //#define STAGES    7
-
     // new synchronous AM PLL & PHASE detector
     // wdsp Warren Pratt, 2016
     //*****************************
 
+    const int16_t blockSizeDecim = blockSize / adb.DF;
+
     // First of all: decimation of I and Q path
-    arm_fir_decimate_f32(&FirDecim_RxSam_I, adb.i_buffer, adb.i_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
-    arm_fir_decimate_f32(&FirDecim_RxSam_Q, adb.q_buffer, adb.q_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
+    AudioDriver_RxFilterStageIQ(AudioDriver_RxStageSamDecimate, adb.i_buffer, adb.q_buffer, blockSize, blockSizeDecim);
 
     switch(ts.dmod_mode)
     {
     case DEMOD_AM:
-        for(int i = 0; i < blockSize / adb.DF; i++)
+        for(int i = 0; i < blockSizeDecim; i++)
         {
-            float32_t audio;
-
-            arm_sqrt_f32 (adb.i_buffer[i] * adb.i_buffer[i] + adb.q_buffer[i] * adb.q_buffer[i], &audio);
-            if(ads.fade_leveler)
-            {
-                audio = AudioDriver_FadeLeveler(0,audio,0);
-            }
-            adb.a_buffer[0][i] = audio;
+            arm_sqrt_f32 (adb.i_buffer[i] * adb.i_buffer[i] + adb.q_buffer[i] * adb.q_buffer[i], &adb.a_buffer[0][i]);
+        }
+        if(ads.fade_leveler)
+        {
+            AudioDriver_FadeLeveler(0, adb.a_buffer[0], NULL, blockSizeDecim);
         }
         break;
 
@@ -3218,142 +3872,111 @@ static void AudioDriver_DemodSAM(int16_t blockSize)
         static float32_t fil_out = 0.0;
         static float32_t lowpass = 0.0;
         static float32_t omega2 = 0.0;
-        static float32_t phs = 0.0;
+        // recursive oscillator, replaces the sin/cos of the accumulated PLL phase
+        static float32_t osc_cos = 1.0;
+        static float32_t osc_sin = 0.0;
+
+        // the mixer outputs, the a and c chain inputs are delayed by one sample,
+        // index 0 holds the last sample of the previous block
+        static float32_t ai[IQ_BLOCK_SIZE + 1];
+        static float32_t bi[IQ_BLOCK_SIZE];
+        static float32_t aq[IQ_BLOCK_SIZE];
+        static float32_t bq[IQ_BLOCK_SIZE + 1];
+        static float32_t corr_i[IQ_BLOCK_SIZE];
 
         // Wheatley 2011 cuteSDR & Warren Pratts WDSP, 2016
-        for(int i = 0; i < blockSize / adb.DF; i++)
+        for(int i = 0; i < blockSizeDecim; i++)
         {   // NCO
+            const float32_t a_i = osc_cos * adb.i_buffer[i];
+            const float32_t b_i = osc_sin * adb.i_buffer[i];
+            const float32_t a_q = osc_cos * adb.q_buffer[i];
+            const float32_t b_q = osc_sin * adb.q_buffer[i];
 
-            float32_t ai, bi, aq, bq;
-            float32_t ai_ps, bi_ps, aq_ps, bq_ps;
-            float32_t Sin, Cos;
+            ai[i + 1] = a_i;
+            bi[i] = b_i;
+            aq[i] = a_q;
+            bq[i + 1] = b_q;
 
-            static float32_t dsI;             // delayed sample, I path
-            static float32_t dsQ;             // delayed sample, Q path
+            const float32_t corr[2] = { a_i + b_q, -b_i + a_q };
+            corr_i[i] = corr[0];
 
+            // determine phase error
+            const float32_t phzerror = AudioDriver_FastAtan2(corr[1], corr[0]);
 
-            sincosf(phs,&Sin,&Cos);
-            ai = Cos * adb.i_buffer[i];
-            bi = Sin * adb.i_buffer[i];
-            aq = Cos * adb.q_buffer[i];
-            bq = Sin * adb.q_buffer[i];
-
-            if (ads.sam_sideband != SAM_SIDEBAND_BOTH)
+            const float32_t del_out = fil_out;
+            // correct frequency 1st step
+            omega2 = omega2 + adb.g2 * phzerror;
+            if (omega2 < adb.omega_min)
             {
-
-#define OUT_IDX   (3 * SAM_PLL_HILBERT_STAGES)
-
-                static float32_t a[3 * SAM_PLL_HILBERT_STAGES + 3];     // Filter a variables
-                static float32_t b[3 * SAM_PLL_HILBERT_STAGES + 3];     // Filter b variables
-                static float32_t c[3 * SAM_PLL_HILBERT_STAGES + 3];     // Filter c variables
-                static float32_t d[3 * SAM_PLL_HILBERT_STAGES + 3];     // Filter d variables
-
-                a[0] = dsI;
-                b[0] = bi;
-                c[0] = dsQ;
-                d[0] = aq;
-                dsI = ai;
-                dsQ = bq;
-
-                for (int j = 0; j < SAM_PLL_HILBERT_STAGES; j++)
-                {
-                    int k = 3 * j;
-                    a[k + 3] = adb.c0[j] * (a[k] - a[k + 5]) + a[k + 2];
-                    b[k + 3] = adb.c1[j] * (b[k] - b[k + 5]) + b[k + 2];
-                    c[k + 3] = adb.c0[j] * (c[k] - c[k + 5]) + c[k + 2];
-                    d[k + 3] = adb.c1[j] * (d[k] - d[k + 5]) + d[k + 2];
-                }
-
-                ai_ps = a[OUT_IDX];
-                bi_ps = b[OUT_IDX];
-                bq_ps = c[OUT_IDX];
-                aq_ps = d[OUT_IDX];
-
-                // make room for next sample
-                for (int j = OUT_IDX + 2; j > 0; j--)
-                {
-                    a[j] = a[j - 1];
-                    b[j] = b[j - 1];
-                    c[j] = c[j - 1];
-                    d[j] = d[j - 1];
-                }
+                omega2 = adb.omega_min;
+            }
+            else if (omega2 > adb.omega_max)
+            {
+                omega2 = adb.omega_max;
             }
+            // correct frequency 2nd step
+            fil_out = adb.g1 * phzerror + omega2;
 
-            float32_t audio[NUM_AUDIO_CHANNELS];
+            AudioDriver_SamRotateOscillator(&osc_cos, &osc_sin, del_out);
+        }
 
-            float32_t corr[2] = { ai + bq, -bi + aq };
+        if (ads.sam_sideband == SAM_SIDEBAND_BOTH)
+        {
+            arm_copy_f32(corr_i, adb.a_buffer[0], blockSizeDecim);
+        }
+        else
+        {
+            // sideband separation, all chains are filtered in place,
+            // afterwards ai holds ai_ps, bi bi_ps, aq aq_ps and bq bq_ps
+            AudioDriver_SamAllpassChain(adb.c0, sam_allpass_state[SAM_ALLPASS_A], ai, blockSizeDecim);
+            AudioDriver_SamAllpassChain(adb.c1, sam_allpass_state[SAM_ALLPASS_B], bi, blockSizeDecim);
+            AudioDriver_SamAllpassChain(adb.c0, sam_allpass_state[SAM_ALLPASS_C], bq, blockSizeDecim);
+            AudioDriver_SamAllpassChain(adb.c1, sam_allpass_state[SAM_ALLPASS_D], aq, blockSizeDecim);
 
             switch(ads.sam_sideband)
             {
-            case SAM_SIDEBAND_BOTH:
-            {
-                audio[0] = corr[0];
-                break;
-            }
             case SAM_SIDEBAND_USB:
             {
-                audio[0] = (ai_ps - bi_ps) + (aq_ps + bq_ps);
+                for (int i = 0; i < blockSizeDecim; i++)
+                {
+                    adb.a_buffer[0][i] = (ai[i] - bi[i]) + (aq[i] + bq[i]);
+                }
                 break;
             }
             case SAM_SIDEBAND_LSB:
             {
-                audio[0] = (ai_ps + bi_ps) - (aq_ps - bq_ps);
+                for (int i = 0; i < blockSizeDecim; i++)
+                {
+                    adb.a_buffer[0][i] = (ai[i] + bi[i]) - (aq[i] - bq[i]);
+                }
                 break;
             }
 #ifdef USE_TWO_CHANNEL_AUDIO
             case SAM_SIDEBAND_STEREO:
             {
-                audio[0] = (ai_ps + bi_ps) - (aq_ps - bq_ps);
-                audio[1] = (ai_ps - bi_ps) + (aq_ps + bq_ps);
-                break;
-            }
-#endif
-
-            }
-
-            // "fade leveler", taken from Warren Pratts WDSP / HPSDR, 2016
-            // http://svn.tapr.org/repos_sdr_hpsdr/trunk/W5WC/PowerSDR_HPSDR_mRX_PS/Source/wdsp/
-            if(ads.fade_leveler)
-            {
-                for (int chan = 0; chan < NUM_AUDIO_CHANNELS; chan++)
+                for (int i = 0; i < blockSizeDecim; i++)
                 {
-                    audio[chan] = AudioDriver_FadeLeveler(chan, audio[chan], corr[0]);
+                    adb.a_buffer[0][i] = (ai[i] + bi[i]) - (aq[i] - bq[i]);
+                    adb.a_buffer[1][i] = (ai[i] - bi[i]) + (aq[i] + bq[i]);
                 }
+                break;
             }
-
- /*
-            a->dc = a->mtauR * a->dc + a->onem_mtauR * audio;
-            							a->dc_insert = a->mtauI * a->dc_insert + a->onem_mtauI * corr[0];
-            audio += a->dc_insert - a->dc;
-   */
-
-            for (int chan = 0; chan < NUM_AUDIO_CHANNELS; chan++)
-            {
-                adb.a_buffer[chan][i] = audio[chan];
+#endif
             }
+        }
 
-            // determine phase error
-            float32_t phzerror = atan2f(corr[1], corr[0]);
+        // the last mixer outputs of this block are the delayed chain inputs of the next one
+        ai[0] = ai[blockSizeDecim];
+        bq[0] = bq[blockSizeDecim];
 
-            float32_t del_out = fil_out;
-            // correct frequency 1st step
-            omega2 = omega2 + adb.g2 * phzerror;
-            if (omega2 < adb.omega_min)
-            {
-                omega2 = adb.omega_min;
-            }
-            else if (omega2 > adb.omega_max)
+        if(ads.fade_leveler)
+        {
+            for (int chan = 0; chan < NUM_AUDIO_CHANNELS; chan++)
             {
-                omega2 = adb.omega_max;
+                AudioDriver_FadeLeveler(chan, adb.a_buffer[chan], corr_i, blockSizeDecim);
             }
-            // correct frequency 2nd step
-            fil_out = adb.g1 * phzerror + omega2;
-            phs = phs + del_out;
-
-            // wrap round 2PI, modulus
-            while (phs >= 2.0 * PI) phs -= (2.0 * PI);
-            while (phs < 0.0) phs += (2.0 * PI);
         }
+
         count++;
         if(count > 50) // to display the exact carrier frequency that the PLL is tuned to
             // in the small frequency display
@@ -3378,24 +4001,18 @@ float32_t sign_new (float32_t x) {
 
 
 
-void AudioDriver_RxHandleIqCorrection(const uint16_t blockSize)
+/**
+ * @brief Updates the coefficients adb.M_c1 and adb.M_c2 of the automatic IQ imbalance correction
+ * The correction of a block uses the coefficients derived from this very block,
+ * so this has to run before the block is processed by AudioDriver_RxFrontEnd
+ */
+static void AudioDriver_RxIqAutoCorrectionEstimate(AudioSample_t * const src, const uint16_t blockSize)
 {
 
     static uint8_t  IQ_auto_counter = 0;
     static ulong    twinpeaks_counter = 0;
     static uint8_t  codec_restarts = 0;
 
-    if(!ts.iq_auto_correction) // Manual IQ imbalance correction
-    {
-        // Apply I/Q amplitude correction
-        arm_scale_f32(adb.i_buffer, ts.rx_adj_gain_var.i, adb.i_buffer, blockSize);
-        arm_scale_f32(adb.q_buffer, ts.rx_adj_gain_var.q, adb.q_buffer, blockSize); // TODO: we need only scale one channel! DD4WH, Dec 2016
-
-        // Apply I/Q phase correction
-        AudioDriver_IQPhaseAdjust(ts.txrx_mode,adb.i_buffer, adb.q_buffer,blockSize);
-    }
-
-    else // Automatic IQ imbalance correction
     {   // Moseley, N.A. & C.H. Slump (2006): A low-complexity feed-forward I/Q imbalance compensation algorithm.
         // in 17th Annual Workshop on Circuits, Nov. 2006, pp. 158-164.
         // http://doc.utwente.nl/66726/1/moseley.pdf
@@ -3403,16 +4020,18 @@ void AudioDriver_RxHandleIqCorrection(const uint16_t blockSize)
         {
             twinpeaks_counter++;
         }
-        if(twinpeaks_counter > 1000) // wait 0.667ms for the system to settle: with 32 IQ samples per block and 48ksps (0.66667ms/block)
+        if(twinpeaks_counter > 1000/AUDIO_TICKS_PER_BLOCK) // wait 0.667s for the system to settle: 1000 blocks with 32 IQ samples per block and 48ksps (0.66667ms/block)
         {
             ts.twinpeaks_tested = 0;
             twinpeaks_counter = 0;
         }
         for(uint32_t i = 0; i < blockSize; i++)
         {
-            adb.teta1 += sign_new(adb.i_buffer[i]) * adb.q_buffer[i]; // eq (34)
-            adb.teta2 += sign_new(adb.i_buffer[i]) * adb.i_buffer[i]; // eq (35)
-            adb.teta3 += sign_new(adb.q_buffer[i]) * adb.q_buffer[i]; // eq (36)
+            const float32_t i_val = src[i].l;
+            const float32_t q_val = src[i].r;
+            adb.teta1 += sign_new(i_val) * q_val; // eq (34)
+            adb.teta2 += sign_new(i_val) * i_val; // eq (35)
+            adb.teta3 += sign_new(q_val) * q_val; // eq (36)
             IQ_auto_counter++;
         }
         if(IQ_auto_counter >= 8)
@@ -3486,81 +4105,243 @@ void AudioDriver_RxHandleIqCorrection(const uint16_t blockSize)
             adb.teta3 = 0.0;
             IQ_auto_counter = 0;
         }
+    }
+
+}
+
+/**
+ * @brief Sets the frequency of the RX NCO, the phase is kept so that retuning is click free
+ * @param freq conversion frequency in Hz, positive frequencies move the signals up
+ * @param restart true if the NCO was not used for the last block, the fixed conversion oscillators start each block at phase 0, so does the NCO
+ */
+static void AudioDriver_RxNcoPrepare(const int32_t freq, const bool restart)
+{
+    if (restart)
+    {
+        rx_nco.acc = 0;
+    }
+    if (freq != rx_nco_freq)
+    {
+        softdds_setFreqDDS(&rx_nco, freq, IQ_SAMPLE_RATE, true);
+        rx_nco_freq = freq;
+    }
+}
+
+/**
+ * @brief IQ imbalance correction of a single sample
+ * @param auto_iq true: automatic correction using adb.M_c1/M_c2 in c1/c2, false: manual correction using gain_i, gain_q and phase
+ */
+static inline __attribute__ ((always_inline)) void AudioDriver_RxFrontEndCorrect(float32_t* i_val, float32_t* q_val, const bool auto_iq,
+        const float32_t gain_i, const float32_t gain_q, const float32_t phase, const float32_t c1, const float32_t c2)
+{
+    if (auto_iq)
+    {
         // first correct Q and then correct I --> this order is crucially important!
-        for(uint32_t i = 0; i < blockSize; i++)
-        {   // see fig. 5
-            adb.q_buffer[i] += adb.M_c1 * adb.i_buffer[i];
-        }
         // see fig. 5
-        arm_scale_f32 (adb.i_buffer, adb.M_c2, adb.i_buffer, blockSize);
+        *q_val += c1 * *i_val;
+        *i_val *= c2;
     }
+    else
+    {
+        // Apply I/Q amplitude correction
+        *i_val *= gain_i;
+        *q_val *= gain_q;
 
+        // Apply I/Q phase correction, same as AudioDriver_IQPhaseAdjust()
+        if (phase < 0)   // we only need to deal with I and put a little bit of it into Q
+        {
+            *q_val += *i_val * phase;
+        }
+        else if (phase > 0)  // we only need to deal with Q and put a little bit of it into I
+        {
+            *i_val += *q_val * phase;
+        }
+    }
 }
 
+// pseudo conversion mode for AudioDriver_RxFrontEndKernel, conversion by AudioDriver_GetRxShiftFreq() using rx_nco
+#define RX_FRONT_END_NCO 0xFF
 
-#ifdef USE_LEAKY_LMS
-
-// Automatic noise reduction
-// Variable-leak LMS algorithm
-// taken from (c) Warren Pratts wdsp library 2016
-// GPLv3 licensed
-void AudioDriver_LeakyLmsNr (float32_t *in_buff, float32_t *out_buff, int buff_size, bool notch)
+/**
+ * @brief The RX front end for a given frequency conversion mode, see AudioDriver_RxFrontEnd
+ * Always inlined with a constant iq_freq_mode, so that each conversion mode gets its own loop.
+ * Works on 4 samples per iteration since the Fs/4 conversion repeats every 4 samples.
+ */
+static inline __attribute__ ((always_inline)) void AudioDriver_RxFrontEndKernel(AudioSample_t * const src, const uint16_t blockSize, const uint8_t iq_freq_mode)
 {
-    int i, j, idx;
-    float32_t c0, c1;
-    float32_t y, error, sigma, inv_sigp;
-    float32_t nel, nev;
-		for (i = 0; i < buff_size; i++)
-		{
-			leakyLMS.d[leakyLMS.in_idx] = in_buff[i];
+    // local copies, they can stay in registers during the loop
+    const bool auto_iq = ts.iq_auto_correction;
+    const float32_t gain_i = ts.rx_adj_gain_var.i;
+    const float32_t gain_q = ts.rx_adj_gain_var.q;
+    const float32_t phase = ads.iq_phase_balance_rx;
+    const float32_t c1 = adb.M_c1;
+    const float32_t c2 = adb.M_c2;
 
-			y = 0;
-			sigma = 0;
+    // spectrum display sample collect for magnify == 0, zoom is handled after the front end
+    const bool capture = sd.reading_ringbuffer == false && sd.fft_iq_len > 0 && sd.magnify == 0;
+    ulong samp_ptr = sd.samp_ptr;
 
-			for (j = 0; j < leakyLMS.n_taps; j++)
-			{
-				idx = (leakyLMS.in_idx + j + leakyLMS.delay) & leakyLMS.mask;
-				y += leakyLMS.w[j] * leakyLMS.d[idx];
-				sigma += leakyLMS.d[idx] * leakyLMS.d[idx];
-			}
-			inv_sigp = 1.0 / (sigma + 1e-10);
-			error = leakyLMS.d[leakyLMS.in_idx] - y;
+    int16_t max_l = INT16_MIN;
 
-			if(notch)
-			{ // automatic notch filter
-				out_buff[i] = error;
-			}
-			else
-			{ // noise reduction
-				out_buff[i] = y;
-			}
-//			leakyLMS.out_buff[2 * i + 1] = 0.0;
+    for (uint16_t n = 0; n < blockSize; n += 4)
+    {
+        float32_t i_val[4], q_val[4];
 
-			if((nel = error * (1.0 - leakyLMS.two_mu * sigma * inv_sigp)) < 0.0) nel = -nel;
-			if((nev = leakyLMS.d[leakyLMS.in_idx] - (1.0 - leakyLMS.two_mu * leakyLMS.ngamma) * y - leakyLMS.two_mu * error * sigma * inv_sigp) < 0.0) nev = -nev;
-			if (nev < nel)
-			{
-				if((leakyLMS.lidx += leakyLMS.lincr) > leakyLMS.lidx_max) leakyLMS.lidx = leakyLMS.lidx_max;
-			}
-			else
-			{
-				if((leakyLMS.lidx -= leakyLMS.ldecr) < leakyLMS.lidx_min) leakyLMS.lidx = leakyLMS.lidx_min;
-			}
-			leakyLMS.ngamma = leakyLMS.gamma * (leakyLMS.lidx * leakyLMS.lidx) * (leakyLMS.lidx * leakyLMS.lidx) * leakyLMS.den_mult;
+        for (uint16_t k = 0; k < 4; k++)
+        {
+            max_l = src[n+k].l > max_l ? src[n+k].l : max_l;
 
-			c0 = 1.0 - leakyLMS.two_mu * leakyLMS.ngamma;
-			c1 = leakyLMS.two_mu * error * inv_sigp;
+            // Split stereo channels
+            i_val[k] = (float32_t)src[n+k].l;
+            q_val[k] = (float32_t)src[n+k].r;
 
-			for (j = 0; j < leakyLMS.n_taps; j++)
-			{
-				idx = (leakyLMS.in_idx + j + leakyLMS.delay) & leakyLMS.mask;
-				leakyLMS.w[j] = c0 * leakyLMS.w[j] + c1 * leakyLMS.d[idx];
-			}
-			leakyLMS.in_idx = (leakyLMS.in_idx + leakyLMS.mask) & leakyLMS.mask;
-		}
+            AudioDriver_RxFrontEndCorrect(&i_val[k], &q_val[k], auto_iq, gain_i, gain_q, phase, c1, c2);
+
+            if (capture)
+            {
+                // Collect I/Q samples // why are the I & Q buffers filled with I & Q, the FFT buffers are filled with Q & I?
+                sd.FFT_RingBuffer[samp_ptr++] = q_val[k];    // get floating point data for FFT for spectrum scope/waterfall display
+                sd.FFT_RingBuffer[samp_ptr++] = i_val[k];
+
+                // On obtaining enough samples for spectrum scope/waterfall, update state machine, reset pointer and wait until we process what we have
+                if(samp_ptr >= sd.fft_iq_len-1) //*2)
+                {
+                    samp_ptr = 0;
+                }
+            }
+        }
+
+        // frequency conversion, see AudioDriver_FreqConversion for the details
+        switch (iq_freq_mode)
+        {
+        case FREQ_IQ_CONV_P12KHZ:
+            // +Fs/4, multiply by 1, j, -1, -j
+            adb.i_buffer[n + 0] =   i_val[0];
+            adb.q_buffer[n + 0] =   q_val[0];
+            adb.i_buffer[n + 1] = - q_val[1];
+            adb.q_buffer[n + 1] =   i_val[1];
+            adb.i_buffer[n + 2] = - i_val[2];
+            adb.q_buffer[n + 2] = - q_val[2];
+            adb.i_buffer[n + 3] =   q_val[3];
+            adb.q_buffer[n + 3] = - i_val[3];
+            break;
+        case FREQ_IQ_CONV_M12KHZ:
+            // -Fs/4, multiply by 1, -j, -1, j
+            adb.i_buffer[n + 0] =   i_val[0];
+            adb.q_buffer[n + 0] =   q_val[0];
+            adb.i_buffer[n + 1] =   q_val[1];
+            adb.q_buffer[n + 1] = - i_val[1];
+            adb.i_buffer[n + 2] = - i_val[2];
+            adb.q_buffer[n + 2] = - q_val[2];
+            adb.i_buffer[n + 3] = - q_val[3];
+            adb.q_buffer[n + 3] =   i_val[3];
+            break;
+        case FREQ_IQ_CONV_P6KHZ:
+            for (uint16_t k = 0; k < 4; k++)
+            {
+                adb.i_buffer[n + k] = i_val[k] * Osc_Q_buffer[n + k] - q_val[k] * Osc_I_buffer[n + k];
+                adb.q_buffer[n + k] = q_val[k] * Osc_Q_buffer[n + k] + i_val[k] * Osc_I_buffer[n + k];
+            }
+            break;
+        case FREQ_IQ_CONV_M6KHZ:
+            for (uint16_t k = 0; k < 4; k++)
+            {
+                adb.i_buffer[n + k] = i_val[k] * Osc_Q_buffer[n + k] + q_val[k] * Osc_I_buffer[n + k];
+                adb.q_buffer[n + k] = q_val[k] * Osc_Q_buffer[n + k] - i_val[k] * Osc_I_buffer[n + k];
+            }
+            break;
+        case RX_FRONT_END_NCO:
+            for (uint16_t k = 0; k < 4; k++)
+            {
+                float32_t osc_cos, osc_sin;
+                softdds_nextSampleCosSinInterpolated(&rx_nco, &osc_cos, &osc_sin);
+                adb.i_buffer[n + k] = i_val[k] * osc_cos - q_val[k] * osc_sin;
+                adb.q_buffer[n + k] = q_val[k] * osc_cos + i_val[k] * osc_sin;
+            }
+            break;
+        default:
+            for (uint16_t k = 0; k < 4; k++)
+            {
+                adb.i_buffer[n + k] = i_val[k];
+                adb.q_buffer[n + k] = q_val[k];
+            }
+        }
+    }
+
+    if (capture)
+    {
+        sd.samp_ptr = samp_ptr;
+        sd.FFT_frequency = (ts.tune_freq); // spectrum shows all, LO is center frequency;
+    }
+
+    if(max_l > ADC_CLIP_WARN_THRESHOLD/4)            // This is the release threshold for the auto RF gain
+    {
+        ads.adc_quarter_clip = 1;
+        if(max_l > ADC_CLIP_WARN_THRESHOLD/2)            // This is the trigger threshold for the auto RF gain
+        {
+            ads.adc_half_clip = 1;
+            if(max_l > ADC_CLIP_WARN_THRESHOLD)          // This is the threshold for the red clip indicator on S-meter
+            {
+                ads.adc_clip = 1;
+            }
+        }
+    }
+}
+
+/**
+ * @brief RX front end: converts the codec samples into adb.i_buffer/adb.q_buffer and does clip detection,
+ * IQ imbalance correction, spectrum display sample collection (no zoom) and frequency conversion in a single pass.
+ * Produces the same results as running these steps one after the other on the whole block.
+ * If the DSP NCO is tuned (ts.rx_nco_offset != 0), the conversion is done by the interpolating NCO instead
+ * of the fixed oscillators for any frequency inside the IQ bandwidth.
+ * @param src IQ samples from the codec
+ * @param blockSize number of samples, has to be a multiple of 4
+ */
+void AudioDriver_RxFrontEnd(AudioSample_t * const src, const uint16_t blockSize)
+{
+    static bool nco_active = false;
+    const int32_t rx_nco_offset = ts.rx_nco_offset;
+
+    assert(blockSize % 4 == 0);
+
+    if (ts.iq_auto_correction)
+    {
+        AudioDriver_RxIqAutoCorrectionEstimate(src, blockSize);
+    }
+
+    if (ts.iq_freq_mode != FREQ_IQ_CONV_MODE_OFF)
+    {
+        AudioDriver_FreqConversionPrepareOsc(blockSize);
+    }
+
+    if (rx_nco_offset != 0)
+    {
+        AudioDriver_RxNcoPrepare(AudioDriver_GetTranslateFreq() + rx_nco_offset, nco_active == false);
+        AudioDriver_RxFrontEndKernel(src, blockSize, RX_FRONT_END_NCO);
+    }
+    else
+    {
+        switch (ts.iq_freq_mode)
+        {
+        case FREQ_IQ_CONV_P6KHZ:
+            AudioDriver_RxFrontEndKernel(src, blockSize, FREQ_IQ_CONV_P6KHZ);
+            break;
+        case FREQ_IQ_CONV_M6KHZ:
+            AudioDriver_RxFrontEndKernel(src, blockSize, FREQ_IQ_CONV_M6KHZ);
+            break;
+        case FREQ_IQ_CONV_P12KHZ:
+            AudioDriver_RxFrontEndKernel(src, blockSize, FREQ_IQ_CONV_P12KHZ);
+            break;
+        case FREQ_IQ_CONV_M12KHZ:
+            AudioDriver_RxFrontEndKernel(src, blockSize, FREQ_IQ_CONV_M12KHZ);
+            break;
+        default:
+            AudioDriver_RxFrontEndKernel(src, blockSize, FREQ_IQ_CONV_MODE_OFF);
+        }
+    }
+    nco_active = rx_nco_offset != 0;
 }
 
-#endif
 
 void AudioDriver_RxProcessorNoiseReduction(uint16_t blockSizeDecim, float32_t* inout_buffer)
 {
@@ -3584,7 +4365,7 @@ void AudioDriver_RxProcessorNoiseReduction(uint16_t blockSizeDecim, float32_t* i
     // buffer needs max blockSizeDecim , less if second decimation is done
     // see below
 
-    bool doSecondDecimation = ts.NR_decimation_enable && (FilterInfo[FilterPathInfo[ts.filter_path].id].width < 2701) && (dsp_active & DSP_NR_ENABLE);
+    bool doSecondDecimation = AudioDriver_NrDecimation(rxf->filter_path) && (dsp_active & DSP_NR_ENABLE);
 
     if (doSecondDecimation == true)
     {
@@ -3606,7 +4387,7 @@ void AudioDriver_RxProcessorNoiseReduction(uint16_t blockSizeDecim, float32_t* i
     if (trans_count_in >= (NR_FFT_SIZE/2))
         //NR_FFT_SIZE has to be an integer mult. of blockSizeDecim!!!
     {
-        NR_in_buffer_add(&mmb.nr_audio_buff[NR_fill_in_pt]); // save pointer to full buffer
+        NrBufferRing_Put(&NR_in_ring, &mmb.nr_audio_buff[NR_fill_in_pt]); // save pointer to full buffer
         trans_count_in=0;                              // set counter to 0
         NR_fill_in_pt++;                               // increase pointer index
         NR_fill_in_pt %= NR_BUFFER_NUM;            // make sure, that index stays in range
@@ -3616,12 +4397,12 @@ void AudioDriver_RxProcessorNoiseReduction(uint16_t blockSizeDecim, float32_t* i
 
     //**********************************************************************************
     //don't worry!  in the mean time the noise reduction routine is (hopefully) doing it's job within ui
-    //as soon as "fdv_audio_has_data" we can start harvesting the output
+    //as soon as NR_out_ring has data we can start harvesting the output
     //**********************************************************************************
 
-    if (out_buffer == NULL && NR_out_has_data() > 1)
+    if (out_buffer == NULL && NrBufferRing_Fill(&NR_out_ring) > 1)
     {
-        NR_out_buffer_peek(&out_buffer);
+        NrBufferRing_Peek(&NR_out_ring, &out_buffer);
     }
 
     float32_t NR_dec_buffer[no_dec_samples];
@@ -3639,11 +4420,16 @@ void AudioDriver_RxProcessorNoiseReduction(uint16_t blockSizeDecim, float32_t* i
         if (outbuff_count >= (NR_FFT_SIZE/2)) // we reached the end of the buffer coming from NR
         {
             outbuff_count = 0;
-            NR_out_buffer_remove(&out_buffer);
+            NrBufferRing_Get(&NR_out_ring, &out_buffer);
             out_buffer = NULL;
-            NR_out_buffer_peek(&out_buffer);
+            NrBufferRing_Peek(&NR_out_ring, &out_buffer);
         }
     }
+    else
+    {
+        // the noise reduction has not yet delivered the first buffer, so we output silence
+        arm_fill_f32(0, NR_dec_buffer, no_dec_samples);
+    }
 
 
     // interpolation of a_buffer from 6ksps to 12ksps!
@@ -3662,6 +4448,141 @@ void AudioDriver_RxProcessorNoiseReduction(uint16_t blockSizeDecim, float32_t* i
 }
 
 
+/**
+ * @brief decimates the IQ input and applies the +/-45 degree Hilbert filter pair in a single pass
+ *
+ * Does the same as arm_fir_decimate_f32() on I and Q followed by arm_fir_f32() with the Hilbert filters of the
+ * filter path and uses the state buffers of these filter instances, so both ways of processing can be exchanged at any time.
+ * Only the samples which are kept after decimation are calculated, the decimated samples go directly
+ * into the Hilbert filter history and each coefficient is loaded only once for I and Q.
+ * Requires hilbert_mirrored, i.e. the Q coefficients are the I coefficients in reversed order.
+ *
+ * @param path filter path
+ * @param i_buffer I input (blockSize samples), on return I output (blockSize / decimation rate samples)
+ * @param q_buffer Q input (blockSize samples), on return Q output (blockSize / decimation rate samples)
+ * @param blockSize number of input samples
+ */
+static void AudioDriver_RxDecimateHilbert(RxFilterPath_t* path, float32_t* i_buffer, float32_t* q_buffer, const uint16_t blockSize)
+{
+    const uint16_t dec_taps = path->dec_i.numTaps;
+    const uint8_t dec_rate = path->dec_i.M;
+    const float32_t* const dec_coeffs = path->dec_i.pCoeffs;
+    float32_t* const dec_state_i = path->dec_i.pState;
+    float32_t* const dec_state_q = path->dec_q.pState;
+
+    const uint16_t hil_taps = path->hilbert_i.numTaps;
+    const float32_t* const hil_coeffs = path->hilbert_i.pCoeffs;
+    float32_t* const hil_state_i = path->hilbert_i.pState;
+    float32_t* const hil_state_q = path->hilbert_q.pState;
+
+    const uint16_t blockSizeDecim = blockSize / dec_rate;
+
+    // append the new samples to the decimation filter history
+    arm_copy_f32(i_buffer, &dec_state_i[dec_taps - 1], blockSize);
+    arm_copy_f32(q_buffer, &dec_state_q[dec_taps - 1], blockSize);
+
+    for (uint16_t n = 0; n < blockSizeDecim; n++)
+    {
+        // decimation lowpass, I and Q use the same coefficients
+        const float32_t* xi = &dec_state_i[n * dec_rate];
+        const float32_t* xq = &dec_state_q[n * dec_rate];
+        float32_t acc_i = 0;
+        float32_t acc_q = 0;
+
+        for (uint16_t k = 0; k < dec_taps; k++)
+        {
+            const float32_t c = dec_coeffs[k];
+            acc_i += c * xi[k];
+            acc_q += c * xq[k];
+        }
+
+        hil_state_i[hil_taps - 1 + n] = acc_i;
+        hil_state_q[hil_taps - 1 + n] = acc_q;
+
+        // Hilbert pair, the Q filter runs through its history backwards instead of using reversed coefficients
+        const float32_t* yi = &hil_state_i[n];
+        const float32_t* yq = &hil_state_q[n + hil_taps - 1];
+        acc_i = 0;
+        acc_q = 0;
+
+        for (uint16_t k = 0; k < hil_taps; k++)
+        {
+            const float32_t c = hil_coeffs[k];
+            acc_i += c * yi[k];
+            acc_q += c * *yq--;
+        }
+
+        // the input samples are already in the history, so we can write the output in place
+        i_buffer[n] = acc_i;
+        q_buffer[n] = acc_q;
+    }
+
+    // keep the most recent samples for the next block
+    arm_copy_f32(&dec_state_i[blockSize], dec_state_i, dec_taps - 1);
+    arm_copy_f32(&dec_state_q[blockSize], dec_state_q, dec_taps - 1);
+    arm_copy_f32(&hil_state_i[blockSizeDecim], hil_state_i, hil_taps - 1);
+    arm_copy_f32(&hil_state_q[blockSizeDecim], hil_state_q, hil_taps - 1);
+}
+
+/**
+ * @brief Hilbert transform of the IQ signal, preceded by the IQ decimation if the filter path uses it
+ */
+static void AudioDriver_RxStageHilbert(RxFilterPath_t* path, float32_t* i_buffer, float32_t* q_buffer, uint16_t blockSize)
+{
+    if(path->decimated_iq && path->hilbert_mirrored)
+    {
+        // decimation and Hilbert transform in a single pass, accounted as Hilbert
+        profileTimedEventStart(ProfileRxHilbert);
+        AudioDriver_RxDecimateHilbert(path, i_buffer, q_buffer, blockSize);
+        profileTimedEventStop(ProfileRxHilbert);
+    }
+    else
+    {
+        uint16_t blockSizeIQ = blockSize;
+
+        if(path->decimated_iq)
+        {
+            // use an adequate lowpass filter before the decimation
+            profileTimedEventStart(ProfileRxDecimation);
+            arm_fir_decimate_f32(&path->dec_i, i_buffer, i_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
+            arm_fir_decimate_f32(&path->dec_q, q_buffer, q_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
+            profileTimedEventStop(ProfileRxDecimation);
+            blockSizeIQ = blockSize / path->dec_i.M;
+        }
+        // SECOND: Hilbert transform (for SSB/CW)
+        profileTimedEventStart(ProfileRxHilbert);
+        arm_fir_f32(&path->hilbert_i, i_buffer, i_buffer, blockSizeIQ);   // Hilbert lowpass +45 degrees
+        arm_fir_f32(&path->hilbert_q, q_buffer, q_buffer, blockSizeIQ);   // Hilbert lowpass -45 degrees
+        profileTimedEventStop(ProfileRxHilbert);
+    }
+}
+
+#ifdef USE_CONVOLUTION
+/**
+ * @brief decimation, sideband selection and audio bandpass of SSB, CW and digital modes in one filter
+ *
+ * The audio is returned in i_buffer and q_buffer is cleared, so the demodulation passes it unchanged.
+ * Filter paths which change without a full reconfiguration have the same decimation filter
+ * (see AudioDriver_RxFilterPathChange()), the filter is replaced without crossfade.
+ *
+ * @param blockSize number of input samples, i_buffer and q_buffer hold blockSize / decimation rate samples on return
+ */
+static void AudioDriver_RxConvolution(float32_t* i_buffer, float32_t* q_buffer, uint16_t blockSize, bool lsb)
+{
+    const uint16_t blockSizeDecim = blockSize / rxf->dec_i.M;
+
+    profileTimedEventStart(ProfileRxDecimation);
+    arm_fir_decimate_f32(&rxf->dec_i, i_buffer, i_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
+    arm_fir_decimate_f32(&rxf->dec_q, q_buffer, q_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
+    profileTimedEventStop(ProfileRxDecimation);
+
+    profileTimedEventStart(ProfileRxFilter);
+    AudioConv_Process(i_buffer, q_buffer, i_buffer, blockSizeDecim, lsb);
+    arm_fill_f32(0.0, q_buffer, blockSizeDecim);
+    profileTimedEventStop(ProfileRxFilter);
+}
+#endif
+
 //
 //*----------------------------------------------------------------------------
 //* Function Name       : audio_rx_processor
@@ -3683,7 +4604,6 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
     // shaved off a few bytes of code
     const uint8_t dmod_mode = ts.dmod_mode;
     const uint8_t tx_audio_source = ts.tx_audio_source;
-    const uint8_t iq_freq_mode = ts.iq_freq_mode;
     const uint8_t  dsp_active = ts.dsp_active;
 #ifdef USE_TWO_CHANNEL_AUDIO
     const bool use_stereo = ((dmod_mode == DEMOD_IQ || dmod_mode == DEMOD_SSBSTEREO || (dmod_mode == DEMOD_SAM && ads.sam_sideband == SAM_SIDEBAND_STEREO)) && ts.stereo_enable);
@@ -3704,41 +4624,19 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
 
     if (ads.af_disabled == 0 )
     {
-        // AudioDriver_NoiseBlanker(src, blockSize);     // do noise blanker function
-        // ------------------------
-        // Split stereo channels
-        for(uint32_t i = 0; i < blockSize; i++)
-        {
-            if(src[i].l > ADC_CLIP_WARN_THRESHOLD/4)            // This is the release threshold for the auto RF gain
-            {
-                ads.adc_quarter_clip = 1;
-                if(src[i].l > ADC_CLIP_WARN_THRESHOLD/2)            // This is the trigger threshold for the auto RF gain
-                {
-                    ads.adc_half_clip = 1;
-                    if(src[i].l > ADC_CLIP_WARN_THRESHOLD)          // This is the threshold for the red clip indicator on S-meter
-                    {
-                        ads.adc_clip = 1;
-                    }
-                }
-            }
-            adb.i_buffer[i] = (float32_t)src[i].l;
-            adb.q_buffer[i] = (float32_t)src[i].r;
-        }
-
-        // artificial amplitude imbalance for testing of the automatic IQ imbalance correction
-        //    arm_scale_f32 (adb.i_buffer, 0.6, adb.i_buffer, blockSize);
+        // switch to a new filter path at the block boundary
+        AudioDriver_RxFilterPathUpdate(blockSize);
 
+        // ------------------------
+        // Split stereo channels, IQ correction, spectrum display sample collect for magnify == 0
+        // and receive frequency conversion
+        profileTimedEventStart(ProfileRxFrontEnd);
+        AudioDriver_RxFrontEnd(src, blockSize);
+        profileTimedEventStop(ProfileRxFrontEnd);
 
-        AudioDriver_RxHandleIqCorrection(blockSize);
-
-
-        // Spectrum display sample collect for magnify == 0
-        AudioDriver_SpectrumNoZoomProcessSamples(blockSize);
-
-        if(iq_freq_mode)            // is receive frequency conversion to be done?
-        {
-            AudioDriver_FreqConversion(adb.i_buffer, adb.q_buffer, blockSize, iq_freq_mode == FREQ_IQ_CONV_P6KHZ || iq_freq_mode == FREQ_IQ_CONV_P12KHZ);
-        }
+        profileTimedEventStart(ProfileRxNoiseBlanker);
+        AudioDriver_RxNoiseBlanker(blockSize);     // do noise blanker function
+        profileTimedEventStop(ProfileRxNoiseBlanker);
 
         // Spectrum display sample collect for magnify != 0
         AudioDriver_SpectrumZoomProcessSamples(blockSize);
@@ -3756,11 +4654,8 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
 
         if (dvmode_signal == false)
         {
-            const bool use_decimatedIQ =
-                    FilterPathInfo[ts.filter_path].FIR_I_coeff_file == i_rx_new_coeffs // lower than 3k8 bandwidth: new filters with excellent sideband suppression
-                    && dmod_mode != DEMOD_FM
-                    && dmod_mode != DEMOD_SAM
-                    && dmod_mode != DEMOD_AM;
+            // lower than 3k8 bandwidth: new filters with excellent sideband suppression
+            const bool use_decimatedIQ = rxf->decimated_iq;
             volatile const uint16_t blockSizeIQ = use_decimatedIQ? blockSizeDecim: blockSize;
 
             // ------------------------
@@ -3769,6 +4664,14 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
             // which case there is ***NO*** audio phase shift applied to the I/Q channels.
             //
             //
+#ifdef USE_CONVOLUTION
+            if (rxf->use_conv)
+            {
+                const bool lsb = dmod_mode == DEMOD_LSB || (dmod_mode == DEMOD_CW && ts.cw_lsb) || (dmod_mode == DEMOD_DIGI && ts.digi_lsb);
+                AudioDriver_RxConvolution(adb.i_buffer, adb.q_buffer, blockSize, lsb);
+            }
+            else
+#endif
             // we need this "if" although Danilo introduced "use_decimated_IQ"
             if(dmod_mode != DEMOD_SAM && dmod_mode != DEMOD_AM) // for SAM & AM leave out this processor-intense filter
             {
@@ -3784,19 +4687,13 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
 //                }
 //
 
-            	if(use_decimatedIQ)
-                {
-            		// use an adequate lowpass filter before the decimation
-                    arm_fir_decimate_f32(&DECIMATE_RX_I, adb.i_buffer, adb.i_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
-                    arm_fir_decimate_f32(&DECIMATE_RX_Q, adb.q_buffer, adb.q_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
-                }
-            	// SECOND: Hilbert transform (for SSB/CW)
-                arm_fir_f32(&Fir_Rx_Hilbert_I,adb.i_buffer, adb.i_buffer, blockSizeIQ);   // Hilbert lowpass +45 degrees
-                arm_fir_f32(&Fir_Rx_Hilbert_Q,adb.q_buffer, adb.q_buffer, blockSizeIQ);   // Hilbert lowpass -45 degrees
+            	// decimation (if used) and Hilbert transform of the current filter path
+            	AudioDriver_RxFilterStageIQ(AudioDriver_RxStageHilbert, adb.i_buffer, adb.q_buffer, blockSize, blockSizeIQ);
 
 
             }
 
+            profileTimedEventStart(ProfileRxDemod);
             switch(dmod_mode)
             {
             case DEMOD_LSB:
@@ -3854,82 +4751,81 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
                 arm_add_f32(adb.i_buffer, adb.q_buffer, adb.a_buffer[0], blockSizeIQ);   // sum of I and Q - USB
                 break;
             }
+            profileTimedEventStop(ProfileRxDemod);
 
             if(dmod_mode != DEMOD_FM)       // are we NOT in FM mode?  If we are not, do decimation, filtering, DSP notch/noise reduction, etc.
             {
                 // Do decimation down to lower rate to reduce processor load
-                if (    DECIMATE_RX_I.numTaps > 0
+                if (    rxf->dec_i.numTaps > 0
                         && use_decimatedIQ == false // we did not already decimate the input earlier
                         && dmod_mode != DEMOD_SAM
                         && dmod_mode != DEMOD_AM) // in AM/SAM mode, the decimation has been done in both I & Q path --> AudioDriver_Demod_SAM
                 {
                     // TODO HILBERT
-                    arm_fir_decimate_f32(&DECIMATE_RX_I, adb.a_buffer[0], adb.a_buffer[0], blockSizeIQ);      // LPF built into decimation (Yes, you can decimate-in-place!)
+                    profileTimedEventStart(ProfileRxDecimation);
+                    AudioDriver_RxFilterStage(AudioDriver_RxStageDecimate, RX_FILTER_STAGE_DECIMATE, 0, adb.a_buffer[0], adb.a_buffer[0], blockSizeIQ, blockSizeDecim);
 #ifdef USE_TWO_CHANNEL_AUDIO
                     if(use_stereo)
                     {
-                        arm_fir_decimate_f32(&DECIMATE_RX_Q, adb.a_buffer[1], adb.a_buffer[1], blockSizeIQ);      // LPF built into decimation (Yes, you can decimate-in-place!)
+                        AudioDriver_RxFilterStage(AudioDriver_RxStageDecimate, RX_FILTER_STAGE_DECIMATE, 1, adb.a_buffer[1], adb.a_buffer[1], blockSizeIQ, blockSizeDecim);
                     }
 #endif
+                    profileTimedEventStop(ProfileRxDecimation);
                 }
 
                 if (ts.dsp_inhibit == false)
                 {
-                    if((dsp_active & DSP_NOTCH_ENABLE) && (dmod_mode != DEMOD_CW) && !(dmod_mode == DEMOD_SAM && (FilterPathInfo[ts.filter_path].sample_rate_dec) == RX_DECIMATION_RATE_24KHZ))       // No notch in CW
-                    {
-#ifdef USE_LEAKY_LMS
-                    	if(ts.enable_leaky_LMS)
-                    	{
-                    	      AudioDriver_LeakyLmsNr(adb.a_buffer[0], adb.a_buffer[0], blockSizeDecim, 1);
-                    	}
-                        else
+                    profileTimedEventStart(ProfileRxLms);
+                    const bool lms_allowed = !(dmod_mode == DEMOD_SAM && (FilterPathInfo[ts.filter_path].sample_rate_dec) == RX_DECIMATION_RATE_24KHZ);
+#ifdef USE_FBLMS
+                    // automatic notch and the pre-filter/AGC instance of the LMS noise reduction run in one pass, see audio_fblms.c
+                    bool lms_notch = lms_allowed && (dsp_active & DSP_NOTCH_ENABLE) && (dmod_mode != DEMOD_CW);       // No notch in CW
+#ifdef USE_ALTERNATE_NR
+                    // with the spectral noise reduction the notch is done by the multi notch of audio_nr.c
+                    lms_notch = lms_notch && !((dsp_active & DSP_NR_ENABLE) && ads.decimation_rate == 4);
 #endif
-                        {
-//#ifdef OBSOLETE_NR
-#ifdef USE_LMS_AUTONOTCH
-                        	AudioDriver_NotchFilter(blockSizeDecim, adb.a_buffer[0]);     // Do notch filter
+                    bool lms_nr = false;
+#ifdef USE_LEAKY_LMS
+                    lms_nr = lms_allowed && ts.enable_leaky_LMS && (dsp_active & DSP_NR_ENABLE) && !(dsp_active & DSP_NR_POSTAGC_ENABLE);     // Do this if enabled and "Pre-AGC" DSP NR enabled
 #endif
-                        }
+                    if (lms_notch || lms_nr)
+                    {
+                        AudioFblms_Process(adb.a_buffer[0], blockSizeDecim, lms_notch, lms_nr);
                     }
-
+#endif
+#ifdef OBSOLETE_NR
                     // DSP noise reduction using LMS (Least Mean Squared) algorithm
                     // This is the pre-filter/AGC instance
-                    if((dsp_active & DSP_NR_ENABLE) && (!(dsp_active & DSP_NR_POSTAGC_ENABLE)) && !(dmod_mode == DEMOD_SAM && (FilterPathInfo[ts.filter_path].sample_rate_dec) == RX_DECIMATION_RATE_24KHZ))      // Do this if enabled and "Pre-AGC" DSP NR enabled
+                    if(lms_allowed && (dsp_active & DSP_NR_ENABLE) && (!(dsp_active & DSP_NR_POSTAGC_ENABLE)))      // Do this if enabled and "Pre-AGC" DSP NR enabled
                     {
-#ifdef USE_LEAKY_LMS
-                    	if(ts.enable_leaky_LMS)
-                    	{
-                    	      AudioDriver_LeakyLmsNr(adb.a_buffer[0], adb.a_buffer[0], blockSizeDecim, 0);
-                    	}
-                        else
-#endif
-                        {
-#ifdef OBSOLETE_NR
-                        	AudioDriver_NoiseReduction(blockSizeDecim, adb.a_buffer[0]);     //
-#endif
-                        }
+                        AudioDriver_NoiseReduction(blockSizeDecim, adb.a_buffer[0]);     //
                     }
-
+#endif
+                    profileTimedEventStop(ProfileRxLms);
                 }
 
-                // Apply audio  bandpass filter
-                if ((IIR_PreFilter[0].numStages > 0))   // yes, we want an audio IIR filter
+                // Apply audio  bandpass filter, the convolution filter includes it
+                if ((rxf->pre[0].numStages > 0 || rxf_fade.old != NULL) && rxf->use_conv == false)   // yes, we want an audio IIR filter
                 {
-                    arm_iir_lattice_f32(&IIR_PreFilter[0], adb.a_buffer[0], adb.a_buffer[0], blockSizeDecim);
+                    profileTimedEventStart(ProfileRxFilter);
+                    AudioDriver_RxFilterStage(AudioDriver_RxStagePreFilter, RX_FILTER_STAGE_PRE, 0, adb.a_buffer[0], adb.a_buffer[0], blockSizeDecim, blockSizeDecim);
 #ifdef USE_TWO_CHANNEL_AUDIO
                     if(use_stereo && !ads.af_disabled)
                     {
-                         arm_iir_lattice_f32(&IIR_PreFilter[1], adb.a_buffer[1], adb.a_buffer[1], blockSizeDecim);
+                        AudioDriver_RxFilterStage(AudioDriver_RxStagePreFilter, RX_FILTER_STAGE_PRE, 1, adb.a_buffer[1], adb.a_buffer[1], blockSizeDecim, blockSizeDecim);
                     }
 #endif
+                    profileTimedEventStop(ProfileRxFilter);
                 }
 
                 // now process the samples and perform the receiver AGC function
+                    profileTimedEventStart(ProfileRxAgc);
 #ifdef USE_TWO_CHANNEL_AUDIO
                     AudioDriver_RxAgcWdsp(blockSizeDecim, adb.a_buffer[0], adb.a_buffer[1]);
 #else
                     AudioDriver_RxAgcWdsp(blockSizeDecim, adb.a_buffer[0]);
 #endif
+                    profileTimedEventStop(ProfileRxAgc);
 
 
                 // DSP noise reduction using LMS (Least Mean Squared) algorithm
@@ -3937,10 +4833,11 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
                 //
                 if((dsp_active & DSP_NR_ENABLE) && (dsp_active & DSP_NR_POSTAGC_ENABLE) && (!ts.dsp_inhibit) && !(dmod_mode == DEMOD_SAM && (FilterPathInfo[ts.filter_path].sample_rate_dec) == RX_DECIMATION_RATE_24KHZ))     // Do DSP NR if enabled and if post-DSP NR enabled
                 {
+                    profileTimedEventStart(ProfileRxLms);
 #ifdef USE_LEAKY_LMS
                 	if(ts.enable_leaky_LMS)
                 	{
-                	      AudioDriver_LeakyLmsNr(adb.a_buffer[0], adb.a_buffer[0], blockSizeDecim, 0);
+                	      AudioFblms_Process(adb.a_buffer[0], blockSizeDecim, false, true);
                 	}
                     else
 #endif
@@ -3949,6 +4846,7 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
                     	AudioDriver_NoiseReduction(blockSizeDecim, adb.a_buffer[0]);     //
 #endif
                     }
+                    profileTimedEventStop(ProfileRxLms);
                 }
                 //
                 //                if (ts.new_nb==true || ts.nr_enable == true) //start of new nb
@@ -3963,7 +4861,9 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
 
                     if (ads.decimation_rate == 4)   //  to make sure, that we are at 12Ksamples
                     {
+                        profileTimedEventStart(ProfileRxNoiseReduction);
                         AudioDriver_RxProcessorNoiseReduction(blockSizeDecim, adb.a_buffer[0]);
+                        profileTimedEventStop(ProfileRxNoiseReduction);
 
                     }
                 } // end of new nb
@@ -4022,16 +4922,18 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
                 }
 
                 // resample back to original sample rate while doing low-pass filtering to minimize audible aliasing effects
-                if (INTERPOLATE_RX[0].phaseLength > 0)
+                // the polyphase interpolation filter includes the antialias lowpass, no further filtering at 48ksps
+                profileTimedEventStart(ProfileRxInterpolation);
+                if (rxf->interp[0].phaseLength > 0)
                 {
 #ifdef USE_TWO_CHANNEL_AUDIO
                     float32_t temp_buffer[IQ_BLOCK_SIZE];
                     if(use_stereo)
                     {
-                        arm_fir_interpolate_f32(&INTERPOLATE_RX[1], adb.a_buffer[1], temp_buffer, blockSizeDecim);
+                        AudioDriver_RxFilterStage(AudioDriver_RxStageInterpolate, RX_FILTER_STAGE_INTERPOLATE, 1, adb.a_buffer[1], temp_buffer, blockSizeDecim, blockSize);
                     }
 #endif
-                    arm_fir_interpolate_f32(&INTERPOLATE_RX[0], adb.a_buffer[0], adb.a_buffer[1], blockSizeDecim);
+                    AudioDriver_RxFilterStage(AudioDriver_RxStageInterpolate, RX_FILTER_STAGE_INTERPOLATE, 0, adb.a_buffer[0], adb.a_buffer[1], blockSizeDecim, blockSize);
 
 #ifdef USE_TWO_CHANNEL_AUDIO
                     if(use_stereo)
@@ -4041,18 +4943,7 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
 #endif
 
                 }
-                // additional antialias filter for specific bandwidths
-                // IIR ARMA-type lattice filter
-                if (IIR_AntiAlias[0].numStages > 0)   // yes, we want an interpolation IIR filter
-                {
-                    arm_iir_lattice_f32(&IIR_AntiAlias[0], adb.a_buffer[1], adb.a_buffer[1], blockSize);
-#ifdef USE_TWO_CHANNEL_AUDIO
-                    if(use_stereo)
-                    {
-                        arm_iir_lattice_f32(&IIR_AntiAlias[1], adb.a_buffer[0], adb.a_buffer[0], blockSize);
-                    }
-#endif
-                }
+                profileTimedEventStop(ProfileRxInterpolation);
 
             } // end NOT in FM mode
             else if(dmod_mode == DEMOD_FM)           // it is FM - we don't do any decimation, interpolation, filtering or any other processing - just rescale audio amplitude
@@ -4062,11 +4953,13 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
                         RadioManagement_FmDevIs5khz() ? FM_RX_SCALING_5K : FM_RX_SCALING_2K5,
                                 adb.a_buffer[1],
                                 blockSizeDecim);  // apply fixed amount of audio gain scaling to make the audio levels correct along with AGC
+                    profileTimedEventStart(ProfileRxAgc);
 #ifdef USE_TWO_CHANNEL_AUDIO
                     AudioDriver_RxAgcWdsp(blockSizeDecim, adb.a_buffer[0], adb.a_buffer[1]);
 #else
                     AudioDriver_RxAgcWdsp(blockSizeDecim, adb.a_buffer[0]);
 #endif
+                    profileTimedEventStop(ProfileRxAgc);
             }
 
             // this is the biquad filter, a highshelf filter
@@ -4095,7 +4988,7 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
         arm_fill_f32(0, adb.a_buffer[1], blockSize);
         if (ts.audio_dac_muting_buffer_count > 0)
         {
-            ts.audio_dac_muting_buffer_count--;
+            ts.audio_dac_muting_buffer_count = AudioDriver_TickDown(ts.audio_dac_muting_buffer_count);
         }
     }
     else
@@ -4191,6 +5084,8 @@ static void AudioDriver_TxCompressor(float32_t* buffer, int16_t blockSize, float
 {
     static uint32_t	alc_delay_inbuf = 0, alc_delay_outbuf;
 
+    profileTimedEventStart(ProfileTxCompressor);
+
     if (ts.tx_comp_level > -1)
     {
         if(!ts.tune)        // do post-filter gain calculations if we are NOT in TUNE mode
@@ -4265,6 +5160,7 @@ static void AudioDriver_TxCompressor(float32_t* buffer, int16_t blockSize, float
 
         arm_mult_f32(buffer, adb.agc_valbuf, buffer, blockSize);		// Apply ALC gain corrections to TX audio channels
     }
+    profileTimedEventStop(ProfileTxCompressor);
 }
 
 /**
@@ -4282,6 +5178,8 @@ static void AudioDriver_TxIqProcessingFinal(float32_t scaling, bool swap, AudioS
 {
     int16_t trans_idx;
 
+    profileTimedEventStart(ProfileTxIqCorrection);
+
     if (ts.dmod_mode == DEMOD_CW || ts.iq_freq_mode == FREQ_IQ_CONV_MODE_OFF)
     {
         trans_idx = IQ_TRANS_OFF;
@@ -4321,6 +5219,7 @@ static void AudioDriver_TxIqProcessingFinal(float32_t scaling, bool swap, AudioS
         dst[i].r = final_q_buffer[i]; // save right channel
     }
 
+    profileTimedEventStop(ProfileTxIqCorrection);
 }
 
 
@@ -4407,10 +5306,12 @@ static void AudioDriver_TxProcessorModulatorSSB(AudioSample_t * const dst, const
 {
     // This is a phase-added 0-90 degree Hilbert transformer that also does low-pass and high-pass filtering
     // to the transmitted audio.  As noted above, it "clobbers" the low end, which is why we made up for it with the above filter.
+    profileTimedEventStart(ProfileTxHilbert);
     // + 0 deg to I data
     arm_fir_f32(&Fir_Tx_Hilbert_I, adb.a_buffer[0], adb.i_buffer, blockSize);
     // - 90 deg to Q data
     arm_fir_f32(&Fir_Tx_Hilbert_Q, adb.a_buffer[0], adb.q_buffer, blockSize);
+    profileTimedEventStop(ProfileTxHilbert);
 
     if(iq_freq_mode)
     {
@@ -4420,7 +5321,9 @@ static void AudioDriver_TxProcessorModulatorSSB(AudioSample_t * const dst, const
         bool swap = is_lsb == true && (iq_freq_mode == FREQ_IQ_CONV_M6KHZ || iq_freq_mode == FREQ_IQ_CONV_M12KHZ);
         swap = swap || ((is_lsb == false) && (iq_freq_mode == FREQ_IQ_CONV_P6KHZ || iq_freq_mode == FREQ_IQ_CONV_P12KHZ));
 
+        profileTimedEventStart(ProfileTxFreqConversion);
         AudioDriver_FreqConversion(adb.i_buffer, adb.q_buffer, blockSize, swap);
+        profileTimedEventStop(ProfileTxFreqConversion);
     }
 
     // apply I/Q amplitude & phase adjustments
@@ -4439,11 +5342,14 @@ static void AudioDriver_TxProcessorAMSideband(float32_t* i_buffer, float32_t* q_
     arm_offset_f32(q_buffer, (-1 * AM_CARRIER_LEVEL), q_buffer, blockSize);
 
     // check and apply correct translate mode
+    profileTimedEventStart(ProfileTxFreqConversion);
     AudioDriver_FreqConversion(i_buffer, q_buffer, blockSize, (ts.iq_freq_mode == FREQ_IQ_CONV_P6KHZ || ts.iq_freq_mode == FREQ_IQ_CONV_P12KHZ));
+    profileTimedEventStop(ProfileTxFreqConversion);
 }
 
 static inline void AudioDriver_TxFilterAudio(bool do_bandpass, bool do_bass_treble, float32_t* inBlock, float32_t* outBlock, const uint16_t blockSize)
 {
+    profileTimedEventStart(ProfileTxFilter);
     if (do_bandpass)
     {
         arm_iir_lattice_f32(&IIR_TXFilter, inBlock, outBlock, blockSize);
@@ -4453,6 +5359,7 @@ static inline void AudioDriver_TxFilterAudio(bool do_bandpass, bool do_bass_treb
         // biquad filter for bass & treble --> NOT enabled when using USB Audio (eg. for Digimodes)
         arm_biquad_cascade_df1_f32 (&IIR_TX_biquad, outBlock,outBlock, blockSize);
     }
+    profileTimedEventStop(ProfileTxFilter);
 }
 
 static void AudioDriver_TxProcessorFM(AudioSample_t * const src, AudioSample_t * const dst, uint16_t blockSize)
@@ -4601,14 +5508,14 @@ static void AudioDriver_TxProcessorDigital (AudioSample_t * const src, AudioSamp
             }
         }
 
-        modulus_NF += 4; //  shift modulus to not loose any data while overlapping
+        modulus_NF += 6 - blockSize % 6; //  shift modulus to not loose any data while overlapping (+4 for 32 samples per block)
         modulus_NF %= 6;//  reset modulus to 0 at modulus = 12
 
         if (trans_count_in == FDV_BUFFER_SIZE) //yes, we really hit exactly 320 - don't worry
         {
             //we have enough samples ready to start the FreeDV encoding
 
-            fdv_audio_buffer_add(&fdv_audio_buff[FDV_TX_fill_in_pt]);
+            FdvAudioBufferRing_Put(&fdv_audio_ring, &fdv_audio_buff[FDV_TX_fill_in_pt]);
             //handshake to external function in ui.driver_thread
             trans_count_in = 0;
 
@@ -4616,8 +5523,8 @@ static void AudioDriver_TxProcessorDigital (AudioSample_t * const src, AudioSamp
             FDV_TX_fill_in_pt %= FDV_BUFFER_AUDIO_NUM;
         }
 
-        if (out_buffer == NULL && fdv_iq_has_data() > 1) {
-            fdv_iq_buffer_remove(&out_buffer);
+        if (out_buffer == NULL && FdvIqBufferRing_Fill(&fdv_iq_ring) > 1) {
+            FdvIqBufferRing_Get(&fdv_iq_ring, &out_buffer);
         }
 
         if (out_buffer != NULL) // freeDV encode has finished (running in ui_driver.c)?
@@ -4682,7 +5589,7 @@ static void AudioDriver_TxProcessorDigital (AudioSample_t * const src, AudioSamp
         {
             outbuff_count = 0;
             out_buffer = NULL;
-            fdv_iq_buffer_remove(&out_buffer);
+            FdvIqBufferRing_Get(&fdv_iq_ring, &out_buffer);
         }
 
         // apply I/Q amplitude & phase adjustments
@@ -4878,9 +5785,11 @@ static void AudioDriver_TxProcessor(AudioSample_t * const srcCodec, AudioSample_
 
             AudioDriver_TxCompressor(adb.a_buffer[0], blockSize, AM_ALC_GAIN_CORRECTION);    // Do the TX ALC and speech compression/processing
 
+            profileTimedEventStart(ProfileTxHilbert);
             arm_fir_f32(&Fir_Tx_Hilbert_I, adb.a_buffer[0], adb.i_buffer, blockSize);
             // - 90 deg to Q data
             arm_fir_f32(&Fir_Tx_Hilbert_Q, adb.a_buffer[0], adb.q_buffer, blockSize);
+            profileTimedEventStop(ProfileTxHilbert);
 
             // COMMENT:  It would be trivial to add the option of generating AM with just a single (Upper or Lower) sideband since we are generating the two, separately anyway
             // and putting them back together!  [KA7OEI]
@@ -4927,7 +5836,7 @@ static void AudioDriver_TxProcessor(AudioSample_t * const srcCodec, AudioSample_
         // Pause or inactivity
         if (ts.audio_dac_muting_buffer_count)
         {
-            ts.audio_dac_muting_buffer_count--;
+            ts.audio_dac_muting_buffer_count = AudioDriver_TickDown(ts.audio_dac_muting_buffer_count);
         }
     }
 
@@ -5004,7 +5913,6 @@ void AudioDriver_I2SCallback(int16_t *src, int16_t *dst, int16_t* audioDst, int1
 {
     static bool to_rx = false;	// used as a flag to clear the RX buffer
     static bool to_tx = false;	// used as a flag to clear the TX buffer
-    static ulong tcount = 0;
     bool muted = false;
 
     const int16_t blockSize = size/2;
@@ -5027,7 +5935,7 @@ void AudioDriver_I2SCallback(int16_t *src, int16_t *dst, int16_t* audioDst, int1
             }
             if ( ts.audio_processor_input_mute_counter >0)
             {
-                ts.audio_processor_input_mute_counter--;
+                ts.audio_processor_input_mute_counter = AudioDriver_TickDown(ts.audio_processor_input_mute_counter);
             }
             to_rx = false;                          // caused by the content of the buffers from TX - used on return from SSB TX
         }
@@ -5037,21 +5945,13 @@ void AudioDriver_I2SCallback(int16_t *src, int16_t *dst, int16_t* audioDst, int1
             // muted input should not modify the ALC so we simply restore it after processing
 //            float agc_holder = ads.agc_val;
             bool dsp_inhibit_holder = ts.dsp_inhibit;
-#ifdef USE_CONVOLUTION
-            AudioDriver_RxProcessorConvolution((AudioSample_t*) src, (AudioSample_t*)dst,blockSize);
-#else
             AudioDriver_RxProcessor((AudioSample_t*) src, (AudioSample_t*)dst,blockSize);
-#endif
             //            ads.agc_val = agc_holder;
             ts.dsp_inhibit = dsp_inhibit_holder;
         }
         else
         {
-#ifdef USE_CONVOLUTION
-            AudioDriver_RxProcessorConvolution((AudioSample_t*) src, (AudioSample_t*)dst,blockSize);
-#else
             AudioDriver_RxProcessor((AudioSample_t*) src, (AudioSample_t*)dst,blockSize);
-#endif
             if (ts.cw_keyer_mode != CW_KEYER_MODE_STRAIGHT && (ts.cw_text_entry || ts.dmod_mode == DEMOD_CW)) // FIXME to call always when straight mode reworked
             {
             	CwGen_Process(adb.i_buffer, adb.q_buffer, blockSize);
@@ -5069,7 +5969,7 @@ void AudioDriver_I2SCallback(int16_t *src, int16_t *dst, int16_t* audioDst, int1
             to_tx = false;                          // caused by the content of the buffers from TX - used on return from SSB TX
             if ( ts.audio_processor_input_mute_counter >0)
             {
-                ts.audio_processor_input_mute_counter--;
+                ts.audio_processor_input_mute_counter = AudioDriver_TickDown(ts.audio_processor_input_mute_counter);
             }
         }
 
@@ -5090,40 +5990,7 @@ void AudioDriver_I2SCallback(int16_t *src, int16_t *dst, int16_t* audioDst, int1
 
     if(ts.audio_spkr_unmute_delay_count)		// this updates at 1.5 kHz - used to time TX->RX delay
     {
-        ts.audio_spkr_unmute_delay_count--;
-    }
-
-    if(ks.debounce_time < DEBOUNCE_TIME_MAX)
-    {
-        ks.debounce_time++;   // keyboard debounce timer
-    }
-
-    // Perform LCD backlight PWM brightness function
-    UiDriver_BacklightDimHandler();
-
-    tcount+=CLOCKS_PER_DMA_CYCLE;		// add the number of clock cycles that would have passed between DMA cycles
-    if(tcount > CLOCKS_PER_CENTISECOND)	 	// has enough clock cycles for 0.01 second passed?
-    {
-        tcount -= CLOCKS_PER_CENTISECOND;	// yes - subtract that many clock cycles
-        ts.sysclock++;	// this clock updates at PRECISELY 100 Hz over the long term
-        //
-        // Has the timing for the keyboard beep expired?
-
-        if(ts.sysclock > ts.beep_timing)
-        {
-            ts.beep_active = 0;				// yes, turn the tone off
-            ts.beep_timing = 0;
-        }
-    }
-
-    if(ts.scope_scheduler)		// update thread timer if non-zero
-    {
-        ts.scope_scheduler--;
-    }
-
-    if(ts.waterfall.scheduler)      // update thread timer if non-zero
-    {
-        ts.waterfall.scheduler--;
+        ts.audio_spkr_unmute_delay_count = AudioDriver_TickDown(ts.audio_spkr_unmute_delay_count);
     }
 
     if(ts.show_debug_info)
@@ -36,12 +36,6 @@ typedef struct {
     __packed int16_t r;
 } AudioSample_t;
 
-#ifdef USE_CONVOLUTION
-typedef struct {
-   COMP samples[SAMPLE_BUFFER_SIZE];
-}  Sample_Buffer;
-#endif
-
 // -----------------------------
 // FFT buffer, this is double the size of the length of the FFT used for spectrum display and waterfall spectrum
 #ifdef USE_FFT_1024
@@ -57,11 +51,12 @@ typedef struct {
 #define	IQ_BUFSZ 	(BUFF_LEN/2)
 
 // number of samples is half of size since we have 2 values (l/r or i/q) per sample.
-#define IQ_BLOCK_SIZE    (IQ_BUFSZ/2)
+// IQ_BLOCK_SIZE itself is configured in uhsdr_hw_i2s.h
 
 // Audio filter
 #define FIR_RXAUDIO_BLOCK_SIZE		IQ_BLOCK_SIZE
 #define FIR_RXAUDIO_NUM_TAPS		16 // maximum number of taps in the decimation and interpolation FIR filters
+#define FIR_RX_INTERPOLATE_PHASE_LEN_MAX	24 // maximum number of taps / interpolation rate of the RX interpolation filters
 #define IIR_RXAUDIO_BLOCK_SIZE		IQ_BLOCK_SIZE
 #define IIR_RXAUDIO_NUM_STAGES_MAX	12 // we use a maximum stage number of 10 at the moment, so this is 12 just to be safe
 //
@@ -323,6 +318,12 @@ typedef struct SMeter
 #define	NB_WARNING1_SETTING	7		// setting at or above which NB warning1 (yellow) is given
 #define	NB_WARNING2_SETTING	12		// setting at or above which NB warning2 (orange) is given
 #define	NB_WARNING3_SETTING	15		// setting at or above which NB warning3 (red) is given
+//
+// 48 kHz IQ noise blanker, the look-ahead delay line is one audio block long
+#define	NB_RAMP_LEN			8		// length in samples of the raised cosine gain ramps
+#define	NB_ADVANCE			(NB_RAMP_LEN + 2)	// blanking starts this many samples before a pulse, has to fit into the delay line
+#define	NB_HANG				12		// samples blanked after the last sample of a pulse
+#define	NB_AVG_TAU			0.02	// time constant (s) of the average signal power the pulse threshold is derived from
 //#define	NB_DURATION			4
 //
 //#define	NB_AGC_FILT			0.999	// Component of IIR filter for recyling previous AGC value
@@ -382,9 +383,6 @@ typedef struct SMeter
 //
 // FM Demodulator parameters
 //
-#define	FM_DEMOD_COEFF1		PI/4			// Factors used in arctan approximation used in FM demodulator
-#define	FM_DEMOD_COEFF2		PI*0.75
-//
 #define	FM_RX_SCALING_2K5		33800			// Amplitude scaling factor of demodulated FM audio (normalized for +/- 2.5 kHz deviation at 1 kHZ)
 #define FM_RX_SCALING_5K	(FM_RX_SCALING_2K5/2)	// Amplitude scaling factor of demodulated FM audio (normalized for +/- 5 kHz deviation at 1 kHz)
 //
@@ -394,6 +392,8 @@ typedef struct SMeter
 //
 #define FM_RX_HPF_ALPHA		0.96			// For FM demodulator:  "Alpha" (high-pass) factor to result in -6dB "knee" at approx. 180 Hz
 //
+#define FM_GOERTZEL_DECIMATION	16			// subaudible tone detection runs at IQ_SAMPLE_RATE/16 = 3ksps, has to divide IQ_BLOCK_SIZE
+//
 #define FM_RX_SQL_SMOOTHING	0.005			// Smoothing factor for IIR squelch noise averaging
 #define	FM_SQUELCH_HYSTERESIS	3			// Hysteresis for FM squelch
 #define FM_SQUELCH_PROC_DECIMATION	50		// Number of times we go through the FM demod algorithm before we do a squelch calculation
@@ -453,6 +453,7 @@ enum	{
 //#define	FM_BANDWIDTH_DEFAULT	FM_RX_BANDWIDTH_10K		// We will use the second-to-narrowest bandwidth as the "Default" FM RX bandwidth to be safe!
 //
 #define	FM_SUBAUDIBLE_GOERTZEL_WINDOW	400				// this sets the overall number of samples involved in the Goertzel decode windows (this value * "size/2")
+#define	FM_SUBAUDIBLE_GOERTZEL_BLOCKS	(FM_SUBAUDIBLE_GOERTZEL_WINDOW/AUDIO_TICKS_PER_BLOCK)	// number of audio blocks per window, keeps the window length independent of IQ_BLOCK_SIZE
 #define	FM_TONE_DETECT_ALPHA	0.9						// setting for IIR filtering of ratiometric result from frequency-differential tone detection
 //
 #define FM_SUBAUDIBLE_TONE_DET_THRESHOLD	1.75		// threshold of "smoothed" output of Goertzel, above which a tone is considered to be "provisionally" detected pending debounce
@@ -541,17 +542,23 @@ enum	{
 
 #ifdef USE_LMS_AUTONOTCH
 //
-// Automatic Notch Filter
-//
-#define	LMS_NOTCH_DELAYBUF_SIZE_MAX	512
+// Automatic Notch Filter, a frequency domain block LMS (audio_fblms.c)
+// the number of taps is a multiple of FBLMS_BLOCK_SIZE
 //
-#define	DSP_NOTCH_NUMTAPS_MAX		64//128
-#define	DSP_NOTCH_NUMTAPS_MIN		64
-#define	DSP_NOTCH_NUMTAPS_DEFAULT	64//96
+#ifdef IS_SMALL_BUILD
+#define	DSP_NOTCH_NUMTAPS_MAX		128     // FBLMS_TAPS_MAX
+#else
+#define	DSP_NOTCH_NUMTAPS_MAX		224     // FBLMS_TAPS_MAX
+#endif
+#define	DSP_NOTCH_NUMTAPS_MIN		32
+#define	DSP_NOTCH_NUMTAPS_DEFAULT	128
+#define	DSP_NOTCH_NUMTAPS_STEP		32		// FBLMS_BLOCK_SIZE, menu step of the number of taps
+// nearest number of taps the filter can run, the time domain notch had steps of 16
+#define	DSP_NOTCH_NUMTAPS_ROUND(taps)	((((taps) + DSP_NOTCH_NUMTAPS_STEP / 2) / DSP_NOTCH_NUMTAPS_STEP) * DSP_NOTCH_NUMTAPS_STEP)
 //
-#define	DSP_NOTCH_BUFLEN_MIN		128//64//48		// minimum length of decorrelation buffer for the notch filter FIR
-#define	DSP_NOTCH_BUFLEN_MAX		128//192	// maximum decorrelation buffer length for the notch filter FIR
-#define	DSP_NOTCH_DELAYBUF_DEFAULT	128//104	// default decorrelation buffer length for the notch filter FIR
+#define	DSP_NOTCH_DELAY_MIN			8		// minimum decorrelation delay of the reference in samples
+#define	DSP_NOTCH_DELAY_MAX			248		// maximum decorrelation delay of the reference in samples
+#define	DSP_NOTCH_DELAY_DEFAULT		120		// default decorrelation delay of the reference in samples
 //
 #define	DSP_NOTCH_MU_MAX			40//40		// maximum "strength" (convergence) setting for the notch
 #define	DSP_NOTCH_MU_DEFAULT		10//25		// default convergence setting for the notch
@@ -570,8 +577,42 @@ enum	{
 #define	AUDIO_DELAY_BUFSIZE		(BUFF_LEN/2)*5	// Size of AGC delaying audio buffer - Must be a multiple of BUFF_LEN/2.
 // This is divided by the decimation rate so that the time delay is constant.
 
-#define CLOCKS_PER_DMA_CYCLE	10656			// Number of 16 MHz clock cycles per DMA cycle
-#define	CLOCKS_PER_CENTISECOND	160000			// Number of 16 MHz clock cycles per 0.01 second timing cycle
+/**
+ * @brief counts down a timer kept in audio interrupt ticks (see AUDIO_TICKS_PER_BLOCK) by the duration of one audio block
+ * @returns remaining ticks, stops at zero
+ */
+static inline uint32_t AudioDriver_TickDown(const uint32_t ticks)
+{
+    return ticks > AUDIO_TICKS_PER_BLOCK ? ticks - AUDIO_TICKS_PER_BLOCK : 0;
+}
+
+/**
+ * @brief atan2 approximation, Abramowitz & Stegun 4.4.49 polynomial on the octant reduced argument
+ * The error is below 1.2e-5 rad in the full range (including float rounding), atan2f() needs many times
+ * the cycles for no audible difference. Returns 0 for x == y == 0.
+ * @returns angle of (x,y) in the range -PI ... PI
+ */
+static inline float32_t AudioDriver_FastAtan2(const float32_t y, const float32_t x)
+{
+    const float32_t abs_x = fabsf(x);
+    const float32_t abs_y = fabsf(y);
+    const bool steep = abs_y > abs_x;
+    // 1e-20 keeps us from dividing zero by zero
+    const float32_t z = steep ? abs_x / (abs_y + 1e-20f) : abs_y / (abs_x + 1e-20f);
+    const float32_t z2 = z * z;
+
+    float32_t angle = z * (0.9998660f + z2 * (-0.3302995f + z2 * (0.1801410f + z2 * (-0.0851330f + z2 * 0.0208351f))));
+
+    if (steep)
+    {
+        angle = PI/2 - angle;
+    }
+    if (x < 0)
+    {
+        angle = PI - angle;
+    }
+    return y < 0 ? -angle : angle;
+}
 //
 //
 // The following refer to the software frequency conversion/translation done in receive and transmit to shift the signals away from the
@@ -604,8 +645,10 @@ enum	{
 // Exports
 void AudioDriver_Init(void);
 void AudioDriver_SetRxAudioProcessing(uint8_t dmod_mode, bool reset_dsp_nr);
+bool AudioDriver_NrDecimation(uint16_t filter_path);
 void AudioDriver_TxFilterInit(uint8_t dmod_mode);
 int32_t AudioDriver_GetTranslateFreq();
+int32_t AudioDriver_GetRxShiftFreq();
 void AudioDriver_SetSamPllParameters (void);
 void AudioDriver_SetupAgcWdsp(void);
 float log10f_fast(float X);
@@ -615,9 +658,8 @@ void AudioDriver_RxAgcWdsp(int16_t blockSize, float32_t *agcbuffer1, float32_t *
 #else
 void AudioDriver_RxAgcWdsp(int16_t blockSize, float32_t *agcbuffer1);
 #endif
-void AudioDriver_RxHandleIqCorrection(const uint16_t blockSize);
+void AudioDriver_RxFrontEnd(AudioSample_t * const src, const uint16_t blockSize);
 bool AudioDriver_RxProcessorDigital(AudioSample_t * const src, float32_t * const dst, const uint16_t blockSize);
-void AudioDriver_SpectrumNoZoomProcessSamples(const uint16_t blockSize);
 void AudioDriver_SpectrumZoomProcessSamples(const uint16_t blockSize);
 
 void RttyDecoder_Init();
@@ -648,37 +690,17 @@ extern SnapCarrier sc;
 
 
 #ifdef USE_LEAKY_LMS
-#define LEAKYLMSDLINE_SIZE 256 //512 // was 256 //2048   // dline_size
-// 1024 funktioniert nicht
+// the leak setting gamma is scaled to the fraction of the weights lost per block of the LMS noise reduction
+#define LEAKY_LMS_LEAK_SCALE 0.001
 typedef struct
 {// Automatic noise reduction
-	// Variable-leak LMS algorithm
-	// taken from (c) Warren Pratts wdsp library 2016
-	// GPLv3 licensed
-//	#define DLINE_SIZE 256 //512 //2048  // dline_size
-	int16_t n_taps; // =     64; //64;                       // taps
-	int16_t delay; // =    16; //16;                       // delay
-	int dline_size; // = LEAKYLMSDLINE_SIZE;
-	//int ANR_buff_size = FFT_length / 2.0;
-	int position;// = 0;
-	float32_t two_mu;// =   0.0001;   typical: 0.001 to 0.000001  = 1000 to 1 -> div by 1000000     // two_mu --> "gain"
+	// settings of the LMS noise reduction, runs as frequency domain block LMS, see audio_fblms.c
+	int16_t n_taps; // =     64;                       // taps, multiple of FBLMS_BLOCK_SIZE
+	int16_t delay; // =    16;                       // delay
+	float32_t two_mu;// =   0.01;   typical: 0.1 to 0.0001  = 1000 to 1 -> div by 10000     // two_mu --> "gain", normalized step size
 	uint32_t two_mu_int;
 	float32_t gamma;// =    0.1;      typical: 1.000 to 0.001  = 1000 to 1 -> div by 1000           // gamma --> "leakage"
 	uint32_t gamma_int;
-	float32_t lidx;// =     120.0;                      // lidx
-	float32_t lidx_min;// = 0.0;                      // lidx_min
-	float32_t lidx_max;// = 200.0;                      // lidx_max
-	float32_t ngamma;// =   0.001;                      // ngamma
-	float32_t den_mult;// = 6.25e-10;                   // den_mult
-	float32_t lincr;// =    1.0;                      // lincr
-	float32_t ldecr;// =    3.0;                     // ldecr
-	//int ANR_mask = ANR_dline_size - 1;
-	int mask;// = DLINE_SIZE - 1;
-	int in_idx;// = 0;
-	float32_t d [LEAKYLMSDLINE_SIZE];
-	float32_t w [LEAKYLMSDLINE_SIZE];
-	uint8_t on;// = 0;
-	uint8_t notch;// = 0;
 } lLMS;
 
 extern lLMS leakyLMS;
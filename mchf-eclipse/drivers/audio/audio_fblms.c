@@ -0,0 +1,249 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     audio_fblms.c                                                   **
+ **  Description:   Frequency domain block LMS for the automatic notch and the      **
+ **                 LMS noise reduction                                             **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+// Both filters are adaptive linear predictors: the reference is the input delayed by
+// some samples, so only the periodic parts of the signal (carriers, voice harmonics) can be
+// predicted. The notch outputs the prediction error, the noise reduction the prediction.
+//
+// Instead of adapting a time domain FIR filter sample by sample, the filter runs as a
+// partitioned overlap-save convolution (multidelay block filter, MDF) in blocks of
+// FBLMS_BLOCK_SIZE samples. A filter with taps = K * FBLMS_BLOCK_SIZE needs per block
+// three FFTs of 2 * FBLMS_BLOCK_SIZE samples, K complex multiply-accumulates for the output
+// and K for the update, plus two FFTs for the gradient constraint of one partition
+// (the partitions take turns). Per sample this is cheaper than a time domain NLMS with
+// FBLMS_BLOCK_SIZE taps, so the filters can have several hundred taps.
+//
+// The real FFT and the scratch buffers are shared by both instances, when notch and noise
+// reduction are both on, the noise reduction works on the output block of the notch, so the
+// chain is delayed by one block only.
+
+#include "audio_fblms.h"
+
+#ifdef USE_FBLMS
+
+#include "arm_math.h"
+
+#define FBLMS_FFT_SIZE          (2 * FBLMS_BLOCK_SIZE)
+#define FBLMS_PARTITIONS_MAX    (FBLMS_TAPS_MAX / FBLMS_BLOCK_SIZE)
+#define FBLMS_POWER_ALPHA       0.7f    // smoothing of the reference power per block
+#define FBLMS_POWER_MIN         1e-10f  // keeps the normalization finite for silence
+
+typedef struct
+{
+    uint8_t partitions;         // taps / FBLMS_BLOCK_SIZE
+    uint8_t newest;             // index of the newest reference spectrum in X
+    uint8_t constrain;          // partition whose weights are constrained in the next block
+    uint8_t fill;               // samples of the current block collected in "in"
+    uint16_t delay;             // reference delay in samples
+    float32_t mu;               // step size per bin, already divided by the number of partitions
+    float32_t leak;             // the weights are multiplied by this factor every block
+    // spectra in the format of arm_rfft_fast_f32: bin 0 and the Nyquist bin (both real) first,
+    // then real and imaginary part of bins 1 ... FBLMS_BLOCK_SIZE - 1
+    float32_t X[FBLMS_PARTITIONS_MAX][FBLMS_FFT_SIZE];  // reference spectra of the last blocks
+    float32_t W[FBLMS_PARTITIONS_MAX][FBLMS_FFT_SIZE];  // weights, partition k works on X of k blocks ago
+    float32_t power;            // smoothed reference power per bin
+    float32_t dline[FBLMS_DELAY_MAX + FBLMS_FFT_SIZE];  // input history, oldest first: delay + 2 blocks
+    float32_t in[FBLMS_BLOCK_SIZE];
+    float32_t out[FBLMS_BLOCK_SIZE];
+} FblmsInstance;
+
+static FblmsInstance fblms[FBLMS_NUM];
+
+// shared by the instances
+static arm_rfft_fast_instance_f32 fblms_rfft;
+static float32_t fblms_frame[FBLMS_FFT_SIZE];   // time domain, arm_rfft_fast_f32 destroys its input
+static float32_t fblms_spec[FBLMS_FFT_SIZE];    // output spectrum, then error spectrum
+static bool fblms_ready;
+
+/**
+ * @brief sets up an instance, the filter has to be reset if the number of taps changes
+ * @param taps rounded down to a multiple of FBLMS_BLOCK_SIZE, 1 ... FBLMS_TAPS_MAX / FBLMS_BLOCK_SIZE partitions
+ * @param delay delay of the reference in samples, 0 ... FBLMS_DELAY_MAX
+ * @param mu normalized step size, the same convergence as a time domain NLMS with this step size
+ * @param leak fraction of the weights lost per block, 0 for no leakage
+ * @param reset clear the weights
+ */
+void AudioFblms_Init(uint8_t instance, uint16_t taps, uint16_t delay, float32_t mu, float32_t leak, bool reset)
+{
+    FblmsInstance* f = &fblms[instance];
+
+    if (fblms_ready == false)
+    {
+        arm_rfft_fast_init_f32(&fblms_rfft, FBLMS_FFT_SIZE);
+        fblms_ready = true;
+    }
+
+    uint8_t partitions = taps / FBLMS_BLOCK_SIZE;
+    if (partitions < 1)
+    {
+        partitions = 1;
+    }
+    else if (partitions > FBLMS_PARTITIONS_MAX)
+    {
+        partitions = FBLMS_PARTITIONS_MAX;
+    }
+
+    if (reset || partitions != f->partitions)
+    {
+        arm_fill_f32(0.0, &f->W[0][0], FBLMS_PARTITIONS_MAX * FBLMS_FFT_SIZE);
+    }
+    arm_fill_f32(0.0, &f->X[0][0], FBLMS_PARTITIONS_MAX * FBLMS_FFT_SIZE);
+    f->power = 0;
+    arm_fill_f32(0.0, f->dline, FBLMS_DELAY_MAX + FBLMS_FFT_SIZE);
+    arm_fill_f32(0.0, f->out, FBLMS_BLOCK_SIZE);
+
+    f->partitions = partitions;
+    f->delay = delay > FBLMS_DELAY_MAX ? FBLMS_DELAY_MAX : delay;
+    // a bin of the reference spectrum has the power of 2 * FBLMS_BLOCK_SIZE samples, the error spectrum
+    // carries a block of error samples: the step per bin mu / partitions is the step of an NLMS over all taps
+    f->mu = 2.0f * mu / partitions;
+    f->leak = 1.0f - leak;
+    f->newest = 0;
+    f->constrain = 0;
+    f->fill = 0;
+}
+
+/**
+ * @brief filters one block, in and out may be the same buffer
+ */
+static void AudioFblms_Block(FblmsInstance* f, bool output_error, const float32_t* in, float32_t* out)
+{
+    const uint16_t K = f->partitions;
+    const uint16_t dlen = f->delay + FBLMS_FFT_SIZE;
+
+    // the reference frame is the oldest part of the history: the last two blocks delayed by f->delay
+    memmove(f->dline, &f->dline[FBLMS_BLOCK_SIZE], (dlen - FBLMS_BLOCK_SIZE) * sizeof(float32_t));
+    arm_copy_f32((float32_t*)in, &f->dline[dlen - FBLMS_BLOCK_SIZE], FBLMS_BLOCK_SIZE);
+    const float32_t* desired = &f->dline[dlen - FBLMS_BLOCK_SIZE];
+
+    f->newest = f->newest == 0 ? K - 1 : f->newest - 1;
+    float32_t* Xn = f->X[f->newest];
+    arm_copy_f32(f->dline, fblms_frame, FBLMS_FFT_SIZE);
+    arm_rfft_fast_f32(&fblms_rfft, fblms_frame, Xn, 0);
+
+    // output spectrum: sum of all partitions, the first two entries are the real bins 0 and Nyquist
+    float32_t* Y = fblms_spec;
+    arm_fill_f32(0.0, Y, FBLMS_FFT_SIZE);
+    for (uint16_t k = 0, xk = f->newest; k < K; k++, xk = xk + 1 < K ? xk + 1 : 0)
+    {
+        const float32_t* X = f->X[xk];
+        const float32_t* W = f->W[k];
+        Y[0] += X[0] * W[0];
+        Y[1] += X[1] * W[1];
+        for (uint16_t bin = 2; bin < FBLMS_FFT_SIZE; bin += 2)
+        {
+            Y[bin] += X[bin] * W[bin] - X[bin + 1] * W[bin + 1];
+            Y[bin + 1] += X[bin] * W[bin + 1] + X[bin + 1] * W[bin];
+        }
+    }
+    // overlap-save: only the second half of the circular convolution is valid
+    arm_rfft_fast_f32(&fblms_rfft, Y, fblms_frame, 1);
+
+    for (uint16_t idx = 0; idx < FBLMS_BLOCK_SIZE; idx++)
+    {
+        const float32_t y = fblms_frame[FBLMS_BLOCK_SIZE + idx];
+        const float32_t e = desired[idx] - y;
+        out[idx] = output_error ? e : y;
+        fblms_frame[FBLMS_BLOCK_SIZE + idx] = e;
+    }
+
+    // error spectrum of the zero padded error block
+    arm_fill_f32(0.0, fblms_frame, FBLMS_BLOCK_SIZE);
+    float32_t* E = fblms_spec;
+    arm_rfft_fast_f32(&fblms_rfft, fblms_frame, E, 0);
+
+    // normalize the error with the smoothed power of the reference, averaged over all bins as in a
+    // time domain NLMS: strong bins (carriers) adapt faster than the weak ones, which gives much
+    // deeper notches than a normalization per bin and leaves the noise and voice bins alone
+    float32_t power = Xn[0] * Xn[0] + Xn[1] * Xn[1];
+    for (uint16_t idx = 2; idx < FBLMS_FFT_SIZE; idx++)
+    {
+        power += 2 * Xn[idx] * Xn[idx];
+    }
+    f->power = FBLMS_POWER_ALPHA * f->power + (1.0f - FBLMS_POWER_ALPHA) * power / FBLMS_FFT_SIZE;
+    arm_scale_f32(E, f->mu / (f->power + FBLMS_POWER_MIN), E, FBLMS_FFT_SIZE);
+
+    // weight update with the correlation of error and reference: W = leak * W + conj(X) * E
+    for (uint16_t k = 0, xk = f->newest; k < K; k++, xk = xk + 1 < K ? xk + 1 : 0)
+    {
+        const float32_t* X = f->X[xk];
+        float32_t* W = f->W[k];
+        W[0] = f->leak * W[0] + X[0] * E[0];
+        W[1] = f->leak * W[1] + X[1] * E[1];
+        for (uint16_t bin = 2; bin < FBLMS_FFT_SIZE; bin += 2)
+        {
+            W[bin] = f->leak * W[bin] + X[bin] * E[bin] + X[bin + 1] * E[bin + 1];
+            W[bin + 1] = f->leak * W[bin + 1] + X[bin] * E[bin + 1] - X[bin + 1] * E[bin];
+        }
+    }
+
+    // the update leaves the partitions with a circular (acausal) part in the second half of their
+    // impulse response, it is removed for one partition per block
+    float32_t* Wc = f->W[f->constrain];
+    arm_copy_f32(Wc, fblms_spec, FBLMS_FFT_SIZE);
+    arm_rfft_fast_f32(&fblms_rfft, fblms_spec, fblms_frame, 1);
+    arm_fill_f32(0.0, &fblms_frame[FBLMS_BLOCK_SIZE], FBLMS_BLOCK_SIZE);
+    arm_rfft_fast_f32(&fblms_rfft, fblms_frame, Wc, 0);
+    f->constrain = f->constrain + 1 < K ? f->constrain + 1 : 0;
+}
+
+/**
+ * @brief runs the notch and/or the noise reduction on a buffer of any length, the output is delayed by FBLMS_BLOCK_SIZE samples
+ * @param notch run the automatic notch
+ * @param nr run the noise reduction (USE_LEAKY_LMS only), after the notch if both are on
+ */
+void AudioFblms_Process(float32_t* buffer, uint16_t blockSize, bool notch, bool nr)
+{
+#ifdef USE_LEAKY_LMS
+    FblmsInstance* first = notch ? &fblms[FBLMS_NOTCH] : &fblms[FBLMS_NR];
+    FblmsInstance* second = notch && nr ? &fblms[FBLMS_NR] : NULL;
+#else
+    FblmsInstance* first = &fblms[FBLMS_NOTCH];
+    FblmsInstance* second = NULL;
+#endif
+
+    if (first->partitions == 0 || (notch == false && nr == false))
+    {
+        return; // not initialized
+    }
+    if (second != NULL && second->partitions == 0)
+    {
+        second = NULL; // not initialized, AudioFblms_Block() needs at least one partition
+    }
+
+    for (uint16_t idx = 0; idx < blockSize;)
+    {
+        uint16_t len = FBLMS_BLOCK_SIZE - first->fill;
+        if (len > blockSize - idx)
+        {
+            len = blockSize - idx;
+        }
+        arm_copy_f32(&buffer[idx], &first->in[first->fill], len);
+        arm_copy_f32(&first->out[first->fill], &buffer[idx], len);
+        first->fill += len;
+        idx += len;
+
+        if (first->fill == FBLMS_BLOCK_SIZE)
+        {
+            first->fill = 0;
+            AudioFblms_Block(first, notch, first->in, first->out);
+            if (second != NULL)
+            {
+                AudioFblms_Block(second, false, first->out, first->out);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,48 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     audio_fblms.h                                                   **
+ **  Description:   Frequency domain block LMS for the automatic notch and the      **
+ **                 LMS noise reduction                                             **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#ifndef DRIVERS_AUDIO_AUDIO_FBLMS_H_
+#define DRIVERS_AUDIO_AUDIO_FBLMS_H_
+
+#include "uhsdr_board.h"
+
+#if defined(USE_LMS_AUTONOTCH) || defined(USE_LEAKY_LMS)
+#define USE_FBLMS
+#endif
+
+#ifdef USE_FBLMS
+// block length and partition length of the filters, the FFTs have twice this length
+// the output is delayed by one block
+#define FBLMS_BLOCK_SIZE        32
+#ifdef IS_SMALL_BUILD
+#define FBLMS_TAPS_MAX          128
+#else
+#define FBLMS_TAPS_MAX          224     // the notch setting is a uint8_t
+#endif
+#define FBLMS_DELAY_MAX         256     // decorrelation delay of the reference in samples
+
+enum
+{
+    FBLMS_NOTCH = 0,    // output is the error: everything the filter could not predict, i.e. without the carriers
+#ifdef USE_LEAKY_LMS
+    FBLMS_NR,           // output is the prediction: the periodic part of the signal, i.e. without the noise
+#endif
+    FBLMS_NUM
+};
+
+void AudioFblms_Init(uint8_t instance, uint16_t taps, uint16_t delay, float32_t mu, float32_t leak, bool reset);
+void AudioFblms_Process(float32_t* buffer, uint16_t blockSize, bool notch, bool nr);
+#endif
+
+#endif /* DRIVERS_AUDIO_AUDIO_FBLMS_H_ */
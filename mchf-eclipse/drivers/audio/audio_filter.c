@@ -123,12 +123,8 @@ sample rate: gives the sample rate used after decimation (12ksps, 24ksps . . .)
 
 &FIR_interpolation filter instance
 [int. filter coeffs_numTaps
-[int. filter coeffs: points to the array of IIR coeffs for the antialias interpolation filter used by the ARM interpolation routine
-
-&IIR interpolation filter instance
-[IIR_antialias_numStages
-[IIR_antialias_coeff_pk
-[IIR_antialias_coeff_pv: points to the array of IIR coeffs for the antialias IIR filter (works at 48ksps)
+[int. filter coeffs: points to the array of FIR coeffs for the antialias interpolation filter used by the ARM interpolation routine,
+  the antialias lowpass is part of the polyphase interpolation filter, there is no separate filter at 48ksps
 
 centre frequency of the filterpath in Hz (for the graphical display of the bandwidth under spectrum display)
 
@@ -148,13 +144,13 @@ const FilterPathDescriptor FilterPathInfo[AUDIO_FILTER_PATH_NUM] =
 {
 // id, mode name (for display), filter_select_ID, FIR_numTaps, FIR_I_coeff_file, FIR_Q_coeff_file, &decimation filter,
 //		sample_rate_dec, &IIR_PreFilter,
-//		&FIR_interpolaton filter, &IIR_interpolation filter, centre frequency of the filterpath (for graphical bandwidth display)
+//		&FIR_interpolaton filter, centre frequency of the filterpath (for graphical bandwidth display)
 //
     // SPECIAL AUDIO_OFF Entry
     {
         AUDIO_OFF, "", FILTER_MASK_NONE, 0, 0, NULL, NULL, NULL,
         0, NULL,
-        NULL, NULL
+        NULL
     },
 
 //###################################################################################################################################
@@ -165,20 +161,20 @@ const FilterPathDescriptor FilterPathInfo[AUDIO_FILTER_PATH_NUM] =
     {
         AUDIO_3P6KHZ, "FM", FILTER_MASK_FM, 1, IQ_RX_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, NULL,
         RX_DECIMATION_RATE_48KHZ, NULL,
-        NULL, NULL
+        NULL
     },
 
     {
         AUDIO_5P0KHZ, "FM", FILTER_MASK_FM, 1, IQ_RX_NUM_TAPS, iq_rx_am_5k_coeffs, iq_rx_am_5k_coeffs, NULL,
         RX_DECIMATION_RATE_48KHZ, NULL,
-        NULL, NULL
+        NULL
     },
 
     {
 //        AUDIO_6P0KHZ, "FM", FILTER_MASK_FM, 1, IQ_NUM_TAPS, iq_rx_am_5k_coeffs, iq_rx_am_5k_coeffs, NULL,
 	    AUDIO_6P0KHZ, "FM", FILTER_MASK_FM, 1, IQ_RX_NUM_TAPS, iq_rx_am_6k_coeffs, iq_rx_am_6k_coeffs, NULL,
 	    RX_DECIMATION_RATE_48KHZ, NULL,
-        NULL, NULL
+        NULL
     },
 
 //###################################################################################################################################
@@ -190,198 +186,198 @@ const FilterPathDescriptor FilterPathInfo[AUDIO_FILTER_PATH_NUM] =
 // 4
     {
         AUDIO_300HZ, "500Hz", FILTER_MASK_SSBCW, 1, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_300hz_500,
-        &FirRxInterpolate, NULL, 500
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_300hz_500),
+        &FirRxInterpolate, 500
     },
 
     {
             AUDIO_300HZ, "550Hz", FILTER_MASK_SSBCW, 2, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-            RX_DECIMATION_RATE_12KHZ, &IIR_300hz_550,
-            &FirRxInterpolate, NULL, 550
+            RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_300hz_550),
+            &FirRxInterpolate, 550
 /*            AUDIO_300HZ, "wowHz", FILTER_MASK_SSBCW, 2, IQ_NUM_TAPS_HI, i_rx_wow_coeffs, q_rx_wow_coeffs, &FirRxDecimate,
-            RX_DECIMATION_RATE_12KHZ, &IIR_300hz_550,
-            &FirRxInterpolate, NULL, 550*/
+            RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_300hz_550),
+            &FirRxInterpolate, 550*/
     },
 
     {
         AUDIO_300HZ, "600Hz", FILTER_MASK_SSBCW, 3, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_300hz_600,
-        &FirRxInterpolate, NULL, 600
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_300hz_600),
+        &FirRxInterpolate, 600
     },
 
     {
         AUDIO_300HZ, "650Hz", FILTER_MASK_SSBCW, 4, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_300hz_650,
-        &FirRxInterpolate, NULL, 650
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_300hz_650),
+        &FirRxInterpolate, 650
     },
 
     {
         AUDIO_300HZ, "700Hz", FILTER_MASK_SSBCW, 5, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_300hz_700,
-        &FirRxInterpolate, NULL, 700
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_300hz_700),
+        &FirRxInterpolate, 700
     },
 
     {
         AUDIO_300HZ, "750Hz", FILTER_MASK_SSBCW, 6, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_300hz_750,
-        &FirRxInterpolate, NULL, 750
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_300hz_750),
+        &FirRxInterpolate, 750
     },
 //10
     {
         AUDIO_300HZ, "800Hz", FILTER_MASK_SSBCW, 7, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_300hz_800,
-        &FirRxInterpolate, NULL, 800
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_300hz_800),
+        &FirRxInterpolate, 800
     },
 
     {
         AUDIO_300HZ, "850Hz", FILTER_MASK_SSBCW, 8, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_300hz_850,
-        &FirRxInterpolate, NULL, 850
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_300hz_850),
+        &FirRxInterpolate, 850
     },
 
     {
         AUDIO_300HZ, "900Hz", FILTER_MASK_SSBCW, 9, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_300hz_900,
-        &FirRxInterpolate, NULL, 900
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_300hz_900),
+        &FirRxInterpolate, 900
     },
 
     {
         AUDIO_300HZ, "950Hz", FILTER_MASK_SSBCW, 10, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_300hz_950,
-        &FirRxInterpolate, NULL, 950
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_300hz_950),
+        &FirRxInterpolate, 950
     },
 
     // 5 filters � 500Hz
     {
         AUDIO_500HZ, "550Hz", FILTER_MASK_SSBCW, 1, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_500hz_550,
-        &FirRxInterpolate, NULL, 550
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_500hz_550),
+        &FirRxInterpolate, 550
     },
 //15
     {
         AUDIO_500HZ, "650Hz", FILTER_MASK_SSBCW, 2, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_500hz_650,
-        &FirRxInterpolate, NULL, 650
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_500hz_650),
+        &FirRxInterpolate, 650
     },
 
     {
         AUDIO_500HZ, "750Hz", FILTER_MASK_SSBCW, 3, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_500hz_750,
-        &FirRxInterpolate, NULL, 750
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_500hz_750),
+        &FirRxInterpolate, 750
     },
 
     {
         AUDIO_500HZ, "850Hz", FILTER_MASK_SSBCW, 4, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_500hz_850,
-        &FirRxInterpolate, NULL, 850
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_500hz_850),
+        &FirRxInterpolate, 850
     },
 
     {
         AUDIO_500HZ, "950Hz", FILTER_MASK_SSBCW, 5, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_500hz_950,
-        &FirRxInterpolate, NULL, 950
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_500hz_950),
+        &FirRxInterpolate, 950
     },
 // 19
     {
         AUDIO_1P4KHZ, "LPF", FILTER_MASK_SSBCW, 1, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_1k4_LPF,
-        &FirRxInterpolate, NULL, 700
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_1k4_LPF),
+        &FirRxInterpolate, 700
     },
 //20
     {
         AUDIO_1P4KHZ, "BPF", FILTER_MASK_SSBCW, 2, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_1k4_BPF,
-        &FirRxInterpolate, NULL, 775
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_1k4_BPF),
+        &FirRxInterpolate, 775
     },
 
     {
         AUDIO_1P6KHZ, "LPF", FILTER_MASK_SSBCW, 1, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_1k6_LPF,
-        &FirRxInterpolate, NULL, 800
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_1k6_LPF),
+        &FirRxInterpolate, 800
     },
 
     {
         AUDIO_1P6KHZ, "BPF", FILTER_MASK_SSBCW, 2, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_1k6_BPF,
-        &FirRxInterpolate, NULL, 875
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_1k6_BPF),
+        &FirRxInterpolate, 875
     },
 
     {
         AUDIO_1P8KHZ, "1.1k", FILTER_MASK_SSBCW, 1, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_1k8_1k125,
-        &FirRxInterpolate, NULL, 1125
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_1k8_1k125),
+        &FirRxInterpolate, 1125
     },
 
     {
         AUDIO_1P8KHZ, "1.3k", FILTER_MASK_SSBCW, 2, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_1k8_1k275,
-        &FirRxInterpolate, NULL, 1275
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_1k8_1k275),
+        &FirRxInterpolate, 1275
     },
 //25
     {
         AUDIO_1P8KHZ, "1.4k", FILTER_MASK_SSBCW, 3, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_1k8_1k425,
-        &FirRxInterpolate, NULL, 1425
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_1k8_1k425),
+        &FirRxInterpolate, 1425
     },
 
     {
         AUDIO_1P8KHZ, "1.6k", FILTER_MASK_SSBCW, 4, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_1k8_1k575,
-        &FirRxInterpolate, NULL, 1575
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_1k8_1k575),
+        &FirRxInterpolate, 1575
     },
 
     {
         AUDIO_1P8KHZ, "1.7k", FILTER_MASK_SSBCW, 5, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_1k8_1k725,
-        &FirRxInterpolate, NULL, 1725
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_1k8_1k725),
+        &FirRxInterpolate, 1725
     },
 
     {
         AUDIO_1P8KHZ, "LPF", FILTER_MASK_SSBCW, 6, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_1k8_LPF,
-        &FirRxInterpolate, NULL, 900
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_1k8_LPF),
+        &FirRxInterpolate, 900
     },
 
     {
         AUDIO_2P1KHZ, "LPF", FILTER_MASK_SSBCW, 1, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k1_LPF,
-        &FirRxInterpolate, NULL, 1050
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k1_LPF),
+        &FirRxInterpolate, 1050
     },
 //30
     {
         AUDIO_2P1KHZ, "BPF", FILTER_MASK_SSBCW, 2, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k1_BPF,
-        &FirRxInterpolate, NULL, 1125
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k1_BPF),
+        &FirRxInterpolate, 1125
     },
 
     {
         AUDIO_2P3KHZ, "1.3k", FILTER_MASK_SSBCW, 1, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k3_1k275,
-        &FirRxInterpolate, NULL, 1275
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k3_1k275),
+        &FirRxInterpolate, 1275
     },
 
     {
         AUDIO_2P3KHZ, "1.4k", FILTER_MASK_SSBCW, 2, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k3_1k412,
-        &FirRxInterpolate, NULL, 1412
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k3_1k412),
+        &FirRxInterpolate, 1412
     },
 
     {
         AUDIO_2P3KHZ, "1.6k", FILTER_MASK_SSBCW, 3, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k3_1k562,
-        &FirRxInterpolate, NULL, 1562
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k3_1k562),
+        &FirRxInterpolate, 1562
     },
 
     {
         AUDIO_2P3KHZ, "1.7k", FILTER_MASK_SSBCW, 4, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k3_1k712,
-        &FirRxInterpolate, NULL, 1712
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k3_1k712),
+        &FirRxInterpolate, 1712
     },
 //35
     {
         AUDIO_2P3KHZ, "LPF", FILTER_MASK_SSBCW, 5, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k3_LPF,
-        &FirRxInterpolate, NULL, 1150
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k3_LPF),
+        &FirRxInterpolate, 1150
     },
 
 //###################################################################################################################################
@@ -390,185 +386,185 @@ const FilterPathDescriptor FilterPathInfo[AUDIO_FILTER_PATH_NUM] =
 
     {
         AUDIO_2P5KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k5_LPF,
-        &FirRxInterpolate, NULL, 1250
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k5_LPF),
+        &FirRxInterpolate, 1250
     },
 
     {
         AUDIO_2P5KHZ, "BPF", FILTER_MASK_SSB, 2, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k5_BPF,
-        &FirRxInterpolate, NULL, 1325
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k5_BPF),
+        &FirRxInterpolate, 1325
     },
 
     {
         AUDIO_2P7KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k7_LPF,
-        &FirRxInterpolate, NULL, 1350
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k7_LPF),
+        &FirRxInterpolate, 1350
     },
 
     {
         AUDIO_2P7KHZ, "BPF", FILTER_MASK_SSB, 2, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k7_BPF,
-        &FirRxInterpolate, NULL, 1425
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k7_BPF),
+        &FirRxInterpolate, 1425
     },
 //40
     {
         AUDIO_2P9KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k9_LPF,
-        &FirRxInterpolate, NULL, 1450
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k9_LPF),
+        &FirRxInterpolate, 1450
     },
 
     {
         AUDIO_2P9KHZ, "BPF", FILTER_MASK_SSB, 2, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k9_BPF,
-        &FirRxInterpolate, NULL, 1525
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k9_BPF),
+        &FirRxInterpolate, 1525
     },
 
     {
         AUDIO_3P2KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_3k2_LPF,
-        &FirRxInterpolate, NULL, 1600
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_3k2_LPF),
+        &FirRxInterpolate, 1600
     },
 
     {
         AUDIO_3P2KHZ, "BPF", FILTER_MASK_SSB, 2, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_3k2_BPF,
-        &FirRxInterpolate, NULL, 1675
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_3k2_BPF),
+        &FirRxInterpolate, 1675
     },
 
-    // in filters from 3k4 on, the FIR interpolate is 4 taps and an additional IIR interpolation filter
-//44	// is switched in to accurately prevent alias frequencies
+    // in filters from 3k4 on, the FIR interpolation filter has a steeper antialias lowpass built in
+//44	// to accurately prevent alias frequencies
     {
         AUDIO_3P4KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_3k4_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 1700
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_3k4_LPF),
+        &FirRxInterpolate_5k, 1700
     },
 //45
     {
         AUDIO_3P4KHZ, "BPF", FILTER_MASK_SSB, 2, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_3k4_BPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 1775
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_3k4_BPF),
+        &FirRxInterpolate_5k, 1775
     },
 
     {
         AUDIO_3P6KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_3k6_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 1800
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_3k6_LPF),
+        &FirRxInterpolate_5k, 1800
     },
 
     {
         AUDIO_3P6KHZ, "BPF", FILTER_MASK_SSB, 2, IQ_RX_NUM_TAPS_HI, i_rx_new_coeffs, q_rx_new_coeffs, FIR_RX_DECIMATE_PTR,
-        RX_DECIMATION_RATE_12KHZ, &IIR_3k6_BPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 1875
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_3k6_BPF),
+        &FirRxInterpolate_5k, 1875
     },
 
     {
         AUDIO_3P8KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_4k5_coeffs, q_rx_4k5_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_3k8_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 1900
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_3k8_LPF),
+        &FirRxInterpolate_5k, 1900
     },
 
     {
         AUDIO_3P8KHZ, "BPF", FILTER_MASK_SSB, 2, IQ_RX_NUM_TAPS, i_rx_4k5_coeffs, q_rx_4k5_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_3k8_BPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 1975
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_3k8_BPF),
+        &FirRxInterpolate_5k, 1975
     },
 //50
     {
         AUDIO_4P0KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_4k5_coeffs, q_rx_4k5_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_4k_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2000
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_4k_LPF),
+        &FirRxInterpolate_5k, 2000
     },
 
     {
         AUDIO_4P2KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_4k5_coeffs, q_rx_4k5_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_4k2_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2100
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_4k2_LPF),
+        &FirRxInterpolate_5k, 2100
     },
 
     {
         AUDIO_4P4KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_4k5_coeffs, q_rx_4k5_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_4k4_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2200
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_4k4_LPF),
+        &FirRxInterpolate_5k, 2200
     },
 
     {
         AUDIO_4P6KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_4k5_coeffs, q_rx_4k5_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_4k6_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2300
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_4k6_LPF),
+        &FirRxInterpolate_5k, 2300
     },
 
     {
         AUDIO_4P8KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_4k5_coeffs, q_rx_4k5_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_4k8_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2400
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_4k8_LPF),
+        &FirRxInterpolate_5k, 2400
     },
 
 //55		// new decimation rate, new decimation filter, new interpolation filter, no IIR Prefilter, no IIR interpolation filter
     {
         AUDIO_5P0KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_5k_coeffs, q_rx_5k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate10KHZ, NULL
+        &FirRxInterpolate10KHZ
     },
 
     {
         AUDIO_5P5KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_5k_coeffs, q_rx_5k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate10KHZ, NULL
+        &FirRxInterpolate10KHZ
     },
 
     {
         AUDIO_6P0KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_6k_coeffs, q_rx_6k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate10KHZ, NULL
+        &FirRxInterpolate10KHZ
     },
 
     {
         AUDIO_6P5KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_6k_coeffs, q_rx_6k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate10KHZ, NULL
+        &FirRxInterpolate10KHZ
     },
 
     {
         AUDIO_7P0KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_6k_coeffs, q_rx_6k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate10KHZ, NULL
+        &FirRxInterpolate10KHZ
     },
 //60
     {
         AUDIO_7P5KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_7k5_coeffs, q_rx_7k5_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate10KHZ, NULL
+        &FirRxInterpolate10KHZ
     },
     // additional IIR interpolation filter
     {
         AUDIO_8P0KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_10k_coeffs, q_rx_10k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_8k
+        &FirRxInterpolate_8k
     },
 
     {
         AUDIO_8P5KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_10k_coeffs, q_rx_10k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_8k5
+        &FirRxInterpolate_8k5
     },
 
     {
         AUDIO_9P0KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_10k_coeffs, q_rx_10k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_9k
+        &FirRxInterpolate_9k
     },
 
     {
         AUDIO_9P5KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_10k_coeffs, q_rx_10k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_9k5
+        &FirRxInterpolate_9k5
     },
 
     {
         AUDIO_10P0KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_10k_coeffs, q_rx_10k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_10k
+        &FirRxInterpolate_10k
     },
 
     //###################################################################################################################################
@@ -580,128 +576,128 @@ const FilterPathDescriptor FilterPathInfo[AUDIO_FILTER_PATH_NUM] =
 
     {
         AUDIO_1P4KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_2k3_coeffs, iq_rx_am_2k3_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_1k4_LPF,
-        &FirRxInterpolate, NULL, 700
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_1k4_LPF),
+        &FirRxInterpolate, 700
     },
 
     {
         AUDIO_1P6KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_2k3_coeffs, iq_rx_am_2k3_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_1k6_LPF,
-        &FirRxInterpolate, NULL, 800
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_1k6_LPF),
+        &FirRxInterpolate, 800
     },
 
     {
         AUDIO_1P8KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_2k3_coeffs, iq_rx_am_2k3_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_1k8_LPF,
-        &FirRxInterpolate, NULL, 900
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_1k8_LPF),
+        &FirRxInterpolate, 900
     },
 
     {
         AUDIO_2P1KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_2k3_coeffs, iq_rx_am_2k3_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k1_LPF,
-        &FirRxInterpolate, NULL, 1050
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k1_LPF),
+        &FirRxInterpolate, 1050
     },
 
     {
         AUDIO_2P3KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_2k3_coeffs, iq_rx_am_2k3_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k3_LPF,
-        &FirRxInterpolate, NULL, 1150
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k3_LPF),
+        &FirRxInterpolate, 1150
     },
 
     {
         AUDIO_2P5KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k5_LPF,
-        &FirRxInterpolate, NULL, 1250
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k5_LPF),
+        &FirRxInterpolate, 1250
     },
 
     {
         AUDIO_2P7KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k7_LPF,
-        &FirRxInterpolate, NULL, 1350
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k7_LPF),
+        &FirRxInterpolate, 1350
     },
 
     {
         AUDIO_2P9KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k9_LPF,
-        &FirRxInterpolate, NULL, 1450
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k9_LPF),
+        &FirRxInterpolate, 1450
     },
 
     {
         AUDIO_3P2KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_12KHZ, &IIR_3k2_LPF,
-        &FirRxInterpolate, NULL, 1600
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_3k2_LPF),
+        &FirRxInterpolate, 1600
     },
 
     {
         AUDIO_3P4KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_12KHZ, &IIR_3k4_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 1700
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_3k4_LPF),
+        &FirRxInterpolate_5k, 1700
     },
 
     {
         AUDIO_3P6KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_4k5_coeffs, iq_rx_am_4k5_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_12KHZ, &IIR_3k6_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 1800
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_3k6_LPF),
+        &FirRxInterpolate_5k, 1800
     },
 
     {
         AUDIO_3P8KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_4k5_coeffs, iq_rx_am_4k5_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_12KHZ, &IIR_3k8_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 1900
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_3k8_LPF),
+        &FirRxInterpolate_5k, 1900
     },
 
     {
         AUDIO_4P0KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_4k5_coeffs, iq_rx_am_4k5_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_12KHZ, &IIR_4k_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2000
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_4k_LPF),
+        &FirRxInterpolate_5k, 2000
     },
 
     {
         AUDIO_4P2KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_4k5_coeffs, iq_rx_am_4k5_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_12KHZ, &IIR_4k2_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2100
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_4k2_LPF),
+        &FirRxInterpolate_5k, 2100
     },
 
     {
         AUDIO_4P4KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_4k5_coeffs, iq_rx_am_4k5_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_12KHZ, &IIR_4k4_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2200
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_4k4_LPF),
+        &FirRxInterpolate_5k, 2200
     },
 
     {
         AUDIO_4P6KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_4k5_coeffs, iq_rx_am_4k5_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_12KHZ, &IIR_4k6_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2300
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_4k6_LPF),
+        &FirRxInterpolate_5k, 2300
     },
 
     {
         AUDIO_4P8KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_5k_coeffs, iq_rx_am_5k_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_12KHZ, &IIR_4k8_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2400
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_4k8_LPF),
+        &FirRxInterpolate_5k, 2400
     },
 
     {
         AUDIO_5P0KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_5k_coeffs, iq_rx_am_5k_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_24KHZ, &IIR_5k_LPF,
-        &FirRxInterpolate10KHZ, NULL
+        RX_DECIMATION_RATE_24KHZ, IIR_RX(IIR_5k_LPF),
+        &FirRxInterpolate10KHZ
     },
 
     {
         AUDIO_6P0KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_6k_coeffs, iq_rx_am_6k_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_24KHZ, &IIR_6k_LPF,
-        &FirRxInterpolate10KHZ, NULL
+        RX_DECIMATION_RATE_24KHZ, IIR_RX(IIR_6k_LPF),
+        &FirRxInterpolate10KHZ
     },
 
     {
         AUDIO_7P5KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_7k5_coeffs, iq_rx_am_7k5_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_24KHZ, &IIR_7k5_LPF,
-        &FirRxInterpolate10KHZ, NULL
+        RX_DECIMATION_RATE_24KHZ, IIR_RX(IIR_7k5_LPF),
+        &FirRxInterpolate10KHZ
     },
 
     {
         AUDIO_10P0KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_RX_NUM_TAPS, iq_rx_am_10k_coeffs, iq_rx_am_10k_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_24KHZ, &IIR_10k_LPF,
-        &FirRxInterpolate_4_10k, &IIR_aa_10k
+        RX_DECIMATION_RATE_24KHZ, IIR_RX(IIR_10k_LPF),
+        &FirRxInterpolate_10k
     },
 
 
@@ -717,86 +713,86 @@ const FilterPathDescriptor FilterPathInfo[AUDIO_FILTER_PATH_NUM] =
 
     {
         AUDIO_1P4KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_2k3_coeffs, iq_rx_am_2k3_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k3_LPF,
-        &FirRxInterpolate, NULL
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k3_LPF),
+        &FirRxInterpolate
     },
 
     {
         AUDIO_1P6KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_2k3_coeffs, iq_rx_am_2k3_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_2k9_LPF,
-        &FirRxInterpolate, NULL
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_2k9_LPF),
+        &FirRxInterpolate
     },
 
     {
         AUDIO_1P8KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_2k3_coeffs, iq_rx_am_2k3_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_3k2_LPF,
-        &FirRxInterpolate, NULL
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_3k2_LPF),
+        &FirRxInterpolate
     },
 
     {
         AUDIO_2P1KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_3k6_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_3k6_LPF),
+        &FirRxInterpolate_5k
     },
 
     {
         AUDIO_2P3KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_4k2_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_4k2_LPF),
+        &FirRxInterpolate_5k
     },
 
     {
         AUDIO_2P5KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_4k6_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_4k6_LPF),
+        &FirRxInterpolate_5k
     },
 
     {
         AUDIO_2P7KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_4k8_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_4k8_LPF),
+        &FirRxInterpolate_5k
     },
 
     {
         AUDIO_2P9KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_24KHZ, &IIR_5k5_LPF,
-        &FirRxInterpolate10KHZ, NULL
+        RX_DECIMATION_RATE_24KHZ, IIR_RX(IIR_5k5_LPF),
+        &FirRxInterpolate10KHZ
     },
 
     {
         AUDIO_3P2KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_24KHZ, &IIR_6k_LPF,
-        &FirRxInterpolate10KHZ, NULL
+        RX_DECIMATION_RATE_24KHZ, IIR_RX(IIR_6k_LPF),
+        &FirRxInterpolate10KHZ
     },
 
     {
         AUDIO_3P4KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_24KHZ, &IIR_6k5_LPF,
-        &FirRxInterpolate10KHZ, NULL
+        RX_DECIMATION_RATE_24KHZ, IIR_RX(IIR_6k5_LPF),
+        &FirRxInterpolate10KHZ
     },
 
     {
         AUDIO_3P6KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_4k5_coeffs, iq_rx_am_4k5_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_24KHZ, &IIR_7k_LPF,
-        &FirRxInterpolate10KHZ, NULL
+        RX_DECIMATION_RATE_24KHZ, IIR_RX(IIR_7k_LPF),
+        &FirRxInterpolate10KHZ
     },
 
     {
         AUDIO_3P8KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_4k5_coeffs, iq_rx_am_4k5_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_24KHZ, &IIR_7k_LPF,
-        &FirRxInterpolate10KHZ, NULL
+        RX_DECIMATION_RATE_24KHZ, IIR_RX(IIR_7k_LPF),
+        &FirRxInterpolate10KHZ
     },
 
     {
         AUDIO_4P0KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_4k5_coeffs, iq_rx_am_4k5_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_24KHZ, &IIR_7k5_LPF,
-        &FirRxInterpolate10KHZ, NULL
+        RX_DECIMATION_RATE_24KHZ, IIR_RX(IIR_7k5_LPF),
+        &FirRxInterpolate10KHZ
     },
 
     {
         AUDIO_4P2KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_4k5_coeffs, iq_rx_am_4k5_coeffs, &FirRxDecimateMinLPF,
-        RX_DECIMATION_RATE_24KHZ, &IIR_8k_LPF,
-        &FirRxInterpolate10KHZ, NULL
+        RX_DECIMATION_RATE_24KHZ, IIR_RX(IIR_8k_LPF),
+        &FirRxInterpolate10KHZ
     },
 
     // from 4.4kHz on, the AM filter has no more IIR PreFilter (at 24ksps sample rate), BUT we add IIR filtering after interpolation (at 48 ksps)!
@@ -804,25 +800,25 @@ const FilterPathDescriptor FilterPathInfo[AUDIO_FILTER_PATH_NUM] =
     {
         AUDIO_4P4KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_4k5_coeffs, iq_rx_am_4k5_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_8k
+        &FirRxInterpolate_8k
     },
 
     {
         AUDIO_4P6KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_4k5_coeffs, iq_rx_am_4k5_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_8k5
+        &FirRxInterpolate_8k5
     },
 
     {
         AUDIO_4P8KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_5k_coeffs, iq_rx_am_5k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_9k
+        &FirRxInterpolate_9k
     },
 
     {
         AUDIO_5P0KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_5k_coeffs, iq_rx_am_5k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_9k5
+        &FirRxInterpolate_9k5
     },
 
     // from 6kHz on, we have no PreFilter, an IIR interpolation filter of 10k and only change the FIR filters bandwidths
@@ -832,19 +828,19 @@ const FilterPathDescriptor FilterPathInfo[AUDIO_FILTER_PATH_NUM] =
     {
         AUDIO_6P0KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_6k_coeffs, iq_rx_am_6k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_10k
+        &FirRxInterpolate_10k
     },
 
     {
         AUDIO_7P5KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_7k5_coeffs, iq_rx_am_7k5_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_10k
+        &FirRxInterpolate_10k
     },
 
     {
         AUDIO_10P0KHZ, "AM/SAM", FILTER_MASK_AMSAM, 1, IQ_NUM_TAPS, iq_rx_am_10k_coeffs, iq_rx_am_10k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_10k
+        &FirRxInterpolate_10k
     },
 
 
@@ -862,26 +858,26 @@ const FilterPathDescriptor FilterPathInfo[AUDIO_FILTER_PATH_NUM] =
 
     {
         AUDIO_1P8KHZ, "SAM", FILTER_MASK_SAM, 1, IQ_NUM_TAPS, iq_rx_am_2k3_coeffs, iq_rx_am_2k3_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_3k2_LPF,
-        &FirRxInterpolate, NULL
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_3k2_LPF),
+        &FirRxInterpolate
     },
 
     {
         AUDIO_2P3KHZ, "SAM", FILTER_MASK_SAM, 1, IQ_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_12KHZ, &IIR_4k2_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k
+        RX_DECIMATION_RATE_12KHZ, IIR_RX(IIR_4k2_LPF),
+        &FirRxInterpolate_5k
     },
 
     {
         AUDIO_2P9KHZ, "SAM", FILTER_MASK_SAM, 1, IQ_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_24KHZ, &IIR_5k5_LPF,
-        &FirRxInterpolate10KHZ, NULL
+        RX_DECIMATION_RATE_24KHZ, IIR_RX(IIR_5k5_LPF),
+        &FirRxInterpolate10KHZ
     },
 
     {
         AUDIO_3P4KHZ, "SAM", FILTER_MASK_SAM, 1, IQ_NUM_TAPS, iq_rx_am_3k6_coeffs, iq_rx_am_3k6_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_24KHZ, &IIR_6k5_LPF,
-        &FirRxInterpolate10KHZ, NULL
+        RX_DECIMATION_RATE_24KHZ, IIR_RX(IIR_6k5_LPF),
+        &FirRxInterpolate10KHZ
     },
     // old remark, must be analysed again
     // measurements with Spectrum Lab have shown that there was considerable, but only barely
@@ -890,32 +886,32 @@ const FilterPathDescriptor FilterPathInfo[AUDIO_FILTER_PATH_NUM] =
 	// are down by at least 60dB below signal level
     {
         AUDIO_4P2KHZ, "SAM", FILTER_MASK_SAM, 1, IQ_NUM_TAPS, iq_rx_am_4k5_coeffs, iq_rx_am_4k5_coeffs, &FirRxDecimate,
-        RX_DECIMATION_RATE_24KHZ, &IIR_8k_LPF,
-        &FirRxInterpolate10KHZ, NULL
+        RX_DECIMATION_RATE_24KHZ, IIR_RX(IIR_8k_LPF),
+        &FirRxInterpolate10KHZ
     },
 
     {
         AUDIO_4P8KHZ, "SAM", FILTER_MASK_SAM, 1, IQ_NUM_TAPS, iq_rx_am_5k_coeffs, iq_rx_am_5k_coeffs, &FirRxDecimate,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_9k
+        &FirRxInterpolate_9k
     },
 
     {
         AUDIO_6P0KHZ, "SAM", FILTER_MASK_SAM, 1, IQ_NUM_TAPS, iq_rx_am_6k_coeffs, iq_rx_am_6k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_10k
+        &FirRxInterpolate_10k
     },
 
     {
         AUDIO_7P5KHZ, "SAM", FILTER_MASK_SAM, 1, IQ_NUM_TAPS, iq_rx_am_7k5_coeffs, iq_rx_am_7k5_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_10k
+        &FirRxInterpolate_10k
     },
 
     {
         AUDIO_10P0KHZ, "SAM", FILTER_MASK_SAM, 1, IQ_NUM_TAPS, iq_rx_am_10k_coeffs, iq_rx_am_10k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_10k
+        &FirRxInterpolate_10k
     }
 */
 }; // end FilterPath
@@ -1079,16 +1075,6 @@ uint8_t AudioFilter_NextApplicableFilterPath(const uint16_t query, const uint16_
 // SSB Hilbert TX Filter
 #include "iq_tx_filter.h"
 
-// RX Hilbert transform (90 degree) FIR filter state tables and instances
-arm_fir_instance_f32    Fir_Rx_Hilbert_I;
-arm_fir_instance_f32    Fir_Rx_Hilbert_Q;
-
-// FIXME: Needs comment and check!
-#define FIR_RX_HILBERT_STATE_SIZE (IQ_RX_NUM_TAPS_MAX + IQ_RX_BLOCK_SIZE)
-static float32_t    __MCHF_SPECIALMEM Fir_Rx_Hilbert_State_I[FIR_RX_HILBERT_STATE_SIZE];
-static float32_t    __MCHF_SPECIALMEM Fir_Rx_Hilbert_State_Q[FIR_RX_HILBERT_STATE_SIZE];
-
-//
 // TX Hilbert transform (90 degree) FIR filter state tables and instances
 arm_fir_instance_f32    Fir_Tx_Hilbert_I;
 arm_fir_instance_f32    Fir_Tx_Hilbert_Q;
@@ -1108,20 +1094,8 @@ static float   __MCHF_SPECIALMEM Fir_TxFreeDV_Interpolate_State_I[FIR_FREEDV_INT
 static float   __MCHF_SPECIALMEM Fir_TxFreeDV_Interpolate_State_Q[FIR_FREEDV_INTERPOLATE_STATE_SIZE];
 
 
-// Audio RX - Decimator (numTaps+blockSize-1)
-arm_fir_decimate_instance_f32   FirDecim_RxSam_I;
-arm_fir_decimate_instance_f32   FirDecim_RxSam_Q;
-
-// FIXME: Needs comment and check!!!
-#define FIR_DECIM_SAM_STATE_SIZE (IQ_RX_NUM_TAPS + IQ_RX_BLOCK_SIZE)
-static float32_t __MCHF_SPECIALMEM FirDecim_RxSam_State_I[FIR_DECIM_SAM_STATE_SIZE];
-static float32_t __MCHF_SPECIALMEM FirDecim_RxSam_State_Q[FIR_DECIM_SAM_STATE_SIZE];
-
 typedef struct
 {
-    float32_t   fir_rx_hilbert_taps_q[IQ_RX_NUM_TAPS_MAX];
-    float32_t   fir_rx_hilbert_taps_i[IQ_RX_NUM_TAPS_MAX];
-
     float32_t   fir_tx_hilbert_taps_q[IQ_TX_NUM_TAPS_MAX];
     float32_t   fir_tx_hilbert_taps_i[IQ_TX_NUM_TAPS_MAX];
 
@@ -1130,62 +1104,6 @@ typedef struct
 static IQFilterCoeffs_t   __MCHF_SPECIALMEM     fc;
 
 
-/*
- * @brief Initialize RX Hilbert filters
- */
-void 	AudioFilter_InitRxHilbertFIR(uint8_t dmod_mode)
-{
-    // always make a fresh copy of the original Q and I coefficients into fast RAM
-    // this speeds up processing on the STM32F4
-    // NOTE:  We are assuming that the I and Q filters are of the same length!
-
-    // new filter_path method
-    // take all info from FilterPathInfo
-    // phase adjustment is now done in audio_driver.c audio_rx_processor
-
-    const uint32_t rx_iq_num_taps = FilterPathInfo[ts.filter_path].FIR_numTaps;
-
-    // in FilterPathInfo, we have stored the coefficients already, so no if . . . necessary
-    // also applicable for FM case !
-    for(int i = 0; i < rx_iq_num_taps; i++)
-    {
-        fc.fir_rx_hilbert_taps_i[i] = FilterPathInfo[ts.filter_path].FIR_I_coeff_file[i];
-        fc.fir_rx_hilbert_taps_q[i] = FilterPathInfo[ts.filter_path].FIR_Q_coeff_file[i];
-    }
-
-    // Initialization of the FIR/Hilbert filters
-    arm_fir_init_f32(&Fir_Rx_Hilbert_I, rx_iq_num_taps, fc.fir_rx_hilbert_taps_i, Fir_Rx_Hilbert_State_I, IQ_RX_BLOCK_SIZE); // load "I" with "I" coefficients
-    arm_fir_init_f32(&Fir_Rx_Hilbert_Q, rx_iq_num_taps, fc.fir_rx_hilbert_taps_q, Fir_Rx_Hilbert_State_Q, IQ_RX_BLOCK_SIZE); // load "Q" with "Q" coefficients
-    //
-    // Set up RX SAM decimation/filter
-    if (dmod_mode == DEMOD_SAM || dmod_mode == DEMOD_AM)
-    {
-        if (FilterPathInfo[ts.filter_path].FIR_numTaps != 0)
-        {
-            FirDecim_RxSam_I.numTaps = FilterPathInfo[ts.filter_path].FIR_numTaps;      // Number of taps in FIR filter
-            FirDecim_RxSam_Q.numTaps = FilterPathInfo[ts.filter_path].FIR_numTaps;      // Number of taps in FIR filter
-            FirDecim_RxSam_I.pCoeffs = fc.fir_rx_hilbert_taps_i; //FilterPathInfo[ts.filter_path].FIR_I_coeff_file;       // Filter coefficients
-            FirDecim_RxSam_Q.pCoeffs = fc.fir_rx_hilbert_taps_q; //FilterPathInfo[ts.filter_path].FIR_Q_coeff_file;       // Filter coefficients
-        }
-        else
-        {
-            FirDecim_RxSam_I.numTaps = 0;
-            FirDecim_RxSam_Q.numTaps = 0;
-            FirDecim_RxSam_I.pCoeffs = NULL;
-            FirDecim_RxSam_Q.pCoeffs = NULL;
-        }
-
-        FirDecim_RxSam_I.M = ads.decimation_rate;
-        FirDecim_RxSam_Q.M = ads.decimation_rate;
-        FirDecim_RxSam_I.pState = FirDecim_RxSam_State_I;            // Filter state variables
-        FirDecim_RxSam_Q.pState = FirDecim_RxSam_State_Q;
-
-        arm_fill_f32(0.0, FirDecim_RxSam_State_I, FIR_DECIM_SAM_STATE_SIZE);
-        arm_fill_f32(0.0, FirDecim_RxSam_State_Q, FIR_DECIM_SAM_STATE_SIZE);
-    }
-}
-
-
 /*
  * @brief Initialize TX Hilbert filters
  */
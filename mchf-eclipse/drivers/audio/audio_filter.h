@@ -17,6 +17,7 @@
 
 #include "uhsdr_types.h"
 #include "arm_math.h"
+#include "audio_iir_design.h"
 
 // TODO: Decide if we switch to use this struct
 typedef struct
@@ -27,14 +28,9 @@ typedef struct
 
 extern arm_fir_instance_f32    Fir_Tx_Hilbert_Q;
 extern arm_fir_instance_f32    Fir_Tx_Hilbert_I;
-extern arm_fir_instance_f32    Fir_Rx_Hilbert_Q;
-extern arm_fir_instance_f32    Fir_Rx_Hilbert_I;
 extern arm_fir_instance_f32    Fir_TxFreeDV_Interpolate_Q;
 extern arm_fir_instance_f32    Fir_TxFreeDV_Interpolate_I;
-extern arm_fir_decimate_instance_f32 FirDecim_RxSam_I;
-extern arm_fir_decimate_instance_f32 FirDecim_RxSam_Q;
 
-void 	AudioFilter_InitRxHilbertFIR(uint8_t dmod_mode);
 void 	AudioFilter_InitTxHilbertFIR(void);
 
 enum
@@ -104,6 +100,13 @@ typedef struct FilterDescriptor_s
 extern const FilterDescriptor FilterInfo[AUDIO_FILTER_NUM];
 extern uint16_t filterpath_mode_map[FILTER_MODE_MAX];
 
+#ifdef USE_RX_IIR_DESIGNER
+// the RX audio IIR filters are designed at runtime from their specifications, see audio_iir_design.c
+typedef IIR_DesignSpec IIR_RxFilter;
+#else
+typedef arm_iir_lattice_instance_f32 IIR_RxFilter;
+#endif
+
 typedef struct FilterPathDescriptor_s
 {
     const uint8_t id;
@@ -123,9 +126,8 @@ typedef struct FilterPathDescriptor_s
 
     const uint8_t sample_rate_dec;
 
-    const arm_iir_lattice_instance_f32* pre_instance;
-    const arm_fir_interpolate_instance_f32* interpolate;
-    const arm_iir_lattice_instance_f32* iir_instance;
+    const IIR_RxFilter* pre_instance;
+    const arm_fir_interpolate_instance_f32* interpolate;     // includes the antialias lowpass
 //  const arm_biquad_casd_df1_inst_f32* notch_instance;
 
     const uint16_t offset; // how much offset in Hz has the center frequency of the filter from base frequency.
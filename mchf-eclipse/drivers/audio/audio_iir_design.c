@@ -0,0 +1,443 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     audio_iir_design.c                                              **
+ **  Description:   Elliptic and Butterworth IIR lowpass/bandpass design            **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+/*
+ * Designs IIR filters as cascaded biquads for arm_biquad_cascade_df2T_f32() from an IIR_DesignSpec.
+ *
+ * The analog lowpass prototype is transformed into the lowpass or bandpass (s -> (s^2 + w0^2) / (s * bw))
+ * and mapped with the prewarped bilinear transform, the poles and zeros are calculated directly.
+ * The elliptic prototype follows S. J. Orfanidis, "Lecture Notes on Elliptic Filter Design", 2006,
+ * using Landen transformations for the elliptic functions.
+ *
+ * Everything is calculated in double precision, only the final coefficients are float32_t.
+ * A design takes a few milliseconds on an STM32F4 without double precision FPU, so this must not
+ * be called from the audio interrupt.
+ */
+
+#include "audio_iir_design.h"
+#include <math.h>
+
+// the Landen sequence converges quadratically, 10 steps are enough for all moduli up to 1 - 1e-12
+#define IIR_DESIGN_LANDEN_STEPS_MAX 10
+// frequencies between 0 and fs/2 for the scaling of the biquads
+#define IIR_DESIGN_GRID_POINTS 256
+
+typedef struct
+{
+    double re;
+    double im;
+} IirDesign_Complex;
+
+// roots of the digital filter, complex roots come in conjugate pairs of which one is stored
+typedef struct
+{
+    IirDesign_Complex pair[IIR_DESIGN_NUM_STAGES_MAX];
+    double real[2 * IIR_DESIGN_NUM_STAGES_MAX];
+    int pairs;
+    int reals;
+} IirDesign_Roots;
+
+// the analog lowpass prototype with a passband edge of 1 rad/s
+typedef struct
+{
+    IirDesign_Complex pole[IIR_DESIGN_NUM_STAGES_MAX];  // one pole of each conjugate pair, followed by the real pole of an odd order
+    double zero[IIR_DESIGN_NUM_STAGES_MAX];             // zero pairs at +/-j*zero, all others are at infinity
+    int pairs;
+    int zeros;
+    int order;
+    double gain;                                        // gain at DC
+} IirDesign_Prototype;
+
+typedef struct
+{
+    double v[IIR_DESIGN_LANDEN_STEPS_MAX];
+    int steps;
+} IirDesign_Landen;
+
+typedef struct
+{
+    double b[3];
+    double a[3];
+    double radius;  // pole radius
+} IirDesign_Section;
+
+static inline IirDesign_Complex AudioIirDesign_Add(IirDesign_Complex x, IirDesign_Complex y)
+{
+    return (IirDesign_Complex) { x.re + y.re, x.im + y.im };
+}
+
+static inline IirDesign_Complex AudioIirDesign_Sub(IirDesign_Complex x, IirDesign_Complex y)
+{
+    return (IirDesign_Complex) { x.re - y.re, x.im - y.im };
+}
+
+static inline IirDesign_Complex AudioIirDesign_Mul(IirDesign_Complex x, IirDesign_Complex y)
+{
+    return (IirDesign_Complex) { x.re * y.re - x.im * y.im, x.re * y.im + x.im * y.re };
+}
+
+static inline IirDesign_Complex AudioIirDesign_Scale(IirDesign_Complex x, double f)
+{
+    return (IirDesign_Complex) { x.re * f, x.im * f };
+}
+
+static IirDesign_Complex AudioIirDesign_Div(IirDesign_Complex x, IirDesign_Complex y)
+{
+    const double d = y.re * y.re + y.im * y.im;
+    return (IirDesign_Complex) { (x.re * y.re + x.im * y.im) / d, (x.im * y.re - x.re * y.im) / d };
+}
+
+static IirDesign_Complex AudioIirDesign_Sqrt(IirDesign_Complex x)
+{
+    const double r = hypot(x.re, x.im);
+    return (IirDesign_Complex) { sqrt((r + x.re) / 2), copysign(sqrt((r - x.re) / 2), x.im) };
+}
+
+/**
+ * @brief descending Landen sequence of the elliptic modulus k
+ */
+static void AudioIirDesign_Landen(double k, IirDesign_Landen* landen)
+{
+    landen->steps = 0;
+    while (landen->steps < IIR_DESIGN_LANDEN_STEPS_MAX && k > 1e-15)
+    {
+        k = k / (1 + sqrt(1 - k * k));
+        k = k * k;
+        landen->v[landen->steps++] = k;
+    }
+}
+
+/**
+ * @brief Jacobi elliptic functions cd(u*K, k) (cd = true) or sn(u*K, k), K is the complete elliptic integral of k
+ */
+static IirDesign_Complex AudioIirDesign_Elliptic(IirDesign_Complex u, const IirDesign_Landen* landen, bool cd)
+{
+    const double a = u.re * M_PI / 2;
+    const double b = u.im * M_PI / 2;
+    IirDesign_Complex w = cd ? (IirDesign_Complex) { cos(a) * cosh(b), -sin(a) * sinh(b) }
+                             : (IirDesign_Complex) { sin(a) * cosh(b), cos(a) * sinh(b) };
+
+    for (int n = landen->steps - 1; n >= 0; n--)
+    {
+        // w = (1 + v) * w / (1 + v * w^2)
+        const double v = landen->v[n];
+        const IirDesign_Complex den = { 1 + v * (w.re * w.re - w.im * w.im), v * 2 * w.re * w.im };
+        w = AudioIirDesign_Div(AudioIirDesign_Scale(w, 1 + v), den);
+    }
+    return w;
+}
+
+/**
+ * @brief elliptic lowpass prototype of the given order, passband ripple and stopband attenuation in dB
+ *
+ * The selectivity follows from the order, the stopband starts at 1/k rad/s.
+ */
+static void AudioIirDesign_EllipticPrototype(IirDesign_Prototype* proto, int order, double ripple, double atten)
+{
+    const double ep = sqrt(pow(10, ripple / 10) - 1);
+    const double es = sqrt(pow(10, atten / 10) - 1);
+    const double k1 = ep / es;
+    const double k1p = sqrt(1 - k1 * k1);
+    IirDesign_Landen landen;
+
+    proto->order = order;
+    proto->pairs = order / 2;
+    proto->zeros = order / 2;
+    proto->gain = (order & 1) ? 1 : 1 / sqrt(1 + ep * ep);
+
+    // degree equation, modulus k of the prototype from the modulus k1 of the specification
+    AudioIirDesign_Landen(k1p, &landen);
+    double kp = pow(k1p, order);
+    for (int i = 0; i < proto->pairs; i++)
+    {
+        const double sn = AudioIirDesign_Elliptic((IirDesign_Complex) { (2.0 * i + 1) / order, 0 }, &landen, false).re;
+        kp *= sn * sn * sn * sn;
+    }
+    const double k = sqrt(1 - kp * kp);
+
+    // v0 = asn(j/ep, k1) / (j * order), the argument stays imaginary throughout the inverse Landen steps
+    AudioIirDesign_Landen(k1, &landen);
+    double y = 1 / ep;
+    for (int n = 0; n < landen.steps; n++)
+    {
+        const double v1 = n == 0 ? k1 : landen.v[n - 1];
+        y = y / (1 + sqrt(1 + y * y * v1 * v1)) * 2 / (1 + landen.v[n]);
+    }
+    const double v0 = 2 / M_PI * asinh(y) / order;
+
+    AudioIirDesign_Landen(k, &landen);
+    for (int i = 0; i < proto->pairs; i++)
+    {
+        const double ui = (2.0 * i + 1) / order;
+        proto->zero[i] = 1 / (k * AudioIirDesign_Elliptic((IirDesign_Complex) { ui, 0 }, &landen, true).re);
+        // pole = j * cd((ui - j * v0) * K, k)
+        const IirDesign_Complex w = AudioIirDesign_Elliptic((IirDesign_Complex) { ui, -v0 }, &landen, true);
+        proto->pole[i] = (IirDesign_Complex) { -w.im, w.re };
+    }
+    if (order & 1)
+    {
+        // pole = j * sn(j * v0 * K, k)
+        const IirDesign_Complex w = AudioIirDesign_Elliptic((IirDesign_Complex) { 0, v0 }, &landen, false);
+        proto->pole[proto->pairs] = (IirDesign_Complex) { -w.im, 0 };
+    }
+}
+
+static void AudioIirDesign_ButterworthPrototype(IirDesign_Prototype* proto, int order)
+{
+    proto->order = order;
+    proto->pairs = order / 2;
+    proto->zeros = 0;
+    proto->gain = 1;
+
+    for (int i = 0; i < proto->pairs; i++)
+    {
+        const double theta = M_PI / 2 + M_PI * (2 * i + 1) / (2 * order);
+        proto->pole[i] = (IirDesign_Complex) { cos(theta), sin(theta) };
+    }
+    if (order & 1)
+    {
+        proto->pole[proto->pairs] = (IirDesign_Complex) { -1, 0 };
+    }
+}
+
+/**
+ * @brief maps an analog root of the prewarped filter to the z plane and stores it
+ */
+static void AudioIirDesign_AddRoot(IirDesign_Roots* roots, IirDesign_Complex s, bool real)
+{
+    const IirDesign_Complex one = { 1, 0 };
+    const IirDesign_Complex z = AudioIirDesign_Div(AudioIirDesign_Add(one, s), AudioIirDesign_Sub(one, s));
+
+    if (real)
+    {
+        roots->real[roots->reals++] = z.re;
+    }
+    else
+    {
+        roots->pair[roots->pairs++] = (IirDesign_Complex) { z.re, fabs(z.im) };
+    }
+}
+
+/**
+ * @brief lowpass or bandpass transformation of a prototype root r, the root is real if is_real is set
+ *
+ * The bandpass turns each root into two, a real root may become a conjugate pair of which one is stored.
+ */
+static void AudioIirDesign_TransformRoot(IirDesign_Roots* roots, IirDesign_Complex r, bool is_real, double wl, double wh)
+{
+    if (wl == 0)
+    {
+        AudioIirDesign_AddRoot(roots, AudioIirDesign_Scale(r, wh), is_real);
+    }
+    else
+    {
+        // roots of s^2 - r * bw * s + w0^2
+        const IirDesign_Complex rb = AudioIirDesign_Scale(r, wh - wl);
+        const IirDesign_Complex d = AudioIirDesign_Sqrt(AudioIirDesign_Sub(AudioIirDesign_Mul(rb, rb), (IirDesign_Complex) { 4 * wl * wh, 0 }));
+        const IirDesign_Complex s1 = AudioIirDesign_Scale(AudioIirDesign_Add(rb, d), 0.5);
+        const IirDesign_Complex s2 = AudioIirDesign_Scale(AudioIirDesign_Sub(rb, d), 0.5);
+
+        if (is_real && d.im != 0)
+        {
+            AudioIirDesign_AddRoot(roots, s1, false);
+        }
+        else
+        {
+            AudioIirDesign_AddRoot(roots, s1, is_real);
+            AudioIirDesign_AddRoot(roots, s2, is_real);
+        }
+    }
+}
+
+static double AudioIirDesign_SectionMagnitude(const IirDesign_Section* sec, double c1, double s1, double c2, double s2)
+{
+    const double nr = sec->b[0] + sec->b[1] * c1 + sec->b[2] * c2;
+    const double ni = sec->b[1] * s1 + sec->b[2] * s2;
+    const double dr = sec->a[0] + sec->a[1] * c1 + sec->a[2] * c2;
+    const double di = sec->a[1] * s1 + sec->a[2] * s2;
+    return sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+}
+
+/**
+ * @brief designs the filter described by spec for the given sample rate
+ *
+ * Each pole pair gets the nearest zero pair, starting with the pole pair closest to the unit circle.
+ * The biquads are ordered by increasing pole radius, so the most resonant one comes last, and each partial
+ * cascade is scaled to the peak gain of the whole filter. This is the same structure as used for the
+ * biquads generated from the lattice filters, see support/host/iir_biquad_gen.c
+ *
+ * @param pCoeffs IIR_DESIGN_NUM_STAGES_MAX * 5 coefficients, { b0, b1, b2, a1, a2 } per biquad as used by
+ * arm_biquad_cascade_df2T_f32()
+ * @return number of biquads, 0 if the specification cannot be designed
+ */
+uint8_t AudioIirDesign_Biquads(const IIR_DesignSpec* spec, float32_t sample_rate, float32_t* pCoeffs)
+{
+    const int stages_max = spec->f_low == 0 ? 2 * IIR_DESIGN_NUM_STAGES_MAX : IIR_DESIGN_NUM_STAGES_MAX;
+
+    if (spec->order == 0 || spec->order > stages_max || spec->f_high >= sample_rate / 2 || spec->f_low >= spec->f_high
+            || (spec->type == IIR_DESIGN_ELLIPTIC && (spec->ripple == 0 || spec->atten * 10 <= spec->ripple)))
+    {
+        return 0;
+    }
+
+    IirDesign_Prototype proto;
+    if (spec->type == IIR_DESIGN_ELLIPTIC)
+    {
+        AudioIirDesign_EllipticPrototype(&proto, spec->order, spec->ripple / 10.0, spec->atten);
+    }
+    else
+    {
+        AudioIirDesign_ButterworthPrototype(&proto, spec->order);
+    }
+
+    // prewarped passband edges for the bilinear transform s = (z - 1) / (z + 1)
+    const double wl = tan(M_PI * spec->f_low / sample_rate);
+    const double wh = tan(M_PI * spec->f_high / sample_rate);
+
+    IirDesign_Roots poles = { .pairs = 0, .reals = 0 };
+    IirDesign_Roots zeros = { .pairs = 0, .reals = 0 };
+    for (int i = 0; i < proto.pairs; i++)
+    {
+        AudioIirDesign_TransformRoot(&poles, proto.pole[i], false, wl, wh);
+    }
+    if (proto.order & 1)
+    {
+        AudioIirDesign_TransformRoot(&poles, proto.pole[proto.pairs], true, wl, wh);
+    }
+    for (int i = 0; i < proto.zeros; i++)
+    {
+        AudioIirDesign_TransformRoot(&zeros, (IirDesign_Complex) { 0, proto.zero[i] }, false, wl, wh);
+    }
+    // zeros at infinity end up at fs/2, and at DC for a bandpass
+    for (int i = 2 * proto.zeros; i < proto.order; i++)
+    {
+        if (wl != 0)
+        {
+            zeros.real[zeros.reals++] = 1;
+        }
+        zeros.real[zeros.reals++] = -1;
+    }
+
+    // group the roots into sections, real roots are combined into pairs where possible
+    typedef struct { IirDesign_Complex r[2]; int num; bool used; } Group;
+    Group zg[IIR_DESIGN_NUM_STAGES_MAX + 1], pg[IIR_DESIGN_NUM_STAGES_MAX + 1];
+    int zg_num = 0, pg_num = 0;
+
+    for (int i = 0; i < zeros.pairs; i++)
+    {
+        zg[zg_num++] = (Group) { { zeros.pair[i], { zeros.pair[i].re, -zeros.pair[i].im } }, 2, false };
+    }
+    for (int i = 0; i < zeros.reals; i += 2)
+    {
+        zg[zg_num++] = (Group) { { { zeros.real[i], 0 }, { i + 1 < zeros.reals ? zeros.real[i + 1] : 0, 0 } }, i + 1 < zeros.reals ? 2 : 1, false };
+    }
+    for (int i = 0; i < poles.pairs; i++)
+    {
+        pg[pg_num++] = (Group) { { poles.pair[i], { poles.pair[i].re, -poles.pair[i].im } }, 2, false };
+    }
+    for (int i = 0; i < poles.reals; i += 2)
+    {
+        pg[pg_num++] = (Group) { { { poles.real[i], 0 }, { i + 1 < poles.reals ? poles.real[i + 1] : 0, 0 } }, i + 1 < poles.reals ? 2 : 1, false };
+    }
+    if (zg_num != pg_num || pg_num > IIR_DESIGN_NUM_STAGES_MAX)
+    {
+        return 0;
+    }
+
+    IirDesign_Section sections[IIR_DESIGN_NUM_STAGES_MAX];
+    for (int s = 0; s < pg_num; s++)
+    {
+        // the pole group closest to the unit circle, which is not yet used
+        int p = -1;
+        for (int i = 0; i < pg_num; i++)
+        {
+            if (pg[i].used == false && (p < 0 || hypot(pg[i].r[0].re, pg[i].r[0].im) > hypot(pg[p].r[0].re, pg[p].r[0].im)))
+            {
+                p = i;
+            }
+        }
+        // the nearest zero group, a first order pole group takes the first order zero group
+        int z = -1;
+        for (int i = 0; i < zg_num; i++)
+        {
+            if (zg[i].used == false && (pg[p].num == 1) == (zg[i].num == 1))
+            {
+                const IirDesign_Complex dist = AudioIirDesign_Sub(zg[i].r[0], pg[p].r[0]);
+                const IirDesign_Complex dist_z = z < 0 ? dist : AudioIirDesign_Sub(zg[z].r[0], pg[p].r[0]);
+                if (z < 0 || hypot(dist.re, dist.im) < hypot(dist_z.re, dist_z.im))
+                {
+                    z = i;
+                }
+            }
+        }
+        if (z < 0)
+        {
+            return 0;
+        }
+        pg[p].used = zg[z].used = true;
+
+        // sections are filled from the end, the most resonant one is processed last
+        IirDesign_Section* sec = &sections[pg_num - 1 - s];
+        const Group* pz = &zg[z];
+        const Group* pp = &pg[p];
+        sec->radius = hypot(pp->r[0].re, pp->r[0].im);
+        sec->b[0] = 1;
+        sec->a[0] = 1;
+        if (pp->num == 1)
+        {
+            sec->b[1] = -pz->r[0].re; sec->b[2] = 0;
+            sec->a[1] = -pp->r[0].re; sec->a[2] = 0;
+        }
+        else
+        {
+            sec->b[1] = -(pz->r[0].re + pz->r[1].re); sec->b[2] = AudioIirDesign_Mul(pz->r[0], pz->r[1]).re;
+            sec->a[1] = -(pp->r[0].re + pp->r[1].re); sec->a[2] = AudioIirDesign_Mul(pp->r[0], pp->r[1]).re;
+        }
+    }
+
+    // peak gains of all partial cascades, section s gets scaled by partial_peak[s - 1] / partial_peak[s]
+    double partial_peak[IIR_DESIGN_NUM_STAGES_MAX] = { 0 };
+    for (int k = 0; k < IIR_DESIGN_GRID_POINTS; k++)
+    {
+        const double w = M_PI * k / (IIR_DESIGN_GRID_POINTS - 1);
+        const double c1 = cos(w), s1 = -sin(w), c2 = cos(2 * w), s2 = -sin(2 * w);
+        double mag = 1;
+        for (int s = 0; s < pg_num; s++)
+        {
+            mag *= AudioIirDesign_SectionMagnitude(&sections[s], c1, s1, c2, s2);
+            partial_peak[s] = fmax(partial_peak[s], mag);
+        }
+    }
+
+    // the gain of the prototype is the gain at DC for a lowpass and at the centre frequency for a bandpass
+    const double w_ref = 2 * atan(sqrt(wl * wh));
+    double ref = 1;
+    for (int s = 0; s < pg_num; s++)
+    {
+        ref *= AudioIirDesign_SectionMagnitude(&sections[s], cos(w_ref), -sin(w_ref), cos(2 * w_ref), -sin(2 * w_ref));
+    }
+    const double peak = partial_peak[pg_num - 1] * proto.gain / ref;
+
+    for (int s = 0; s < pg_num; s++)
+    {
+        const double scale = (s == 0 ? peak : partial_peak[s - 1]) / partial_peak[s];
+        float32_t* c = &pCoeffs[5 * s];
+        c[0] = sections[s].b[0] * scale;
+        c[1] = sections[s].b[1] * scale;
+        c[2] = sections[s].b[2] * scale;
+        c[3] = -sections[s].a[1];
+        c[4] = -sections[s].a[2];
+    }
+
+    return pg_num;
+}
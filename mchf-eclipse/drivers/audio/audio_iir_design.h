@@ -0,0 +1,42 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     audio_iir_design.h                                              **
+ **  Description:   Elliptic and Butterworth IIR lowpass/bandpass design            **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#ifndef DRIVERS_AUDIO_AUDIO_IIR_DESIGN_H_
+#define DRIVERS_AUDIO_AUDIO_IIR_DESIGN_H_
+
+#include "uhsdr_types.h"
+#include "arm_math.h"
+
+enum
+{
+    IIR_DESIGN_ELLIPTIC = 0,
+    IIR_DESIGN_BUTTERWORTH,
+};
+
+// a bandpass has twice the order of its lowpass prototype, both need at most this number of biquads
+#define IIR_DESIGN_NUM_STAGES_MAX 6
+
+// specification of an IIR lowpass (f_low = 0) or bandpass filter, the sample rate is given at design time
+typedef struct
+{
+    uint16_t f_low;     // lower passband edge in Hz, 0 for a lowpass
+    uint16_t f_high;    // upper passband edge in Hz
+    uint8_t order;      // order of the lowpass prototype
+    uint8_t type;       // IIR_DESIGN_ELLIPTIC or IIR_DESIGN_BUTTERWORTH
+    uint8_t ripple;     // passband ripple in 0.1dB (elliptic only), the passband edges are at -ripple, -3dB for Butterworth
+    uint8_t atten;      // stopband attenuation in dB (elliptic only)
+} IIR_DesignSpec;
+
+uint8_t AudioIirDesign_Biquads(const IIR_DesignSpec* spec, float32_t sample_rate, float32_t* pCoeffs);
+
+#endif /* DRIVERS_AUDIO_AUDIO_IIR_DESIGN_H_ */
@@ -16,6 +16,7 @@
 #include "uhsdr_board.h"
 #include "profiling.h"
 #include "uhsdr_hw_i2s.h"
+#include "ring_buffer.h"
 
 #include "audio_driver.h"
 
@@ -34,6 +35,7 @@ __UHSDR_DMAMEM __IO dma_audio_buffer_t audio_buf[DMA_AUDIO_NUM];
 
 
 static uint32_t szbuf;
+static uint32_t block_cycles; // cpu cycles available for processing a single audio block
 
 
 #ifdef USE_24_BITS
@@ -57,53 +59,135 @@ void UhsdrHwI2s_Codec_ClearTxDmaBuffer()
     memset((void*)&audio_buf[CODEC_IQ_IDX].out, 0, sizeof(audio_buf[CODEC_IQ_IDX].out));
 }
 
-static void MchfHw_Codec_HandleBlock(uint16_t which)
+/*
+ * The audio blocks travel in a circle between the DMA interrupt and the worker interrupt:
+ * the DMA interrupt takes a processed block from the done ring, copies its output to the codec
+ * and fills it with the new input, then puts it into the pending ring and triggers the worker.
+ * The worker processes all pending blocks and puts them into the done ring.
+ * Each ring has exactly one producer and one consumer, so no locking is needed.
+ */
+typedef struct
 {
+    audio_data_t in[BUFF_LEN/2];
+    audio_data_t out[BUFF_LEN/2];
+#if CODEC_ANA_IDX != CODEC_IQ_IDX
+    audio_data_t audio_out[BUFF_LEN/2];    // during TX the analog codec gets its own output
+#endif
+    bool is_tx;
+} audio_block_t;
+
+RING_BUFFER_BLOCK_DEFINE(AudioBlockRing, audio_block_t, AUDIO_BLOCK_NUM)
+
+static audio_block_t audio_blocks[AUDIO_BLOCK_NUM];
+static AudioBlockRing audio_pending;     // filled by the DMA interrupt, emptied by the worker
+static AudioBlockRing audio_done;        // filled by the worker, emptied by the DMA interrupt
+
+// an interrupt which is not used by the hardware, triggered by software to run the audio processing
+#define AUDIO_WORKER_IRQn               ETH_WKUP_IRQn
+#define AudioWorker_IRQHandler          ETH_WKUP_IRQHandler
+// below the codec DMA interrupt, above everything else but usb device and systick
+#define AUDIO_WORKER_IRQ_PRIO           3
+
+static void UhsdrHwI2s_AudioBlocksReset()
+{
+    AudioBlockRing_Init(&audio_pending);
+    AudioBlockRing_Init(&audio_done);
+
+    // all blocks start as processed silence, this gives the worker its slack
+    memset(audio_blocks, 0, sizeof(audio_blocks));
+    for (uint32_t idx = 0; idx < AUDIO_BLOCK_NUM; idx++)
+    {
+        AudioBlockRing_Put(&audio_done, &audio_blocks[idx]);
+    }
+}
+
+/**
+ * @brief runs the audio processing for all blocks handed over by the DMA interrupt
+ */
+void AudioWorker_IRQHandler(void)
+{
+    audio_block_t* block;
+
+    while (AudioBlockRing_Get(&audio_pending, &block))
+    {
 #ifdef PROFILE_EVENTS
-    // we stop during interrupt
-    // at the end we start again
-    // profileCycleCount_stop();
-    profileTimedEventStart(ProfileAudioInterrupt);
+        profileTimedEventStart(ProfileAudioInterrupt);
+#endif
+#ifdef EXEC_PROFILING
+        // Profiling pin (high level)
+        GPIOE->BSRRL = GPIO_Pin_10;
 #endif
 
-    static audio_data_t *src, *dst, sz;
+#if CODEC_ANA_IDX != CODEC_IQ_IDX
+        audio_data_t* audioDst = block->is_tx ? block->audio_out : block->out;
+#else
+        audio_data_t* audioDst = block->out;
+#endif
+        AudioDriver_I2SCallback(block->in, block->out, audioDst, BUFF_LEN/2);
 
 #ifdef EXEC_PROFILING
-    // Profiling pin (high level)
-    GPIOE->BSRRL = GPIO_Pin_10;
+        // Profiling pin (low level)
+        GPIOE->BSRRH = GPIO_Pin_10;
+#endif
+#ifdef PROFILE_EVENTS
+        profileTimedEventStop(ProfileAudioInterrupt);
+#endif
+
+        AudioBlockRing_Put(&audio_done, block);
+    }
+}
+
+static void MchfHw_Codec_HandleBlock(uint16_t which)
+{
+#ifdef PROFILE_EVENTS
+    // if we get the same half twice in a row, the interrupt for the other half was lost
+    // so a whole block was skipped
+    static uint16_t last_which = 0xffff;
+    if (which == last_which)
+    {
+        eventProfile.audio_deadline_missed++;
+    }
+    last_which = which;
 #endif
 
     ts.audio_int_counter++;   // generating a time base for encoder handling
 
     // Transfer complete interrupt
     // Point to 2nd half of buffers
-    sz = szbuf/2;
-    uint16_t offset = which == 0?sz:0;
+    const uint32_t sz = szbuf/2;
+    const uint16_t offset = which == 0?sz:0;
+
+    audio_block_t* block;
 
-    if (ts.txrx_mode != TRX_MODE_TX)
+    if (AudioBlockRing_Get(&audio_done, &block))
     {
-        src = (audio_data_t*)&audio_buf[CODEC_IQ_IDX].in[offset];
-        dst = (audio_data_t*)&audio_buf[CODEC_ANA_IDX].out[offset];
+        if (block->is_tx == false)
+        {
+            memcpy((void*)&audio_buf[CODEC_ANA_IDX].out[offset], block->out, sizeof(block->out));
+        }
+        else
+        {
+            memcpy((void*)&audio_buf[CODEC_IQ_IDX].out[offset], block->out, sizeof(block->out));
+#if CODEC_ANA_IDX != CODEC_IQ_IDX
+            memcpy((void*)&audio_buf[CODEC_ANA_IDX].out[offset], block->audio_out, sizeof(block->audio_out));
+#endif
+        }
+
+        block->is_tx = ts.txrx_mode == TRX_MODE_TX;
+        const uint32_t in_idx = block->is_tx ? CODEC_ANA_IDX : CODEC_IQ_IDX;
+        memcpy(block->in, (void*)&audio_buf[in_idx].in[offset], sizeof(block->in));
+
+        AudioBlockRing_Put(&audio_pending, block);
+        HAL_NVIC_SetPendingIRQ(AUDIO_WORKER_IRQn);
     }
     else
     {
-        src = (audio_data_t*)&audio_buf[CODEC_ANA_IDX].in[offset];
-        dst = (audio_data_t*)&audio_buf[CODEC_IQ_IDX].out[offset];
-    }
-
-    // Handle
-    AudioDriver_I2SCallback(src, dst, (audio_data_t*)&audio_buf[CODEC_ANA_IDX].out[offset], sz);
-
-#ifdef EXEC_PROFILING
-    // Profiling pin (low level)
-    GPIOE->BSRRH = GPIO_Pin_10;
-#endif
+        // the worker is more than AUDIO_BLOCK_NUM-1 blocks behind, the input block is dropped
+        // and the codec repeats old audio data
 #ifdef PROFILE_EVENTS
-    // we stopped during interrupt
-    // now we start again
-    // profileCycleCount_start();
-    profileTimedEventStop(ProfileAudioInterrupt);
+        eventProfile.audio_deadline_missed++;
 #endif
+    }
 }
 
 #ifdef UI_BRD_MCHF
@@ -148,6 +232,12 @@ void HAL_SAI_RxHalfCpltCallback(SAI_HandleTypeDef *hi2s)
 void UhsdrHwI2s_Codec_StartDMA()
 {
     szbuf = BUFF_LEN;
+    // each interrupt processes half of the buffer, i.e. szbuf/4 stereo samples
+    block_cycles = (SystemCoreClock / IQ_SAMPLE_RATE) * (szbuf / 4);
+
+    UhsdrHwI2s_AudioBlocksReset();
+    HAL_NVIC_SetPriority(AUDIO_WORKER_IRQn, AUDIO_WORKER_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(AUDIO_WORKER_IRQn);
 
 #ifdef UI_BRD_MCHF
     HAL_I2SEx_TransmitReceive_DMA(&hi2s3,(uint16_t*)audio_buf[0].out,(uint16_t*)audio_buf[0].in,szbuf);
@@ -166,6 +256,14 @@ void UhsdrHwI2s_Codec_StartDMA()
 }
 
 
+/**
+ * @brief cpu cycles between two audio interrupts, i.e. the processing time budget for one audio block
+ */
+uint32_t UhsdrHwI2s_GetBlockCycles()
+{
+    return block_cycles;
+}
+
 void UhsdrHwI2s_Codec_StopDMA(void)
 {
 #ifdef UI_BRD_MCHF
@@ -15,13 +15,30 @@
 #ifndef __MCHF_HW_I2S_H
 #define __MCHF_HW_I2S_H
 
-// #define BUFF_LEN (2*(32*2)) // == 128
-#define BUFF_LEN 128
+/*
+ * IQ_BLOCK_SIZE is the number of LR samples per audio interrupt, it can be chosen at build time
+ * (make IQ_BLOCK_SIZE=128). Larger blocks pay the per block overhead less often and lower the cpu load,
+ * at the expense of latency. 32 keeps the latency lowest (i.e. for CW QSK) and is the default.
+ */
+#ifndef IQ_BLOCK_SIZE
+#define IQ_BLOCK_SIZE 32
+#endif
+
+#if IQ_BLOCK_SIZE != 32 && IQ_BLOCK_SIZE != 64 && IQ_BLOCK_SIZE != 128
+#error "IQ_BLOCK_SIZE has to be 32, 64 or 128"
+#endif
 
 /*
- * BUFF_LEN is derived from 2* 32 LR Samples per Audio-Interrupt (== 64 * int16_t )
+ * BUFF_LEN is derived from 2* IQ_BLOCK_SIZE LR Samples per Audio-Interrupt (== 128 * int16_t for 32 LR samples)
  * since we get half of the buffer in each DMA Interrupt for processing
  */
+#define BUFF_LEN (2*(IQ_BLOCK_SIZE*2))
+
+/*
+ * The audio interrupt runs at 1500Hz with the default block size. Counters driven by the audio interrupt
+ * count in these 1/1500s ticks for all block sizes, every interrupt advances them by AUDIO_TICKS_PER_BLOCK.
+ */
+#define AUDIO_TICKS_PER_BLOCK (IQ_BLOCK_SIZE/32)
 
 typedef struct
 {
@@ -36,10 +53,19 @@ typedef struct
 #define DMA_AUDIO_NUM 2
 #endif
 
+/*
+ * The DMA interrupt only hands the blocks over, the audio processing runs in a lower priority
+ * worker interrupt. AUDIO_BLOCK_NUM blocks are in flight between both, so the worker may fall
+ * AUDIO_BLOCK_NUM-1 blocks behind (i.e. after a long NR or FreeDV block) without audio dropouts.
+ * Each block adds IQ_BLOCK_SIZE samples of latency.
+ */
+#define AUDIO_BLOCK_NUM 2
+
 void UhsdrHwI2s_Codec_StartDMA();
 void UhsdrHwI2s_Codec_StopDMA();
 
 void UhsdrHwI2s_Codec_ClearTxDmaBuffer();
+uint32_t UhsdrHwI2s_GetBlockCycles();
 
 #endif
 
@@ -386,11 +386,12 @@ void CwDecode_RxProcessor(float32_t * const src, int16_t blockSize)
 	{
 		raw_signal_buffer[sample_counter] = src[idx];
 		sample_counter++;
-	}
-	if (sample_counter >= cw_decoder_config.blocksize)
-	{
-		CW_Decode_exe();
-		sample_counter = 0;
+		// audio blocks may be larger than the decoder block, so check on every sample
+		if (sample_counter >= cw_decoder_config.blocksize)
+		{
+			CW_Decode_exe();
+			sample_counter = 0;
+		}
 	}
 }
 
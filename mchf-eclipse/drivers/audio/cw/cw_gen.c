@@ -41,6 +41,7 @@
 #include "cw_gen.h"
 #include "cat_driver.h"
 #include "ui_driver.h"
+#include "uhsdr_hw_i2s.h"
 
 // FIXME: will need to be changed to  "digimodes.h" later
 #include "rtty.h"
@@ -67,6 +68,8 @@
 // 1 => 2.7ms , 5 steps of 0.66ms required.
 // 3 => 8ms, 13 steps
 #define CW_SMOOTH_STEPS		9	// 1 step = 0.6ms; 13 for 8ms, 9 for 5.4 ms, for internal keyer
+// the keyer runs once per audio block, with larger blocks a step covers AUDIO_TICKS_PER_BLOCK * 0.6ms
+#define CW_SMOOTH_BLOCKS	(CW_SMOOTH_STEPS/AUDIO_TICKS_PER_BLOCK)
 
 
 typedef struct PaddleState
@@ -403,15 +406,16 @@ void CwGen_SetSpeed()
 	int32_t weight_corr = ((int32_t)ts.cw_keyer_weight-100) * dit_time/100;
 
 	// we add the correction value to both dit and dah and subtract from pause. dah gets less change proportionally because of this
-	ps.dit_time = (dit_time + weight_corr)/100;
-	ps.dah_time = (dah_time + weight_corr)/100;
-	ps.pause_time = (pause_time - weight_corr)/100;
-	ps.space_time = space_time / 100;
+	// all timers count audio blocks, i.e. 1/1500s for the standard block size
+	ps.dit_time = (dit_time + weight_corr)/(100*AUDIO_TICKS_PER_BLOCK);
+	ps.dah_time = (dah_time + weight_corr)/(100*AUDIO_TICKS_PER_BLOCK);
+	ps.pause_time = (pause_time - weight_corr)/(100*AUDIO_TICKS_PER_BLOCK);
+	ps.space_time = space_time / (100*AUDIO_TICKS_PER_BLOCK);
 }
 
 static void CwGen_SetBreakTime()
 {
-	ps.break_timer = ts.cw_rx_delay*50 + 1;      // break timer value
+	ps.break_timer = (ts.cw_rx_delay*50)/AUDIO_TICKS_PER_BLOCK + 1;      // break timer value
 }
 
 /**
@@ -983,7 +987,7 @@ static bool CwGen_ProcessIambic(float32_t *i_buffer,float32_t *q_buffer,ulong bl
 					CwGen_RemoveClickOnRisingEdge(i_buffer,q_buffer,blockSize);
 				}
 				// Smooth end of element
-				if(ps.key_timer < CW_SMOOTH_STEPS)
+				if(ps.key_timer < CW_SMOOTH_BLOCKS)
 				{
 					CwGen_RemoveClickOnFallingEdge(i_buffer,q_buffer,blockSize);
 				}
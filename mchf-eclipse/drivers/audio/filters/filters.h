@@ -28,8 +28,12 @@ extern const arm_fir_decimate_instance_f32 FirRxDecimate_sideband_supp;
 extern const arm_fir_decimate_instance_f32 FirZoomFFTDecimate[6];
 extern const arm_fir_decimate_instance_f32 FirRxDecimateMinLPF;
 extern const arm_fir_interpolate_instance_f32 FirRxInterpolate;
-extern const arm_fir_interpolate_instance_f32 FirRxInterpolate_4_5k;
-extern const arm_fir_interpolate_instance_f32 FirRxInterpolate_4_10k;
+extern const arm_fir_interpolate_instance_f32 FirRxInterpolate_5k;
+extern const arm_fir_interpolate_instance_f32 FirRxInterpolate_8k;
+extern const arm_fir_interpolate_instance_f32 FirRxInterpolate_8k5;
+extern const arm_fir_interpolate_instance_f32 FirRxInterpolate_9k;
+extern const arm_fir_interpolate_instance_f32 FirRxInterpolate_9k5;
+extern const arm_fir_interpolate_instance_f32 FirRxInterpolate_10k;
 extern const arm_fir_interpolate_instance_f32 FirRxInterpolate10KHZ;
 extern const arm_fir_instance_f32 Fir_TxFreeDV_Interpolate;
 extern const float Fir_Rx_FreeDV_Interpolate_Coeffs[24];
@@ -136,10 +140,84 @@ extern const arm_iir_lattice_instance_f32 IIR_8k_LPF;
 extern const arm_iir_lattice_instance_f32 IIR_8k5_hpf;
 extern const arm_iir_lattice_instance_f32 IIR_9k5_LPF;
 extern const arm_iir_lattice_instance_f32 IIR_9k_LPF;
-extern const arm_iir_lattice_instance_f32 IIR_aa_5k;
-extern const arm_iir_lattice_instance_f32 IIR_aa_10k;
-extern const arm_iir_lattice_instance_f32 IIR_aa_8k;
-extern const arm_iir_lattice_instance_f32 IIR_aa_8k5;
-extern const arm_iir_lattice_instance_f32 IIR_aa_9k;
-extern const arm_iir_lattice_instance_f32 IIR_aa_9k5;
+
+// an RX audio IIR lattice filter converted into cascaded second order sections for arm_biquad_cascade_df2T_f32()
+// see iir_rx_biquad.c, which is generated by support/host/iir_biquad_gen
+typedef struct
+{
+    const arm_iir_lattice_instance_f32* lattice;
+    const uint8_t numStages;
+    const float32_t* pCoeffs;   // numStages * { b0, b1, b2, a1, a2 }
+} IIR_BiquadDescriptor;
+
+// a lattice filter with N stages has (N+1)/2 biquads, we use at most 10 lattice stages at the moment
+#define IIR_RX_BIQUAD_NUM_STAGES_MAX 6
+
+extern const IIR_BiquadDescriptor IirRxBiquadInfo[];
+extern const uint16_t IirRxBiquadInfo_num;
+
+// specifications of the RX audio IIR filters for the runtime designer, see iir_rx_design.c
+extern const IIR_DesignSpec IIR_300hz_500_spec;
+extern const IIR_DesignSpec IIR_300hz_550_spec;
+extern const IIR_DesignSpec IIR_300hz_600_spec;
+extern const IIR_DesignSpec IIR_300hz_650_spec;
+extern const IIR_DesignSpec IIR_300hz_700_spec;
+extern const IIR_DesignSpec IIR_300hz_750_spec;
+extern const IIR_DesignSpec IIR_300hz_800_spec;
+extern const IIR_DesignSpec IIR_300hz_850_spec;
+extern const IIR_DesignSpec IIR_300hz_900_spec;
+extern const IIR_DesignSpec IIR_300hz_950_spec;
+extern const IIR_DesignSpec IIR_500hz_550_spec;
+extern const IIR_DesignSpec IIR_500hz_650_spec;
+extern const IIR_DesignSpec IIR_500hz_750_spec;
+extern const IIR_DesignSpec IIR_500hz_850_spec;
+extern const IIR_DesignSpec IIR_500hz_950_spec;
+extern const IIR_DesignSpec IIR_1k4_LPF_spec;
+extern const IIR_DesignSpec IIR_1k4_BPF_spec;
+extern const IIR_DesignSpec IIR_1k6_LPF_spec;
+extern const IIR_DesignSpec IIR_1k6_BPF_spec;
+extern const IIR_DesignSpec IIR_1k8_1k125_spec;
+extern const IIR_DesignSpec IIR_1k8_1k275_spec;
+extern const IIR_DesignSpec IIR_1k8_1k425_spec;
+extern const IIR_DesignSpec IIR_1k8_1k575_spec;
+extern const IIR_DesignSpec IIR_1k8_1k725_spec;
+extern const IIR_DesignSpec IIR_1k8_LPF_spec;
+extern const IIR_DesignSpec IIR_2k1_LPF_spec;
+extern const IIR_DesignSpec IIR_2k1_BPF_spec;
+extern const IIR_DesignSpec IIR_2k3_1k275_spec;
+extern const IIR_DesignSpec IIR_2k3_1k412_spec;
+extern const IIR_DesignSpec IIR_2k3_1k562_spec;
+extern const IIR_DesignSpec IIR_2k3_1k712_spec;
+extern const IIR_DesignSpec IIR_2k3_LPF_spec;
+extern const IIR_DesignSpec IIR_2k5_LPF_spec;
+extern const IIR_DesignSpec IIR_2k5_BPF_spec;
+extern const IIR_DesignSpec IIR_2k7_LPF_spec;
+extern const IIR_DesignSpec IIR_2k7_BPF_spec;
+extern const IIR_DesignSpec IIR_2k9_LPF_spec;
+extern const IIR_DesignSpec IIR_2k9_BPF_spec;
+extern const IIR_DesignSpec IIR_3k2_LPF_spec;
+extern const IIR_DesignSpec IIR_3k2_BPF_spec;
+extern const IIR_DesignSpec IIR_3k4_LPF_spec;
+extern const IIR_DesignSpec IIR_3k4_BPF_spec;
+extern const IIR_DesignSpec IIR_3k6_LPF_spec;
+extern const IIR_DesignSpec IIR_3k6_BPF_spec;
+extern const IIR_DesignSpec IIR_3k8_LPF_spec;
+extern const IIR_DesignSpec IIR_3k8_BPF_spec;
+extern const IIR_DesignSpec IIR_4k_LPF_spec;
+extern const IIR_DesignSpec IIR_4k2_LPF_spec;
+extern const IIR_DesignSpec IIR_4k4_LPF_spec;
+extern const IIR_DesignSpec IIR_4k6_LPF_spec;
+extern const IIR_DesignSpec IIR_4k8_LPF_spec;
+extern const IIR_DesignSpec IIR_5k_LPF_spec;
+extern const IIR_DesignSpec IIR_6k_LPF_spec;
+extern const IIR_DesignSpec IIR_7k5_LPF_spec;
+extern const IIR_DesignSpec IIR_10k_LPF_spec;
+
+// FilterPathInfo refers to the RX audio IIR filters through IIR_RX(), which selects the specification
+// with USE_RX_IIR_DESIGNER, so neither the lattice nor the biquad coefficient tables get linked
+#ifdef USE_RX_IIR_DESIGNER
+#define IIR_RX(name) (&name##_spec)
+#else
+#define IIR_RX(name) (&name)
+#endif
 #endif
@@ -65,46 +65,370 @@ const arm_fir_interpolate_instance_f32 FirRxInterpolate=
     }
 };
 
-/*#####################################################
- *
- * Interpolation filter with 4 taps
- * 4 taps minimum for the ARM function to work
- * two versions:
- * 1.) for filter bandwidths between 3k4 and 4k8
- * 		--> 5kHz stop frequency
- * 2.) for filter bandwidths between 8k0 and 10k
- * 		--> 10kHz stop frequency
- *
- * these "filters" do not filter much with 4 taps . . .
- * FIR 4 taps, Fstop 5kHz / 10kHz, Rectangular
- * designed with Iowa Hills FIR Filter Designer
- * DD4WH 2016_03_11
- *
- * ####################################################
- */
+/**************************************************************
+
+Interpolation filters with the antialias lowpass built in
+
+These replace the 4 tap interpolation filters which needed an additional
+6th order elliptic IIR antialias filter running at 48ksps. The polyphase
+implementation of arm_fir_interpolate_f32 only computes the taps which see
+input samples, i.e. taps / interpolation rate multiplications per output sample.
+As with the other filters here .phaseLength holds the number of taps.
+
+Equiripple (Parks-McClellan) lowpass, Fsamp = 48000 Hz, weighted for 1dB passband ripple / 60dB stopband
+and 20dB more within 3 kHz of the multiples of the input sample rate, where the images of the speech band fall.
+Scaled to the gain of the former interpolation + antialias filter combination at 1 kHz.
+Images of the decimated audio start at Fsamp_in - bandwidth, everything above Fstop is suppressed.
+The 24ksps filters also set the audio bandwidth of the wide SSB filter paths (no audio IIR filter),
+their -6dB points are within about 100 Hz of the former antialias filters.
+
+***************************************************************/
+
+// 5 kHz lowpass, 12 ksps -> 48 ksps (interpolation by 4), 48 taps, Fpass = 4800 Hz, Fstop = 7200 Hz
+//  ripple: 0.8dB  -6dB: 5611 Hz  -20dB: 6406 Hz  -50dB: 7106 Hz  stopband: >61dB  images of 0-3 kHz: >81dB
+const arm_fir_interpolate_instance_f32 FirRxInterpolate_5k =
+{
+    .phaseLength = 48,
+    .pCoeffs = (float*) (const float[])
+    {
+        0.00060611721136142552,
+        0.0017577093164764209,
+        0.0035751908740566641,
+        0.0055947251202663863,
+        0.0061167359793637324,
+        0.0043018756972039258,
+        -0.00058489034453745891,
+        -0.0075349735593964679,
+        -0.013263589709956534,
+        -0.014669531156608118,
+        -0.0092783582548740737,
+        0.0020017500236462569,
+        0.014314229593786171,
+        0.020819575105253899,
+        0.015574388390210966,
+        -0.0022869387585823585,
+        -0.026646695941545055,
+        -0.045010091489932597,
+        -0.043568924882634717,
+        -0.013271335235401001,
+        0.044952562308257879,
+        0.11813429746681871,
+        0.18559089694580508,
+        0.22600498401574026,
+        0.22600498401574026,
+        0.18559089694580508,
+        0.11813429746681871,
+        0.044952562308257879,
+        -0.013271335235401001,
+        -0.043568924882634717,
+        -0.045010091489932597,
+        -0.026646695941545055,
+        -0.0022869387585823585,
+        0.015574388390210966,
+        0.020819575105253899,
+        0.014314229593786171,
+        0.0020017500236462569,
+        -0.0092783582548740737,
+        -0.014669531156608118,
+        -0.013263589709956534,
+        -0.0075349735593964679,
+        -0.00058489034453745891,
+        0.0043018756972039258,
+        0.0061167359793637324,
+        0.0055947251202663863,
+        0.0035751908740566641,
+        0.0017577093164764209,
+        0.00060611721136142552
+    }
+};
+
+// 8 kHz lowpass, 24 ksps -> 48 ksps (interpolation by 2), 48 taps, Fpass = 7300 Hz, Fstop = 9700 Hz
+//  ripple: 0.7dB  -6dB: 8145 Hz  -20dB: 8925 Hz  -50dB: 9600 Hz  stopband: >62dB  images of 0-3 kHz: >82dB
+const arm_fir_interpolate_instance_f32 FirRxInterpolate_8k =
+{
+    .phaseLength = 48,
+    .pCoeffs = (float*) (const float[])
+    {
+        -0.00054796586469359556,
+        -7.0163826925370503e-05,
+        0.0033424507157337902,
+        0.0084653425584482727,
+        0.01165059981381391,
+        0.0081174670827391382,
+        -0.001991586498106017,
+        -0.010813304769160575,
+        -0.0091982460918401832,
+        0.0039100087285345872,
+        0.016467318385992424,
+        0.013390797488798956,
+        -0.0067675969558781178,
+        -0.025625581595018977,
+        -0.019847540254241069,
+        0.01222416007630055,
+        0.041426605123147588,
+        0.030685786089550176,
+        -0.024160782075497586,
+        -0.076005462059464596,
+        -0.056467236370801886,
+        0.064393201894162741,
+        0.23933011615950955,
+        0.36774047963322798,
+        0.36774047963322798,
+        0.23933011615950955,
+        0.064393201894162741,
+        -0.056467236370801886,
+        -0.076005462059464596,
+        -0.024160782075497586,
+        0.030685786089550176,
+        0.041426605123147588,
+        0.01222416007630055,
+        -0.019847540254241069,
+        -0.025625581595018977,
+        -0.0067675969558781178,
+        0.013390797488798956,
+        0.016467318385992424,
+        0.0039100087285345872,
+        -0.0091982460918401832,
+        -0.010813304769160575,
+        -0.001991586498106017,
+        0.0081174670827391382,
+        0.01165059981381391,
+        0.0084653425584482727,
+        0.0033424507157337902,
+        -7.0163826925370503e-05,
+        -0.00054796586469359556
+    }
+};
 
-const arm_fir_interpolate_instance_f32 FirRxInterpolate_4_5k=
+// 8.5 kHz lowpass, 24 ksps -> 48 ksps (interpolation by 2), 48 taps, Fpass = 7800 Hz, Fstop = 10250 Hz
+//  ripple: 0.5dB  -6dB: 8632 Hz  -20dB: 9430 Hz  -50dB: 10125 Hz  stopband: >65dB  images of 0-3 kHz: >85dB
+const arm_fir_interpolate_instance_f32 FirRxInterpolate_8k5 =
 {
-    .phaseLength = 4,
+    .phaseLength = 48,
     .pCoeffs = (float*) (const float[])
     {
-        0.210149639888675743,
-        0.292367020487055873,
-        0.292367020487055873,
-        0.210149639888675743
+        -0.0012808642790538391,
+        -0.0047791349524395439,
+        -0.0080010883189060023,
+        -0.0071933209406613192,
+        -0.00071187374318034747,
+        0.006940999460113703,
+        0.0074138932901704861,
+        -0.0015778210008885016,
+        -0.011329109592023845,
+        -0.0091760451665715628,
+        0.0059993654473308516,
+        0.018145111705956157,
+        0.0099855354823140067,
+        -0.014487237941216126,
+        -0.027784370575120284,
+        -0.0078574987214982024,
+        0.030517388613475721,
+        0.041902133875642511,
+        -0.0014287913558095903,
+        -0.065430173352077847,
+        -0.069764354141316834,
+        0.038732195572096735,
+        0.22153988871855992,
+        0.36336538145689595,
+        0.36336538145689595,
+        0.22153988871855992,
+        0.038732195572096735,
+        -0.069764354141316834,
+        -0.065430173352077847,
+        -0.0014287913558095903,
+        0.041902133875642511,
+        0.030517388613475721,
+        -0.0078574987214982024,
+        -0.027784370575120284,
+        -0.014487237941216126,
+        0.0099855354823140067,
+        0.018145111705956157,
+        0.0059993654473308516,
+        -0.0091760451665715628,
+        -0.011329109592023845,
+        -0.0015778210008885016,
+        0.0074138932901704861,
+        0.006940999460113703,
+        -0.00071187374318034747,
+        -0.0071933209406613192,
+        -0.0080010883189060023,
+        -0.0047791349524395439,
+        -0.0012808642790538391
+    }
+};
 
+// 9 kHz lowpass, 24 ksps -> 48 ksps (interpolation by 2), 48 taps, Fpass = 8300 Hz, Fstop = 10750 Hz
+//  ripple: 0.6dB  -6dB: 9118 Hz  -20dB: 9933 Hz  -50dB: 10634 Hz  stopband: >64dB  images of 0-3 kHz: >84dB
+const arm_fir_interpolate_instance_f32 FirRxInterpolate_9k =
+{
+    .phaseLength = 48,
+    .pCoeffs = (float*) (const float[])
+    {
+        0.00038847481296305791,
+        -0.00055593181813134074,
+        -0.0046178252528574588,
+        -0.009316867209859029,
+        -0.0093825501929781716,
+        -0.0017424623719664563,
+        0.0078000788470187193,
+        0.0080848352710947875,
+        -0.0032094257429425895,
+        -0.013401610566211253,
+        -0.0071506862400576255,
+        0.011757276348185044,
+        0.019576647241315422,
+        0.00095760451132968197,
+        -0.025680148780768245,
+        -0.023225606161952239,
+        0.015512378226759261,
+        0.046298140811720394,
+        0.018264458784146419,
+        -0.054207186825483519,
+        -0.081334963102311961,
+        0.017724150973995267,
+        0.21620225195070053,
+        0.37910773186954067,
+        0.37910773186954067,
+        0.21620225195070053,
+        0.017724150973995267,
+        -0.081334963102311961,
+        -0.054207186825483519,
+        0.018264458784146419,
+        0.046298140811720394,
+        0.015512378226759261,
+        -0.023225606161952239,
+        -0.025680148780768245,
+        0.00095760451132968197,
+        0.019576647241315422,
+        0.011757276348185044,
+        -0.0071506862400576255,
+        -0.013401610566211253,
+        -0.0032094257429425895,
+        0.0080848352710947875,
+        0.0078000788470187193,
+        -0.0017424623719664563,
+        -0.0093825501929781716,
+        -0.009316867209859029,
+        -0.0046178252528574588,
+        -0.00055593181813134074,
+        0.00038847481296305791
+    }
+};
+
+// 9.5 kHz lowpass, 24 ksps -> 48 ksps (interpolation by 2), 48 taps, Fpass = 8750 Hz, Fstop = 11250 Hz
+//  ripple: 0.5dB  -6dB: 9651 Hz  -20dB: 10432 Hz  -50dB: 11122 Hz  stopband: >66dB  images of 0-3 kHz: >86dB
+const arm_fir_interpolate_instance_f32 FirRxInterpolate_9k5 =
+{
+    .phaseLength = 48,
+    .pCoeffs = (float*) (const float[])
+    {
+        0.0017065482771067883,
+        0.0055781373130450503,
+        0.0077006054578673839,
+        0.0037381611159212273,
+        -0.004830498565610083,
+        -0.0086800519311897324,
+        -0.0013469296405360254,
+        0.008967675581032012,
+        0.0070290719748303332,
+        -0.0082254954914261456,
+        -0.016629285948138679,
+        -0.0021915658788579234,
+        0.019494607659704177,
+        0.015732006574535381,
+        -0.016352450505461781,
+        -0.034323556070256972,
+        -0.0032456771454174656,
+        0.044988754784717463,
+        0.036731498621291388,
+        -0.042176029501182287,
+        -0.094987743554099988,
+        -0.0039345597857146416,
+        0.22178591642699619,
+        0.41850685132062265,
+        0.41850685132062265,
+        0.22178591642699619,
+        -0.0039345597857146416,
+        -0.094987743554099988,
+        -0.042176029501182287,
+        0.036731498621291388,
+        0.044988754784717463,
+        -0.0032456771454174656,
+        -0.034323556070256972,
+        -0.016352450505461781,
+        0.015732006574535381,
+        0.019494607659704177,
+        -0.0021915658788579234,
+        -0.016629285948138679,
+        -0.0082254954914261456,
+        0.0070290719748303332,
+        0.008967675581032012,
+        -0.0013469296405360254,
+        -0.0086800519311897324,
+        -0.004830498565610083,
+        0.0037381611159212273,
+        0.0077006054578673839,
+        0.0055781373130450503,
+        0.0017065482771067883
     }
 };
 
-const arm_fir_interpolate_instance_f32 FirRxInterpolate_4_10k=
+// 10 kHz lowpass, 24 ksps -> 48 ksps (interpolation by 2), 48 taps, Fpass = 9200 Hz, Fstop = 11750 Hz
+//  ripple: 0.5dB  -6dB: 10113 Hz  -20dB: 10917 Hz  -50dB: 11625 Hz  stopband: >65dB  images of 0-3 kHz: >85dB
+const arm_fir_interpolate_instance_f32 FirRxInterpolate_10k =
 {
-    .phaseLength = 4,
+    .phaseLength = 48,
     .pCoeffs = (float*) (const float[])
     {
-        0.139302961114601442,
-        0.460435107346899464,
-        0.460435107346899464,
-        0.139302961114601442
+        -5.3820511130709023e-05,
+        0.0018905139208018988,
+        0.0066981652268086576,
+        0.0094967964592377364,
+        0.0046491295528027421,
+        -0.0052561580376611003,
+        -0.0081091819490214084,
+        0.0020455451783959458,
+        0.01179236236626424,
+        0.0042853540613560955,
+        -0.013357946723353687,
+        -0.013652272574294171,
+        0.010047925064368746,
+        0.024313959939833225,
+        0.00052931578148530272,
+        -0.033089564689829494,
+        -0.020028126505083767,
+        0.035163434071737776,
+        0.050292030333758772,
+        -0.023100928990443977,
+        -0.09772198567142551,
+        -0.024218823138284669,
+        0.21437574984713523,
+        0.43585959990948758,
+        0.43585959990948758,
+        0.21437574984713523,
+        -0.024218823138284669,
+        -0.09772198567142551,
+        -0.023100928990443977,
+        0.050292030333758772,
+        0.035163434071737776,
+        -0.020028126505083767,
+        -0.033089564689829494,
+        0.00052931578148530272,
+        0.024313959939833225,
+        0.010047925064368746,
+        -0.013652272574294171,
+        -0.013357946723353687,
+        0.0042853540613560955,
+        0.01179236236626424,
+        0.0020455451783959458,
+        -0.0081091819490214084,
+        -0.0052561580376611003,
+        0.0046491295528027421,
+        0.0094967964592377364,
+        0.0066981652268086576,
+        0.0018905139208018988,
+        -5.3820511130709023e-05
     }
 };
 
@@ -0,0 +1,633 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     iir_rx_biquad.c                                                 **
+ **  Description:   RX audio IIR lattice filters converted to cascaded biquads      **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#include "filters.h"
+//
+// GENERATED FILE, DO NOT EDIT
+// created by support/host/iir_biquad_gen from the lattice filters referenced in FilterPathInfo,
+// rerun it after changing or adding RX audio IIR filters, support/host/iir_biquad_check verifies the result
+//
+// the responses are identical to the lattice filters, only the structure differs:
+// second order sections in arm_biquad_cascade_df2T_f32() coefficient order { b0, b1, b2, a1, a2 },
+// i.e. a1 and a2 have the inverted sign of the textbook denominator
+// the most resonant section comes last, each partial cascade has the peak gain of the whole filter
+//
+
+// IIR_1k4_LPF, 10 lattice stages
+static const float32_t IIR_1k4_LPF_biquad_coeffs[5*5] =
+{
+    0.0250253829, 0.017909857, 0.0250253691, 1.62540147, -0.694435556,
+    0.249892903, -0.250989515, 0.249893099, 1.56074344, -0.823155072,
+    0.616688234, -0.827690542, 0.616687469, 1.50912447, -0.926751094,
+    0.84521118, -1.20842054, 0.845210869, 1.48676616, -0.974482206,
+    0.932560612, -1.35590956, 0.932561491, 1.48200124, -0.993961521,
+};
+
+// IIR_1k4_BPF, 10 lattice stages
+static const float32_t IIR_1k4_BPF_biquad_coeffs[5*5] =
+{
+    0.0727939887, -0.0104324853, 0.0727939935, 1.5065343, -0.778980207,
+    0.16955327, 8.88977782e-07, -0.169552256, 1.74747484, -0.800993088,
+    0.34000589, -0.298931606, 0.340005964, 1.43324318, -0.924754669,
+    0.958392248, -1.91578592, 0.958400414, 1.94167342, -0.952355178,
+    0.987492983, -1.97267677, 0.987490219, 1.98464334, -0.990821526,
+};
+
+// IIR_1k6_LPF, 10 lattice stages
+static const float32_t IIR_1k6_LPF_biquad_coeffs[5*5] =
+{
+    0.0299807361, 0.0287683785, 0.0299807573, 1.5659072, -0.656038639,
+    0.261740512, -0.200656629, 0.261740593, 1.46167138, -0.80216207,
+    0.625494272, -0.727179071, 0.625493417, 1.37923105, -0.91845823,
+    0.849332902, -1.07765326, 0.849334641, 1.34327678, -0.971654234,
+    0.934752778, -1.21376755, 0.934751874, 1.33402121, -0.993295768,
+};
+
+// IIR_1k6_BPF, 10 lattice stages
+static const float32_t IIR_1k6_BPF_biquad_coeffs[5*5] =
+{
+    0.0814385054, 0.0145046637, 0.0814385273, 1.40084985, -0.745823102,
+    0.193419162, 3.00392313e-06, -0.193416027, 1.70925271, -0.770117619,
+    0.36257085, -0.220509981, 0.362570905, 1.28455391, -0.914450153,
+    0.960916506, -1.92087235, 0.960939795, 1.939021, -0.949875935,
+    0.989088861, -1.97590234, 0.989080599, 1.984379, -0.990556445,
+};
+
+// IIR_1k8_LPF, 10 lattice stages
+static const float32_t IIR_1k8_LPF_biquad_coeffs[5*5] =
+{
+    0.035713996, 0.0411967185, 0.0357140168, 1.50409933, -0.618503121,
+    0.275534636, -0.144785607, 0.275534211, 1.35391828, -0.782434925,
+    0.635762716, -0.616696679, 0.635763423, 1.23682088, -0.910925722,
+    0.854113032, -0.934137979, 0.85411291, 1.18586022, -0.969125854,
+    0.937228537, -1.05773259, 0.937228314, 1.17157338, -0.992703594,
+};
+
+// IIR_1k8_1k125, 10 lattice stages
+static const float32_t IIR_1k8_1k125_biquad_coeffs[5*5] =
+{
+    0.164141491, -1.64111527e-06, -0.164143241, 1.14330892, -0.671715276,
+    0.158825496, 0.106468901, 0.158825427, 1.55487201, -0.68187073,
+    0.362989094, -0.0406727679, 0.36298913, 0.973858753, -0.886199406,
+    0.926694089, -1.85053466, 0.926679679, 1.87670916, -0.907747545,
+    0.976908047, -1.94710269, 0.97691313, 1.96167891, -0.980705448,
+};
+
+// IIR_1k8_1k275, 10 lattice stages
+static const float32_t IIR_1k8_1k275_biquad_coeffs[5*5] =
+{
+    0.158973844, 9.03945577e-08, -0.15897388, 1.46696399, -0.682052733,
+    0.180150222, 0.133110302, 0.180150152, 1.0406405, -0.692300781,
+    0.741937491, -1.47751528, 0.741939307, 1.80880529, -0.880998642,
+    0.419995923, -0.00242886535, 0.419995981, 0.844524853, -0.893342774,
+    0.958511541, -1.89911413, 0.958509425, 1.92544556, -0.972922298,
+};
+
+// IIR_1k8_1k425, 10 lattice stages
+static const float32_t IIR_1k8_1k425_biquad_coeffs[5*5] =
+{
+    0.158245625, -3.30435062e-08, -0.158245658, 1.37018795, -0.683508741,
+    0.195090777, 0.157058889, 0.195090667, 0.928339884, -0.708846508,
+    0.681711919, -1.35124813, 0.681710854, 1.73439901, -0.862337027,
+    0.427822933, 0.0424056369, 0.427823072, 0.712642427, -0.899589665,
+    0.938678921, -1.84190226, 0.938680071, 1.87756684, -0.966633016,
+};
+
+// IIR_1k8_1k575, 10 lattice stages
+static const float32_t IIR_1k8_1k575_biquad_coeffs[5*5] =
+{
+    0.159064633, 1.95558518e-08, -0.159064685, 1.26234399, -0.681870727,
+    0.210551366, 0.187837633, 0.210551337, 0.798363746, -0.719174528,
+    0.635207223, -1.25080459, 0.635206827, 1.65347908, -0.847844186,
+    0.43776299, 0.0994924607, 0.437763008, 0.563112158, -0.903981531,
+    0.919890304, -1.78126398, 0.91989075, 1.82014386, -0.961414022,
+};
+
+// IIR_1k8_1k725, 10 lattice stages
+static const float32_t IIR_1k8_1k725_biquad_coeffs[5*5] =
+{
+    0.158609619, -1.98745515e-07, -0.158609955, 1.14948435, -0.682780804,
+    0.224379188, 0.216916023, 0.224379249, 0.669315716, -0.729697755,
+    0.594206442, -1.15942059, 0.59420524, 1.56398882, -0.836770808,
+    0.446359245, 0.152669843, 0.446359153, 0.420515364, -0.908408076,
+    0.90079737, -1.71337355, 0.900797749, 1.75122894, -0.957017776,
+};
+
+// IIR_2k1_LPF, 10 lattice stages
+static const float32_t IIR_2k1_LPF_biquad_coeffs[5*5] =
+{
+    0.0459228276, 0.0630929606, 0.0459227111, 1.40623559, -0.563621591,
+    0.299923866, -0.0505584027, 0.29992444, 1.17607805, -0.755427065,
+    0.65375937, -0.43394837, 0.65376066, 1.00191137, -0.901197423,
+    0.862418377, -0.698117105, 0.862413129, 0.927063472, -0.965951007,
+    0.941411719, -0.801380601, 0.941415351, 0.904686753, -0.991966827,
+};
+
+// IIR_2k1_BPF, 10 lattice stages
+static const float32_t IIR_2k1_BPF_biquad_coeffs[5*5] =
+{
+    0.164414663, -3.89983356e-08, -0.164414844, 1.11069809, -0.671170444,
+    0.168380019, 0.136596703, 0.168379986, 1.6120766, -0.691619742,
+    0.427439451, 0.018421952, 0.427439433, 0.864630657, -0.89341733,
+    0.963867243, -1.926788, 0.963865502, 1.93404022, -0.945202035,
+    0.991234967, -1.98027057, 0.991236059, 1.98391116, -0.990087215,
+};
+
+// IIR_2k3_LPF, 10 lattice stages
+static const float32_t IIR_2k3_LPF_biquad_coeffs[5*5] =
+{
+    0.0539330875, 0.0801307493, 0.0539332247, 1.33692663, -0.527893405,
+    0.318694033, 0.0192557716, 0.318693251, 1.04673505, -0.739312068,
+    0.66737924, -0.302005173, 0.667380229, 0.832697352, -0.895851541,
+    0.86863195, -0.529208516, 0.868630443, 0.741902232, -0.964279026,
+    0.944467277, -0.61831321, 0.944468378, 0.714107556, -0.99158437,
+};
+
+// IIR_2k3_1k275, 10 lattice stages
+static const float32_t IIR_2k3_1k275_biquad_coeffs[5*5] =
+{
+    0.142199625, 0.157719891, 0.14219945, 0.90335457, -0.578906384,
+    0.284179323, 4.86750045e-06, -0.284175159, 1.50305864, -0.594154302,
+    0.442893874, 0.180165164, 0.442894072, 0.630311165, -0.859987055,
+    0.957051652, -1.91317685, 0.957074494, 1.91724768, -0.929475117,
+    0.989615391, -1.976958, 0.989607487, 1.97976846, -0.986717439,
+};
+
+// IIR_2k3_1k412, 10 lattice stages
+static const float32_t IIR_2k3_1k412_biquad_coeffs[5*5] =
+{
+    0.203580198, 1.74380692e-06, -0.203578675, 1.40195733, -0.592841219,
+    0.219121986, 0.256414809, 0.219121767, 0.787818954, -0.606419224,
+    0.428603107, 0.219541494, 0.428603277, 0.481644153, -0.868877977,
+    0.917390858, -1.83089571, 0.917403251, 1.84148837, -0.885776716,
+    0.975708399, -1.94204452, 0.975703103, 1.94932662, -0.976349504,
+};
+
+// IIR_2k3_1k562, 10 lattice stages
+static const float32_t IIR_2k3_1k562_biquad_coeffs[5*5] =
+{
+    0.203391643, 5.05447345e-07, -0.203391959, 1.2941641, -0.593216523,
+    0.237225384, 0.290953435, 0.237225035, 0.664467664, -0.628238507,
+    0.756063274, -1.50436854, 0.756063048, 1.76309352, -0.85543425,
+    0.487448256, 0.297966225, 0.487448311, 0.336944208, -0.876599307,
+    0.959803738, -1.89783027, 0.959804454, 1.90805051, -0.967825655,
+};
+
+// IIR_2k3_1k712, 10 lattice stages
+static const float32_t IIR_2k3_1k712_biquad_coeffs[5*5] =
+{
+    0.202641446, 1.08037687e-07, -0.202641762, 1.17896672, -0.594716797,
+    0.254100656, 0.325450845, 0.254100506, 0.535069028, -0.646646049,
+    0.702508088, -1.39124361, 0.702507524, 1.67791581, -0.832724597,
+    0.495109686, 0.350342441, 0.49510968, 0.193332709, -0.883496724,
+    0.942587328, -1.84517017, 0.942587645, 1.85523114, -0.960575044,
+};
+
+// IIR_2k5_LPF, 10 lattice stages
+static const float32_t IIR_2k5_LPF_biquad_coeffs[5*5] =
+{
+    0.0630433469, 0.099398931, 0.0630433615, 1.26377301, -0.492820522,
+    0.339515383, 0.0947061096, 0.339514852, 0.908791427, -0.724869618,
+    0.682188913, -0.163044589, 0.682190279, 0.6547923, -0.891489126,
+    0.875321544, -0.35299247, 0.875319422, 0.548764764, -0.962984074,
+    0.947697622, -0.427819106, 0.947698973, 0.515799667, -0.991293869,
+};
+
+// IIR_2k5_BPF, 10 lattice stages
+static const float32_t IIR_2k5_BPF_biquad_coeffs[5*5] =
+{
+    0.189397953, -2.45057354e-06, -0.189400204, 0.85251473, -0.621202377,
+    0.220616869, 0.257146743, 0.220617026, 1.53077587, -0.625945833,
+    0.487059758, 0.243211398, 0.48705966, 0.492983652, -0.882048853,
+    0.964668674, -1.92839455, 0.964649675, 1.93112179, -0.942452,
+    0.992097311, -1.98203685, 0.992104513, 1.98365232, -0.98982747,
+};
+
+// IIR_2k7_LPF, 10 lattice stages
+static const float32_t IIR_2k7_LPF_biquad_coeffs[5*5] =
+{
+    0.0734020309, 0.121200596, 0.0734019872, 1.18617765, -0.458415567,
+    0.362425488, 0.17582488, 0.36242534, 0.762299036, -0.712263104,
+    0.698093698, -0.018095786, 0.69809499, 0.469508653, -0.888167088,
+    0.882418625, -0.171224361, 0.882416626, 0.349576357, -0.962081149,
+    0.951066612, -0.231957576, 0.951067515, 0.311910668, -0.991098517,
+};
+
+// IIR_2k7_BPF, 10 lattice stages
+static const float32_t IIR_2k7_BPF_biquad_coeffs[5*5] =
+{
+    0.206857373, 3.98337545e-06, -0.206853284, 1.5033793, -0.586308273,
+    0.248213102, 0.325855423, 0.248213005, 0.718085336, -0.590792827,
+    0.528470205, 0.375832195, 0.52847045, 0.299591021, -0.876192905,
+    0.971698304, -1.94284463, 0.971727633, 1.94356229, -0.950985232,
+    0.994169941, -1.98696838, 0.994159298, 1.98765708, -0.99161327,
+};
+
+// IIR_2k9_LPF, 10 lattice stages
+static const float32_t IIR_2k9_LPF_biquad_coeffs[5*5] =
+{
+    0.0851930825, 0.145909722, 0.0851931168, 1.10344463, -0.424736745,
+    0.387459926, 0.262619039, 0.387460474, 0.607363674, -0.701681153,
+    0.714982998, 0.13173095, 0.714982143, 0.278273264, -0.885939245,
+    0.889849227, 0.01427393, 0.889848036, 0.146340925, -0.961581803,
+    0.954543108, -0.0328540414, 0.954544411, 0.104644317, -0.991000035,
+};
+
+// IIR_2k9_BPF, 10 lattice stages
+static const float32_t IIR_2k9_BPF_biquad_coeffs[5*5] =
+{
+    0.222075324, -8.80106487e-07, -0.222075403, 1.44400023, -0.555849374,
+    0.276196563, 0.39236017, 0.2761973, 0.571103093, -0.58143862,
+    0.551928688, 0.487344449, 0.551928173, 0.104419738, -0.875947501,
+    0.964881473, -1.92885201, 0.964879412, 1.92877832, -0.940237453,
+    0.992613268, -1.98308942, 0.992613234, 1.98345264, -0.989626944,
+};
+
+// IIR_3k2_LPF, 10 lattice stages
+static const float32_t IIR_3k2_LPF_biquad_coeffs[5*5] =
+{
+    0.106079291, 0.18946736, 0.106079046, 0.967889769, -0.375859759,
+    0.429056755, 0.403361957, 0.429058076, 0.359575381, -0.690084935,
+    0.741881051, 0.362953204, 0.741879521, -0.0163194577, -0.884753673,
+    0.901464817, 0.295366583, 0.901465802, -0.161570097, -0.961604939,
+    0.959869013, 0.267181345, 0.959868752, -0.207679838, -0.991036613,
+};
+
+// IIR_3k2_BPF, 10 lattice stages
+static const float32_t IIR_3k2_BPF_biquad_coeffs[5*5] =
+{
+    0.250461756, 2.01237775e-06, -0.250460295, 1.37372035, -0.499078005,
+    0.321918253, 0.503443061, 0.321917793, 0.344652752, -0.559448647,
+    0.602907065, 0.677388514, 0.60290729, -0.189814997, -0.874954871,
+    0.964844402, -1.92879882, 0.964853095, 1.92728152, -0.938820131,
+    0.992862793, -1.98360222, 0.992860719, 1.98332673, -0.989500613,
+};
+
+// IIR_3k4_LPF, 10 lattice stages
+static const float32_t IIR_3k4_LPF_biquad_coeffs[5*5] =
+{
+    0.12257366, 0.22372094, 0.122573689, 0.868420488, -0.344695239,
+    0.459499969, 0.504062974, 0.459499559, 0.184635526, -0.685573472,
+    0.760648327, 0.519475096, 0.76064986, -0.215384009, -0.885460876,
+    0.909406481, 0.481840268, 0.909403492, -0.365788397, -0.962139085,
+    0.963438329, 0.464967091, 0.963440135, -0.41356474, -0.991183314,
+};
+
+// IIR_3k4_BPF, 10 lattice stages
+static const float32_t IIR_3k4_BPF_biquad_coeffs[5*5] =
+{
+    0.270699915, -3.02120707e-06, -0.270704524, 1.32360532, -0.458595604,
+    0.355468757, 0.583600987, 0.355467448, 0.186371678, -0.549095469,
+    0.637518818, 0.805160885, 0.63751943, -0.384083133, -0.876018997,
+    0.964780219, -1.92864642, 0.964758965, 1.92637611, -0.937961495,
+    0.992984745, -1.98386575, 0.992992651, 1.98325214, -0.989425686,
+};
+
+// IIR_3k6_LPF, 10 lattice stages
+static const float32_t IIR_3k6_LPF_biquad_coeffs[5*5] =
+{
+    0.14157325, 0.263054386, 0.141573333, 0.760255813, -0.31508486,
+    0.492093168, 0.61000312, 0.492092912, 0.00254185156, -0.683971078,
+    0.779899165, 0.676207287, 0.779897717, -0.414419181, -0.88740375,
+    0.917408912, 0.665281895, 0.917411697, -0.566657495, -0.963086171,
+    0.966978369, 0.658467732, 0.966977081, -0.614981948, -0.991426249,
+};
+
+// IIR_3k6_BPF, 10 lattice stages
+static const float32_t IIR_3k6_BPF_biquad_coeffs[5*5] =
+{
+    0.262817949, -5.75636865e-06, -0.262823373, 0.0751743261, -0.47435971,
+    0.44394711, 0.756876806, 0.443947424, 1.22588599, -0.355589182,
+    0.64012207, 0.878351563, 0.640121988, -0.471637751, -0.848289998,
+    0.960046658, -1.91928992, 0.96001466, 1.91669386, -0.927440851,
+    0.991792251, -1.98173204, 0.991804229, 1.98101788, -0.98696203,
+};
+
+// IIR_3k8_LPF, 10 lattice stages
+static const float32_t IIR_3k8_LPF_biquad_coeffs[5*5] =
+{
+    0.163574417, 0.308468387, 0.163574329, 0.64192206, -0.287579776,
+    0.526778872, 0.720819155, 0.526778628, -0.185881835, -0.685595229,
+    0.799453921, 0.831576577, 0.799455561, -0.611425441, -0.89060425,
+    0.925391649, 0.843735453, 0.925389219, -0.762023495, -0.964439389,
+    0.970449697, 0.845582405, 0.970450998, -0.809751588, -0.991762834,
+};
+
+// IIR_3k8_BPF, 10 lattice stages
+static const float32_t IIR_3k8_BPF_biquad_coeffs[5*5] =
+{
+    0.315345109, -6.59066026e-06, -0.315351907, 1.21306595, -0.369303015,
+    0.430314079, 0.75927237, 0.430313887, -0.147197558, -0.540525151,
+    0.707037756, 1.05797952, 0.707037828, -0.760385766, -0.882266826,
+    0.964532882, -1.92815075, 0.964500768, 1.92473442, -0.936402418,
+    0.993154995, -1.98422785, 0.993166968, 1.98311951, -0.98929252,
+};
+
+// IIR_300hz_500, 10 lattice stages
+static const float32_t IIR_300hz_500_biquad_coeffs[5*5] =
+{
+    0.00290988869, 0.0469098463, -0.0498171003, 1.88184835, -0.948807144,
+    0.0784305289, -0.0785102741, 0.000117906741, 1.91714346, -0.96227873,
+    0.158921365, -0.275555532, 0.160144217, 1.86953558, -0.962677567,
+    0.493245061, -0.978135481, 0.493240452, 1.95202735, -0.987724607,
+    0.623186446, -1.15095611, 0.623147936, 1.87865205, -0.987786153,
+};
+
+// IIR_300hz_550, 10 lattice stages
+static const float32_t IIR_300hz_550_biquad_coeffs[5*5] =
+{
+    0.00656464962, 0.0405934624, -0.0471358352, 1.86631991, -0.947751704,
+    0.0883584089, -0.0967380058, 0.00858246798, 1.9035876, -0.960590741,
+    0.18604813, -0.313169437, 0.177426534, 1.85262399, -0.962444864,
+    0.47179361, -0.932897194, 0.471776704, 1.94082996, -0.986921541,
+    0.630971916, -1.15233874, 0.630893515, 1.86087217, -0.98775988,
+};
+
+// IIR_300hz_600, 10 lattice stages
+static const float32_t IIR_300hz_600_biquad_coeffs[5*5] =
+{
+    0.00811489821, 0.0057981679, 0.001213877, 1.85838454, -0.954167025,
+    0.0682121174, -0.0514807511, 0.00161859605, 1.8393297, -0.965425943,
+    0.0933140569, -0.0727841995, -0.0202011294, 1.89536616, -0.965501922,
+    0.383381368, -0.691302752, 0.383380985, 1.84300595, -0.988320176,
+    0.764293584, -1.50353976, 0.764292223, 1.93013225, -0.988400677,
+};
+
+// IIR_300hz_650, 10 lattice stages
+static const float32_t IIR_300hz_650_biquad_coeffs[5*5] =
+{
+    0.0021970983, 0.00494779841, 0.0093443776, 1.8420264, -0.954189275,
+    0.0616412501, -0.0459113208, -0.0157083065, 1.82059769, -0.965414373,
+    0.0943598067, -0.0612364964, -0.0052402995, 1.8811874, -0.965553423,
+    0.384768027, -0.684849101, 0.384765698, 1.8228423, -0.988315354,
+    -0.757678788, 1.48286837, -0.757671241, 1.91698114, -0.988417898,
+};
+
+// IIR_300hz_700, 10 lattice stages
+static const float32_t IIR_300hz_700_biquad_coeffs[5*5] =
+{
+    0.0551413752, -0.0596192719, 0.00452057775, 1.81951338, -0.95012676,
+    0.105367217, -0.134827923, 0.0296076816, 1.86229337, -0.96214521,
+    0.154482137, -0.239283306, 0.149086354, 1.79776823, -0.963579187,
+    0.449032802, -0.874691918, 0.448990251, 1.90165935, -0.98726871,
+    0.641519339, -1.12669011, 0.641460431, 1.80072498, -0.987977823,
+};
+
+// IIR_300hz_750, 10 lattice stages
+static const float32_t IIR_300hz_750_biquad_coeffs[5*5] =
+{
+    0.0344372301, -0.0111662725, -0.0232939739, 1.79435167, -0.943662689,
+    0.0515504271, -0.0224062077, -0.0291120638, 1.84115269, -0.957120564,
+    0.141995225, -0.199486585, 0.127038287, 1.77156098, -0.958916979,
+    0.452544568, -0.875930829, 0.452543393, 1.8848746, -0.985579779,
+    -0.648494788, 1.12222637, -0.648479473, 1.77590417, -0.986437795,
+};
+
+// IIR_300hz_800, 10 lattice stages
+static const float32_t IIR_300hz_800_biquad_coeffs[5*5] =
+{
+    0.0186356049, 0.00432350288, 7.98905607e-05, 1.7762044, -0.945973274,
+    0.2567682, -0.50350264, 0.256752332, 1.82543099, -0.959472243,
+    0.221284624, -0.354794915, 0.221232592, 1.75122108, -0.961476053,
+    0.449430564, -0.863361946, 0.449422303, 1.8686088, -0.986661076,
+    0.653811452, -1.11461547, 0.653791226, 1.75339718, -0.987554502,
+};
+
+// IIR_300hz_850, 10 lattice stages
+static const float32_t IIR_300hz_850_biquad_coeffs[5*5] =
+{
+    0.0225500366, -0.00208864733, 0.00180415575, 1.76019834, -0.951430522,
+    0.172598716, -0.344367422, 0.17176971, 1.80864419, -0.962893361,
+    0.123923278, -0.163210628, 0.115897794, 1.73124086, -0.964312191,
+    0.436268317, -0.831833198, 0.436266877, 1.85057969, -0.987424823,
+    0.648321807, -1.08625018, 0.648278409, 1.72936452, -0.988129978,
+};
+
+// IIR_300hz_900, 10 lattice stages
+static const float32_t IIR_300hz_900_biquad_coeffs[5*5] =
+{
+    0.0137974361, 0.00527346874, 0.00468912137, 1.73949196, -0.953437623,
+    0.0294087022, 1.59872904e-05, 3.55274971e-08, 1.78886776, -0.96409311,
+    0.0980181528, -0.319651648, 0.221548205, 1.70778243, -0.965377651,
+    0.429650654, -0.812304248, 0.429653037, 1.83104324, -0.987677122,
+    0.647984784, -1.06644199, 0.647971299, 1.70349967, -0.988341371,
+};
+
+// IIR_300hz_950, 10 lattice stages
+static const float32_t IIR_300hz_950_biquad_coeffs[5*5] =
+{
+    0.0177259827, 0.00314789661, 0.00407270471, 1.7157104, -0.953500231,
+    0.0441146992, -0.0157145128, 0.000910040514, 1.76706759, -0.964131197,
+    0.0330456245, -0.199453616, 0.166357897, 1.68178973, -0.965412462,
+    0.427067996, -0.79985606, 0.427067741, 1.81017447, -0.987685405,
+    0.650368276, -1.05064467, 0.650359794, 1.67608607, -0.988349235,
+};
+
+// IIR_500hz_550, 10 lattice stages
+static const float32_t IIR_500hz_550_biquad_coeffs[5*5] =
+{
+    0.0277234315, -0.000484982563, 2.01269703e-06, 1.82606322, -0.905533879,
+    0.125964493, -0.0974811692, 0.0102772921, 1.79870085, -0.927830657,
+    0.18123221, -0.191492551, 0.0102768541, 1.88801339, -0.929976128,
+    0.361878281, -0.624522477, 0.361877876, 1.8114868, -0.975022095,
+    0.851084962, -1.69725095, 0.851057732, 1.95012323, -0.977225492,
+};
+
+// IIR_500hz_650, 10 lattice stages
+static const float32_t IIR_500hz_650_biquad_coeffs[5*5] =
+{
+    0.00411501755, 0.0073789217, 0.0184769578, 1.80621774, -0.913974104,
+    0.152178388, -0.161828816, 0.00875756259, 1.76706974, -0.931784081,
+    0.183934237, -0.184841971, 0.00204612753, 1.87249081, -0.937711625,
+    0.316290498, -0.525601248, 0.316081644, 1.77104361, -0.975973662,
+    0.756290057, -1.51241645, 0.75615586, 1.93160373, -0.978908538,
+};
+
+// IIR_500hz_750, 10 lattice stages
+static const float32_t IIR_500hz_750_biquad_coeffs[5*5] =
+{
+    0.0714311293, -0.0484452774, -0.0229722616, 1.75708599, -0.907197196,
+    0.0277645407, 0.0156951012, 0.00370644844, 1.82941632, -0.926443054,
+    0.0557055536, 0.0290639289, 0.00731043163, 1.71884425, -0.931683287,
+    0.465760835, -0.92044584, 0.465892288, 1.90142722, -0.974384364,
+    0.557711967, -0.894190652, 0.557386799, 1.72209938, -0.976445028,
+};
+
+// IIR_500hz_850, 10 lattice stages
+static const float32_t IIR_500hz_850_biquad_coeffs[5*5] =
+{
+    0.0309639216, 0.0114402788, 0.000626284006, 1.71898998, -0.903510313,
+    0.0532444685, -0.0376078336, 0.0673735219, 1.66738539, -0.925180483,
+    0.378511461, -0.756786587, 0.378275168, 1.80299516, -0.930300326,
+    0.354730146, -0.54756218, 0.354736264, 1.66640029, -0.974081952,
+    -0.778884099, 1.51826232, -0.778894588, 1.87367819, -0.97708431,
+};
+
+// IIR_500hz_950, 10 lattice stages
+static const float32_t IIR_500hz_950_biquad_coeffs[5*5] =
+{
+    0.0352480597, 0.00896464234, 0.000492829809, 1.68202535, -0.909858137,
+    0.0687660306, -0.0211662042, 0.0394976038, 1.62272449, -0.930502192,
+    0.342901712, -0.685786769, 0.342885063, 1.77022557, -0.934810064,
+    0.380933342, -0.570196195, 0.380911163, 1.61472408, -0.976213292,
+    -0.778307784, 1.49462312, -0.778312601, 1.84080856, -0.978671642,
+};
+
+// IIR_4k_LPF, 10 lattice stages
+static const float32_t IIR_4k_LPF_biquad_coeffs[5*5] =
+{
+    0.189203909, 0.361226546, 0.189203644, 0.511661668, -0.262979464,
+    0.563450787, 0.835968839, 0.563451292, -0.37949897, -0.690787483,
+    0.819122616, 0.983919516, 0.819124051, -0.80427952, -0.895072461,
+    0.933265452, 1.01524888, 0.933262519, -0.949755956, -0.966188019,
+    0.973815927, 1.02428559, 0.973817592, -0.99576106, -0.992189431,
+};
+
+// IIR_4k2_LPF, 10 lattice stages
+static const float32_t IIR_4k2_LPF_biquad_coeffs[5*5] =
+{
+    0.219261436, 0.422937518, 0.219261287, 0.367379566, -0.242436787,
+    0.601937682, 0.954692038, 0.601938989, -0.57678783, -0.699905721,
+    0.838697227, 1.13148346, 0.83869301, -0.990750525, -0.900805298,
+    0.940944976, 1.17791049, 0.940951929, -1.12776568, -0.968316568,
+    0.97702735, 1.19262246, 0.977023519, -1.17098852, -0.992701824,
+};
+
+// IIR_4k4_LPF, 10 lattice stages
+static const float32_t IIR_4k4_LPF_biquad_coeffs[5*5] =
+{
+    0.254757744, 0.495630112, 0.254757711, 0.206588946, -0.227612293,
+    0.641985714, 1.07596089, 0.641985669, -0.775764321, -0.713312544,
+    0.857950016, 1.27244083, 0.85794982, -1.16852021, -0.907784541,
+    0.94834835, 1.32988022, 0.948349983, -1.29402645, -0.970805776,
+    0.980086528, 1.34879834, 0.980085294, -1.33352752, -0.993293863,
+};
+
+// IIR_4k6_LPF, 10 lattice stages
+static const float32_t IIR_4k6_LPF_biquad_coeffs[5*5] =
+{
+    0.297008094, 0.581940414, 0.297008154, 0.0263694535, -0.22090216,
+    0.683239443, 1.19842592, 0.683238485, -0.973907907, -0.731357533,
+    0.876648869, 1.40491899, 0.876653656, -1.33520995, -0.91597475,
+    0.955390009, 1.46938577, 0.955381591, -1.44660553, -0.973631617,
+    0.982922874, 1.49106547, 0.982927417, -1.48160166, -0.993959442,
+};
+
+// IIR_4k8_LPF, 10 lattice stages
+static const float32_t IIR_4k8_LPF_biquad_coeffs[5*5] =
+{
+    0.347761878, 0.685364483, 0.347761873, -0.176632623, -0.225775404,
+    0.725222962, 1.32037433, 0.72522296, -1.16809639, -0.754353562,
+    0.894552152, 1.52702093, 0.894551435, -1.48841673, -0.925321042,
+    0.961987402, 1.59476252, 0.961990684, -1.58368913, -0.976765232,
+    0.985310401, 1.61754343, 0.985307862, -1.61358506, -0.99469237,
+};
+
+// IIR_5k_LPF, 10 lattice stages
+static const float32_t IIR_5k_LPF_biquad_coeffs[5*5] =
+{
+    0.0630433469, 0.099398931, 0.0630433615, 1.26377301, -0.492820522,
+    0.339515383, 0.0947061096, 0.339514852, 0.908791427, -0.724869618,
+    0.682188913, -0.163044589, 0.682190279, 0.6547923, -0.891489126,
+    0.875321544, -0.35299247, 0.875319422, 0.548764764, -0.962984074,
+    0.947697622, -0.427819106, 0.947698973, 0.515799667, -0.991293869,
+};
+
+// IIR_6k_LPF, 10 lattice stages
+static const float32_t IIR_6k_LPF_biquad_coeffs[5*5] =
+{
+    0.0916953088, 0.15949511, 0.0916949364, 1.05990204, -0.40820379,
+    0.400783258, 0.308135472, 0.40078522, 0.526784698, -0.697215852,
+    0.7237572, 0.208101988, 0.723754926, 0.180902285, -0.885250864,
+    0.893669021, 0.107828609, 0.893671573, 0.0438480089, -0.961485974,
+    0.956307797, 0.0672473995, 0.95630636, 0.00044536635, -0.990987743,
+};
+
+// IIR_7k5_LPF, 8 lattice stages
+static const float32_t IIR_7k5_LPF_biquad_coeffs[4*5] =
+{
+    0.164330218, 0.310070038, 0.164330052, 0.637961689, -0.286818783,
+    0.527339368, 0.724761997, 0.527339873, -0.190938346, -0.686575891,
+    0.79700954, 0.838807599, 0.797010298, -0.613457218, -0.894003432,
+    0.914777975, 0.858256403, 0.914777144, -0.754730158, -0.97515812,
+};
+
+// IIR_10k_LPF, 8 lattice stages
+static const float32_t IIR_10k_LPF_biquad_coeffs[4*5] =
+{
+    0.419323003, 0.830830978, 0.419321953, -0.443457091, -0.252482838,
+    0.773396877, 1.45723108, 0.773400767, -1.3817781, -0.787815885,
+    0.912763872, 1.65192922, 0.912760674, -1.64489156, -0.939242238,
+    0.965352847, 1.71863239, 0.965353775, -1.72000419, -0.986474355,
+};
+
+const IIR_BiquadDescriptor IirRxBiquadInfo[] =
+{
+    { &IIR_1k4_LPF, 5, IIR_1k4_LPF_biquad_coeffs },
+    { &IIR_1k4_BPF, 5, IIR_1k4_BPF_biquad_coeffs },
+    { &IIR_1k6_LPF, 5, IIR_1k6_LPF_biquad_coeffs },
+    { &IIR_1k6_BPF, 5, IIR_1k6_BPF_biquad_coeffs },
+    { &IIR_1k8_LPF, 5, IIR_1k8_LPF_biquad_coeffs },
+    { &IIR_1k8_1k125, 5, IIR_1k8_1k125_biquad_coeffs },
+    { &IIR_1k8_1k275, 5, IIR_1k8_1k275_biquad_coeffs },
+    { &IIR_1k8_1k425, 5, IIR_1k8_1k425_biquad_coeffs },
+    { &IIR_1k8_1k575, 5, IIR_1k8_1k575_biquad_coeffs },
+    { &IIR_1k8_1k725, 5, IIR_1k8_1k725_biquad_coeffs },
+    { &IIR_2k1_LPF, 5, IIR_2k1_LPF_biquad_coeffs },
+    { &IIR_2k1_BPF, 5, IIR_2k1_BPF_biquad_coeffs },
+    { &IIR_2k3_LPF, 5, IIR_2k3_LPF_biquad_coeffs },
+    { &IIR_2k3_1k275, 5, IIR_2k3_1k275_biquad_coeffs },
+    { &IIR_2k3_1k412, 5, IIR_2k3_1k412_biquad_coeffs },
+    { &IIR_2k3_1k562, 5, IIR_2k3_1k562_biquad_coeffs },
+    { &IIR_2k3_1k712, 5, IIR_2k3_1k712_biquad_coeffs },
+    { &IIR_2k5_LPF, 5, IIR_2k5_LPF_biquad_coeffs },
+    { &IIR_2k5_BPF, 5, IIR_2k5_BPF_biquad_coeffs },
+    { &IIR_2k7_LPF, 5, IIR_2k7_LPF_biquad_coeffs },
+    { &IIR_2k7_BPF, 5, IIR_2k7_BPF_biquad_coeffs },
+    { &IIR_2k9_LPF, 5, IIR_2k9_LPF_biquad_coeffs },
+    { &IIR_2k9_BPF, 5, IIR_2k9_BPF_biquad_coeffs },
+    { &IIR_3k2_LPF, 5, IIR_3k2_LPF_biquad_coeffs },
+    { &IIR_3k2_BPF, 5, IIR_3k2_BPF_biquad_coeffs },
+    { &IIR_3k4_LPF, 5, IIR_3k4_LPF_biquad_coeffs },
+    { &IIR_3k4_BPF, 5, IIR_3k4_BPF_biquad_coeffs },
+    { &IIR_3k6_LPF, 5, IIR_3k6_LPF_biquad_coeffs },
+    { &IIR_3k6_BPF, 5, IIR_3k6_BPF_biquad_coeffs },
+    { &IIR_3k8_LPF, 5, IIR_3k8_LPF_biquad_coeffs },
+    { &IIR_3k8_BPF, 5, IIR_3k8_BPF_biquad_coeffs },
+    { &IIR_300hz_500, 5, IIR_300hz_500_biquad_coeffs },
+    { &IIR_300hz_550, 5, IIR_300hz_550_biquad_coeffs },
+    { &IIR_300hz_600, 5, IIR_300hz_600_biquad_coeffs },
+    { &IIR_300hz_650, 5, IIR_300hz_650_biquad_coeffs },
+    { &IIR_300hz_700, 5, IIR_300hz_700_biquad_coeffs },
+    { &IIR_300hz_750, 5, IIR_300hz_750_biquad_coeffs },
+    { &IIR_300hz_800, 5, IIR_300hz_800_biquad_coeffs },
+    { &IIR_300hz_850, 5, IIR_300hz_850_biquad_coeffs },
+    { &IIR_300hz_900, 5, IIR_300hz_900_biquad_coeffs },
+    { &IIR_300hz_950, 5, IIR_300hz_950_biquad_coeffs },
+    { &IIR_500hz_550, 5, IIR_500hz_550_biquad_coeffs },
+    { &IIR_500hz_650, 5, IIR_500hz_650_biquad_coeffs },
+    { &IIR_500hz_750, 5, IIR_500hz_750_biquad_coeffs },
+    { &IIR_500hz_850, 5, IIR_500hz_850_biquad_coeffs },
+    { &IIR_500hz_950, 5, IIR_500hz_950_biquad_coeffs },
+    { &IIR_4k_LPF, 5, IIR_4k_LPF_biquad_coeffs },
+    { &IIR_4k2_LPF, 5, IIR_4k2_LPF_biquad_coeffs },
+    { &IIR_4k4_LPF, 5, IIR_4k4_LPF_biquad_coeffs },
+    { &IIR_4k6_LPF, 5, IIR_4k6_LPF_biquad_coeffs },
+    { &IIR_4k8_LPF, 5, IIR_4k8_LPF_biquad_coeffs },
+    { &IIR_5k_LPF, 5, IIR_5k_LPF_biquad_coeffs },
+    { &IIR_6k_LPF, 5, IIR_6k_LPF_biquad_coeffs },
+    { &IIR_7k5_LPF, 4, IIR_7k5_LPF_biquad_coeffs },
+    { &IIR_10k_LPF, 4, IIR_10k_LPF_biquad_coeffs },
+};
+
+const uint16_t IirRxBiquadInfo_num = sizeof(IirRxBiquadInfo)/sizeof(IirRxBiquadInfo[0]);
@@ -0,0 +1,90 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     iir_rx_design.c                                                 **
+ **  Description:   Specifications of the RX audio IIR filters for the designer     **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#include "filters.h"
+//
+// With USE_RX_IIR_DESIGNER the RX audio IIR filters are designed at runtime from these specifications
+// (drivers/audio/audio_iir_design.c) instead of using the coefficient tables in flash.
+// Each specification reproduces the lattice filter of the same name, support/host/iir_design_check
+// compares both.
+//
+// { f_low, f_high, order of the lowpass prototype, type, passband ripple in 0.1dB, stopband attenuation in dB }
+//
+// The sample rate follows from the filter path: audio filters run at IQ_SAMPLE_RATE / sample_rate_dec.
+//
+// The CW bandpass filters (300hz, 500hz) are least pth norm designs with 0.4 to 0.85dB passband ripple
+// and 55 to 60dB stopband attenuation, here they are elliptic with the same passband and comparable skirts.
+//
+
+// CW 300Hz, at 12ksps
+const IIR_DesignSpec IIR_300hz_500_spec = { 363, 635, 5, IIR_DESIGN_ELLIPTIC, 8, 60 };
+const IIR_DesignSpec IIR_300hz_550_spec = { 413, 685, 5, IIR_DESIGN_ELLIPTIC, 8, 60 };
+const IIR_DesignSpec IIR_300hz_600_spec = { 463, 735, 5, IIR_DESIGN_ELLIPTIC, 8, 60 };
+const IIR_DesignSpec IIR_300hz_650_spec = { 513, 785, 5, IIR_DESIGN_ELLIPTIC, 8, 60 };
+const IIR_DesignSpec IIR_300hz_700_spec = { 563, 835, 5, IIR_DESIGN_ELLIPTIC, 8, 60 };
+const IIR_DesignSpec IIR_300hz_750_spec = { 613, 885, 5, IIR_DESIGN_ELLIPTIC, 8, 60 };
+const IIR_DesignSpec IIR_300hz_800_spec = { 663, 935, 5, IIR_DESIGN_ELLIPTIC, 8, 60 };
+const IIR_DesignSpec IIR_300hz_850_spec = { 713, 985, 5, IIR_DESIGN_ELLIPTIC, 8, 60 };
+const IIR_DesignSpec IIR_300hz_900_spec = { 763, 1035, 5, IIR_DESIGN_ELLIPTIC, 8, 60 };
+const IIR_DesignSpec IIR_300hz_950_spec = { 813, 1085, 5, IIR_DESIGN_ELLIPTIC, 8, 60 };
+
+// CW 500Hz, at 12ksps
+const IIR_DesignSpec IIR_500hz_550_spec = { 320, 778, 5, IIR_DESIGN_ELLIPTIC, 8, 60 };
+const IIR_DesignSpec IIR_500hz_650_spec = { 420, 875, 5, IIR_DESIGN_ELLIPTIC, 8, 60 };
+const IIR_DesignSpec IIR_500hz_750_spec = { 525, 975, 5, IIR_DESIGN_ELLIPTIC, 8, 60 };
+const IIR_DesignSpec IIR_500hz_850_spec = { 625, 1075, 5, IIR_DESIGN_ELLIPTIC, 8, 60 };
+const IIR_DesignSpec IIR_500hz_950_spec = { 720, 1170, 5, IIR_DESIGN_ELLIPTIC, 8, 60 };
+
+// SSB and AM/SAM audio filters, at 12ksps
+const IIR_DesignSpec IIR_1k4_LPF_spec = { 0, 1400, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_1k4_BPF_spec = { 150, 1400, 5, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_1k6_LPF_spec = { 0, 1600, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_1k6_BPF_spec = { 150, 1600, 5, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_1k8_1k125_spec = { 268, 1946, 5, IIR_DESIGN_ELLIPTIC, 5, 60 };
+const IIR_DesignSpec IIR_1k8_1k275_spec = { 424, 2100, 5, IIR_DESIGN_ELLIPTIC, 5, 60 };
+const IIR_DesignSpec IIR_1k8_1k425_spec = { 582, 2250, 5, IIR_DESIGN_ELLIPTIC, 5, 60 };
+const IIR_DesignSpec IIR_1k8_1k575_spec = { 735, 2412, 5, IIR_DESIGN_ELLIPTIC, 5, 60 };
+const IIR_DesignSpec IIR_1k8_1k725_spec = { 890, 2562, 5, IIR_DESIGN_ELLIPTIC, 5, 60 };
+const IIR_DesignSpec IIR_1k8_LPF_spec = { 0, 1800, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_2k1_LPF_spec = { 0, 2100, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_2k1_BPF_spec = { 150, 2100, 5, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_2k3_1k275_spec = { 162, 2316, 5, IIR_DESIGN_ELLIPTIC, 5, 60 };
+const IIR_DesignSpec IIR_2k3_1k412_spec = { 320, 2480, 5, IIR_DESIGN_ELLIPTIC, 5, 60 };
+const IIR_DesignSpec IIR_2k3_1k562_spec = { 477, 2636, 5, IIR_DESIGN_ELLIPTIC, 5, 60 };
+const IIR_DesignSpec IIR_2k3_1k712_spec = { 635, 2786, 5, IIR_DESIGN_ELLIPTIC, 5, 60 };
+const IIR_DesignSpec IIR_2k3_LPF_spec = { 0, 2300, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_2k5_LPF_spec = { 0, 2500, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_2k5_BPF_spec = { 150, 2500, 5, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_2k7_LPF_spec = { 0, 2700, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_2k7_BPF_spec = { 120, 2700, 5, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_2k9_LPF_spec = { 0, 2900, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_2k9_BPF_spec = { 150, 2900, 5, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_3k2_LPF_spec = { 0, 3200, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_3k2_BPF_spec = { 150, 3200, 5, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_3k4_LPF_spec = { 0, 3400, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_3k4_BPF_spec = { 150, 3400, 5, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_3k6_LPF_spec = { 0, 3600, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_3k6_BPF_spec = { 150, 3466, 5, IIR_DESIGN_ELLIPTIC, 5, 60 };
+const IIR_DesignSpec IIR_3k8_LPF_spec = { 0, 3800, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_3k8_BPF_spec = { 150, 3800, 5, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_4k_LPF_spec = { 0, 4000, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_4k2_LPF_spec = { 0, 4200, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_4k4_LPF_spec = { 0, 4400, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_4k6_LPF_spec = { 0, 4600, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_4k8_LPF_spec = { 0, 4800, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+
+// AM/SAM audio filters, at 24ksps
+const IIR_DesignSpec IIR_5k_LPF_spec = { 0, 5000, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_6k_LPF_spec = { 0, 6000, 10, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_7k5_LPF_spec = { 0, 7500, 8, IIR_DESIGN_ELLIPTIC, 10, 60 };
+const IIR_DesignSpec IIR_10k_LPF_spec = { 0, 10000, 8, IIR_DESIGN_ELLIPTIC, 10, 60 };
@@ -33,146 +33,8 @@ struct freedv *f_FREEDV;
 
 FDV_Audio_Buffer fdv_audio_buff[FDV_BUFFER_AUDIO_NUM];
 
-FDV_IQ_Buffer* fdv_iq_buffers[FDV_BUFFER_IQ_FIFO_SIZE];
-
-
-__IO int32_t fdv_iq_head = 0;
-__IO int32_t fdv_iq_tail = 0;
-
-int fdv_iq_buffer_peek(FDV_IQ_Buffer** c_ptr)
-{
-    int ret = 0;
-
-    if (fdv_iq_head != fdv_iq_tail)
-    {
-        FDV_IQ_Buffer* c = fdv_iq_buffers[fdv_iq_tail];
-        *c_ptr = c;
-        ret++;
-    }
-    return ret;
-}
-
-
-int fdv_iq_buffer_remove(FDV_IQ_Buffer** c_ptr)
-{
-    int ret = 0;
-
-    if (fdv_iq_head != fdv_iq_tail)
-    {
-        FDV_IQ_Buffer* c = fdv_iq_buffers[fdv_iq_tail];
-        fdv_iq_tail = (fdv_iq_tail + 1) % FDV_BUFFER_IQ_FIFO_SIZE;
-        *c_ptr = c;
-        ret++;
-    }
-    return ret;
-}
-
-/* no room left in the buffer returns 0 */
-int fdv_iq_buffer_add(FDV_IQ_Buffer* c)
-{
-    int ret = 0;
-    int32_t next_head = (fdv_iq_head + 1) % FDV_BUFFER_IQ_FIFO_SIZE;
-
-    if (next_head != fdv_iq_tail)
-    {
-        /* there is room */
-        fdv_iq_buffers[fdv_iq_head] = c;
-        fdv_iq_head = next_head;
-        ret ++;
-    }
-    return ret;
-}
-
-void fdv_iq_buffer_reset()
-{
-    fdv_iq_tail = fdv_iq_head;
-}
-
-int32_t fdv_iq_has_data()
-{
-    int32_t len = fdv_iq_head - fdv_iq_tail;
-    return len < 0?len+FDV_BUFFER_IQ_FIFO_SIZE:len;
-}
-
-int32_t fdv_iq_has_room()
-{
-    // FIXME: Since we cannot completely fill the buffer
-    // we need to say full 1 element earlier
-    return FDV_BUFFER_IQ_FIFO_SIZE - 1 - fdv_iq_has_data();
-}
-
-
-
-#define FDV_BUFFER_AUDIO_FIFO_SIZE (FDV_BUFFER_AUDIO_NUM+1)
-// we allow for one more pointer to a buffer as we have buffers
-// why? because our implementation will only fill up the fifo only to N-1 elements
-
-FDV_Audio_Buffer* fdv_audio_buffers[FDV_BUFFER_AUDIO_FIFO_SIZE];
-__IO int32_t fdv_audio_head = 0;
-__IO int32_t fdv_audio_tail = 0;
-
-int fdv_audio_buffer_peek(FDV_Audio_Buffer** c_ptr)
-{
-    int ret = 0;
-
-    if (fdv_audio_head != fdv_audio_tail)
-    {
-        FDV_Audio_Buffer* c = fdv_audio_buffers[fdv_audio_tail];
-        *c_ptr = c;
-        ret++;
-    }
-    return ret;
-}
-
-
-int fdv_audio_buffer_remove(FDV_Audio_Buffer** c_ptr)
-{
-    int ret = 0;
-
-    if (fdv_audio_head != fdv_audio_tail)
-    {
-        FDV_Audio_Buffer* c = fdv_audio_buffers[fdv_audio_tail];
-        fdv_audio_tail = (fdv_audio_tail + 1) % FDV_BUFFER_AUDIO_FIFO_SIZE;
-        *c_ptr = c;
-        ret++;
-    }
-    return ret;
-}
-
-/* no room left in the buffer returns 0 */
-int fdv_audio_buffer_add(FDV_Audio_Buffer* c)
-{
-    int ret = 0;
-    int32_t next_head = (fdv_audio_head + 1) % FDV_BUFFER_AUDIO_FIFO_SIZE;
-
-    if (next_head != fdv_audio_tail)
-    {
-        /* there is room */
-        fdv_audio_buffers[fdv_audio_head] = c;
-        fdv_audio_head = next_head;
-        ret ++;
-    }
-    return ret;
-}
-
-void fdv_audio_buffer_reset()
-{
-    fdv_audio_tail = fdv_audio_head;
-}
-
-int32_t fdv_audio_has_data()
-{
-    int32_t len = fdv_audio_head - fdv_audio_tail;
-    return len < 0?len+FDV_BUFFER_AUDIO_FIFO_SIZE:len;
-}
-
-int32_t fdv_audio_has_room()
-{
-    // FIXME: Since we cannot completely fill the buffer
-    // we need to say full 1 element earlier
-    return FDV_BUFFER_AUDIO_FIFO_SIZE - 1 - fdv_audio_has_data();
-}
-
+FdvIqBufferRing fdv_iq_ring;
+FdvAudioBufferRing fdv_audio_ring;
 
 
 typedef struct {
@@ -253,25 +115,25 @@ void FreeDv_HandleFreeDv()
         tx_was_here = false; //set to false to detect the first entry after switching to TX
         rx_was_here = false;
         fdv_current_buffer_idx = 0;
-        fdv_audio_buffer_reset();
-        fdv_iq_buffer_reset();
+        FdvAudioBufferRing_Reset(&fdv_audio_ring);
+        FdvIqBufferRing_Reset(&fdv_iq_ring);
     }
     //will later be inside RX
     if (ts.digital_mode == DigitalMode_FreeDV) {  // if we are in freedv1-mode and ...
-        if ((ts.txrx_mode == TRX_MODE_TX) && fdv_audio_has_data() && fdv_iq_has_room())
+        if ((ts.txrx_mode == TRX_MODE_TX) && FdvAudioBufferRing_Fill(&fdv_audio_ring) && FdvIqBufferRing_Room(&fdv_iq_ring))
         {           // ...and if we are transmitting and samples from dv_tx_processor are ready
 
             tx_was_here = true;
             fdv_current_buffer_idx %= FDV_BUFFER_IQ_NUM;
 
             FDV_Audio_Buffer* input_buf = NULL;
-            fdv_audio_buffer_remove(&input_buf);
+            FdvAudioBufferRing_Get(&fdv_audio_ring, &input_buf);
 
             freedv_comptx(f_FREEDV,
                     mmb.fdv_iq_buff[fdv_current_buffer_idx].samples,
                     input_buf->samples); // start the encoding process
 
-            fdv_iq_buffer_add(&mmb.fdv_iq_buff[fdv_current_buffer_idx]);
+            FdvIqBufferRing_Put(&fdv_iq_ring, &mmb.fdv_iq_buff[fdv_current_buffer_idx]);
 
             // to bypass the encoding
             // for (s=0;s<320;s++)
@@ -310,9 +172,9 @@ void FreeDv_HandleFreeDv()
 
             // while makes this highest prio
             // if may give more responsiveness but can cause interrupted reception
-            while (fdv_iq_has_data() && fdv_audio_has_room())
-                // while (fdv_audio_has_room())
-                // if (fdv_iq_has_data() && fdv_audio_has_room())
+            while (FdvIqBufferRing_Fill(&fdv_iq_ring) && FdvAudioBufferRing_Room(&fdv_audio_ring))
+                // while (FdvAudioBufferRing_Room(&fdv_audio_ring))
+                // if (FdvIqBufferRing_Fill(&fdv_iq_ring) && FdvAudioBufferRing_Room(&fdv_audio_ring))
             {
                 // MchfBoard_GreenLed(LED_STATE_OFF);
 
@@ -329,7 +191,7 @@ void FreeDv_HandleFreeDv()
                     // See below
                     if  (inBuf == NULL)
                     {
-                        fdv_iq_buffer_peek(&inBuf);
+                        FdvIqBufferRing_Peek(&fdv_iq_ring, &inBuf);
 #ifdef DEBUG_FREEDV
                         // here we simulate input using pre-generated data
                         static  int iq_testidx  = 0;
@@ -350,12 +212,12 @@ void FreeDv_HandleFreeDv()
                     {
                         memcpy(&iq_buffer[inBufCtrl.offset],&inBuf->samples[inBufCtrl.start],(FDV_BUFFER_SIZE-inBufCtrl.start)*sizeof(COMP));
                         inBufCtrl.offset += FDV_BUFFER_SIZE-inBufCtrl.start;
-                        fdv_iq_buffer_remove(&inBuf);
+                        FdvIqBufferRing_Get(&fdv_iq_ring, &inBuf);
                         inBuf = NULL;
 
                         // if there is no buffer available, leave the whole
                         // function, next time we'll have more data ready here
-                        leave_now = (fdv_iq_has_data() == 0);
+                        leave_now = (FdvIqBufferRing_Fill(&fdv_iq_ring) == 0);
                         if (leave_now)
                         {
                             break;
@@ -395,14 +257,14 @@ void FreeDv_HandleFreeDv()
 
                             outBufCtrl.offset += FDV_BUFFER_SIZE-outBufCtrl.start;
 
-                            fdv_audio_buffer_add(&fdv_audio_buff[fdv_current_buffer_idx]);
+                            FdvAudioBufferRing_Put(&fdv_audio_ring, &fdv_audio_buff[fdv_current_buffer_idx]);
                             fdv_current_buffer_idx ++;
                             fdv_current_buffer_idx %= FDV_BUFFER_AUDIO_NUM;
                             outBufCtrl.start = 0;
 
                             if (outBufCtrl.count > outBufCtrl.offset) {
                                 // do we have more data? no -> leave the whole function
-                                leave_now = (fdv_audio_has_room() == 0);
+                                leave_now = (FdvAudioBufferRing_Room(&fdv_audio_ring) == 0);
                                 if (leave_now)
                                 {
                                     break;
@@ -15,6 +15,7 @@
  **  Licence:       GNU GPLv3                                                      **
  ************************************************************************************/
 #include "uhsdr_board.h"
+#include "ring_buffer.h"
 
 
 #define FDV_BUFFER_SIZE     320
@@ -63,22 +64,13 @@ void FreeDv_DisplayClear();
 void FreeDv_DisplayPrepare();
 void FreeDv_DisplayUpdate();
 
-int fdv_iq_buffer_peek(FDV_IQ_Buffer** c_ptr);
-int fdv_iq_buffer_remove(FDV_IQ_Buffer** c_ptr);
-/* no room left in the buffer returns 0 */
-int fdv_iq_buffer_add(FDV_IQ_Buffer* c);
-void fdv_iq_buffer_reset();
-int32_t fdv_iq_has_data();
-int32_t fdv_iq_has_room();
+// filled buffers are handed between audio interrupt and FreeDv_HandleFreeDv(),
+// RX: IQ (demodulated audio) to the codec, decoded speech back; TX: microphone to the codec, modulation back
+RING_BUFFER_BLOCK_DEFINE(FdvIqBufferRing, FDV_IQ_Buffer, FDV_BUFFER_IQ_NUM)
+RING_BUFFER_BLOCK_DEFINE(FdvAudioBufferRing, FDV_Audio_Buffer, FDV_BUFFER_AUDIO_NUM)
 
-
-int fdv_audio_buffer_peek(FDV_Audio_Buffer** c_ptr);
-int fdv_audio_buffer_remove(FDV_Audio_Buffer** c_ptr);
-/* no room left in the buffer returns 0 */
-int fdv_audio_buffer_add(FDV_Audio_Buffer* c);
-void fdv_audio_buffer_reset();
-int32_t fdv_audio_has_data();
-int32_t fdv_audio_has_room();
+extern FdvIqBufferRing fdv_iq_ring;
+extern FdvAudioBufferRing fdv_audio_ring;
 
 #endif
 #if defined(USE_FREEDV) || defined(USE_ALTERNATE_NR)
@@ -86,16 +78,6 @@ int32_t fdv_audio_has_room();
 
 extern MultiModeBuffer_t mmb;
 
-// we allow for one more pointer to a buffer as we have buffers
-// why? because our implementation will only fill up the fifo only to N-1 elements
-#define FDV_BUFFER_IQ_FIFO_SIZE (FDV_BUFFER_IQ_NUM+1)
-#define NR_BUFFER_FIFO_SIZE (NR_BUFFER_NUM+1)
-
-
 extern FDV_Audio_Buffer fdv_audio_buff[FDV_BUFFER_AUDIO_NUM];
-
-
-// we allow for one more pointer to a buffer as we have buffers
-// why? because our implementation will only fill up the fifo only to N-1 elements
 #endif
 #endif
@@ -22,6 +22,7 @@
 #include "ui_driver.h"
 #include "rtty.h"
 #include "radio_management.h"
+#include "ring_buffer.h"
 
 
 
@@ -640,7 +641,7 @@ void RttyDecoder_ProcessSample(float32_t sample)
 		// reading 7 more bits
 		if (rttyDecoderData.byteResultp < 8)
 		{
-			bool bitResult;
+			bool bitResult = false;
 			if (RttyDecoder_getBitDPLL(sample, &bitResult))
 			{
 				switch (rttyDecoderData.byteResultp)
@@ -672,7 +673,7 @@ void RttyDecoder_ProcessSample(float32_t sample)
 		}
 		if (rttyDecoderData.byteResultp == 8 && rttyDecoderData.state == RTTY_RUN_STATE_BIT)
 		{
-			char charResult;
+			char charResult = 0;
 
 			switch (rttyDecoderData.byteResult) {
 			case RTTY_LETTER_CODE:
@@ -732,57 +733,39 @@ rtty_tx_encoder_state_t  rtty_tx =
 
 #define DIGIMODES_TX_BUFFER_SIZE  128
 
-static __IO uint8_t digimodes_tx_buffer[DIGIMODES_TX_BUFFER_SIZE];
-static __IO int32_t digimodes_tx_buffer_head = 0;
-static __IO int32_t digimodes_tx_tail = 0;
+// filled by the user interface and the CW decoder, emptied by the digimode modulators
+RING_BUFFER_DEFINE(DigiModesTxRing, uint8_t, DIGIMODES_TX_BUFFER_SIZE)
+static DigiModesTxRing digimodes_tx_ring;
 
 uint8_t DigiModes_TxBufferHasData()
 {
-    int32_t len = digimodes_tx_buffer_head - digimodes_tx_tail;
-    return len < 0?len+DIGIMODES_TX_BUFFER_SIZE:len;
+    return DigiModesTxRing_Fill(&digimodes_tx_ring);
 }
 
 int DigiModes_TxBufferRemove(uint8_t* c_ptr)
 {
-	int ret = 0;
-
-    if (digimodes_tx_buffer_head != digimodes_tx_tail)
-    {
-        int c = digimodes_tx_buffer[digimodes_tx_tail];
-        digimodes_tx_tail = (digimodes_tx_tail + 1) % DIGIMODES_TX_BUFFER_SIZE;
-        *c_ptr = (uint8_t)c;
-        ret++;
-    }
-    return ret;
+    return DigiModesTxRing_Get(&digimodes_tx_ring, c_ptr);
 }
 
 /* no room left in the buffer returns 0 */
 int DigiModes_TxBufferPutChar(uint8_t c)
 {
-	int ret = 0;
-    int32_t next_head = (digimodes_tx_buffer_head + 1) % DIGIMODES_TX_BUFFER_SIZE;
-
-    if (next_head != digimodes_tx_tail)
-    {
-        /* there is room */
-        digimodes_tx_buffer[digimodes_tx_buffer_head] = c;
-        digimodes_tx_buffer_head = next_head;
-        ret ++;
-    }
-    return ret;
+    return DigiModesTxRing_Put(&digimodes_tx_ring, c);
 }
 
+// the sign is published as a whole, so the modulator never sees half of it
 void DigiModes_TxBufferPutSign(const char* s)
 {
-	DigiModes_TxBufferPutChar('<');
-	DigiModes_TxBufferPutChar(s[0]);
-	DigiModes_TxBufferPutChar(s[1]);
-	DigiModes_TxBufferPutChar('>');
+    const uint8_t sign[4] = { '<', s[0], s[1], '>' };
+    if (DigiModesTxRing_Room(&digimodes_tx_ring) >= sizeof(sign))
+    {
+        DigiModesTxRing_Write(&digimodes_tx_ring, sign, sizeof(sign));
+    }
 }
 
 void DigiModes_TxBufferReset()
 {
-    digimodes_tx_tail = digimodes_tx_buffer_head;
+    DigiModesTxRing_Reset(&digimodes_tx_ring);
 }
 
 
@@ -863,7 +846,7 @@ int16_t Rtty_Modulator_GenSample()
 			bool bitsFilled = false;
 			while (DigiModes_TxBufferHasData() && bitsFilled == false)
 			{
-				uint8_t current_ascii;
+				uint8_t current_ascii = 0;
 				DigiModes_TxBufferRemove(&current_ascii);
 				uint8_t current_baudot = Ascii2Baudot[current_ascii & 0x7f];
 				if (current_baudot > 0)
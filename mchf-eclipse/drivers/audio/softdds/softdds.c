@@ -27,6 +27,11 @@ soft_dds_t dbldds[2];
 
 uint32_t softdds_stepForSampleRate(float32_t freq, uint32_t samp_rate)
 {
+    if (freq < 0)
+    {
+        // negative frequencies let the accumulator run backwards
+        return -softdds_stepForSampleRate(-freq, samp_rate);
+    }
     uint64_t freq64_shifted = freq * DDS_TBL_SIZE;
     freq64_shifted <<= DDS_ACC_SHIFT;
     uint64_t step = freq64_shifted / samp_rate;
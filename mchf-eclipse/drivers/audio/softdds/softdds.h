@@ -49,7 +49,27 @@ inline int16_t softdds_nextSample(soft_dds_t* dds)
 	return DDS_TABLE[softdds_nextSampleIndex(dds)];
 }
 
+/**
+ * Execute a single step and return cosine and sine of the accumulator phase with an amplitude of 1.0.
+ * In contrast to softdds_nextSample() the value is linearly interpolated between the table entries using
+ * the lower accumulator bits, this brings the spurs for arbitrary frequencies down to the table resolution (~ -90dBc).
+ */
+static inline void softdds_nextSampleCosSinInterpolated(soft_dds_t* dds, float32_t* cos_val, float32_t* sin_val)
+{
+	const uint32_t acc = dds->acc;
+	dds->acc += dds->step;
+
+	const uint32_t k = (acc >> DDS_ACC_SHIFT)%DDS_TBL_SIZE;
+	const uint32_t kc = (k + DDS_TBL_SIZE/4)%DDS_TBL_SIZE; // +90 degrees
+	const float32_t frac = (acc & ((1 << DDS_ACC_SHIFT) - 1)) * (1.0f / (1 << DDS_ACC_SHIFT));
+
+	const float32_t s0 = DDS_TABLE[k];
+	const float32_t c0 = DDS_TABLE[kc];
+	*sin_val = (s0 + (DDS_TABLE[(k + 1)%DDS_TBL_SIZE] - s0) * frac) * (1.0f / INT16_MAX);
+	*cos_val = (c0 + (DDS_TABLE[(kc + 1)%DDS_TBL_SIZE] - c0) * frac) * (1.0f / INT16_MAX);
+}
 
+uint32_t softdds_stepForSampleRate(float32_t freq, uint32_t samp_rate);
 void softdds_setFreqDDS(soft_dds_t* dds, float32_t freq, uint32_t samp_rate, uint8_t smooth);
 void softdds_genIQSingleTone(soft_dds_t* dds, float32_t *i_buff,float32_t *q_buff,uint16_t size);
 void softdds_genIQTwoTone(soft_dds_t* ddsA, soft_dds_t* ddsB, float *i_buff,float *q_buff,ushort size);
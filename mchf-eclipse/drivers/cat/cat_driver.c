@@ -22,6 +22,7 @@
 #include "audio_driver.h"
 #include "radio_management.h"
 #include "config_storage.h"
+#include "ring_buffer.h"
 
 uint8_t limit_4bits(uint32_t in)
 {
@@ -96,54 +97,26 @@ CatInterfaceState CatDriver_GetInterfaceState()
 
 
 #define CAT_BUFFER_SIZE 256
-__IO uint8_t cat_buffer[CAT_BUFFER_SIZE];
-__IO int32_t cat_head = 0;
-__IO int32_t cat_tail = 0;
+// filled by the USB interrupt, emptied by CatDriver_HandleProtocol()
+RING_BUFFER_DEFINE(CatRing, uint8_t, CAT_BUFFER_SIZE)
+static CatRing cat_ring;
 
-static uint8_t CatDriver_InterfaceBufferHasData()
+static uint32_t CatDriver_InterfaceBufferHasData()
 {
-    int32_t len = cat_head - cat_tail;
-    return len < 0?len+CAT_BUFFER_SIZE:len;
+    return CatRing_Fill(&cat_ring);
 }
 
-
-
-static int cat_buffer_remove(uint8_t* c_ptr)
+/* returns the number of bytes stored, the rest is dropped if there is no room left */
+uint32_t CatDriver_InterfaceBufferAddData(const uint8_t* Buf, uint32_t Len)
 {
-	int ret = 0;
-
-    if (cat_head != cat_tail)
+    uint32_t ret = CatRing_Write(&cat_ring, Buf, Len);
+    if (ret)
     {
-        int c = cat_buffer[cat_tail];
-        cat_tail = (cat_tail + 1) % CAT_BUFFER_SIZE;
-        *c_ptr = (uint8_t)c;
-        ret++;
-    }
-    return ret;
-}
-
-/* no room left in the buffer returns 0 */
-int CatDriver_InterfaceBufferAddData(uint8_t c)
-{
-	int ret = 0;
-    int32_t next_head = (cat_head + 1) % CAT_BUFFER_SIZE;
-
-    if (next_head != cat_tail)
-    {
-        /* there is room */
-        cat_buffer[cat_head] = c;
-        cat_head = next_head;
         cat_driver.lastbufferadd_time = ts.sysclock;
-        ret ++;
     }
     return ret;
 }
 
-static void cat_buffer_reset()
-{
-    cat_tail = cat_head;
-}
-
 #define CAT_DRIVER_TIMEOUT 30
 // defined in increments of 10ms, needs to be longer than the longest running operation
 // the mcHF can do. It seems band switching is taking longest time.
@@ -173,7 +146,7 @@ static void cat_driver_sync_data( void)
             while(bufsz)
             {
                 uint8_t c;
-                cat_buffer_remove(&c);
+                CatRing_Get(&cat_ring, &c);
                 bufsz--;
             }
         }
@@ -185,10 +158,7 @@ static uint8_t CatDriver_InterfaceBufferGetData(uint8_t* Buf,uint32_t Len)
     uint8_t res = 0;
     if (CatDriver_InterfaceBufferHasData() >= Len)
     {
-        for  (int i = 0; i < Len; i++)
-        {
-            cat_buffer_remove(&Buf[i]);
-        }
+        CatRing_Read(&cat_ring, Buf, Len);
         res = 1;
     }
     return res;
@@ -1309,7 +1279,7 @@ void CatDriver_HandleProtocol()
     {
         if (ft817.state != CAT_INIT)
         {
-            cat_buffer_reset();
+            CatRing_Reset(&cat_ring);
             ft817.state = CAT_INIT;
         }
     }
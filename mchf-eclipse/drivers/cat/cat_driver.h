@@ -34,7 +34,7 @@ typedef enum
 
 CatInterfaceState CatDriver_GetInterfaceState();
 
-int CatDriver_InterfaceBufferAddData(uint8_t c);
+uint32_t CatDriver_InterfaceBufferAddData(const uint8_t* Buf, uint32_t Len);
 
 void CatDriver_HandleProtocol();
 
@@ -0,0 +1,450 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     ui_compositor.c                                                 **
+ **  Description:   Deferred drawing of the desktop widgets with redundancy check   **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+// The desktop widgets (frequency digits, meters, voltage, clock, AGC box, text line ...) are
+// updated from the state machine of the main loop, mostly by drawing the same content again.
+// Instead of drawing directly they hand their draw operations to the compositor which keeps them
+// until UiCompositor_Flush() is called once per main loop pass.
+//
+// For each region drawn the compositor remembers the position, size and a hash of the content.
+// An operation whose region shows the same content already is dropped. Queued operations which
+// touch each other (single digits of the frequency, adjacent rectangles of the same colour) are
+// drawn as one. A flush ends after the time budget, the rest is drawn by the next flush.
+//
+// The compositor knows only what it has drawn itself. Code which draws directly over a widget has
+// to call UiCompositor_InvalidateRect() for that area, UiCompositor_Reset() forgets everything.
+
+#include <string.h>
+#include "ui_compositor.h"
+#include "ui_lcd_hy28.h"
+
+typedef enum
+{
+    COMP_OP_TEXT = 0,
+    COMP_OP_TEXT_CENTERED,
+    COMP_OP_FILL,
+} UiCompositor_OpType;
+
+typedef struct
+{
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+} UiCompositor_Rect;
+
+typedef struct
+{
+    UiCompositor_Rect area;     // the area the operation draws to, its position identifies the region
+    uint32_t hash;              // of type, area, colours, font and text
+    uint16_t clr_fg;            // fill colour of COMP_OP_FILL
+    uint16_t clr_bg;
+    uint16_t text;              // offset of the zero terminated text in the text pool
+    uint8_t len;
+    uint8_t font;
+    uint8_t type;
+} UiCompositor_Op;
+
+typedef struct
+{
+    UiCompositor_Rect area;     // w == 0 marks an unused entry
+    uint32_t hash;
+} UiCompositor_Region;
+
+static struct
+{
+    UiCompositor_Op op[UI_COMPOSITOR_OPS];
+    uint8_t op_num;
+    uint16_t text_used;
+    char text[UI_COMPOSITOR_TEXT_POOL];
+    UiCompositor_Region region[UI_COMPOSITOR_REGIONS];
+    uint8_t region_victim;      // next region to reuse if all are in use
+} comp;
+
+// the longest text which is merged from several operations
+#define COMP_MERGE_TEXT_MAX     ui_txt_msg_buffer_size
+
+/**
+ * @brief forgets all known regions and queued operations, call this after clearing the screen
+ */
+void UiCompositor_Reset()
+{
+    memset(&comp, 0, sizeof(comp));
+}
+
+static bool UiCompositor_RectOverlap(const UiCompositor_Rect* a, const UiCompositor_Rect* b)
+{
+    return a->x < b->x + b->w && b->x < a->x + a->w && a->y < b->y + b->h && b->y < a->y + a->h;
+}
+
+static bool UiCompositor_RectCovers(const UiCompositor_Rect* outer, const UiCompositor_Rect* inner)
+{
+    return outer->x <= inner->x && outer->y <= inner->y
+            && outer->x + outer->w >= inner->x + inner->w && outer->y + outer->h >= inner->y + inner->h;
+}
+
+/**
+ * @brief the content of the regions in this area is unknown from now on, e.g. because something else has been drawn there
+ */
+void UiCompositor_InvalidateRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    const UiCompositor_Rect area = { .x = x, .y = y, .w = w, .h = h };
+
+    for (uint16_t idx = 0; idx < UI_COMPOSITOR_REGIONS; idx++)
+    {
+        if (comp.region[idx].area.w != 0 && UiCompositor_RectOverlap(&comp.region[idx].area, &area))
+        {
+            comp.region[idx].area.w = 0;
+        }
+    }
+}
+
+/**
+ * @brief FNV-1a
+ */
+static uint32_t UiCompositor_Hash(uint32_t hash, const void* data, uint32_t len)
+{
+    const uint8_t* bytes = data;
+    for (uint32_t idx = 0; idx < len; idx++)
+    {
+        hash = (hash ^ bytes[idx]) * 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t UiCompositor_OpHash(const UiCompositor_Op* op)
+{
+    uint32_t hash = 2166136261u;
+    hash = UiCompositor_Hash(hash, &op->type, sizeof(op->type));
+    hash = UiCompositor_Hash(hash, &op->area, sizeof(op->area));
+    hash = UiCompositor_Hash(hash, &op->clr_fg, sizeof(op->clr_fg));
+    hash = UiCompositor_Hash(hash, &op->clr_bg, sizeof(op->clr_bg));
+    hash = UiCompositor_Hash(hash, &op->font, sizeof(op->font));
+    return UiCompositor_Hash(hash, &comp.text[op->text], op->len);
+}
+
+/**
+ * @returns true if the region of the operation does not show its content already
+ */
+static bool UiCompositor_OpNeedsDraw(const UiCompositor_Op* op)
+{
+    bool retval = true;
+    for (uint16_t idx = 0; idx < UI_COMPOSITOR_REGIONS; idx++)
+    {
+        const UiCompositor_Region* region = &comp.region[idx];
+        if (region->area.w != 0 && region->area.x == op->area.x && region->area.y == op->area.y)
+        {
+            retval = region->hash != op->hash;
+            break;
+        }
+    }
+    return retval;
+}
+
+/**
+ * @brief records the content drawn by the operation, regions it has drawn over are unknown now
+ */
+static void UiCompositor_RegionStore(const UiCompositor_Op* op)
+{
+    UiCompositor_Region* region = NULL;
+    UiCompositor_Region* unused = NULL;
+
+    for (uint16_t idx = 0; idx < UI_COMPOSITOR_REGIONS; idx++)
+    {
+        UiCompositor_Region* r = &comp.region[idx];
+        if (r->area.w == 0)
+        {
+            unused = unused == NULL ? r : unused;
+        }
+        else if (r->area.x == op->area.x && r->area.y == op->area.y)
+        {
+            region = r;
+        }
+        else if (UiCompositor_RectOverlap(&r->area, &op->area))
+        {
+            r->area.w = 0;
+            unused = unused == NULL ? r : unused;
+        }
+    }
+
+    if (region == NULL)
+    {
+        region = unused;
+    }
+    if (region == NULL)
+    {
+        // all in use, forgetting a region costs only a redraw
+        region = &comp.region[comp.region_victim];
+        comp.region_victim = (comp.region_victim + 1) % UI_COMPOSITOR_REGIONS;
+    }
+    region->area = op->area;
+    region->hash = op->hash;
+}
+
+static void UiCompositor_OpDraw(const UiCompositor_Op* op, const char* text)
+{
+    switch(op->type)
+    {
+    case COMP_OP_TEXT:
+        UiLcdHy28_PrintText(op->area.x, op->area.y, text, op->clr_fg, op->clr_bg, op->font);
+        break;
+    case COMP_OP_TEXT_CENTERED:
+        // the area is at least as wide as the text, so this draws the same as with the original box width
+        UiLcdHy28_PrintTextCentered(op->area.x, op->area.y, op->area.w, text, op->clr_fg, op->clr_bg, op->font);
+        break;
+    case COMP_OP_FILL:
+        UiLcdHy28_DrawFullRect(op->area.x, op->area.y, op->area.h, op->area.w, op->clr_fg);
+        break;
+    }
+}
+
+/**
+ * @returns true if the single line texts or rectangles of the same colours touch each other and can be drawn as one
+ */
+static bool UiCompositor_OpMergeable(const UiCompositor_Op* merged, const UiCompositor_Op* op, uint16_t text_len)
+{
+    bool retval = false;
+
+    if (op->type == merged->type && op->clr_fg == merged->clr_fg && UiCompositor_OpNeedsDraw(op))
+    {
+        const UiCompositor_Rect* a = &merged->area;
+        const UiCompositor_Rect* b = &op->area;
+        const bool horizontal = a->y == b->y && a->h == b->h && (a->x + a->w == b->x || b->x + b->w == a->x);
+        const bool vertical = a->x == b->x && a->w == b->w && (a->y + a->h == b->y || b->y + b->h == a->y);
+
+        switch(op->type)
+        {
+        case COMP_OP_TEXT:
+            retval = horizontal && op->clr_bg == merged->clr_bg && op->font == merged->font
+                    && text_len + op->len < COMP_MERGE_TEXT_MAX
+                    && memchr(&comp.text[op->text], '\n', op->len) == NULL;
+            break;
+        case COMP_OP_FILL:
+            retval = horizontal || vertical;
+            break;
+        }
+    }
+    return retval;
+}
+
+/**
+ * @brief draws the operation together with the following ones it can be merged with
+ * @returns index of the first operation not drawn
+ */
+static uint8_t UiCompositor_OpDrawMerged(uint8_t first)
+{
+    UiCompositor_Op merged = comp.op[first];
+    char text[COMP_MERGE_TEXT_MAX];
+    uint16_t text_len = 0;
+    uint8_t next = first + 1;
+
+    const bool mergeable = (merged.type == COMP_OP_TEXT && merged.len < COMP_MERGE_TEXT_MAX
+            && memchr(&comp.text[merged.text], '\n', merged.len) == NULL) || merged.type == COMP_OP_FILL;
+
+    if (mergeable)
+    {
+        memcpy(text, &comp.text[merged.text], merged.len);
+        text_len = merged.len;
+
+        for (; next < comp.op_num && UiCompositor_OpMergeable(&merged, &comp.op[next], text_len); next++)
+        {
+            const UiCompositor_Op* op = &comp.op[next];
+            if (op->area.x < merged.area.x || op->area.y < merged.area.y)
+            {
+                // in front of what we have
+                memmove(&text[op->len], text, text_len);
+                memcpy(text, &comp.text[op->text], op->len);
+                merged.area.x = op->area.x;
+                merged.area.y = op->area.y;
+            }
+            else
+            {
+                memcpy(&text[text_len], &comp.text[op->text], op->len);
+            }
+            text_len += op->len;
+            if (merged.area.y == op->area.y)
+            {
+                merged.area.w += op->area.w;
+            }
+            else
+            {
+                merged.area.h += op->area.h;
+            }
+        }
+        text[text_len] = '\0';
+    }
+
+    UiCompositor_OpDraw(&merged, mergeable ? text : &comp.text[merged.text]);
+
+    for (uint8_t idx = first; idx < next; idx++)
+    {
+        UiCompositor_RegionStore(&comp.op[idx]);
+    }
+    return next;
+}
+
+/**
+ * @brief draws the queued operations which change the screen content
+ *
+ * Called once per main loop pass.
+ *
+ * @param budget time in ms after which the remaining operations are left for the next call, 0 to draw all
+ */
+void UiCompositor_Flush(uint32_t budget)
+{
+    const uint32_t start = HAL_GetTick();
+    uint8_t idx = 0;
+
+    while (idx < comp.op_num)
+    {
+        if (UiCompositor_OpNeedsDraw(&comp.op[idx]))
+        {
+            idx = UiCompositor_OpDrawMerged(idx);
+            if (budget != 0 && HAL_GetTick() - start >= budget)
+            {
+                break;
+            }
+        }
+        else
+        {
+            idx++;
+        }
+    }
+
+    // keep the remaining operations in order, their texts are in the pool in the same order
+    uint8_t op_num = 0;
+    uint16_t text_used = 0;
+    for (; idx < comp.op_num; idx++, op_num++)
+    {
+        UiCompositor_Op* op = &comp.op[op_num];
+        *op = comp.op[idx];
+        memmove(&comp.text[text_used], &comp.text[op->text], op->len + 1);
+        op->text = text_used;
+        text_used += op->len + 1;
+    }
+    comp.op_num = op_num;
+    comp.text_used = text_used;
+}
+
+/**
+ * @brief queues the operation, a queued operation at the same position which it draws over is dropped
+ */
+static void UiCompositor_OpAdd(UiCompositor_Op* op, const char* str)
+{
+    const size_t len = str != NULL ? strlen(str) : 0;
+
+    if (comp.op_num == UI_COMPOSITOR_OPS || comp.text_used + len + 1 > UI_COMPOSITOR_TEXT_POOL)
+    {
+        UiCompositor_Flush(0);
+    }
+
+    if (len + 1 > UI_COMPOSITOR_TEXT_POOL || len > UINT8_MAX)
+    {
+        // does not fit at all, the queue is empty now, so this is in order
+        UiCompositor_OpDraw(op, str);
+        UiCompositor_InvalidateRect(op->area.x, op->area.y, op->area.w, op->area.h);
+    }
+    else
+    {
+        for (uint8_t idx = 0; idx < comp.op_num; idx++)
+        {
+            const UiCompositor_Op* queued = &comp.op[idx];
+            if (queued->area.x == op->area.x && queued->area.y == op->area.y && UiCompositor_RectCovers(&op->area, &queued->area))
+            {
+                // the text stays in the pool until the next flush
+                memmove(&comp.op[idx], &comp.op[idx + 1], (comp.op_num - idx - 1) * sizeof(comp.op[0]));
+                comp.op_num--;
+                break;
+            }
+        }
+
+        op->text = comp.text_used;
+        op->len = len;
+        memcpy(&comp.text[comp.text_used], str != NULL ? str : "", len + 1);
+        comp.text_used += len + 1;
+        op->hash = UiCompositor_OpHash(op);
+        comp.op[comp.op_num++] = *op;
+    }
+}
+
+/**
+ * @returns the number of lines of the text
+ */
+static uint16_t UiCompositor_TextLines(const char* str)
+{
+    uint16_t retval = 1;
+    for (; str != NULL && *str != '\0'; str++)
+    {
+        if (*str == '\n')
+        {
+            retval++;
+        }
+    }
+    return retval;
+}
+
+/**
+ * @brief queues UiLcdHy28_PrintText()
+ */
+void UiCompositor_PrintText(uint16_t x, uint16_t y, const char* str, uint16_t clr_fg, uint16_t clr_bg, uint8_t font)
+{
+    UiCompositor_Op op =
+    {
+            .area = { .x = x, .y = y, .w = UiLcdHy28_TextWidth(str, font), .h = UiCompositor_TextLines(str) * UiLcdHy28_TextHeight(font) },
+            .clr_fg = clr_fg,
+            .clr_bg = clr_bg,
+            .font = font,
+            .type = COMP_OP_TEXT,
+    };
+    if (op.area.w != 0)
+    {
+        UiCompositor_OpAdd(&op, str);
+    }
+}
+
+/**
+ * @brief queues UiLcdHy28_PrintTextCentered()
+ */
+void UiCompositor_PrintTextCentered(uint16_t x, uint16_t y, uint16_t bbW, const char* str, uint16_t clr_fg, uint16_t clr_bg, uint8_t font)
+{
+    const uint16_t txtW = UiLcdHy28_TextWidth(str, font);
+    UiCompositor_Op op =
+    {
+            .area = { .x = x, .y = y, .w = txtW > bbW ? txtW : bbW, .h = UiCompositor_TextLines(str) * UiLcdHy28_TextHeight(font) },
+            .clr_fg = clr_fg,
+            .clr_bg = clr_bg,
+            .font = font,
+            .type = COMP_OP_TEXT_CENTERED,
+    };
+    if (op.area.w != 0)
+    {
+        UiCompositor_OpAdd(&op, str);
+    }
+}
+
+/**
+ * @brief queues UiLcdHy28_DrawFullRect()
+ */
+void UiCompositor_DrawFullRect(uint16_t x, uint16_t y, uint16_t h, uint16_t w, uint16_t color)
+{
+    UiCompositor_Op op =
+    {
+            .area = { .x = x, .y = y, .w = w, .h = h },
+            .clr_fg = color,
+            .type = COMP_OP_FILL,
+    };
+    if (w != 0 && h != 0)
+    {
+        UiCompositor_OpAdd(&op, NULL);
+    }
+}
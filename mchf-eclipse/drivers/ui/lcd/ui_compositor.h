@@ -0,0 +1,41 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     ui_compositor.h                                                 **
+ **  Description:   Deferred drawing of the desktop widgets with redundancy check   **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#ifndef UI_LCD_UI_COMPOSITOR_H_
+#define UI_LCD_UI_COMPOSITOR_H_
+
+#include "uhsdr_board.h"
+#include "ui_lcd_layouts.h"
+
+// draw operations which can wait for the next flush
+#define UI_COMPOSITOR_OPS           32
+// text of all queued operations, the text message line is the longest single text
+#define UI_COMPOSITOR_TEXT_POOL     (4 * ui_txt_msg_buffer_size)
+// screen regions for which the compositor remembers what has been drawn
+#define UI_COMPOSITOR_REGIONS       64
+
+// maximum time in ms one flush may spend drawing, at least one operation is drawn per flush
+#ifndef UI_COMPOSITOR_FRAME_BUDGET
+#define UI_COMPOSITOR_FRAME_BUDGET  5
+#endif
+
+void UiCompositor_Reset(void);
+void UiCompositor_InvalidateRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+
+void UiCompositor_PrintText(uint16_t x, uint16_t y, const char* str, uint16_t clr_fg, uint16_t clr_bg, uint8_t font);
+void UiCompositor_PrintTextCentered(uint16_t x, uint16_t y, uint16_t bbW, const char* str, uint16_t clr_fg, uint16_t clr_bg, uint8_t font);
+void UiCompositor_DrawFullRect(uint16_t x, uint16_t y, uint16_t h, uint16_t w, uint16_t color);
+
+void UiCompositor_Flush(uint32_t budget);
+
+#endif /* UI_LCD_UI_COMPOSITOR_H_ */
@@ -21,6 +21,7 @@
 
 #include "ui_lcd_hy28_fonts.h"
 #include "ui_lcd_hy28.h"
+#include "ring_buffer.h"
 
 #define hspiDisplay hspi2
 #define SPI_DISPLAY SPI2
@@ -37,6 +38,23 @@
 #define USE_SPI_DISPLAY
 #define USE_DISPLAY_PAR
 
+#if !defined(STM32H7) && !defined(BOOTLOADER_BUILD)
+  // memory to FSMC/FMC DMA for the parallel interface, the H7 would need the MDMA
+  #define USE_DISPLAY_PAR_DMA
+#endif
+
+#ifdef BOOTLOADER_BUILD
+  // the bootloader prints a few lines of small text only
+  #undef USE_GLYPH_CACHE
+#endif
+
+#ifdef UHSDR_HOST_BUILD
+  // the virtual display of support/host emulates the parallel bus only, the SPI framing is accounted for there
+  #undef USE_SPI_DISPLAY
+  #undef USE_SPI_DMA
+  #undef USE_DISPLAY_PAR_DMA
+#endif
+
 #include "spi.h"
 
 #ifdef USE_DISPLAY_PAR
@@ -65,6 +83,50 @@
     #define LCD_RAM      (*((volatile unsigned short *) 0x60004000))
     #endif
     #endif
+
+#ifdef UHSDR_HOST_BUILD
+    // implemented by the virtual display in support/host/host_display.c
+    void UiLcdHost_BusWriteIndex(uint16_t index);
+    void UiLcdHost_BusWriteData(uint16_t data);
+    uint16_t UiLcdHost_BusReadData(void);
+    // the memory to bus DMA of the virtual display, it calls UiLcdHost_DmaComplete() from UiLcdHost_DmaPoll()
+    bool UiLcdHost_DmaEnabled(void);
+    bool UiLcdHost_DmaStart(const uint16_t* pixel, uint32_t len);
+    void UiLcdHost_DmaPoll(void);
+    void UiLcdHost_GlyphCacheSelect(uint8_t min_height);
+#endif
+
+/**
+ * @brief parallel bus access: index (register) write, data write and data read
+ */
+static inline void UiLcdHy28_ParWriteIndex(uint16_t index)
+{
+#ifdef UHSDR_HOST_BUILD
+    UiLcdHost_BusWriteIndex(index);
+#else
+    LCD_REG = index;
+    __DMB();
+#endif
+}
+
+static inline void UiLcdHy28_ParWriteData(uint16_t data)
+{
+#ifdef UHSDR_HOST_BUILD
+    UiLcdHost_BusWriteData(data);
+#else
+    LCD_RAM = data;
+    __DMB();
+#endif
+}
+
+static inline uint16_t UiLcdHy28_ParReadData()
+{
+#ifdef UHSDR_HOST_BUILD
+    return UiLcdHost_BusReadData();
+#else
+    return LCD_RAM;
+#endif
+}
 #endif
 
 
@@ -710,26 +772,14 @@ void UiLcdHy28_GpioInit(mchf_display_types_t display_type)
 
 DMA_HandleTypeDef DMA_Handle;
 
+#ifdef USE_DISPLAY_PAR_DMA
+// the stream is not used by any other peripheral on the F4 and F7 boards
+#define LCD_DMA_STREAM          DMA2_Stream7
+#define LCD_DMA_IRQn            DMA2_Stream7_IRQn
+#define LCD_DMA_IRQHandler      DMA2_Stream7_IRQHandler
 
-static inline void UiLcdHy28_SpiDmaStop()
-{
-    while (DMA1_Stream4->CR & DMA_SxCR_EN) { asm(""); }
-}
-
-
-
-void UiLcdHy28_SpiDmaStart(uint8_t* buffer, uint32_t size)
-{
-
-    // do busy waiting here. This is just for testing if everything goes according to plan
-    // if this works okay, we can let SPI DMA running while doing something else
-    // and just check before next transfer if DMA is being done.
-    // and finally we can move that into an interrupt, of course.
-    if (size > 0)  {
-        UiLcdHy28_SpiDmaStop();
-        HAL_SPI_Transmit_DMA(&hspiDisplay,buffer,size);
-    }
-}
+static DMA_HandleTypeDef hdma_lcd;
+#endif
 
 void UiLcdHy28_SpiDeInit()
 {
@@ -909,8 +959,7 @@ static inline void UiLcdHy28_WriteDataOnly( unsigned short data)
     else
     {
 #ifdef USE_DISPLAY_PAR
-        LCD_RAM = data;
-        __DMB();
+        UiLcdHy28_ParWriteData(data);
 #endif
     }
 }
@@ -927,8 +976,7 @@ static inline void UiLcdHy28_WriteData( unsigned short data)
     else
     {
 #ifdef USE_DISPLAY_PAR
-        LCD_RAM = data;
-        __DMB();
+        UiLcdHy28_ParWriteData(data);
 #endif
     }
 }
@@ -977,10 +1025,8 @@ void UiLcdHy28_WriteReg(unsigned short LCD_Reg, unsigned short LCD_RegValue)
     else
     {
 #ifdef USE_DISPLAY_PAR
-        LCD_REG = LCD_Reg;
-        __DMB();
-        LCD_RAM = LCD_RegValue;
-        __DMB();
+        UiLcdHy28_ParWriteIndex(LCD_Reg);
+        UiLcdHy28_ParWriteData(LCD_RegValue);
 #endif
     }
 }
@@ -999,10 +1045,9 @@ unsigned short UiLcdHy28_ReadReg( unsigned short LCD_Reg)
     {
 #ifdef USE_DISPLAY_PAR
         // Write 16-bit Index (then Read Reg)
-        LCD_REG = LCD_Reg;
+        UiLcdHy28_ParWriteIndex(LCD_Reg);
         // Read 16-bit Reg
-        __DMB();
-        retval = LCD_RAM;
+        retval = UiLcdHy28_ParReadData();
 #else
         retval = 0;
 #endif
@@ -1025,8 +1070,7 @@ static void UiLcdHy28_WriteRAM_Prepare_Index(uint16_t wr_prep_reg)
     else
     {
 #ifdef USE_DISPLAY_PAR
-        LCD_REG = wr_prep_reg;
-        __DMB();
+        UiLcdHy28_ParWriteIndex(wr_prep_reg);
 #endif
     }
 }
@@ -1043,112 +1087,420 @@ static void UiLcdHy28_SetActiveWindow(uint16_t XLeft, uint16_t XRight, uint16_t
     mchf_display.SetActiveWindow(XLeft, XRight, YTop, YBottom);
 }
 
-static void UiLcdHy28_BulkWrite(uint16_t* pixel, uint32_t len)
+/*
+ * Display transfer queue
+ *
+ * The drawing functions render into pixel buffers and queue them together with the windows they
+ * go to. UiLcdHy28_TransferPump() works off the queue: a window job is sent right away with
+ * register writes, a pixel job is handed to the DMA (SPI DMA or memory to FSMC DMA) and the DMA
+ * completion callback gives the buffer back and continues with the next job. So up to
+ * PIXELBUFFERCOUNT - 1 buffers are in flight while the main loop renders into the next one. The
+ * main loop only waits if all buffers are in use or if it needs the bus itself, see
+ * UiLcdHy28_FinishWaitBulkWrite(). Without DMA the pump sends the pixels itself.
+ *
+ * Areas of a single colour are sent from one buffer holding PIXELBUFFERSIZE pixels of the colour, the
+ * job sends it repeat times before the buffer is given back.
+ *
+ * The pixels are stored in the byte order of the bus while rendering, i.e. swapped for the SPI
+ * DMA which sends them byte by byte.
+ */
+
+#define PIXELBUFFERSIZE 512
+#define PIXELBUFFERCOUNT 4
+#define LCD_TRANSFER_JOBS 8     // power of two, for the pixel jobs of all buffers and the windows in between
+
+typedef struct
 {
+    uint16_t* pixel;            // buffer to send, NULL if the job opens the window
+    uint32_t len;
+    uint32_t repeat;            // how often the buffer is sent
+    lcd_bulk_transfer_header_t window;
+} lcd_transfer_job_t;
+
+RING_BUFFER_DEFINE(LcdTransferJobRing, lcd_transfer_job_t, LCD_TRANSFER_JOBS)
+RING_BUFFER_BLOCK_DEFINE(LcdPixelBufferRing, uint16_t, PIXELBUFFERCOUNT)
+
+static __UHSDR_DMAMEM uint16_t   pixelbuffer[PIXELBUFFERCOUNT][PIXELBUFFERSIZE];
+
+static struct
+{
+    LcdTransferJobRing jobs;        // main loop -> pump
+    LcdPixelBufferRing free;        // pump -> main loop
+    uint16_t* active;               // buffer the DMA is sending
+    uint32_t active_len;
+    uint32_t active_repeat;         // transfers of the active buffer still to do, including the running one
+    volatile bool busy;             // a DMA transfer is running, its completion continues the pump
+    bool dma;                       // the pixels are sent by DMA
+    bool swap;                      // the pixels are stored byte swapped
+    uint16_t* pixelbuf;             // buffer the main loop renders into, NULL if none
+    uint16_t pixelcount;
+} lcd_transfer;
+
+static void UiLcdHy28_TransferPump();
+
+static bool UiLcdHy28_TransferDmaStart(uint16_t* pixel, uint32_t len);
 
-// if we are not using SPI DMA, we send the data as it comes
-// if we are using SPI DMA, we do this only if we are NOT using SPI
+/**
+ * @brief called when the DMA has sent the active buffer, sends it again or continues with the next job
+ */
+static void UiLcdHy28_TransferComplete()
+{
+    lcd_transfer.active_repeat--;
+    if (lcd_transfer.active_repeat == 0 || UiLcdHy28_TransferDmaStart(lcd_transfer.active, lcd_transfer.active_len) == false)
+    {
+        LcdPixelBufferRing_Put(&lcd_transfer.free, lcd_transfer.active);
+        lcd_transfer.active = NULL;
+        lcd_transfer.busy = false;
+        UiLcdHy28_TransferPump();
+    }
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    if (hspi == &hspiDisplay && lcd_transfer.busy)
+    {
+        UiLcdHy28_TransferComplete();
+    }
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    // the buffer is lost, but the queue must not stall
+    HAL_SPI_TxCpltCallback(hspi);
+}
+
+#ifdef UHSDR_HOST_BUILD
+void UiLcdHost_DmaComplete(void)
+{
+    if (lcd_transfer.busy)
+    {
+        UiLcdHy28_TransferComplete();
+    }
+}
+
+/**
+ * @brief state of the transfer queue for the checks of the virtual display
+ */
+void UiLcdHost_TransferFill(uint32_t* jobs_fill, uint32_t* jobs_room, uint32_t* free_buffers)
+{
+    *jobs_fill = LcdTransferJobRing_Fill(&lcd_transfer.jobs);
+    *jobs_room = LcdTransferJobRing_Room(&lcd_transfer.jobs);
+    *free_buffers = LcdPixelBufferRing_Fill(&lcd_transfer.free);
+}
+#endif
+
+#ifdef USE_DISPLAY_PAR_DMA
+static void UiLcdHy28_ParallelDmaCplt(DMA_HandleTypeDef* hdma)
+{
+    if (lcd_transfer.busy)
+    {
+        UiLcdHy28_TransferComplete();
+    }
+}
+
+void LCD_DMA_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&hdma_lcd);
+}
+
+/**
+ * @brief memory to memory DMA from the pixel buffers to the fixed LCD_RAM address
+ */
+static bool UiLcdHy28_ParallelDmaInit()
+{
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    hdma_lcd.Instance = LCD_DMA_STREAM;
+    hdma_lcd.Init.Channel = DMA_CHANNEL_0;
+    hdma_lcd.Init.Direction = DMA_MEMORY_TO_MEMORY;
+    hdma_lcd.Init.PeriphInc = DMA_PINC_ENABLE;      // source: the pixel buffer
+    hdma_lcd.Init.MemInc = DMA_MINC_DISABLE;        // destination: LCD_RAM
+    hdma_lcd.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    hdma_lcd.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    hdma_lcd.Init.Mode = DMA_NORMAL;
+    hdma_lcd.Init.Priority = DMA_PRIORITY_LOW;
+    hdma_lcd.Init.FIFOMode = DMA_FIFOMODE_ENABLE;   // memory to memory requires the FIFO
+    hdma_lcd.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_HALFFULL;
+    hdma_lcd.Init.MemBurst = DMA_MBURST_SINGLE;
+    hdma_lcd.Init.PeriphBurst = DMA_PBURST_SINGLE;
+
+    bool retval = HAL_DMA_Init(&hdma_lcd) == HAL_OK;
+    if (retval)
+    {
+        hdma_lcd.XferCpltCallback = UiLcdHy28_ParallelDmaCplt;
+        hdma_lcd.XferErrorCallback = UiLcdHy28_ParallelDmaCplt;
+
+        HAL_NVIC_SetPriority(LCD_DMA_IRQn, 14, 0);
+        HAL_NVIC_EnableIRQ(LCD_DMA_IRQn);
+    }
+    return retval;
+}
+#endif
+
+/**
+ * @brief empties the queue and hands out all pixel buffers, the display has to be detected already
+ */
+static void UiLcdHy28_TransferInit()
+{
+    LcdTransferJobRing_Init(&lcd_transfer.jobs);
+    LcdPixelBufferRing_Init(&lcd_transfer.free);
+    for (uint16_t idx = 0; idx < PIXELBUFFERCOUNT; idx++)
+    {
+        LcdPixelBufferRing_Put(&lcd_transfer.free, pixelbuffer[idx]);
+    }
+    lcd_transfer.active = NULL;
+    lcd_transfer.busy = false;
+    lcd_transfer.pixelbuf = NULL;
+    lcd_transfer.pixelcount = 0;
+    lcd_transfer.dma = false;
+
+    if (UiLcdHy28_SpiDisplayUsed())
+    {
 #ifdef USE_SPI_DMA
-    if(UiLcdHy28_SpiDisplayUsed() == false)
+        lcd_transfer.dma = true;
 #endif
+    }
+    else if (mchf_display.display_type != DISPLAY_NONE)
     {
-        for (uint32_t i = len; i; i--)
-        {
-            UiLcdHy28_WriteDataOnly(*(pixel++));
-        }
+#ifdef USE_DISPLAY_PAR_DMA
+        lcd_transfer.dma = UiLcdHy28_ParallelDmaInit();
+#endif
+#ifdef UHSDR_HOST_BUILD
+        lcd_transfer.dma = UiLcdHost_DmaEnabled();
+#endif
     }
+    lcd_transfer.swap = lcd_transfer.dma && UiLcdHy28_SpiDisplayUsed();
+}
+
+static bool UiLcdHy28_TransferDmaStart(uint16_t* pixel, uint32_t len)
+{
+    bool retval = false;
+    if (UiLcdHy28_SpiDisplayUsed())
+    {
 #ifdef USE_SPI_DMA
+        retval = HAL_SPI_Transmit_DMA(&hspiDisplay, (uint8_t*)pixel, len*2) == HAL_OK;
+#endif
+    }
     else
     {
-        for (uint32_t i = 0; i < len; i++)
+#ifdef USE_DISPLAY_PAR_DMA
+        retval = HAL_DMA_Start_IT(&hdma_lcd, (uint32_t)pixel, (uint32_t)&LCD_RAM, len) == HAL_OK;
+        // a FIFO error is no reason to stop, but the HAL would report it as transfer error
+        __HAL_DMA_DISABLE_IT(&hdma_lcd, DMA_IT_FE);
+#endif
+#ifdef UHSDR_HOST_BUILD
+        retval = UiLcdHost_DmaStart(pixel, len);
+#endif
+    }
+    return retval;
+}
+
+/**
+ * @brief sets the window and the cursor and starts writing to the display RAM
+ */
+static void UiLcdHy28_TransferWindow(const lcd_bulk_transfer_header_t* window)
+{
+    if(UiLcdHy28_SpiDisplayUsed())
+    {
+        // ends the pixel data of the last window
+        UiLcdHy28_LcdSpiFinishTransfer();
+    }
+    UiLcdHy28_SetActiveWindow(window->x, window->x + window->width - 1, window->y, window->y + window->height - 1);
+    UiLcdHy28_SetCursorA(window->x, window->y);
+    UiLcdHy28_WriteRAM_Prepare();
+}
+
+/**
+ * @brief works off the queue until a DMA transfer is running or the queue is empty
+ *
+ * Runs in the DMA completion interrupt or in the main loop if no transfer is running, never in both at
+ * the same time: the interrupt only comes while a transfer runs and the main loop calls it only if none runs.
+ */
+static void UiLcdHy28_TransferPump()
+{
+    lcd_transfer_job_t job;
+
+    while (lcd_transfer.busy == false && LcdTransferJobRing_Get(&lcd_transfer.jobs, &job))
+    {
+        if (job.pixel == NULL)
         {
-            pixel[i] = __REV16(pixel[i]); // reverse byte order;
+            UiLcdHy28_TransferWindow(&job.window);
+        }
+        else if (lcd_transfer.dma)
+        {
+            lcd_transfer.active = job.pixel;
+            lcd_transfer.active_len = job.len;
+            lcd_transfer.active_repeat = job.repeat;
+            lcd_transfer.busy = true;
+            if (UiLcdHy28_TransferDmaStart(job.pixel, job.len) == false)
+            {
+                lcd_transfer.busy = false;
+                LcdPixelBufferRing_Put(&lcd_transfer.free, job.pixel);
+            }
+        }
+        else
+        {
+            for (uint32_t count = 0; count < job.repeat; count++)
+            {
+                for (uint32_t idx = 0; idx < job.len; idx++)
+                {
+                    UiLcdHy28_WriteDataOnly(job.pixel[idx]);
+                }
+            }
+            LcdPixelBufferRing_Put(&lcd_transfer.free, job.pixel);
         }
-        UiLcdHy28_SpiDmaStart((uint8_t*)pixel,len*2);
     }
+}
+
+/**
+ * @brief starts the pump in the main loop if no transfer is running
+ */
+static inline void UiLcdHy28_TransferKick()
+{
+#ifdef UHSDR_HOST_BUILD
+    // the virtual display delivers its transfer completion interrupt here
+    UiLcdHost_DmaPoll();
 #endif
+    if (lcd_transfer.busy == false)
+    {
+        UiLcdHy28_TransferPump();
+    }
+}
 
+static void UiLcdHy28_TransferQueue(const lcd_transfer_job_t* job)
+{
+    while (LcdTransferJobRing_Room(&lcd_transfer.jobs) == 0)
+    {
+        UiLcdHy28_TransferKick();
+    }
+    LcdTransferJobRing_Put(&lcd_transfer.jobs, *job);
+    UiLcdHy28_TransferKick();
 }
 
+/**
+ * @brief waits until all queued jobs have been sent, the last window stays open
+ */
+static void UiLcdHy28_TransferWaitIdle()
+{
+    do
+    {
+        UiLcdHy28_TransferKick();
+    } while (lcd_transfer.busy || LcdTransferJobRing_Fill(&lcd_transfer.jobs) != 0);
+}
+
+/**
+ * @brief waits for all transfers and ends the last one, afterwards the bus can be used directly
+ */
 static void UiLcdHy28_FinishWaitBulkWrite()
 {
+    UiLcdHy28_TransferWaitIdle();
     if(UiLcdHy28_SpiDisplayUsed())         // SPI enabled?
     {
-#ifdef USE_SPI_DMA
-        UiLcdHy28_SpiDmaStop();
-#endif
         UiLcdHy28_LcdSpiFinishTransfer();
     }
 }
 
 static void UiLcdHy28_OpenBulkWrite(ushort x, ushort width, ushort y, ushort height)
 {
-    UiLcdHy28_FinishWaitBulkWrite();
-    UiLcdHy28_SetActiveWindow(x, x + width - 1, y, y + height - 1);
-    UiLcdHy28_SetCursorA(x, y);
-    UiLcdHy28_WriteRAM_Prepare();
+    const lcd_transfer_job_t job =
+    {
+            .pixel = NULL,
+            .window = { .x = x, .width = width, .y = y, .height = height },
+    };
+    UiLcdHy28_TransferQueue(&job);
 }
 
 static void UiLcdHy28_CloseBulkWrite()
 {
 #ifdef USE_GFX_RA8875
 	uint16_t MAX_X=mchf_display.MAX_X; uint16_t MAX_Y=mchf_display.MAX_Y;
+    UiLcdHy28_TransferWaitIdle();
     UiLcdHy28_SetActiveWindow(0, MAX_X - 1, 0, MAX_Y - 1);
     UiLcdHy28_WriteReg(0x40, 0);
 #endif
 }
 
 
-
-
-#define PIXELBUFFERSIZE 512
-#define PIXELBUFFERCOUNT 2
-
-static __UHSDR_DMAMEM uint16_t   pixelbuffer[PIXELBUFFERCOUNT][PIXELBUFFERSIZE];
-static uint16_t pixelcount = 0;
-static uint16_t pixelbufidx = 0;
-
+/**
+ * @brief makes sure there is a buffer to render into, waits for one if all are in flight
+ */
 static inline void UiLcdHy28_BulkPixel_BufferInit()
 {
-    pixelbufidx= (pixelbufidx+1)%PIXELBUFFERCOUNT;
-    pixelcount = 0;
+    if (lcd_transfer.pixelbuf == NULL)
+    {
+        while (LcdPixelBufferRing_Get(&lcd_transfer.free, &lcd_transfer.pixelbuf) == false)
+        {
+            UiLcdHy28_TransferKick();
+        }
+    }
+    lcd_transfer.pixelcount = 0;
 }
 
-
+/**
+ * @brief queues the rendered pixels, they are sent in the background
+ */
 inline void UiLcdHy28_BulkPixel_BufferFlush()
 {
-    UiLcdHy28_BulkWrite(pixelbuffer[pixelbufidx],pixelcount);
-    UiLcdHy28_BulkPixel_BufferInit();
+    if (lcd_transfer.pixelbuf != NULL && lcd_transfer.pixelcount != 0)
+    {
+        const lcd_transfer_job_t job =
+        {
+                .pixel = lcd_transfer.pixelbuf,
+                .len = lcd_transfer.pixelcount,
+                .repeat = 1,
+        };
+        lcd_transfer.pixelbuf = NULL;
+        UiLcdHy28_TransferQueue(&job);
+    }
+    lcd_transfer.pixelcount = 0;
 }
 
 inline void UiLcdHy28_BulkPixel_Put(uint16_t pixel)
 {
-    pixelbuffer[pixelbufidx][pixelcount++] = pixel;
-    if (pixelcount == PIXELBUFFERSIZE)
+    if (lcd_transfer.pixelbuf == NULL)
+    {
+        UiLcdHy28_BulkPixel_BufferInit();
+    }
+    lcd_transfer.pixelbuf[lcd_transfer.pixelcount++] = lcd_transfer.swap ? __REV16(pixel) : pixel;
+    if (lcd_transfer.pixelcount == PIXELBUFFERSIZE)
     {
         UiLcdHy28_BulkPixel_BufferFlush();
     }
 }
 
-// TODO: Not most efficient way, we could use remaining buffer size to judge
-// if it will fit without flush and fill accordingly.
-
+/**
+ * @brief copies pixels into the buffers, pixel_buffer can be reused right after the call
+ */
 inline void UiLcdHy28_BulkPixel_PutBuffer(uint16_t* pixel_buffer, uint32_t len)
 {
-    // We bypass the buffering if in parallel mode
-    // since as for now, it will not benefit from it.
-    // this can be changed if someone write DMA code for the parallel
-    // interface (memory to memory DMA)
-    if(UiLcdHy28_SpiDisplayUsed())         // SPI enabled?
+    while (len > 0)
     {
-        for (uint32_t idx = 0; idx < len; idx++)
+        if (lcd_transfer.pixelbuf == NULL)
         {
-            UiLcdHy28_BulkPixel_Put(pixel_buffer[idx]);
+            UiLcdHy28_BulkPixel_BufferInit();
+        }
+        uint16_t* dst = &lcd_transfer.pixelbuf[lcd_transfer.pixelcount];
+        const uint32_t count = len < PIXELBUFFERSIZE - lcd_transfer.pixelcount ? len : PIXELBUFFERSIZE - lcd_transfer.pixelcount;
+
+        if (lcd_transfer.swap)
+        {
+            for (uint32_t idx = 0; idx < count; idx++)
+            {
+                dst[idx] = __REV16(pixel_buffer[idx]);
+            }
+        }
+        else
+        {
+            memcpy(dst, pixel_buffer, count * sizeof(*dst));
+        }
+        pixel_buffer += count;
+        len -= count;
+        lcd_transfer.pixelcount += count;
+
+        if (lcd_transfer.pixelcount == PIXELBUFFERSIZE)
+        {
+            UiLcdHy28_BulkPixel_BufferFlush();
         }
-    }
-    else
-    {
-        UiLcdHy28_BulkWrite(pixel_buffer, len);
     }
 }
 
@@ -1164,29 +1516,11 @@ inline void UiLcdHy28_BulkPixel_CloseWrite()
     UiLcdHy28_CloseBulkWrite();
 }
 
-
 void UiLcdHy28_LcdClear(ushort Color)
 {
 	uint32_t MAX_X=mchf_display.MAX_X; uint32_t MAX_Y=mchf_display.MAX_Y;
     UiLcdHy28_OpenBulkWrite(0,MAX_X,0,MAX_Y);
-#ifdef USE_SPI_DMA
-    if(UiLcdHy28_SpiDisplayUsed())
-    {
-        int idx;
-
-        UiLcdHy28_BulkPixel_BufferInit();
-
-        for (idx = 0; idx < MAX_X * MAX_Y; idx++)
-        {
-            UiLcdHy28_BulkPixel_Put(Color);
-        }
-        UiLcdHy28_BulkPixel_BufferFlush();
-    }
-    else
-#endif
-    {
-        UiLcdHy28_BulkWriteColor(Color,MAX_X * MAX_Y);
-    }
+    UiLcdHy28_BulkWriteColor(Color,MAX_X * MAX_Y);
     UiLcdHy28_CloseBulkWrite();
 }
 
@@ -1198,15 +1532,16 @@ void UiLcdHy28_DrawColorPoint( unsigned short Xpos, unsigned short Ypos, unsigne
 #ifdef USE_GFX_RA8875
     if( Xpos < MAX_X && Ypos < MAX_Y )
     {
+        UiLcdHy28_TransferWaitIdle();
         UiLcdHy28_SetCursorA(Xpos, Ypos);
         UiLcdHy28_WriteReg(0x02, point);
     }
 #else
     if( Xpos < MAX_X && Ypos < MAX_Y )
     {
-        UiLcdHy28_OpenBulkWrite(Xpos,1,Ypos,1);
-        UiLcdHy28_WriteDataOnly(point);
-        UiLcdHy28_CloseBulkWrite();
+        UiLcdHy28_BulkPixel_OpenWrite(Xpos,1,Ypos,1);
+        UiLcdHy28_BulkPixel_Put(point);
+        UiLcdHy28_BulkPixel_CloseWrite();
     }
 #endif
 }
@@ -1216,6 +1551,7 @@ void UiLcdHy28_DrawColorPoint( unsigned short Xpos, unsigned short Ypos, unsigne
 void UiLcdHy28_DrawFullRect(ushort Xpos, ushort Ypos, ushort Height, ushort Width ,ushort color)
 {
 #ifdef USE_GFX_RA8875
+    UiLcdHy28_TransferWaitIdle();
     UiLcdRA8875_SetForegroundColor(color);
     /* Horizontal start */
     UiLcdRa8875_WriteReg_16bit(0x91, Xpos);
@@ -1254,8 +1590,9 @@ void UiLcdRa8875_WriteReg_8bit(uint16_t LCD_Reg, uint8_t LCD_RegValue)
 }
 void UiLcdRa8875_WriteReg_16bit(uint16_t LCD_Reg, uint16_t LCD_RegValue)
 {
+    // the 16bit registers are pairs of 8bit registers, low byte first
     UiLcdRa8875_WriteReg_8bit(LCD_Reg,LCD_RegValue & 0xff);
-    UiLcdRa8875_WriteReg_8bit(LCD_Reg,(LCD_RegValue >> 8) & 0xff);
+    UiLcdRa8875_WriteReg_8bit(LCD_Reg + 1,(LCD_RegValue >> 8) & 0xff);
 }
 
 
@@ -1377,6 +1714,7 @@ void UiLcdHy28_DrawStraightLine(ushort x, ushort y, ushort Length, uchar Directi
     #define LCD_DLVER1  (0x98)      /* Draw Line/Square Vertical End Address Register1 */
 
 
+    UiLcdHy28_TransferWaitIdle();
     UiLcdRA8875_SetForegroundColor(color);
 
     uint16_t x_end, y_end;
@@ -1462,23 +1800,40 @@ void UiLcdHy28_DrawBottomButton(ushort Xpos, ushort Ypos, ushort Height, ushort
 
 static void UiLcdHy28_BulkWriteColor(uint16_t Color, uint32_t len)
 {
-
-#ifdef USE_SPI_DMA
-    if(UiLcdHy28_SpiDisplayUsed())
+    if(lcd_transfer.dma)
     {
-        int idx;
-
-        UiLcdHy28_BulkPixel_BufferInit();
+        // one buffer of the colour is sent as often as it fits, the rest goes through a second buffer
+        const uint32_t fill_len = len < PIXELBUFFERSIZE ? len : PIXELBUFFERSIZE;
+        const uint16_t pixel = lcd_transfer.swap ? __REV16(Color) : Color;
 
-        for (idx = 0; idx < len; idx++)
+        UiLcdHy28_BulkPixel_BufferFlush();
+        if (fill_len > 0)
         {
-            UiLcdHy28_BulkPixel_Put(Color);
+            UiLcdHy28_BulkPixel_BufferInit();
+            for (uint32_t idx = 0; idx < fill_len; idx++)
+            {
+                lcd_transfer.pixelbuf[idx] = pixel;
+            }
+            const lcd_transfer_job_t job =
+            {
+                    .pixel = lcd_transfer.pixelbuf,
+                    .len = fill_len,
+                    .repeat = len / fill_len,
+            };
+            lcd_transfer.pixelbuf = NULL;
+            UiLcdHy28_TransferQueue(&job);
+
+            for (uint32_t idx = len % fill_len; idx > 0; idx--)
+            {
+                UiLcdHy28_BulkPixel_Put(Color);
+            }
+            UiLcdHy28_BulkPixel_BufferFlush();
         }
-        UiLcdHy28_BulkPixel_BufferFlush();
     }
     else
-#endif
     {
+        // without DMA nothing can run in the background, writing directly saves the copy
+        UiLcdHy28_TransferWaitIdle();
         uint32_t i = len;
         for (; i; i--)
         {
@@ -1488,8 +1843,43 @@ static void UiLcdHy28_BulkWriteColor(uint16_t Color, uint32_t len)
 }
 
 
+/**
+ * @brief size of the window a character is drawn to
+ */
+static void UiLcdHy28_CharSize(char symb, const sFONT *cf, uint16_t* width, uint16_t* height)
+{
+    *width = cf->Width;
+    *height = cf->Height;
+#ifdef USE_8bit_FONT
+    if (cf->BitCount == 8)
+    {
+        // plus the spacing after the character
+        *width = cf->Width + 1;
+        if (symb != 0x20)
+        {
+            *height = cf->heightTable[symb-cf->firstCode];
+        }
+    }
+#endif
+}
+
+/**
+ * @brief the pixels go to pixel_buffer or, if it is NULL, to the open bulk write
+ */
+static inline void UiLcdHy28_CharPixel(uint16_t** pixel_buffer, uint16_t pixel)
+{
+    if (*pixel_buffer != NULL)
+    {
+        *(*pixel_buffer)++ = pixel;
+    }
+    else
+    {
+        UiLcdHy28_BulkPixel_Put(pixel);
+    }
+}
+
 #ifdef USE_8bit_FONT
-static void UiLcdHy28_DrawChar_8bit(ushort x, ushort y, char symb,ushort Color, ushort bkColor,const sFONT *cf)
+static void UiLcdHy28_RenderChar_8bit(uint16_t* pixel_buffer, char symb,ushort Color, ushort bkColor,const sFONT *cf)
 {
     uint8_t cntrX, cntrY;
     uint8_t FontDefaultSize,Font_W,Font_H;
@@ -1524,8 +1914,6 @@ static void UiLcdHy28_DrawChar_8bit(ushort x, ushort y, char symb,ushort Color,
 
     int32_t ColFG_Ro,ColFG_Go,ColFG_Bo;
 
-    UiLcdHy28_BulkPixel_OpenWrite(x, FontDefaultSize+charSpacing, y, Font_H);
-
     if(symb==0x20)
     {
         Font_W=4;
@@ -1534,13 +1922,10 @@ static void UiLcdHy28_DrawChar_8bit(ushort x, ushort y, char symb,ushort Color,
             //Cidx=0;
             for(cntrX=0;cntrX<(FontDefaultSize+charSpacing);cntrX++)
             {
-                UiLcdHy28_BulkPixel_Put(bkColor);
+                UiLcdHy28_CharPixel(&pixel_buffer, bkColor);
             }
 
         }
-        UiLcdHy28_BulkPixel_BufferFlush();
-        // flush all not yet  transferred pixel to display.
-        UiLcdHy28_CloseBulkWrite();
     }
     else
     {
@@ -1573,14 +1958,14 @@ static void UiLcdHy28_DrawChar_8bit(ushort x, ushort y, char symb,ushort Color,
 
                     pixel=(ColFG_Ro<<11)|(ColFG_Go<<5)|ColFG_Bo;    //assembly of destination colour
                 }
-                UiLcdHy28_BulkPixel_Put(pixel);
+                UiLcdHy28_CharPixel(&pixel_buffer, pixel);
 
             }
             if(Font_W<FontDefaultSize)
             {
                 for(int n=0;n<(FontDefaultSize-Font_W);n++)
                 {
-                    UiLcdHy28_BulkPixel_Put(bkColor);
+                    UiLcdHy28_CharPixel(&pixel_buffer, bkColor);
                 }
 
             }
@@ -1588,20 +1973,17 @@ static void UiLcdHy28_DrawChar_8bit(ushort x, ushort y, char symb,ushort Color,
             //adding the spacing after the printed font
             for(cntrX=0;cntrX<charSpacing;cntrX++)
             {
-                UiLcdHy28_BulkPixel_Put(bkColor);
+                UiLcdHy28_CharPixel(&pixel_buffer, bkColor);
             }
 
 
 
         }
-        UiLcdHy28_BulkPixel_BufferFlush();
-        // flush all not yet  transferred pixel to display.
-        UiLcdHy28_CloseBulkWrite();
     }
 }
 #endif
 
-static void UiLcdHy28_DrawChar_1bit(ushort x, ushort y, char symb,ushort Color, ushort bkColor,const sFONT *cf)
+static void UiLcdHy28_RenderChar_1bit(uint16_t* pixel_buffer, char symb,ushort Color, ushort bkColor,const sFONT *cf)
 {
     ulong       i,j;
     ushort      a,b,d;
@@ -1614,8 +1996,6 @@ static void UiLcdHy28_DrawChar_1bit(ushort x, ushort y, char symb,ushort Color,
         ch+=(symb - 32) * cf->Height;
 
 
-    UiLcdHy28_OpenBulkWrite(x,cf->Width,y,cf->Height);
-    UiLcdHy28_BulkPixel_BufferInit();
     for(i = 0; i < cf->Height; i++)
     {
         if(cf->Width>8)
@@ -1634,33 +2014,135 @@ static void UiLcdHy28_DrawChar_1bit(ushort x, ushort y, char symb,ushort Color,
             a = (d & ((0x80 << ((fw / 12 ) * 8)) >> j));
             b = (d &  (0x01 << j));
             //
-            UiLcdHy28_BulkPixel_Put(((!a && (fw <= 12)) || (!b && (fw > 12)))?bkColor:Color);
+            UiLcdHy28_CharPixel(&pixel_buffer, ((!a && (fw <= 12)) || (!b && (fw > 12)))?bkColor:Color);
         }
     }
-    UiLcdHy28_BulkPixel_BufferFlush();
-    // flush all not yet  transferred pixel to display.
-    UiLcdHy28_CloseBulkWrite();
 }
-//volatile int debtxt=0;
 
-void UiLcdHy28_DrawChar(ushort x, ushort y, char symb,ushort Color, ushort bkColor,const sFONT *cf)
+/**
+ * @brief renders the character into pixel_buffer or, if it is NULL, into the open bulk write
+ */
+static void UiLcdHy28_RenderChar(uint16_t* pixel_buffer, char symb,ushort Color, ushort bkColor,const sFONT *cf)
 {
-//	if((x==0) && (y==302))		//this is only for catching the faulty new line drawing event for decoded text line.
-//		debtxt++;
 #ifdef USE_8bit_FONT
-	switch(cf->BitCount)
-	{
-	case 1:		//1 bit font (basic type)
+    switch(cf->BitCount)
+    {
+    case 1:     //1 bit font (basic type)
 #endif
-	    UiLcdHy28_DrawChar_1bit(x, y, symb, Color, bkColor, cf);
+        UiLcdHy28_RenderChar_1bit(pixel_buffer, symb, Color, bkColor, cf);
 #ifdef USE_8bit_FONT
-		break;
-	case 8:	//8 bit grayscaled font
-        UiLcdHy28_DrawChar_8bit(x, y, symb, Color, bkColor, cf);
-	    break;
-	}
+        break;
+    case 8: //8 bit grayscaled font
+        UiLcdHy28_RenderChar_8bit(pixel_buffer, symb, Color, bkColor, cf);
+        break;
+    }
+#endif
+}
+
+#ifdef USE_GLYPH_CACHE
+// Rendering the large fonts takes much longer than sending the pixels, the 8 bit fonts even
+// blend every pixel. The frequency display draws the same few digits over and over, so the
+// rendered characters of the large fonts are kept in a small arena with LRU replacement.
+#define GLYPH_CACHE_PIXELS          (16 * 24)       // the largest fonts
+#define GLYPH_CACHE_MIN_HEIGHT      16              // smaller fonts are rendered directly
+#ifndef GLYPH_CACHE_SLOTS
+    #define GLYPH_CACHE_SLOTS       12              // the digits, the dot and the space in one colour
+#endif
+
+typedef struct
+{
+    const sFONT* font;          // NULL if unused
+    uint16_t clr_fg;
+    uint16_t clr_bg;
+    char symb;
+    uint32_t used;              // time of last use for the LRU replacement
+} glyph_cache_entry_t;
+
+static struct
+{
+    glyph_cache_entry_t entry[GLYPH_CACHE_SLOTS];
+    uint32_t now;
+    uint16_t pixel[GLYPH_CACHE_SLOTS][GLYPH_CACHE_PIXELS];
+} glyph_cache;
+
+#ifdef UHSDR_HOST_BUILD
+// the glyph cache check of support/host compares all fonts drawn with and without the cache
+static uint8_t glyph_cache_min_height = GLYPH_CACHE_MIN_HEIGHT;
+
+/**
+ * @brief empties the cache, fonts lower than min_height are rendered directly from now on
+ */
+void UiLcdHost_GlyphCacheSelect(uint8_t min_height)
+{
+    memset(&glyph_cache, 0, sizeof(glyph_cache));
+    glyph_cache_min_height = min_height;
+}
+#else
+#define glyph_cache_min_height GLYPH_CACHE_MIN_HEIGHT
 #endif
 
+/**
+ * @returns the rendered character or NULL if it is not cached
+ */
+static uint16_t* UiLcdHy28_GlyphCacheGet(char symb, ushort Color, ushort bkColor, const sFONT *cf, uint32_t pixel_count)
+{
+    uint16_t* retval = NULL;
+
+    if (cf->Height >= glyph_cache_min_height && pixel_count <= GLYPH_CACHE_PIXELS)
+    {
+        uint32_t slot;
+        uint32_t lru = 0;
+
+        for (slot = 0; slot < GLYPH_CACHE_SLOTS; slot++)
+        {
+            const glyph_cache_entry_t* entry = &glyph_cache.entry[slot];
+            if (entry->font == cf && entry->symb == symb && entry->clr_fg == Color && entry->clr_bg == bkColor)
+            {
+                break;
+            }
+            if (entry->used < glyph_cache.entry[lru].used)
+            {
+                lru = slot;
+            }
+        }
+
+        if (slot == GLYPH_CACHE_SLOTS)
+        {
+            slot = lru;
+            glyph_cache_entry_t* entry = &glyph_cache.entry[slot];
+            entry->font = cf;
+            entry->symb = symb;
+            entry->clr_fg = Color;
+            entry->clr_bg = bkColor;
+            UiLcdHy28_RenderChar(glyph_cache.pixel[slot], symb, Color, bkColor, cf);
+        }
+
+        glyph_cache.entry[slot].used = ++glyph_cache.now;
+        retval = glyph_cache.pixel[slot];
+    }
+    return retval;
+}
+#endif
+
+void UiLcdHy28_DrawChar(ushort x, ushort y, char symb,ushort Color, ushort bkColor,const sFONT *cf)
+{
+    uint16_t width, height;
+    UiLcdHy28_CharSize(symb, cf, &width, &height);
+
+    UiLcdHy28_BulkPixel_OpenWrite(x, width, y, height);
+#ifdef USE_GLYPH_CACHE
+    uint16_t* glyph = UiLcdHy28_GlyphCacheGet(symb, Color, bkColor, cf, width * height);
+    if (glyph != NULL)
+    {
+        UiLcdHy28_BulkPixel_PutBuffer(glyph, width * height);
+    }
+    else
+#endif
+    {
+        UiLcdHy28_RenderChar(NULL, symb, Color, bkColor, cf);
+    }
+    // flush all not yet  transferred pixel to display.
+    UiLcdHy28_BulkPixel_CloseWrite();
 }
 
 const sFONT   *UiLcdHy28_Font(uint8_t font)
@@ -1954,9 +2436,9 @@ static uint16_t UiLcdHy28_ReadDisplayId_ILI9486()
     if (mchf_display.use_spi == false)
     {
         retval = UiLcdHy28_ReadReg(0xd3);
-        retval = LCD_RAM;    //first dummy read
-        retval = (LCD_RAM&0xff)<<8;
-        retval |=LCD_RAM&0xff;
+        retval = UiLcdHy28_ParReadData();    //first dummy read
+        retval = (UiLcdHy28_ParReadData()&0xff)<<8;
+        retval |=UiLcdHy28_ParReadData()&0xff;
     }
 
     switch (retval)
@@ -2342,6 +2824,8 @@ uint8_t UiLcdHy28_Init()
 
     mchf_display.display_type = retval;
 
+    UiLcdHy28_TransferInit();
+
 #ifndef BOOTLOADER_BUILD
     switch(mchf_display.DeviceCode)
     {
@@ -247,6 +247,7 @@ static void UiSpectrum_UpdateSpectrumPixelParameters()
     static bool old_cw_lsb = false;
     static uint8_t old_dmod_mode = 0xFF;
     static uint8_t old_iq_freq_mode = 0xFF;
+    static int32_t old_rx_nco_offset = 0;
     static uint16_t old_cw_sidetone_freq = 0;
     static uint8_t old_digital_mode = 0xFF;
 
@@ -259,14 +260,15 @@ static void UiSpectrum_UpdateSpectrumPixelParameters()
         force_update = true;
     }
 
-    if (ts.iq_freq_mode != old_iq_freq_mode  || force_update)
+    if (ts.iq_freq_mode != old_iq_freq_mode  || ts.rx_nco_offset != old_rx_nco_offset || force_update)
     {
         old_iq_freq_mode = ts.dmod_mode;
+        old_rx_nco_offset = ts.rx_nco_offset;
         force_update = true;
 
         if(!sd.magnify)     // is magnify mode on?
         {
-            sd.rx_carrier_pos = slayout.scope.w/2 - 0.5 - (AudioDriver_GetTranslateFreq()/sd.hz_per_pixel);
+            sd.rx_carrier_pos = slayout.scope.w/2 - 0.5 - (AudioDriver_GetRxShiftFreq()/sd.hz_per_pixel);
         }
         else        // magnify mode is on
         {
@@ -319,7 +321,7 @@ static void UiSpectrum_UpdateSpectrumPixelParameters()
                 sd.marker_num = 1;
             }
 
-            for (uint16_t idx; idx < sd.marker_num; idx++)
+            for (uint16_t idx = 0; idx < sd.marker_num; idx++)
             {
                 mode_marker_offset[idx] = (ts.digi_lsb?-1.0:1.0)*(mode_marker[idx] / sd.hz_per_pixel);
             }
@@ -330,7 +332,7 @@ static void UiSpectrum_UpdateSpectrumPixelParameters()
             sd.marker_num = 1;
         }
 
-        for (uint16_t idx; idx < sd.marker_num; idx++)
+        for (uint16_t idx = 0; idx < sd.marker_num; idx++)
         {
             sd.marker_offset[idx] = tx_vfo_offset + mode_marker_offset[idx];
             sd.marker_pos[idx] = sd.rx_carrier_pos + sd.marker_offset[idx];
@@ -663,6 +665,7 @@ static void UiSpectrum_CreateDrawArea()
 
 void UiSpectrum_Clear()
 {
+    sd.wfall_wipe_valid = false;    // the area is used for other content now, the waterfall has to be drawn completely
     UiLcdHy28_DrawFullRect(slayout.full.x, slayout.full.y, slayout.full.h, slayout.full.w, Black);	// Clear screen under spectrum scope by drawing a single, black block (faster with SPI!)
     ts.VirtualKeysShown_flag=false;	//if virtual keypad was shown, switch it off
 }
@@ -792,10 +795,12 @@ static void    UiSpectrum_DrawScope(uint16_t *old_pos, float32_t *fft_new)
             {
             	if((sd.marker_line_pos_prev[idx]>=left_filter_border_pos)&&(sd.marker_line_pos_prev[idx]<=right_filter_border_pos)) //BW highlight control
             	{
+            		clr_scope=clr_scope_fltr;
             		clr_bg=clr_scope_fltrbg;
             	}
             	else
             	{
+            		clr_scope=clr_scope_normal;
             		clr_bg=Black;
             	}
 
@@ -816,7 +821,7 @@ static void    UiSpectrum_DrawScope(uint16_t *old_pos, float32_t *fft_new)
                             sd.marker_line_pos_prev[idx],
                             spec_top_y - spec_height_limit /* old = max pos */ ,
                             spec_top_y /* new = min pos */,
-                            clr_scope, clr_bg,	//TODO: add highlight color here
+                            clr_scope, clr_bg,
                             false);
 
                     // we erase the memory for this location, so that it is fully redrawn
@@ -1027,6 +1032,7 @@ static void UiSpectrum_InitSpectrumDisplayData()
     sd.scope_size = slayout.scope.h;
     sd.wfall_ystart = slayout.wfall.y;
     sd.wfall_size = slayout.wfall.h;
+    sd.wfall_wipe_valid = false;
 
     // now make sure we fit in
     // please note, this works only if we have enough memory for have the lines
@@ -1084,6 +1090,195 @@ void UiSpectrum_WaterfallClearData()
 }
 
 
+/**
+ * @brief creates the pixels of a waterfall display line from a line of the waterfall buffer
+ *
+ * The line is shifted by the difference of its center frequency to cur_center_hz and padded with black pixels.
+ */
+static void UiSpectrum_WaterfallLinePixels(uint16_t* spectrum_pixel_buf, const uint16_t lptr, const int32_t cur_center_hz, const uint16_t* marker_line_pixel_pos)
+{
+    uint8_t  * const waterfallline_ptr = &sd.waterfall[lptr*slayout.wfall.w];
+
+
+    const int32_t line_center_hz = sd.waterfall_frequencies[lptr];
+
+    // if our old_center is lower than cur_center_hz -> find start idx in waterfall_line, end_idx is line end, and pad with black pixels;
+    // if our old_center is higher than cur_center_hz -> find start pixel x in end_idx is line end, first pad with black pixels until this point and then use pixel buffer;
+    // if identical -> well, no padding.
+    const int32_t diff_centers = (line_center_hz - cur_center_hz);
+    int32_t offset_pixel = diff_centers/sd.hz_per_pixel;
+    uint16_t pixel_start, pixel_count, left_padding_count, right_padding_count;
+
+
+    // here we actually create a single line pixel by pixel.
+
+    if (offset_pixel >= slayout.wfall.w || offset_pixel <= -slayout.wfall.w)
+    {
+        offset_pixel = slayout.wfall.w-1;
+    }
+    if (offset_pixel <= 0)
+    {
+                        // we have to start -offset_pixel later and then pad with black
+        left_padding_count = 0;
+        pixel_start = -offset_pixel;
+        right_padding_count = -offset_pixel;
+        pixel_count = slayout.wfall.w + offset_pixel;
+    }
+    else
+    {
+        // we to start with offset_pixel black padding  and then draw the pixels until we reach spectrum width
+        left_padding_count = offset_pixel;
+        pixel_start = 0;
+        right_padding_count = 0;
+        pixel_count = slayout.wfall.w - offset_pixel;
+    }
+
+
+    uint16_t* pixel_buf_ptr = &spectrum_pixel_buf[0];
+
+    // fill from the left border with black pixels
+    for(uint16_t i = 0; i < left_padding_count; i++)
+    {
+        *pixel_buf_ptr++ = Black;
+    }
+
+    for(uint16_t idx = pixel_start, i = 0; i < pixel_count; i++,idx++)
+    {
+        *pixel_buf_ptr++ = sd.waterfall_colours[waterfallline_ptr[idx]];    // write to memory using waterfall color from palette
+    }
+
+    // fill to the right border with black pixels
+    for(uint16_t i = 0; i < right_padding_count; i++)
+    {
+        *pixel_buf_ptr++ = Black;
+    }
+
+    for (uint16_t idx = 0; idx < sd.marker_num; idx ++)
+    {
+        // Place center line marker on screen:  Location [64] (the 65th) of the palette is reserved is a special color reserved for this
+        if (marker_line_pixel_pos[idx] < slayout.wfall.w)
+        {
+            spectrum_pixel_buf[marker_line_pixel_pos[idx]] = sd.waterfall_colours[NUMBER_WATERFALL_COLOURS];
+        }
+    }
+}
+
+/**
+ * @brief draws all lines of the waterfall, starting with the newest line at the top
+ * @param doubleLine how often the newest line already has been drawn in repeated line mode
+ * @returns true if all lines have been drawn, false if aborted by a ptt request
+ */
+static bool UiSpectrum_WaterfallRepaint(uint16_t lptr, uint8_t doubleLine, const uint16_t* marker_line_pixel_pos)
+{
+    // set up LCD for bulk write, limited only to area of screen with waterfall display.  This allow data to start from the
+    // bottom-left corner and advance to the right and up to the next line automatically without ever needing to address
+    // the location of any of the display data - as long as we "blindly" write precisely the correct number of pixels per
+    // line and the number of lines.
+
+    UiLcdHy28_BulkPixel_OpenWrite(slayout.wfall.x, slayout.wfall.w, slayout.wfall.y, slayout.wfall.h);
+
+    uint16_t spectrum_pixel_buf[slayout.wfall.w];
+
+    uint16_t lcnt = 0;
+
+    // we update the display unless there is a ptt request, in this case we skip to the end.
+    while(ts.ptt_req == false && lcnt < slayout.wfall.h)                 // set up counter for number of lines defining height of waterfall
+    {
+        UiSpectrum_WaterfallLinePixels(spectrum_pixel_buf, lptr, sd.FFT_frequency, marker_line_pixel_pos);
+
+        for(;doubleLine<sd.repeatWaterfallLine+1;doubleLine++)
+        {
+            UiLcdHy28_BulkPixel_PutBuffer(spectrum_pixel_buf, slayout.wfall.w);
+            lcnt++;
+            if(lcnt==slayout.wfall.h)	//preventing the window overlap if doubling oversize the display window
+            {
+            	break;
+            }
+        }
+        doubleLine=0;
+        lptr = lptr?lptr-1 : sd.wfall_size-1;
+        lptr %= sd.wfall_size;              // clip to display height
+
+    }
+
+
+    UiLcdHy28_BulkPixel_CloseWrite();                   // we are done updating the display - return to normal full-screen mode
+
+    return lcnt == slayout.wfall.h;
+}
+
+/**
+ * @returns true if the lines on the display are still correct and only the new lines have to be drawn in wipe mode
+ */
+static bool UiSpectrum_WaterfallWipePossible(const int32_t cur_center_hz, const uint16_t* marker_line_pixel_pos)
+{
+    bool retval = sd.wfall_wipe_valid
+            && ts.waterfall.vert_step_size < slayout.wfall.h
+            && sd.wfall_wipe_center_hz == cur_center_hz
+            && sd.wfall_wipe_hz_per_pixel == sd.hz_per_pixel
+            && sd.wfall_wipe_marker_num == sd.marker_num;
+
+    for (uint16_t idx = 0; retval && idx < sd.marker_num; idx++)
+    {
+        retval = sd.wfall_wipe_marker_pos[idx] == marker_line_pixel_pos[idx];
+    }
+    return retval;
+}
+
+/**
+ * @brief remembers for which center frequency and markers the displayed waterfall has been drawn
+ */
+static void UiSpectrum_WaterfallWipeSetState(const int32_t cur_center_hz, const uint16_t* marker_line_pixel_pos)
+{
+    sd.wfall_wipe_center_hz = cur_center_hz;
+    sd.wfall_wipe_hz_per_pixel = sd.hz_per_pixel;
+    sd.wfall_wipe_marker_num = sd.marker_num;
+    for (uint16_t idx = 0; idx < sd.marker_num; idx++)
+    {
+        sd.wfall_wipe_marker_pos[idx] = marker_line_pixel_pos[idx];
+    }
+}
+
+/**
+ * @brief draws only the new lines above the previous newest line, they overwrite the oldest lines
+ *
+ * Each call of UiSpectrum_DrawWaterfall adds one display line, so an update draws as many lines as calls per update.
+ * The new lines are the first lines UiSpectrum_WaterfallRepaint would draw. Above the top of the area we continue
+ * at the bottom, i.e. the newest line moves up through the area and the lines below it get older.
+ */
+static void UiSpectrum_WaterfallWipe(uint16_t lptr, uint8_t doubleLine, const uint16_t* marker_line_pixel_pos)
+{
+    const uint16_t lines = ts.waterfall.vert_step_size;
+    uint16_t row = (sd.wfall_wipe_row + slayout.wfall.h - lines) % slayout.wfall.h;
+
+    sd.wfall_wipe_row = row;
+
+    UiLcdHy28_BulkPixel_OpenWrite(slayout.wfall.x, slayout.wfall.w, slayout.wfall.y + row, slayout.wfall.h - row);
+
+    uint16_t spectrum_pixel_buf[slayout.wfall.w];
+
+    for(uint16_t lcnt = 0; lcnt < lines;)
+    {
+        UiSpectrum_WaterfallLinePixels(spectrum_pixel_buf, lptr, sd.FFT_frequency, marker_line_pixel_pos);
+
+        for(;doubleLine<sd.repeatWaterfallLine+1 && lcnt < lines;doubleLine++, lcnt++, row++)
+        {
+            if (row == slayout.wfall.h)
+            {
+                // continue at the top of the waterfall area
+                UiLcdHy28_BulkPixel_CloseWrite();
+                row = 0;
+                UiLcdHy28_BulkPixel_OpenWrite(slayout.wfall.x, slayout.wfall.w, slayout.wfall.y, slayout.wfall.h);
+            }
+            UiLcdHy28_BulkPixel_PutBuffer(spectrum_pixel_buf, slayout.wfall.w);
+        }
+        doubleLine=0;
+        lptr = lptr?lptr-1 : sd.wfall_size-1;
+    }
+
+    UiLcdHy28_BulkPixel_CloseWrite();
+}
+
 static void UiSpectrum_DrawWaterfall()
 {
     sd.wfall_line %= sd.wfall_size; // make sure that the circular buffer is clipped to the size of the display area
@@ -1139,106 +1334,31 @@ static void UiSpectrum_DrawWaterfall()
 
         lptr %= sd.wfall_size;      // do modulus limit of spectrum high
 
-        // set up LCD for bulk write, limited only to area of screen with waterfall display.  This allow data to start from the
-        // bottom-left corner and advance to the right and up to the next line automatically without ever needing to address
-        // the location of any of the display data - as long as we "blindly" write precisely the correct number of pixels per
-        // line and the number of lines.
-
-        UiLcdHy28_BulkPixel_OpenWrite(slayout.wfall.x, slayout.wfall.w, slayout.wfall.y, slayout.wfall.h);
-
-        uint16_t spectrum_pixel_buf[slayout.wfall.w];
-
         const int32_t cur_center_hz = sd.FFT_frequency;
 
-        uint8_t doubleLine=doubleLineStart;
-
-        // we update the display unless there is a ptt request, in this case we skip to the end.
-        for(uint16_t lcnt = 0; ts.ptt_req == false && lcnt < slayout.wfall.h;)                 // set up counter for number of lines defining height of waterfall
+        if ((ts.flags2 & FLAGS2_WFALL_WIPE) == 0)
         {
-            uint8_t  * const waterfallline_ptr = &sd.waterfall[lptr*slayout.wfall.w];
-
-
-            const int32_t line_center_hz = sd.waterfall_frequencies[lptr];
-
-            // if our old_center is lower than cur_center_hz -> find start idx in waterfall_line, end_idx is line end, and pad with black pixels;
-            // if our old_center is higher than cur_center_hz -> find start pixel x in end_idx is line end, first pad with black pixels until this point and then use pixel buffer;
-            // if identical -> well, no padding.
-            const int32_t diff_centers = (line_center_hz - cur_center_hz);
-            int32_t offset_pixel = diff_centers/sd.hz_per_pixel;
-            uint16_t pixel_start, pixel_count, left_padding_count, right_padding_count;
-
-
-            // here we actually create a single line pixel by pixel.
-
-            if (offset_pixel >= slayout.wfall.w || offset_pixel <= -slayout.wfall.w)
-            {
-                offset_pixel = slayout.wfall.w-1;
-            }
-            if (offset_pixel <= 0)
-            {
-                                // we have to start -offset_pixel later and then pad with black
-                left_padding_count = 0;
-                pixel_start = -offset_pixel;
-                right_padding_count = -offset_pixel;
-                pixel_count = slayout.wfall.w + offset_pixel;
-            }
-            else
-            {
-                // we to start with offset_pixel black padding  and then draw the pixels until we reach spectrum width
-                left_padding_count = offset_pixel;
-                pixel_start = 0;
-                right_padding_count = 0;
-                pixel_count = slayout.wfall.w - offset_pixel;
-            }
-
-
-            uint16_t* pixel_buf_ptr = &spectrum_pixel_buf[0];
-
-            // fill from the left border with black pixels
-            for(uint16_t i = 0; i < left_padding_count; i++)
-            {
-                *pixel_buf_ptr++ = Black;
-            }
-
-            for(uint16_t idx = pixel_start, i = 0; i < pixel_count; i++,idx++)
-            {
-                *pixel_buf_ptr++ = sd.waterfall_colours[waterfallline_ptr[idx]];    // write to memory using waterfall color from palette
-            }
-
-            // fill to the right border with black pixels
-            for(uint16_t i = 0; i < right_padding_count; i++)
-            {
-                *pixel_buf_ptr++ = Black;
-            }
-
-            for (uint16_t idx = 0; idx < sd.marker_num; idx ++)
-            {
-                // Place center line marker on screen:  Location [64] (the 65th) of the palette is reserved is a special color reserved for this
-                if (marker_line_pixel_pos[idx] < slayout.wfall.w)
-                {
-                    spectrum_pixel_buf[marker_line_pixel_pos[idx]] = sd.waterfall_colours[NUMBER_WATERFALL_COLOURS];
-                }
-            }
-
-
-
-            for(;doubleLine<sd.repeatWaterfallLine+1;doubleLine++)
-            {
-                UiLcdHy28_BulkPixel_PutBuffer(spectrum_pixel_buf, slayout.wfall.w);
-                lcnt++;
-                if(lcnt==slayout.wfall.h)	//preventing the window overlap if doubling oversize the display window
-                {
-                	break;
-                }
-            }
-            doubleLine=0;
-            lptr = lptr?lptr-1 : sd.wfall_size-1;
-            lptr %= sd.wfall_size;              // clip to display height
-
+            // all lines move down, so all are drawn again
+            UiSpectrum_WaterfallRepaint(lptr, doubleLineStart, marker_line_pixel_pos);
+            sd.wfall_wipe_valid = false;
+        }
+        else if (ts.ptt_req == true)
+        {
+            // lines are skipped, the display no longer matches the buffer
+            sd.wfall_wipe_valid = false;
+        }
+        else if (UiSpectrum_WaterfallWipePossible(cur_center_hz, marker_line_pixel_pos))
+        {
+            // only the new lines are transferred to the display
+            UiSpectrum_WaterfallWipe(lptr, doubleLineStart, marker_line_pixel_pos);
+        }
+        else
+        {
+            // the center frequency or the markers have changed, all lines have to be shifted
+            sd.wfall_wipe_row = 0;
+            sd.wfall_wipe_valid = UiSpectrum_WaterfallRepaint(lptr, doubleLineStart, marker_line_pixel_pos);
+            UiSpectrum_WaterfallWipeSetState(cur_center_hz, marker_line_pixel_pos);
         }
-
-
-        UiLcdHy28_BulkPixel_CloseWrite();                   // we are done updating the display - return to normal full-screen mode
     }
 
 }
@@ -1657,7 +1777,7 @@ static void UiSpectrum_DrawFrequencyBar()
 
         if (sd.magnify == 0)
         {
-            freq_calc += AudioDriver_GetTranslateFreq();
+            freq_calc += AudioDriver_GetRxShiftFreq();
             // correct for display center not being RX center frequency location
         }
         if(sd.magnify < 3)
@@ -1704,7 +1824,7 @@ static void UiSpectrum_DrawFrequencyBar()
                 char *c;
                 if(sd.magnify < 3)
                 {
-                    snprintf(txt,16, "%02lu", ((uint32_t)(freq_calc+(idx*grat)))%100);   // build string for middle-left frequency (1khz precision)
+                    snprintf(txt,16, "%02u", (unsigned int)(((uint32_t)(freq_calc+(idx*grat)))%100));   // build string for middle-left frequency (1khz precision)
                     c = txt;  // point at 2nd character from the end
                 }
                 else
@@ -2126,6 +2246,8 @@ static void UiSpectrum_CalculateDBm()
                 {
                     bin_offset =  (buff_len_int / 8);
                 }
+                // the DSP NCO moves the receive frequency away from the translate frequency
+                bin_offset -= roundf(ts.rx_nco_offset / bin_BW);
             }
 
             int posbin = buff_len_int / 4 + bin_offset;  // right in the middle!
@@ -248,6 +248,14 @@ typedef struct SpectrumDisplay
     //uint16_t wfall_disp_lines;        // vertical size of the waterfall on display
     uint16_t wfall_ystart;
 
+    // wipe mode waterfall, new lines overwrite the oldest lines on the display instead of scrolling the area
+    bool     wfall_wipe_valid;          // the display shows the waterfall for the state below, only new lines have to be drawn
+    uint16_t wfall_wipe_row;            // display row of the newest line
+    int32_t  wfall_wipe_center_hz;      // center frequency the displayed lines have been shifted to
+    float32_t wfall_wipe_hz_per_pixel;
+    uint16_t wfall_wipe_marker_num;
+    uint16_t wfall_wipe_marker_pos[SPECTRUM_MAX_MARKER];
+
     uint16_t scope_size;
     uint16_t scope_ystart;
 
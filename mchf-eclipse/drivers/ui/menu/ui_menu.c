@@ -38,6 +38,7 @@
 #include "osc_si570.h"
 
 #include "audio_nr.h"
+#include "audio_fblms.h"
 
 #define CLR_OR_SET_BITMASK(cond,value,mask) ((value) = (((cond))? ((value) | (mask)): ((value) & ~(mask))))
 
@@ -45,7 +46,7 @@ void float2fixedstr(char* buf, int maxchar, float32_t f, uint16_t digitsBefore,
 {
     char formatstr[16],numberstr[32];
 
-    int32_t mult_digits = pow10(digitsAfter);
+    int32_t mult_digits = exp10(digitsAfter);
 
     snprintf(formatstr,16,(digitsBefore + digitsBefore > 0)?"%%%dd":"%%d",digitsBefore + digitsAfter);
 
@@ -2340,6 +2341,9 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
                                    );
         snprintf(options,32, "  %u", ts.waterfall.vert_step_size);
         break;
+    case MENU_WFALL_WIPE:
+        UiDriverMenuItemChangeEnableOnOffFlag(var, mode, &ts.flags2,0,options,&clr, FLAGS2_WFALL_WIPE);
+        break;
 #if 0
     case MENU_WFALL_OFFSET: // set step size of of waterfall display?
         UiDriverMenuItemChangeInt32(var, mode, &ts.waterfall.offset,
@@ -3280,18 +3284,13 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
         }
         snprintf(options,32, "  %u", ts.dsp_notch_mu);
         break;
-    case CONFIG_DSP_NOTCH_DECORRELATOR_BUFFER_LENGTH:       // Adjustment of DSP noise reduction de-correlation delay buffer length
-        var_change = UiDriverMenuItemChangeUInt8(var, mode, &ts.dsp_notch_delaybuf_len,
-                                              DSP_NOTCH_BUFLEN_MIN,
-                                              DSP_NOTCH_BUFLEN_MAX,
-                                              DSP_NOTCH_DELAYBUF_DEFAULT,
+    case CONFIG_DSP_NOTCH_DELAY:       // Adjustment of DSP notch de-correlation delay
+        var_change = UiDriverMenuItemChangeUInt8(var, mode, &ts.dsp_notch_delay,
+                                              DSP_NOTCH_DELAY_MIN,
+                                              DSP_NOTCH_DELAY_MAX,
+                                              DSP_NOTCH_DELAY_DEFAULT,
                                               8);
 
-
-        if(ts.dsp_notch_delaybuf_len <= ts.dsp_notch_numtaps)       // did we try to decrease it smaller than FFT size?
-        {
-            ts.dsp_notch_delaybuf_len = ts.dsp_notch_numtaps + 8;                       // yes - limit it to previous size
-        }
         if(var_change)      // did something change?
         {
             if(ts.dsp_active & DSP_NOTCH_ENABLE)    // only update if DSP Notch active
@@ -3303,21 +3302,15 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
         {
             clr = Orange;
         }
-        if(ts.dsp_notch_numtaps >= ts.dsp_notch_delaybuf_len)
-        {
-            clr = Red;
-        }
-        snprintf(options,32, "  %u", (uint)ts.dsp_notch_delaybuf_len);
+        snprintf(options,32, "  %u", (uint)ts.dsp_notch_delay);
         break;
     case CONFIG_DSP_NOTCH_FFT_NUMTAPS:      // Adjustment of DSP noise reduction de-correlation delay buffer length
-        ts.dsp_notch_numtaps &= 0xf0;   // mask bottom nybble to enforce 16-count boundary
+        ts.dsp_notch_numtaps = DSP_NOTCH_NUMTAPS_ROUND(ts.dsp_notch_numtaps);   // enforce the block length of the filter
         var_change = UiDriverMenuItemChangeUInt8(var, mode, &ts.dsp_notch_numtaps,
-                                              16,
+                                              DSP_NOTCH_NUMTAPS_MIN,
                                               DSP_NOTCH_NUMTAPS_MAX,
                                               DSP_NOTCH_NUMTAPS_DEFAULT,
-                                              16);
-//        if(ts.dsp_notch_numtaps >= ts.dsp_notch_delaybuf_len)   // force buffer size to always be larger than number of taps
-//            ts.dsp_notch_delaybuf_len = ts.dsp_notch_numtaps + 8;
+                                              DSP_NOTCH_NUMTAPS_STEP);
         if(var_change)      // did something change?
         {
             if(ts.dsp_active & DSP_NOTCH_ENABLE)    // only update if DSP NR active
@@ -3329,10 +3322,6 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
         {
             clr = Orange;
         }
-        if(ts.dsp_notch_numtaps >= ts.dsp_notch_delaybuf_len)   // Warn if number of taps greater than/equal buffer length!
-        {
-            clr = Red;
-        }
         snprintf(options,32, "  %u", ts.dsp_notch_numtaps);
         break;
 #endif
@@ -3396,16 +3385,28 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
             AudioDriver_TxFilterInit(ts.dmod_mode);
         }
         break;
+#ifdef USE_CONVOLUTION
+    case CONFIG_RX_CONV_FILTER:
+        var_change = UiDriverMenuItemChangeEnableOnOffFlag(var, mode, &ts.flags2,0,options,&clr, FLAGS2_RX_CONV_FILTER);
+        if(var_change)
+        {
+            AudioDriver_SetRxAudioProcessing(ts.dmod_mode, false);
+        }
+        break;
+#endif
 
         case CONFIG_TUNE_TONE_MODE: // set power for antenne tuning
         temp_var_u8 = ts.menu_var_changed;
         // this is not save, so no need to mark as dirty,
         // we just remember the state and restore it
-        var_change = UiDriverMenuItemChangeUInt8(var, mode, &ts.tune_tone_mode,
+        // the enum is not a byte on every compiler
+        uint8_t tune_tone_mode = ts.tune_tone_mode;
+        var_change = UiDriverMenuItemChangeUInt8(var, mode, &tune_tone_mode,
                                               TUNE_TONE_SINGLE,
                                               TUNE_TONE_TWO,
                                               TUNE_TONE_SINGLE,
                                               1);
+        ts.tune_tone_mode = tune_tone_mode;
         switch(ts.tune_tone_mode)
         {
         case TUNE_TONE_SINGLE:
@@ -3748,6 +3749,10 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
 #ifdef USE_LEAKY_LMS
         case MENU_DEBUG_LEAKY_LMS:
             var_change = UiDriverMenuItemChangeEnableOnOffBool(var, mode, &ts.enable_leaky_LMS,0,options,&clr);
+            if(var_change)
+            {
+                AudioDriver_SetRxAudioProcessing(ts.dmod_mode, false);
+            }
             break;
 
 
@@ -3760,7 +3765,8 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
             );
             if(var_change)
             {
-            	leakyLMS.two_mu = leakyLMS.two_mu_int / 1000000;
+            	leakyLMS.two_mu = leakyLMS.two_mu_int / 10000.0;
+                AudioDriver_SetRxAudioProcessing(ts.dmod_mode, false);
             }
             snprintf(options, 32, " %4u",(unsigned int)leakyLMS.two_mu_int);
 
@@ -3774,7 +3780,8 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
             );
             if(var_change)
             {
-            	leakyLMS.gamma = leakyLMS.gamma_int / 1000;
+            	leakyLMS.gamma = leakyLMS.gamma_int / 1000.0;
+                AudioDriver_SetRxAudioProcessing(ts.dmod_mode, false);
             }
             snprintf(options, 32, " %4u",(unsigned int)leakyLMS.gamma_int);
 
@@ -3782,14 +3789,14 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
 
         case MENU_DEBUG_ANR_TAPS:      //
             var_change = UiDriverMenuItemChangeInt16(var, mode, &leakyLMS.n_taps,
-                    1,
-                    192,
+                    32,
+                    FBLMS_TAPS_MAX,
                     64,
-                    2
+                    32
             );
             if(var_change)
             {
-//            	leakyLMS.gamma = leakyLMS.gamma_int / 1000;
+                AudioDriver_SetRxAudioProcessing(ts.dmod_mode, false);
             }
             snprintf(options, 32, " %3u",(unsigned int)leakyLMS.n_taps);
 
@@ -3803,7 +3810,7 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
             );
             if(var_change)
             {
-//            	leakyLMS.gamma = leakyLMS.gamma_int / 1000;
+                AudioDriver_SetRxAudioProcessing(ts.dmod_mode, false);
             }
             snprintf(options, 32, " %3u",(unsigned int)leakyLMS.delay);
 
@@ -3968,18 +3975,18 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
 			}
         break; */
 
-            case MENU_DEBUG_NR_ASNR:
-             var_change = UiDriverMenuItemChangeInt16(var, mode, &NR2.asnr,
-                                                   2,
-                                                   30,
-                                                   30,
-                                                   1);
-             if(var_change)      // did something change?
-             {
-             	//ts.nr_first_time = 1;
-             }
-             snprintf(options,32, "  %3u", (unsigned int)NR2.asnr);
-             break;
+//            case MENU_DEBUG_NR_ASNR:
+//             var_change = UiDriverMenuItemChangeInt16(var, mode, &NR2.asnr,
+//                                                   2,
+//                                                   30,
+//                                                   30,
+//                                                   1);
+//             if(var_change)      // did something change?
+//             {
+//             	//ts.nr_first_time = 1;
+//             }
+//             snprintf(options,32, "  %3u", (unsigned int)NR2.asnr);
+//             break;
 
 
         case MENU_DEBUG_NR_GAIN_SMOOTH_WIDTH:
@@ -4049,18 +4056,25 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
         //     case MENU_DEBUG_NEW_NB:
         //         var_change = UiDriverMenuItemChangeEnableOnOffBool(var, mode, &ts.new_nb,0,options,&clr);
         //         break;//
-//#if defined(STM32F7) || defined(STM32H7)
-/*     case MENU_DEBUG_NR_FFT_SIZE:
-                 var_change = UiDriverMenuItemChangeEnableOnOffBool(var, mode, &ts.nr_fft_256_enable,0,options,&clr);
-                 ts.NR_FFT_L = 128;
-                 ts.NR_FFT_LOOP_NO = 2;
-                 if(ts.nr_fft_256_enable)
+     case MENU_DEBUG_NR_FFT_SIZE:
+     {
+                 // 0 = 128, 1 = 256, 2 = 512 samples
+                 uint8_t fft_size_idx = ts.NR_FFT_L / 256;
+                 var_change = UiDriverMenuItemChangeUInt8(var, mode, &fft_size_idx,
+                                                   0,
+                                                   2,
+                                                   NR_FFT_L_DEFAULT / 256,
+                                                   1);
+                 if(var_change)
                  {
-                	 ts.NR_FFT_LOOP_NO = 1;
-                	 ts.NR_FFT_L = 256;
+                	 ts.NR_FFT_L = 128 << fft_size_idx;
+                	 ts.nr_first_time = 1; //Restart the noisereduction
                  }
+                 snprintf(options,32, "  %3u", (unsigned int)ts.NR_FFT_L);
+     }
         break;
-     case MENU_DEBUG_NR_DEC_ENABLE:
+//#if defined(STM32F7) || defined(STM32H7)
+/*     case MENU_DEBUG_NR_DEC_ENABLE:
                  var_change = UiDriverMenuItemChangeEnableOnOffBool(var, mode, &ts.NR_decimation_enable,0,options,&clr);
         break;
 //#endif
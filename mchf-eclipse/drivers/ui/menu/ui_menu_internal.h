@@ -82,6 +82,7 @@ enum
     MENU_SPECTRUM_MODE,
     MENU_WFALL_COLOR_SCHEME,
     MENU_WFALL_STEP_SIZE,
+    MENU_WFALL_WIPE,
     MENU_WFALL_OFFSET,
     MENU_WFALL_CONTRAST,
     MENU_WFALL_SPEED,
@@ -206,13 +207,16 @@ enum
 #endif
 #ifdef USE_LMS_AUTONOTCH
     CONFIG_DSP_NOTCH_CONVERGE_RATE,
-    CONFIG_DSP_NOTCH_DECORRELATOR_BUFFER_LENGTH,
+    CONFIG_DSP_NOTCH_DELAY,
     CONFIG_DSP_NOTCH_FFT_NUMTAPS,
 #endif
 //    CONFIG_AGC_TIME_CONSTANT,
     CONFIG_AM_TX_FILTER_DISABLE,
 //    CONFIG_SSB_TX_FILTER_DISABLE,
     CONFIG_SSB_TX_FILTER,
+#ifdef USE_CONVOLUTION
+    CONFIG_RX_CONV_FILTER,
+#endif
     CONFIG_TUNE_POWER_LEVEL,
     CONFIG_TUNE_TONE_MODE,
 //    CONFIG_SPECTRUM_FFT_WINDOW_TYPE,
@@ -258,11 +262,11 @@ enum
 //	MENU_DEBUG_NR_VAD_DELAY,
 	MENU_DEBUG_NR_BETA,
 //	MENU_DEBUG_NR_Mode,
+	MENU_DEBUG_NR_FFT_SIZE,
 //#if defined(STM32F7) || defined(STM32H7)
-//	MENU_DEBUG_NR_FFT_SIZE,
 //	MENU_DEBUG_NR_DEC_ENABLE,
 //#endif
-	MENU_DEBUG_NR_ASNR,
+//	MENU_DEBUG_NR_ASNR,
 	MENU_DEBUG_NR_GAIN_SMOOTH_WIDTH,
 	MENU_DEBUG_NR_GAIN_SMOOTH_THRESHOLD,
 //	MENU_DEBUG_RTTY_ATC,
@@ -270,11 +274,13 @@ enum
 	MENU_DEBUG_ENABLE_STEREO,
 #endif
 	//	MENU_DEBUG_CW_DECODER,
-//	MENU_DEBUG_LEAKY_LMS,
-//	MENU_DEBUG_ANR_TAPS,
-//	MENU_DEBUG_ANR_DELAY,
-//	MENU_DEBUG_ANR_GAIN,
-//	MENU_DEBUG_ANR_LEAK,
+#ifdef USE_LEAKY_LMS
+	MENU_DEBUG_LEAKY_LMS,
+	MENU_DEBUG_ANR_TAPS,
+	MENU_DEBUG_ANR_DELAY,
+	MENU_DEBUG_ANR_GAIN,
+	MENU_DEBUG_ANR_LEAK,
+#endif
 	MENU_DEBUG_OSC_SI5351_PLLRESET,
 
     CONFIG_RTC_START,
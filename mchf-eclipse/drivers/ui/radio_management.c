@@ -341,6 +341,17 @@ void RadioManagement_SetPaBias()
 }
 
 
+/**
+ * @brief returns how far (in Hz) the tune frequency may move away from the LO frequency before the LO is retuned
+ * Inside this window the RX DSP NCO follows the tuning, which is click free and requires no I2C traffic.
+ * Half the translate frequency keeps the signal well away from zero IF, with translate mode off the LO is always retuned.
+ */
+static int32_t RadioManagement_GetDspTuneWindow()
+{
+    const int32_t translate_freq = AudioDriver_GetTranslateFreq();
+    return (translate_freq < 0 ? -translate_freq : translate_freq) / 2;
+}
+
 bool RadioManagement_ChangeFrequency(bool force_update, uint32_t dial_freq,uint8_t txrx_mode)
 {
     // everything else uses main VFO frequency
@@ -350,7 +361,28 @@ bool RadioManagement_ChangeFrequency(bool force_update, uint32_t dial_freq,uint8
     // Calculate actual tune frequency
     ts.tune_freq_req = RadioManagement_Dial2TuneFrequency(dial_freq, txrx_mode);
 
-    if((ts.tune_freq != ts.tune_freq_req) || (ts.refresh_freq_disp) || df.temp_factor_changed || force_update )  // did the frequency NOT change and display refresh NOT requested??
+    const int32_t lo_offset = (int32_t)(ts.tune_freq - ts.tune_freq_req);
+    const int32_t dsp_tune_window = RadioManagement_GetDspTuneWindow();
+
+    // the NCO offset is relative to ts.tune_freq, after a failed LO change we do not know where the LO is
+    const bool lo_on_tune_freq = ts.last_lo_result != OSC_COMM_ERROR && ts.last_lo_result != OSC_ERROR_VERIFY;
+
+    // on receive small moves are done by the DSP NCO, the LO stays where it is
+    // TX always gets the exact LO frequency, the TX path has no NCO
+    if (txrx_mode == TRX_MODE_RX && ts.tune_freq != 0 && force_update == false && df.temp_factor_changed == false &&
+            ts.refresh_freq_disp == false && lo_on_tune_freq == true &&
+            lo_offset >= -dsp_tune_window && lo_offset <= dsp_tune_window)
+    {
+        if (lo_offset != ts.rx_nco_offset)
+        {
+            ts.rx_nco_offset = lo_offset;
+            df.tune_old = dial_freq*TUNE_MULT;
+
+            // Inform Spectrum Display code that a frequency change has happened
+            ts.dial_moved = 1;
+        }
+    }
+    else if((ts.tune_freq != ts.tune_freq_req) || (ts.refresh_freq_disp) || df.temp_factor_changed || force_update )  // did the frequency NOT change and display refresh NOT requested??
     {
 
         if(ts.sysclock-ts.last_tuning > 5 || ts.last_tuning == 0)     // prevention for SI570 crash due too fast frequency changes
@@ -388,6 +420,7 @@ bool RadioManagement_ChangeFrequency(bool force_update, uint32_t dial_freq,uint8
             {
                 df.temp_factor_changed = false;
                 ts.tune_freq = ts.tune_freq_req;        // frequency change required - update change detector
+                ts.rx_nco_offset = 0;                   // LO is now exactly on frequency
                 // Save current freq
                 df.tune_old = dial_freq*TUNE_MULT;
             }
@@ -416,10 +449,16 @@ bool RadioManagement_ChangeFrequency(bool force_update, uint32_t dial_freq,uint8
         }
         else
         {
+            // the NCO offset stays until the LO change is done
             lo_change_pending = true;
         }
 
     }
+    else if (txrx_mode == TRX_MODE_TX)
+    {
+        // the LO is already on the TX frequency
+        ts.rx_nco_offset = 0;
+    }
 
     // successfully executed the change
     return lo_change_pending == false;
@@ -1331,7 +1370,7 @@ static void RadioManagement_PowerFromADCValue(float val, float sensor_null, floa
     }
 
     dbm = (10 * (log10f(pwr))) + 30 + coupling_calc;
-    pwr = pow10f(dbm/10)/1000;
+    pwr = exp10f(dbm/10)/1000;
     *pwr_ptr = pwr;
     *dbm_ptr = dbm;
 }
@@ -1436,7 +1475,7 @@ void RadioManagement_HandleRxIQSignalCodecGain()
     Codec_IQInGainAdj((uint8_t)rfg_calc); // set the RX gain on the codec
 
     // Now calculate the RF gain setting
-    gcalc = pow10(((rfg_calc * 1.5) - 34.5) / 10) ;
+    gcalc = exp10(((rfg_calc * 1.5) - 34.5) / 10) ;
 
     // codec has 1.5 dB/step
     // offset codec setting by 34.5db (full gain = 12dB)
@@ -133,7 +133,7 @@ const ConfigEntryDescriptor ConfigEntryInfo[] =
 #endif
 
 #ifdef USE_LMS_AUTONOTCH
-	{ ConfigEntry_UInt8, EEPROM_DSP_NOTCH_DECOR_BUFLEN,&ts.dsp_notch_delaybuf_len,DSP_NOTCH_DELAYBUF_DEFAULT,DSP_NOTCH_BUFLEN_MIN,DSP_NOTCH_BUFLEN_MAX},
+	{ ConfigEntry_UInt8, EEPROM_DSP_NOTCH_DELAY,&ts.dsp_notch_delay,DSP_NOTCH_DELAY_DEFAULT,DSP_NOTCH_DELAY_MIN,DSP_NOTCH_DELAY_MAX},
     { ConfigEntry_UInt8, EEPROM_DSP_NOTCH_FFT_NUMTAPS,&ts.dsp_notch_numtaps,DSP_NOTCH_NUMTAPS_DEFAULT, DSP_NOTCH_NUMTAPS_MIN,DSP_NOTCH_NUMTAPS_MAX},
     { ConfigEntry_UInt8, EEPROM_DSP_NOTCH_CONV_RATE,&ts.dsp_notch_mu,DSP_NOTCH_MU_DEFAULT,0,DSP_NOTCH_MU_MAX},
 #endif
@@ -734,6 +734,11 @@ void UiConfiguration_LoadEepromValues(void)
 
     ts.alc_tx_postfilt_gain_var =  ts.alc_tx_postfilt_gain; // "working" copy of variable
 
+#ifdef USE_LMS_AUTONOTCH
+    // settings of the old notch may be in steps of 16
+    ts.dsp_notch_numtaps = DSP_NOTCH_NUMTAPS_ROUND(ts.dsp_notch_numtaps);
+#endif
+
     // set xlate to -12KHz at first start
     if(ts.version_number_release == 0 && ts.version_number_minor == 0 && ts.version_number_major == 0 )
          {
@@ -357,7 +357,7 @@ void		UiConfiguration_UpdateMacroCap(void);
 #define EEPROM_DSP_NOTCH_CONV_RATE			165     // DSP Notch convergence rate
 #endif
 #ifdef USE_LMS_AUTONOTCH
-#define EEPROM_DSP_NOTCH_DECOR_BUFLEN		164     // DSP Notch De-correlator buffer length
+// 164 is the buffer length of the old notch, the block LMS notch stores its delay in EEPROM_DSP_NOTCH_DELAY
 #define EEPROM_DSP_NOTCH_CONV_RATE			165     // DSP Notch convergence rate
 #endif
 //
@@ -595,7 +595,8 @@ void		UiConfiguration_UpdateMacroCap(void);
 #define EEPROM_ENABLE_PTT_RTS				409
 #define EEPROM_CW_DECODER_THRESH					410
 #define EEPROM_CW_DECODER_BLOCKSIZE				411
-#define EEPROM_FIRST_UNUSED 				412		// change this if new value ids are introduced, must be correct at any time
+#define EEPROM_DSP_NOTCH_DELAY					412     // DSP Notch decorrelation delay in samples
+#define EEPROM_FIRST_UNUSED 				413		// change this if new value ids are introduced, must be correct at any time
 
 #define MAX_VAR_ADDR (EEPROM_FIRST_UNUSED - 1)
 
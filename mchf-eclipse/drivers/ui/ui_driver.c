@@ -33,6 +33,7 @@
 // LCD
 #include "ui_lcd_hy28.h"
 #include "ui_spectrum.h"
+#include "ui_compositor.h"
 
 #include "freedv_uhsdr.h"
 
@@ -43,6 +44,7 @@
 
 // Codec control
 #include "codec.h"
+#include "uhsdr_hw_i2s.h"
 
 #include "audio_management.h"
 #include "ui_driver.h"
@@ -59,8 +61,6 @@
 #include "cw_decoder.h"
 #include "psk.h"
 
-#include "audio_convolution.h"
-
 #define SPLIT_ACTIVE_COLOUR         		Yellow      // colour of "SPLIT" indicator when active
 #define SPLIT_INACTIVE_COLOUR           	Grey        // colour of "SPLIT" indicator when NOT active
 #define COL_PWR_IND                 		White
@@ -80,7 +80,7 @@ static void 	UiDriver_InitFrequency();
 //
 
 static void     UiDriver_UpdateLcdFreq(ulong dial_freq,ushort color,ushort mode);
-static bool 	UiDriver_IsButtonPressed(ulong button_num);
+static bool 	UiDriver_IsButtonPressed(uint32_t button_num);
 static void		UiDriver_TimeScheduler();				// Also handles audio gain and switching of audio on return from TX back to RX
 static void 	UiDriver_ChangeToNextDemodMode(bool select_alternative_mode);
 static void 	UiDriver_ChangeBand(uchar is_up);
@@ -502,7 +502,7 @@ void UiDriver_TextMsgClear()
 	}
 	ui_txt_msg_buffer[fillcnt]='\0';
 
-    UiLcdHy28_PrintText(ts.Layout->TextMsgLine.x,ts.Layout->TextMsgLine.y, ui_txt_msg_buffer,Yellow,Black,ts.Layout->TextMsg_font);
+    UiCompositor_PrintText(ts.Layout->TextMsgLine.x,ts.Layout->TextMsgLine.y, ui_txt_msg_buffer,Yellow,Black,ts.Layout->TextMsg_font);
     ui_txt_msg_idx = 0;
     ui_txt_msg_update = true;
 }
@@ -522,7 +522,7 @@ void UiDriver_TextMsgDisplay()
         	ui_txt_msg_buffer[fillcnt]='\0';
         }
 
-        UiLcdHy28_PrintText(ts.Layout->TextMsgLine.x,ts.Layout->TextMsgLine.y, ui_txt_msg_buffer,Yellow,Black,ts.Layout->TextMsg_font);
+        UiCompositor_PrintText(ts.Layout->TextMsgLine.x,ts.Layout->TextMsgLine.y, ui_txt_msg_buffer,Yellow,Black,ts.Layout->TextMsg_font);
     }
 }
 
@@ -693,20 +693,74 @@ void UiDriver_FrequencyUpdateLOandDisplay(bool full_update)
 	ts.refresh_freq_disp = 0;           // update ALL digits
 }
 
+/**
+ * @brief draws the text at once, the compositor forgets what it has drawn there
+ *
+ * The debug and load display share their line with the text message line on some layouts.
+ */
+static void UiDriver_PrintTextDirect(uint16_t x, uint16_t y, const char* str, uint16_t clr_fg, uint16_t clr_bg, uint8_t font)
+{
+	UiLcdHy28_PrintText(x, y, str, clr_fg, clr_bg, font);
+	UiCompositor_InvalidateRect(x, y, UiLcdHy28_TextWidth(str, font), UiLcdHy28_TextHeight(font));
+}
+
 void UiDriver_DebugInfo_DisplayEnable(bool enable)
 {
 
-	UiLcdHy28_PrintText(ts.Layout->DEBUG_X,ts.Layout->LOADANDDEBUG_Y,enable?"enabled":"       ",Green,Black,0);
+	UiDriver_PrintTextDirect(ts.Layout->DEBUG_X,ts.Layout->LOADANDDEBUG_Y,enable?"enabled":"       ",Green,Black,0);
 
 	if (enable == false)
 	{
-		UiLcdHy28_PrintText(ts.Layout->LOAD_X,ts.Layout->LOADANDDEBUG_Y,"     ",White,Black,0);
+		// also the audio stage text of UiDriver_DisplayAudioStages()
+		UiDriver_PrintTextDirect(ts.Layout->DEBUG_X,ts.Layout->LOADANDDEBUG_Y,"              ",White,Black,0);
+		UiDriver_PrintTextDirect(ts.Layout->LOAD_X,ts.Layout->LOADANDDEBUG_Y,"     ",White,Black,0);
 	}
 
 	ts.show_debug_info = enable;
 
 }
 
+/**
+ * @brief number of audio blocks which missed their deadline since start and the audio stage with the
+ * longest 99th percentile (the longest maximum if there are no histograms), in percent of the block period
+ * The stage events are reset afterwards, so the percentile is the one of the last display interval.
+ */
+static void UiDriver_DisplayAudioStages(uint32_t cycles_per_percent)
+{
+	// short names of the stages from ProfileRxFrontEnd to ProfileTxIqCorrection
+	static const char stage_names[PROFILE_HISTOGRAM_EVENTS][3] =
+	{
+			"FE", "NB", "DC", "HB", "DM", "LM", "FL", "AG", "NR", "IN",
+			"TF", "CP", "TH", "FC", "IQ"
+	};
+
+	uint32_t stage_cycles = 0;
+	int stage = 0;
+
+	for (int idx = 0; idx < PROFILE_HISTOGRAM_EVENTS; idx++)
+	{
+		const ProfiledEventNames pe = PROFILE_HISTOGRAM_FIRST + idx;
+		const uint32_t cycles = profileTimedEventHistogram(pe) != NULL ? profileTimedEventPercentile(pe, 990) : profileTimedEventGet(pe)->max;
+
+		if (cycles > stage_cycles)
+		{
+			stage_cycles = cycles;
+			stage = idx;
+		}
+		profileTimedEventReset(pe);
+	}
+
+	uint32_t missed = eventProfile.audio_deadline_missed;
+	if (missed > 9999)
+	{
+		missed = 9999;
+	}
+
+	char str[16];
+	snprintf(str,16,"D%4u %s%3u%%",(unsigned int)missed,stage_names[stage],(unsigned int)(stage_cycles / cycles_per_percent));
+	UiDriver_PrintTextDirect(ts.Layout->DEBUG_X,ts.Layout->LOADANDDEBUG_Y,str,White,Black,0);
+}
+
 void UiDriver_SpectrumChangeLayoutParameters()
 {
 	UiSpectrum_WaterfallClearData();
@@ -864,7 +918,6 @@ void UiDriver_Init()
 
 	AudioManagement_CalcTxCompLevel();      // calculate current settings for TX speech compressor
 
-	AudioFilter_InitRxHilbertFIR(ts.dmod_mode);
 	AudioFilter_InitTxHilbertFIR();
 
 	AudioManagement_SetSidetoneForDemodMode(ts.dmod_mode,false);
@@ -1079,7 +1132,7 @@ void UiDriver_EncoderDisplaySimple(const uint8_t column, const uint8_t row, cons
 	char temp[5];
 	uint32_t color = encoder_active?White:Grey;
 
-	snprintf(temp,5," %2lu",value);
+	snprintf(temp,5," %2u",(unsigned int)value);
 	UiDriver_EncoderDisplay(column, row, label, encoder_active,
 			temp, color);
 }
@@ -1098,10 +1151,10 @@ void UiDriver_DisplaySplitFreqLabels()
 		split_rx = "(B) RX->";  // Place identifying marker for RX frequency
 		split_tx = "(A) TX->";  // Place identifying marker for TX frequency
 	}
-	UiLcdHy28_PrintText(ts.Layout->TUNE_SPLIT_MARKER_X - (SMALL_FONT_WIDTH * 5),
+	UiCompositor_PrintText(ts.Layout->TUNE_SPLIT_MARKER_X - (SMALL_FONT_WIDTH * 5),
 			ts.Layout->TUNE_FREQ.y, split_rx, RX_Grey, Black,
 			0);  // Place identifying marker for RX frequency
-	UiLcdHy28_PrintText(ts.Layout->TUNE_SPLIT_MARKER_X - (SMALL_FONT_WIDTH * 5),
+	UiCompositor_PrintText(ts.Layout->TUNE_SPLIT_MARKER_X - (SMALL_FONT_WIDTH * 5),
 			ts.Layout->TUNE_SPLIT_FREQ_Y_TX, split_tx, TX_Grey, Black,
 			0);  // Place identifying marker for TX frequency
 }
@@ -1506,7 +1559,7 @@ void UiDriver_DisplayFreqStepSize()
 	// UiLcdHy28_DrawFullRect(POS_TUNE_STEP_X,POS_TUNE_STEP_Y-1,POS_TUNE_STEP_MASK_H,POS_TUNE_STEP_MASK_W,stepsize_background);
 
 	{
-		char step_name[10];
+		char step_name[16];
 
 		// I know the code below will not win the price for the most readable code
 		// ever. But it does the job of display any freq step somewhat reasonable.
@@ -1519,7 +1572,7 @@ void UiDriver_DisplayFreqStepSize()
 			line_loc = -1;
 		}
 		const char* stepUnitPrefix[] = { "","k","M","G","T"};
-		snprintf(step_name,10,"%d%sHz",(int)(df.tuning_step/exp10((pow10/3)*3)), stepUnitPrefix[pow10/3]);
+		snprintf(step_name,16,"%d%sHz",(int)(df.tuning_step/exp10((pow10/3)*3)), stepUnitPrefix[pow10/3]);
 
 		UiLcdHy28_PrintTextCentered(ts.Layout->TUNE_STEP.x,ts.Layout->TUNE_STEP.y,ts.Layout->TUNE_STEP.w,step_name,color,stepsize_background,0);
 	}
@@ -1655,7 +1708,7 @@ static void UiDriver_CreateMainFreqDisplay()
 	UiDriver_FButton_F3MemSplit();
 	if((is_splitmode()))	 	// are we in SPLIT mode?
 	{
-		UiLcdHy28_PrintText(ts.Layout->TUNE_FREQ.x-16,ts.Layout->TUNE_FREQ.y,"          ",White,Black,1);	// clear large frequency digits
+		UiCompositor_PrintText(ts.Layout->TUNE_FREQ.x-16,ts.Layout->TUNE_FREQ.y,"          ",White,Black,1);	// clear large frequency digits
 		UiDriver_DisplaySplitFreqLabels();
 	}
 	UiDriver_DisplayFreqStepSize();
@@ -1719,6 +1772,7 @@ static void UiDriver_CreateDesktop()
 
 	// Clear display
 	UiLcdHy28_LcdClear(Black);
+	UiCompositor_Reset();
 
 	// Create Band value
 	UiDriver_DisplayBand(ts.band);
@@ -2140,7 +2194,7 @@ static void UiDriver_UpdateMeter(uchar val, uchar warn, uint32_t color_norm, uin
 
 static void UiDriver_UpdateTopMeterA(uchar val)
 {
-	ulong clr;
+	uint32_t clr;
 	UiMenu_MapColors(ts.meter_colour_up,NULL,&clr);
 	UiDriver_UpdateMeter(val,SMETER_MAX_LEVEL+1,clr,METER_TOP);
 }
@@ -2152,7 +2206,7 @@ static void UiDriver_UpdateTopMeterA(uchar val)
  */
 static void UiDriver_UpdateBtmMeter(float val, uchar warn)
 {
-	ulong clr;
+	uint32_t clr;
 	UiMenu_MapColors(ts.meter_colour_down,NULL,&clr);
 	if (val < 0)
 	{
@@ -2417,7 +2471,7 @@ static void UiDriver_UpdateFreqDisplay(ulong dial_freq, uint8_t* dial_digits, ul
 				// don't show leading zeros, except for the 0th digits
 				digit[0] = noshow?' ':0x30 + (digits[idx] & 0x0F);
 				// Update segment
-				UiLcdHy28_PrintText((pos_x_loc + pos_mult[idx] * font_width), pos_y_loc, digit, color, Black, digit_size);
+				UiCompositor_PrintText((pos_x_loc + pos_mult[idx] * font_width), pos_y_loc, digit, color, Black, digit_size);
 			}
 		}
 
@@ -2425,7 +2479,7 @@ static void UiDriver_UpdateFreqDisplay(ulong dial_freq, uint8_t* dial_digits, ul
 		{
 			bool noshow = last_non_zero < idx;
 			digit[0] = noshow?' ':'.';
-			UiLcdHy28_PrintText(pos_x_loc+ (pos_mult[idx]+1) * font_width,pos_y_loc,digit,color,Black,digit_size);
+			UiCompositor_PrintText(pos_x_loc+ (pos_mult[idx]+1) * font_width,pos_y_loc,digit,color,Black,digit_size);
 		}
 
 	}
@@ -3931,7 +3985,7 @@ static void UiDriver_DisplayCmpLevel(bool encoder_active)
 	}
 	else if(ts.tx_comp_level < TX_AUDIO_COMPRESSION_MAX)	 	// 	display numbers for all but the highest value
 	{
-		snprintf(temp,5," %02d",ts.tx_comp_level);
+		snprintf(temp,5," %02u",(uint8_t)ts.tx_comp_level);
 		outs = temp;
 	}
 	else
@@ -4151,7 +4205,7 @@ static void UiDriver_DisplayRfGain(bool encoder_active)
     }
 
 	 */
-	snprintf(temp,5," %02ld",value);
+	snprintf(temp,5," %02d",(int)value);
 
 	UiDriver_EncoderDisplay(0,1,label, encoder_active, temp, color);
 
@@ -4192,7 +4246,7 @@ static void UiDriver_DisplayNoiseBlanker(bool encoder_active)
 			}
 			label = "NB";
 			value = ts.nb_setting;
-			snprintf(temp,5,"%3ld",value);
+			snprintf(temp,5,"%3d",(int)value);
 			val_txt = temp;
 		}
 
@@ -4224,7 +4278,7 @@ static void UiDriver_DisplayNoiseBlanker(bool encoder_active)
 				break;
 			}
 			value = (int32_t)(ts.agc_wdsp_tau_decay[ts.agc_wdsp_mode] / 10.0);
-			snprintf(temp,5,"%3ld",value);
+			snprintf(temp,5,"%3d",(int)value);
 			val_txt = temp;
 		}
 		UiDriver_EncoderDisplay(1,1,label, encoder_active, val_txt, color);
@@ -4543,6 +4597,8 @@ static void UiDriver_HandleTXMeters()
 static void UiDriver_CreateVoltageDisplay() {
 	// Create voltage
 	UiLcdHy28_PrintTextCentered (ts.Layout->PWR_IND.x,ts.Layout->PWR_IND.y,ts.Layout->LEFTBOXES_IND.w,   "--.- V",  COL_PWR_IND,Black,0);
+	// the measured voltage is drawn by the compositor
+	UiCompositor_InvalidateRect(ts.Layout->PWR_IND.x,ts.Layout->PWR_IND.y,ts.Layout->LEFTBOXES_IND.w,UiLcdHy28_TextHeight(0));
 }
 
 static bool UiDriver_SaveConfiguration()
@@ -4662,9 +4718,9 @@ static void UiDriver_DisplayVoltage()
 		voltage_blink = 0;
 	}
 
-	char digits[6];
-	snprintf(digits,6,"%2ld.%02ld",pwmt.voltage/100,pwmt.voltage%100);
-	UiLcdHy28_PrintText(ts.Layout->PWR_IND.x,ts.Layout->PWR_IND.y,digits,col,Black,0);
+	char digits[14];
+	snprintf(digits,14,"%2u.%02u",(unsigned int)(pwmt.voltage/100),(unsigned int)(pwmt.voltage%100));
+	UiCompositor_PrintText(ts.Layout->PWR_IND.x,ts.Layout->PWR_IND.y,digits,col,Black,0);
 }
 
 /**
@@ -4852,7 +4908,7 @@ static void UiDriver_DisplayTemperature(int temp)
 			{
 				ttemp = ((ttemp *9)/5) + 320;			// multiply by 1.8 and add 32 degrees
 			}
-			snprintf(out,10,"%3ld.%1ld",ttemp/10,(ttemp)%10);
+			snprintf(out,10,"%3d.%1d",(int)(ttemp/10),(int)(ttemp%10));
 			txt_ptr = out;
 		}
 		UiLcdHy28_PrintText(ts.Layout->TEMP_IND.x + TEMP_DATA + SMALL_FONT_WIDTH*1,(ts.Layout->TEMP_IND.y + 1),txt_ptr,Grey,Black,0);
@@ -5161,7 +5217,7 @@ static void UiDriver_KeyTestScreen()
 		UiLcdHy28_LcdClear(Blue);							// clear the screen
         UiLcdHy28_PrintTextCentered(2,05,ts.Layout->Size.x-4,"INPUT TEST SCREEN",clr_fg,clr_bg,1);
 
-		snprintf(txt_buf,40,"Keys Initial: %08lx",keyScanState);
+		snprintf(txt_buf,40,"Keys Initial: %08x",(unsigned int)keyScanState);
 		UiLcdHy28_PrintTextCentered(0,30,ts.Layout->Size.x,txt_buf,White,Blue,0);
 
 		UiLcdHy28_PrintTextCentered(0,70,ts.Layout->Size.x,"press & hold POWER button to poweroff\npress & hold BAND- button to reboot",White,Blue,0);
@@ -5184,7 +5240,7 @@ static void UiDriver_KeyTestScreen()
 	        if (newKeyScanState != keyScanState)
 	        {
 	            keyScanState = newKeyScanState;
-	            snprintf(txt_buf,40,"Keys Current: %08lx",keyScanState);
+	            snprintf(txt_buf,40,"Keys Current: %08x",(unsigned int)keyScanState);
 	            UiLcdHy28_PrintTextCentered(0,45,ts.Layout->Size.x,txt_buf,White,Blue,0);
 	        }
 
@@ -5227,7 +5283,7 @@ static void UiDriver_KeyTestScreen()
 
 			if(encoderIdx != ENC_MAX)
 			{
-				snprintf(txt_buf,40," Encoder %ld <%s>", encoderIdx+1, encoderDirection>0 ? "right":"left");		// building string for encoders
+				snprintf(txt_buf,40," Encoder %u <%s>", (unsigned int)encoderIdx+1, encoderDirection>0 ? "right":"left");		// building string for encoders
 				idxFirstPressedButton = BUTTON_NUM+encoderIdx;					// add encoders behind buttons;
 			}
 
@@ -5307,7 +5363,7 @@ static void UiDriver_KeyTestScreen()
 				UiLcdHy28_PrintTextCentered(0,120,ts.Layout->Size.x,txt,White,Blue,1);			// identify button on screen
 			}
 
-			snprintf(txt_buf,40, "# of buttons pressed: %ld  ", numOfPressedButtons);
+			snprintf(txt_buf,40, "# of buttons pressed: %u  ", (unsigned int)numOfPressedButtons);
 			UiLcdHy28_PrintTextCentered(0,160,ts.Layout->Size.x,txt_buf,White,Blue,0);			// show number of buttons pressed on screen
 
 			if(ts.tp->present)			// show translation of touchscreen if present
@@ -6557,8 +6613,8 @@ static void UiDriver_HandleTouchScreen(bool is_long_press)
 
 		if (ts.show_debug_info)					// show coordinates for coding purposes
 		{
-			char text[14];
-			snprintf(text,14,"%04d%s%04d%s",ts.tp->hr_x," : ",ts.tp->hr_y,"  ");
+			char text[18];
+			snprintf(text,18,"%04d%s%04d%s",ts.tp->hr_x," : ",ts.tp->hr_y,"  ");
 
     #ifdef TOUCH_SHOW_REGIONS_AND_POINTS
 			UiLcdHy28_DrawColorPoint(ts.tp->hr_x,ts.tp->hr_y,White);
@@ -6575,7 +6631,7 @@ static void UiDriver_HandleTouchScreen(bool is_long_press)
     #endif
 
 
-			UiLcdHy28_PrintText(0,ts.Layout->LOADANDDEBUG_Y,text,White,Black,0);
+			UiDriver_PrintTextDirect(0,ts.Layout->LOADANDDEBUG_Y,text,White,Black,0);
 		}
 
 		bool TouchProcessed=0;
@@ -6780,10 +6836,6 @@ void UiDriver_TaskHandler_HighPrioTasks()
     }
 #endif
 
-#ifdef USE_CONVOLUTION
-    	convolution_handle();
-#endif
-
 }
 
 void UiDriver_TaskHandler_MainTasks()
@@ -6912,15 +6964,17 @@ void UiDriver_TaskHandler_MainTasks()
 				//
 				// Num of cycles per audio interrupt = cycles for all counted interrupts / number of interrupts
 				// Max num of cycles between two interrupts / 100 = HCLK frequency / Interruptfrequenz -> e.g. 168000000 / 1500 / 100 = 1120
-				// FIXME: Need to figure out which clock is being used, 168000000 in mcHF, I40 UI = 168.000.000 or 216.000.000 or something else...
+				// the i2s driver knows the HCLK frequency and the block size, so we ask it
 
-				uint32_t load =  pe_ptr->duration / (pe_ptr->count * (1120));
+				const uint32_t cycles_per_percent = UhsdrHwI2s_GetBlockCycles() / 100;
+				uint32_t load = pe_ptr->count == 0 ? 0 : pe_ptr->duration / (pe_ptr->count * cycles_per_percent);
 				profileTimedEventReset(ProfileAudioInterrupt);
 				char str[20];
 				snprintf(str,20,"L%3u%%",(unsigned int)load);
 				if(ts.show_debug_info)
 				{
-					UiLcdHy28_PrintText(ts.Layout->LOAD_X,ts.Layout->LOADANDDEBUG_Y,str,White,Black,0);
+					UiDriver_PrintTextDirect(ts.Layout->LOAD_X,ts.Layout->LOADANDDEBUG_Y,str,White,Black,0);
+					UiDriver_DisplayAudioStages(cycles_per_percent);
 				}
 #endif
 			}
@@ -6935,7 +6989,7 @@ void UiDriver_TaskHandler_MainTasks()
 
 					char str[20];
 					snprintf(str,20,"%2u:%02u:%02u",sTime.Hours,sTime.Minutes,sTime.Seconds);
-					UiLcdHy28_PrintText(ts.Layout->RTC_IND.x, ts.Layout->RTC_IND.y, str, White, Black, 0);
+					UiCompositor_PrintText(ts.Layout->RTC_IND.x, ts.Layout->RTC_IND.y, str, White, Black, 0);
 				}
 			}
 			break;
@@ -6952,7 +7006,7 @@ void UiDriver_TaskHandler_MainTasks()
 				UiDriver_FrequencyUpdateLOandDisplay(false);
 				UiDriver_DisplayMemoryLabel();				// this is because a frequency dialing via CAT must be indicated if "CAT in sandbox" is active
 			}
-			else if (df.temp_factor_changed  || ts.tune_freq != ts.tune_freq_req)
+			else if (df.temp_factor_changed  || ts.tune_freq - ts.rx_nco_offset != ts.tune_freq_req)
 			{
 				// this handles the cases where the dial frequency remains the same but the
 				// LO tune frequency needs adjustment, e.g. in CW mode  or if temp of LO changes
@@ -7001,7 +7055,7 @@ void UiDriver_TaskHandler_MainTasks()
 				}
 
 //				UiLcdHy28_PrintTextCentered(ts.Layout->DEMOD_MODE_MASK.x - 41,ts.Layout->DEMOD_MODE_MASK.y,ts.Layout->DEMOD_MODE_MASK.w-6,txt,AGC_fg_clr,AGC_bg_clr,0);
-				UiLcdHy28_PrintTextCentered(ts.Layout->AGC_MASK.x,ts.Layout->AGC_MASK.y,ts.Layout->AGC_MASK.w,txt,AGC_fg_clr,AGC_bg_clr,0);
+				UiCompositor_PrintTextCentered(ts.Layout->AGC_MASK.x,ts.Layout->AGC_MASK.y,ts.Layout->AGC_MASK.w,txt,AGC_fg_clr,AGC_bg_clr,0);
 				// display CW decoder WPM speed
 				if(ts.cw_decoder_enable && ts.dmod_mode == DEMOD_CW)
 				{
@@ -7026,12 +7080,15 @@ void UiDriver_TaskHandler_MainTasks()
 			drv_state = 0;
 		}
 	}
+
+	// draw what the widgets have changed in this pass
+	UiCompositor_Flush(UI_COMPOSITOR_FRAME_BUDGET);
 }
 
 /*
  * This handler creates a software pwm for the LCD backlight. It needs to be called
- * very regular to work properly. Right now it is activated from the audio interrupt
- * at a rate of 1.5khz The rate itself is not too critical,
+ * very regular to work properly. Right now it is activated from UiDriver_TimeKeeping()
+ * at a rate of 1khz The rate itself is not too critical,
  * just needs to be high and very regular.
  */
 void UiDriver_BacklightDimHandler()
@@ -7040,7 +7097,7 @@ void UiDriver_BacklightDimHandler()
 
 	if(!ts.lcd_blanking_flag)       // is LCD *NOT* blanked?
 	{
-		if(!lcd_dim_prescale)       // Only update dimming PWM counter every fourth time through to reduce frequency below that of audible range
+		if(!lcd_dim_prescale)       // Only update dimming PWM counter every third time through to reduce frequency below that of audible range
 		{
 			UiLcdHy28_BacklightEnable(lcd_dim >= ts.lcd_backlight_brightness);   // LCD backlight off or on
 
@@ -7048,7 +7105,7 @@ void UiDriver_BacklightDimHandler()
 			lcd_dim %= 4;   // limit brightness PWM count to 0-3
 		}
 		lcd_dim_prescale++;
-		lcd_dim_prescale %= 4;  // limit prescale count to 0-3
+		lcd_dim_prescale %= 3;  // limit prescale count to 0-2
 	}
 	else if(!ts.menu_mode)
 	{ // LCD is to be blanked - if NOT in menu mode
@@ -7056,3 +7113,44 @@ void UiDriver_BacklightDimHandler()
 	}
 }
 
+/**
+ * @brief ui time keeping, called every 1ms from the SysTick interrupt
+ *
+ * ts.sysclock counts 1/100s. Key debounce and the spectrum schedulers keep counting in 1/1500s,
+ * the time base of the audio interrupt they were driven by, so they advance by 1 and 2 ticks in turn.
+ */
+void UiDriver_TimeKeeping()
+{
+	static uint8_t ms_count = 0;
+	static uint8_t odd_ms = 0;
+
+	odd_ms ^= 1;
+	const uint16_t ticks = 1 + odd_ms;  // 1.5 ticks per ms on average
+
+	if(ks.debounce_time < DEBOUNCE_TIME_MAX)
+	{
+		ks.debounce_time += ticks;   // keyboard debounce timer
+	}
+
+	// update thread timers if non-zero
+	ts.scope_scheduler = ts.scope_scheduler > ticks ? ts.scope_scheduler - ticks : 0;
+	ts.waterfall.scheduler = ts.waterfall.scheduler > ticks ? ts.waterfall.scheduler - ticks : 0;
+
+	// Perform LCD backlight PWM brightness function
+	UiDriver_BacklightDimHandler();
+
+	ms_count++;
+	if(ms_count == 10)
+	{
+		ms_count = 0;
+		ts.sysclock++;	// this clock updates at PRECISELY 100 Hz
+
+		// Has the timing for the keyboard beep expired?
+		if(ts.sysclock > ts.beep_timing)
+		{
+			ts.beep_active = 0;				// yes, turn the tone off
+			ts.beep_timing = 0;
+		}
+	}
+}
+
@@ -208,6 +208,7 @@ void UiDriver_SetSplitMode(bool mode_active);
 void UiDriver_StartupScreen_LogIfProblem(bool isError, const char* txt);
 
 void UiDriver_BacklightDimHandler();
+void UiDriver_TimeKeeping();
 
 void UiDriver_TextMsgPutChar(char ch);
 void UiDriver_TextMsgPutSign(const char *s);
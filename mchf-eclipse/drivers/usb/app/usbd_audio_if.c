@@ -45,6 +45,7 @@
 #include "usbd_audio_if.h"
 /* USER CODE BEGIN INCLUDE */
 #include "uhsdr_board.h"
+#include "ring_buffer.h"
 /* USER CODE END INCLUDE */
 
 /** @addtogroup STM32_USB_OTG_DEVICE_LIBRARY
@@ -157,72 +158,21 @@ USB_AUDIO_State_t usb_dig_audio_state = USB_DIG_AUDIO_OUT_INIT;
 #define USB_AUDIO_OUT_PKT_SIZE   (AUDIO_OUT_PACKET/2)
 #define USB_AUDIO_OUT_BUF_SIZE (USB_AUDIO_OUT_NUM_BUF * USB_AUDIO_OUT_PKT_SIZE)
 
-static volatile int16_t out_buffer[USB_AUDIO_OUT_BUF_SIZE]; //buffer for filtered PCM data from Recv.
-static volatile uint16_t out_buffer_tail;
-static volatile uint16_t out_buffer_head;
-static volatile uint16_t out_buffer_overflow;
+// filled by the USB interrupt with the received PCM data, emptied by the audio interrupt
+// the storage is rounded up to the next power of two, the ring holds USB_AUDIO_OUT_BUF_SIZE samples
+RING_BUFFER_DEFINE_CAPACITY(UsbAudioOutRing, int16_t, RING_BUFFER_POW2(USB_AUDIO_OUT_BUF_SIZE), USB_AUDIO_OUT_BUF_SIZE)
+static UsbAudioOutRing out_ring;
 static volatile uint16_t out_buffer_underflow;
 
-static void audio_out_put_buffer(int16_t sample)
-{
-
-    uint32_t next_head = (out_buffer_head + 1) %USB_AUDIO_OUT_BUF_SIZE;
-
-    if (next_head != out_buffer_head)
-    {
-        out_buffer[out_buffer_head] = sample;
-        out_buffer_head = next_head;
-    }
-    else
-    {
-        // ok. We loose data now, should never ever happen, but so what
-        // will cause minor distortion if only a few bytes.
-        out_buffer_overflow++;
-    }
-}
-
-volatile uint16_t audio_out_buffer_fill()
-{
-    uint16_t temp_head = out_buffer_head;
-    return ((((temp_head < out_buffer_tail)?USB_AUDIO_OUT_BUF_SIZE:0) + temp_head) - out_buffer_tail);
-}
-
-volatile int16_t* audio_out_buffer_next_pkt(uint32_t len)
-{
-    if (audio_out_buffer_fill() >= len)
-    {
-        return &out_buffer[out_buffer_tail];
-    }
-    else
-    {
-
-        return NULL;
-    }
-}
-static void audio_out_buffer_pop_pkt(volatile int16_t* ptr, uint32_t len)
-{
-    if (ptr)
-    {
-        // there was data and pkt has been used
-        // free  the space
-        out_buffer_tail = (out_buffer_tail+len)%USB_AUDIO_OUT_BUF_SIZE;
-    }
-}
-
 /* len is length in 16 bit samples */
 void audio_out_fill_tx_buffer(int16_t *buffer, uint32_t len)
 {
-    volatile int16_t *pkt = audio_out_buffer_next_pkt(len);
-
     static uint16_t fill_buffer = 1;
-    if (fill_buffer == 0 && pkt)
+    uint32_t fill = UsbAudioOutRing_Fill(&out_ring);
+
+    if (fill_buffer == 0 && fill >= len)
     {
-        uint32_t idx;
-        for (idx = len; idx; idx--)
-        {
-            *buffer++ = *pkt++;
-        }
-        audio_out_buffer_pop_pkt(pkt,len);
+        UsbAudioOutRing_Read(&out_ring, buffer, len);
     }
     else
     {
@@ -231,7 +181,7 @@ void audio_out_fill_tx_buffer(int16_t *buffer, uint32_t len)
             out_buffer_underflow++;
             fill_buffer = 1;
         }
-        if (audio_out_buffer_next_pkt((USB_AUDIO_OUT_BUF_SIZE*2)/3) != NULL)
+        if (fill >= (USB_AUDIO_OUT_BUF_SIZE*2)/3)
         {
             fill_buffer = 0;
         }
@@ -330,10 +280,9 @@ static int8_t AUDIO_AudioCmd_FS (uint8_t* pbuf, uint32_t size, uint8_t cmd)
             if (ts.txrx_mode == TRX_MODE_TX)
             {
                 uint16_t* pkt = (uint16_t*)pbuf;
-                uint32_t count;
                 static bool too_high = false;
 
-                fill =  audio_out_buffer_fill();
+                fill =  UsbAudioOutRing_Fill(&out_ring);
                 // USB_AUDIO_OUT_NUM_BUF * USB_AUDIO_OUT_PKT_SIZE
                 bool is_low_space = fill > (3*(USB_AUDIO_OUT_NUM_BUF/4) * USB_AUDIO_OUT_PKT_SIZE);
                 bool is_high_space = fill < (USB_AUDIO_OUT_NUM_BUF/4 * USB_AUDIO_OUT_PKT_SIZE);
@@ -354,14 +303,12 @@ static int8_t AUDIO_AudioCmd_FS (uint8_t* pbuf, uint32_t size, uint8_t cmd)
                 {
                     num_samples-=2;
                 }
-                for (count =0; count < num_samples; count++)
-                {
-                    audio_out_put_buffer(pkt[count]);
-                }
+                // if there is no room, we loose data now, should never ever happen, but so what
+                // will cause minor distortion if only a few bytes. The ring counts the lost samples.
+                UsbAudioOutRing_Write(&out_ring, (const int16_t*)pkt, num_samples);
                 if (too_high)
                 {
-                    audio_out_put_buffer(pkt[num_samples-2]);
-                    audio_out_put_buffer(pkt[num_samples-1]);
+                    UsbAudioOutRing_Write(&out_ring, (const int16_t*)&pkt[num_samples-2], 2);
                 }
 
             }
@@ -306,10 +306,7 @@ static int8_t CDC_Control_FS  (uint8_t cmd, uint8_t* pbuf, uint16_t length)
 static int8_t CDC_Receive_FS (uint8_t* Buf, uint32_t *Len)
 {
   /* USER CODE BEGIN 6 */
-    for (uint32_t i = 0; i < *Len; i++)
-    {
-        CatDriver_InterfaceBufferAddData(Buf[i]);
-    }
+    CatDriver_InterfaceBufferAddData(Buf, *Len);
 
   USBD_CDC_SetRxBuffer(&hUsbDeviceFS, &Buf[0]);
   USBD_CDC_ReceivePacket(&hUsbDeviceFS);
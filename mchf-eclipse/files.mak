@@ -27,6 +27,7 @@ drivers/ui/menu/ui_menu_structure.c \
 drivers/ui/lcd/ui_lcd_hy28.c \
 drivers/ui/lcd/ui_lcd_hy28_fonts.c \
 drivers/ui/lcd/ui_spectrum.c \
+drivers/ui/lcd/ui_compositor.c \
 drivers/ui/encoder/ui_rotary.c \
 drivers/ui/radio_management.c \
 drivers/ui/ui_configuration.c \
@@ -123,7 +124,8 @@ drivers/audio/filters/iir_8k.c \
 drivers/audio/filters/iir_8k5_hpf_fm_squelch.c \
 drivers/audio/filters/iir_9_5k.c \
 drivers/audio/filters/iir_9k.c \
-drivers/audio/filters/iir_antialias.c \
+drivers/audio/filters/iir_rx_biquad.c \
+drivers/audio/filters/iir_rx_design.c \
 drivers/audio/filters/iq_rx_filter.c \
 drivers/audio/filters/iq_rx_filter_am.c \
 drivers/audio/filters/iq_tx_filter.c \
@@ -133,8 +135,10 @@ drivers/audio/codec/codec.c \
 drivers/audio/codec/uhsdr_hw_i2s.c \
 drivers/audio/audio_driver.c \
 drivers/audio/audio_filter.c \
+drivers/audio/audio_iir_design.c \
 drivers/audio/audio_convolution.c \
 drivers/audio/audio_nr.c \
+drivers/audio/audio_fblms.c \
 drivers/audio/audio_management.c \
 drivers/audio/freedv_uhsdr.c \
 drivers/audio/freedv_test_data.c \
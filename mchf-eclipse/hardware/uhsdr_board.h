@@ -33,9 +33,12 @@
 
 
 
-// Fast convolution filtering
-// experimental at the moment DD4WH, 2018_08_18
-//#define USE_CONVOLUTION
+// Fast convolution filtering: the RX bandpass of SSB, CW and digital modes as a linear phase
+// partitioned convolution filter instead of Hilbert transform and audio IIR filter,
+// selectable in the filter menu, see drivers/audio/audio_convolution.c
+// needs about 11k RAM, its flash and RAM use in the F4/F7/H7 builds is not checked yet, so it is off by default
+// the host build (support/host) always has it
+// #define USE_CONVOLUTION
 
 // old LMS noise reduction
 // will probably never used any more
@@ -45,6 +48,11 @@
 // leave this switched on, until we have a new autonotch filter approach
 #define USE_LMS_AUTONOTCH
 
+// runs the RX audio IIR filters (audio bandpass) as cascaded biquads
+// instead of lattice filters, same responses but less processor time per sample
+// the biquads are generated from the lattice filters, see drivers/audio/filters/iir_rx_biquad.c
+#define USE_RX_IIR_BIQUAD
+
 // save processor time for the STM32F4
 // changes lowpass decimation filters to 89 taps instead of 199 taps
 // because they run at 48ksps, this is a considerable decrease in processing power
@@ -81,6 +89,8 @@
 #ifndef IS_SMALL_BUILD
   #define USE_8bit_FONT
   #define USE_PREDEFINED_WINDOW_DATA
+  // keeps the rendered characters of the large fonts (frequency digits), about 9k RAM
+  #define USE_GLYPH_CACHE
 #endif
 
 // OPTION
@@ -100,6 +110,14 @@
     #define USE_FREEDV
 #endif
 // #define DEBUG_FREEDV
+
+// OPTION
+// designs the RX audio IIR filters at runtime from a small table of specifications instead of
+// linking about 12k of coefficient tables, see drivers/audio/audio_iir_design.c
+// requires USE_RX_IIR_BIQUAD
+#if defined(IS_SMALL_BUILD) && !defined(USE_RX_IIR_DESIGNER)
+    #define USE_RX_IIR_DESIGNER
+#endif
 // hardware specific switches
 
 
@@ -129,7 +147,10 @@
 // In general this should be defined but in case of issues one may want to execute High Prio tasks not concurrently
 // to normal tasks, comment this in this case and see if the issue goes away. But this may cause other problems
 // of course.
+// The host build of the audio chain (see support/host) has no NVIC, hence no PendSV.
+#ifndef UHSDR_HOST_BUILD
 #define USE_PENDSV_FOR_HIGHPRIO_TASKS
+#endif
 
 #include "uhsdr_mcu.h"
 // HW libs
@@ -195,7 +216,7 @@ struct mchf_waterfall
     uint8_t	color_scheme;			// stores waterfall color scheme
     uint8_t	vert_step_size;		// vertical step size in waterfall mode
     // int32_t	offset;			// offset for waterfall display
-    ulong	contrast;			// contrast setting for waterfall display
+    uint32_t	contrast;			// contrast setting for waterfall display
 	uint8_t	speed;	// speed of update of the waterfall
 	// uint8_t	nosig_adjust;			// Adjustment for no signal adjustment conditions for waterfall
 	uint16_t scheduler;
@@ -635,6 +656,7 @@ typedef struct TransceiverState
     // Frequency synthesizer
     ulong	tune_freq;			// main synthesizer frequency
     ulong	tune_freq_req;		// used to detect change of main synthesizer frequency
+    int32_t	rx_nco_offset;		// in Hz, tune_freq minus tune_freq_req, compensated by the RX DSP NCO instead of retuning the synthesizer
 
     // Transceiver calibration mode flag
     //uchar	calib_mode;
@@ -753,7 +775,7 @@ typedef struct TransceiverState
     uint8_t spectrum_db_scale;  // db/Division scale setting on spectrum scope
     //  uint8_t   fft_window_type;            // type of windowing function applied to scope/waterfall.  At the moment, only lower 4 bits are used - upper 4 bits are reserved
 
-    uint16_t scope_scheduler;        // timer for scheduling the next update of the spectrum scope update, updated at DMA rate
+    uint16_t scope_scheduler;        // timer for scheduling the next update of the spectrum scope update, counts 1/1500s
     uint8_t scope_speed;    // update rate for spectrum scope
     uint8_t	scope_trace_colour;	// color of spectrum scope trace;
     uint8_t	scope_grid_colour;	// saved color of spectrum scope grid;
@@ -767,7 +789,7 @@ typedef struct TransceiverState
     bool	radio_config_menu_enable;	// TRUE if radio configuration menu is to be visible
     //
     uint8_t	xverter_mode;		// TRUE if transverter mode active
-    ulong	xverter_offset;		// frequency offset for transverter (added to frequency display)
+    uint32_t	xverter_offset;		// frequency offset for transverter (added to frequency display)
 
     bool	refresh_freq_disp;		// TRUE if frequency display display is to be refreshed
     //
@@ -778,9 +800,9 @@ typedef struct TransceiverState
     uint8_t	pwr_adj[2][MAX_BAND_NUM];
     //
     ulong	alc_decay;					// adjustable ALC release time - EEPROM read/write version
-    ulong	alc_decay_var;				// adjustable ALC release time - working variable version
+    uint32_t	alc_decay_var;				// adjustable ALC release time - working variable version
     ulong	alc_tx_postfilt_gain;		// amount of gain after the TX audio filtering - EEPROM read/write version
-    ulong	alc_tx_postfilt_gain_var;	// amount of gain after the TX audio filtering - working variable version
+    uint32_t	alc_tx_postfilt_gain_var;	// amount of gain after the TX audio filtering - working variable version
 
 // we can use AT least the upper 8 bits of freq_step_config for other purpose since these have not been used and are all initialized with 0)
 #define FREQ_STEP_SWAP_BTN	    0x10
@@ -806,6 +828,7 @@ typedef struct TransceiverState
     uint8_t	dsp_notch_numtaps;
     uint8_t	dsp_notch_mu;				// mu adjust of notch DSP LMS
     uint8_t	dsp_notch_delaybuf_len;		// size of DSP notch delay buffer
+    uint8_t	dsp_notch_delay;			// decorrelation delay of the automatic notch reference in samples
     uint8_t dsp_inhibit;				// if != 0, DSP (NR, Notch) functions are inhibited.  Used during power-up and switching
 
 
@@ -883,6 +906,8 @@ typedef struct TransceiverState
 #define FLAGS2_TOUCHSCREEN_FLIP_XY	 	0x20    // 1 if touchscreen x and y are flipped
 #define FLAGS2_HIGH_BAND_BIAS_REDUCE    0x40    // 1 if bias values for higher bands  above 8Mhz have lower influence factor
 #define FLAGS2_UI_INVERSE_SCROLLING		0x80    // 1 if inverted Enc2/Enc3 UI actions, clockwise goes previous UiMenu_RenderChangeItem, folds up menu groups
+#define FLAGS2_RX_CONV_FILTER           0x100   // 1 if the convolution filter is the RX bandpass of SSB, CW and digital modes (USE_CONVOLUTION)
+#define FLAGS2_WFALL_WIPE               0x200   // 1 if new waterfall lines overwrite the oldest lines instead of scrolling the waterfall
 #define FLAGS2_CONFIG_DEFAULT (FLAGS2_HIGH_BAND_BIAS_REDUCE|FLAGS2_LOW_BAND_BIAS_REDUCE)
 
     uint32_t	sysclock;				// This counts up from zero when the unit is powered up at precisely 100 Hz over the long term.  This
@@ -909,7 +934,7 @@ typedef struct TransceiverState
     ulong	vfo_mem_mode;				// this is used to record the VFO/memory mode (0 = VFO "A" = backwards compatibility)
     // LSB+6 (0x40):  0 = VFO A, 1 = VFO B
     // LSB+7 (0x80): 0 = normal mode, 1 = Split mode (e.g. LSB=0:  RX=A, TX=B;  LSB=1:  RX=B, TX=A)
-    ulong	voltmeter_calibrate;			// used to calibrate the voltmeter
+    uint32_t	voltmeter_calibrate;			// used to calibrate the voltmeter
 
 
     bool	dvmode;					// TRUE if alternate (stripped-down) RX and TX functions (USB-only) are to be used
@@ -921,14 +946,14 @@ typedef struct TransceiverState
     bool	vfo_mem_flag;				// when TRUE, memory mode is enabled
     bool	mem_disp;				// when TRUE, memory display is enabled
     bool	load_eeprom_defaults;			// when TRUE, load EEPROM defaults into RAM when "UiDriverLoadEepromValues()" is called - MUST be saved by user IF these are to take effect!
-    ulong	fm_subaudible_tone_gen_select;		// lookup ("tone number") used to index the table tone generation (0 corresponds to "tone disabled")
+    uint32_t	fm_subaudible_tone_gen_select;		// lookup ("tone number") used to index the table tone generation (0 corresponds to "tone disabled")
     uint8_t	fm_tone_burst_mode;			// this is the setting for the tone burst generator
     ulong	fm_tone_burst_timing;			// this is used to time/schedule the duration of a tone burst
     uint8_t	fm_sql_threshold;			// squelch threshold "dial" setting
 //	uchar	fm_rx_bandwidth;			// bandwidth setting for FM reception
-    ulong	fm_subaudible_tone_det_select;		// lookup ("tone number") used to index the table for tone detection (0 corresponds to "disabled")
+    uint32_t	fm_subaudible_tone_det_select;		// lookup ("tone number") used to index the table for tone detection (0 corresponds to "disabled")
     bool	beep_active;				// TRUE if beep is active
-    ulong	beep_frequency;				// beep frequency, in Hz
+    uint32_t	beep_frequency;				// beep frequency, in Hz
     ulong	beep_timing;				// used to time/schedule the duration of a keyboard beep
     uint8_t	beep_loudness;				// loudness of the keyboard/CW sidetone test beep
     bool	load_freq_mode_defaults;		// when TRUE, load frequency/mode defaults into RAM when "UiDriverLoadEepromValues()" is called - MUST be saved by user IF these are to take effect!
@@ -1067,9 +1092,7 @@ typedef struct TransceiverState
 //	bool nr_long_tone_reset; // used to reset gains of the long tone detection to 1.0
 //	int16_t nr_vad_delay; // how many frames to delay the noise estimate after VAD has detected NOISE
 //	int16_t nr_mode;
-	bool nr_fft_256_enable; // debugging: enable FFT256 instead of FFT128 for spectral NR
-	uint16_t NR_FFT_L; // resulting FFT length: 128 or 256
-	uint8_t NR_FFT_LOOP_NO;
+	uint16_t NR_FFT_L; // frame length of the spectral NR: 128, 256 or 512
 	bool NR_decimation_enable; // set to true, if we want to use another decimation step for the spectral NR leading to 6ksps sample rate
 	uint8_t debug_si5351a_pllreset;
 	uint16_t graticulePowerupYpos;	//initial (after powerup) position of graticule (frequency bar)
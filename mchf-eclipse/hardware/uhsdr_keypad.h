@@ -73,9 +73,9 @@ enum
 extern UhsdrHwKey_t  hwKeys; // these buttons represent the gpio to logical button id mapping
 extern const UhsdrButtonLogical_t  buttons[]; // this array gives us the names of the available logical buttons
 
-const Keypad_KeyPhys_t* bm_set_normal;
+extern const Keypad_KeyPhys_t* bm_set_normal;
 #ifdef UI_BRD_MCHF
-const Keypad_KeyPhys_t* bm_set_rtc;
+extern const Keypad_KeyPhys_t* bm_set_rtc;
 #endif
 
 bool Keypad_IsButtonPressed(uint32_t button_num);
@@ -63,7 +63,11 @@ inline mchf_cpu_t MchfHW_Cpu()
 
 #endif
 
-#if defined(STM32H7)
+#if defined(UHSDR_HOST_BUILD)
+    // no gpios on a workstation, see support/host
+    #define GPIO_SetBits(PORT,PINS) { }
+    #define GPIO_ResetBits(PORT,PINS) { }
+#elif defined(STM32H7)
     #define GPIO_SetBits(PORT,PINS) { (PORT)->BSRRL = (PINS); }
     #define GPIO_ResetBits(PORT,PINS) { (PORT)->BSRRH = (PINS); }
 #elif defined(STM32F7) || defined(STM32F4)
@@ -71,7 +75,16 @@ inline mchf_cpu_t MchfHW_Cpu()
     #define GPIO_ResetBits(PORT,PINS) { (PORT)->BSRR = (PINS) << 16U; }
 #endif
 
+#if defined(UHSDR_HOST_BUILD)
+#define GPIO_ToggleBits(PORT,PINS) { }
+// the CMSIS version is ARM assembly, on a workstation a full compiler/cpu barrier does the job
+#define __DMB() __sync_synchronize()
+#define __DSB() __sync_synchronize()
+// byte swap of both halfwords, used for the pixel data of the display
+#define __REV16(value) ((((uint32_t)(value) & 0xff00ff00) >> 8) | (((uint32_t)(value) & 0x00ff00ff) << 8))
+#else
 #define GPIO_ToggleBits(PORT,PINS) { (PORT)->ODR ^= (PINS); }
+#endif
 #define GPIO_ReadInputDataBit(PORT,PINS) { ((PORT)->IDR = (PINS); }
 
 #endif
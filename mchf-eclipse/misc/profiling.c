@@ -23,6 +23,20 @@
  */
 EventProfile_t eventProfile;
 
+// external definitions of the inline functions, used wherever the compiler decides not to inline them
+extern inline void profileEvent(const ProfiledEventNames pe);
+extern inline void profileCycleCount_reset();
+extern inline void profileCycleCount_start();
+extern inline void profileCycleCount_stop();
+extern inline uint32_t profileCycleCount_get();
+extern inline void profileTimedEventInit();
+extern inline void profileTimedEventStart(const ProfiledEventNames pe);
+extern inline uint16_t* profileTimedEventHistogram(const ProfiledEventNames pe);
+extern inline uint32_t profileHistogramBucket(const uint32_t cycles);
+extern inline void profileTimedEventStop(const ProfiledEventNames pe);
+extern inline void profileTimedEventReset(const ProfiledEventNames pe);
+extern inline ProfilingTimedEvent* profileTimedEventGet(const ProfiledEventNames pe);
+
 #if 0
 // the code below is only used to ease profiling with eclipse
 // you just need hover over a variable to get the value
@@ -52,18 +66,74 @@ void dummy() {
 }
 #endif
 
+/**
+ * @brief estimates a percentile of the duration of an event from its histogram
+ * @param permille requested percentile in 1/1000, e.g. 990 for the 99th percentile
+ * @returns upper bound in cycles of the histogram bucket containing the percentile, 0 if no event was recorded
+ *          or the event has no histogram (see profileTimedEventHistogram())
+ */
+uint32_t profileTimedEventPercentile(const ProfiledEventNames pe, const uint16_t permille)
+{
+    uint32_t retval = 0;
+    ProfilingTimedEvent* ev_ptr = profileTimedEventGet(pe);
+    const uint16_t* histogram = profileTimedEventHistogram(pe);
+
+    if (ev_ptr != NULL && histogram != NULL)
+    {
+        uint32_t total = 0;
+        for (int idx = 0; idx < PROFILE_HISTOGRAM_BUCKETS; idx++)
+        {
+            total += histogram[idx];
+        }
+
+        if (total != 0)
+        {
+            const uint32_t limit = (total * permille + 999) / 1000;
+            uint32_t sum = 0;
+            int idx;
+            for (idx = 0; idx < PROFILE_HISTOGRAM_BUCKETS - 1; idx++)
+            {
+                sum += histogram[idx];
+                if (sum >= limit)
+                {
+                    break;
+                }
+            }
+
+            if (idx == PROFILE_HISTOGRAM_BUCKETS - 1)
+            {
+                // the last bucket is open ended
+                retval = ev_ptr->max;
+            }
+            else
+            {
+                // the bucket covers [ (4 + step) * 2^(octave-2) , (5 + step) * 2^(octave-2) )
+                const uint32_t octave = PROFILE_HISTOGRAM_MIN_OCTAVE + idx / PROFILE_HISTOGRAM_STEPS;
+                const uint32_t step = idx % PROFILE_HISTOGRAM_STEPS;
+                retval = (PROFILE_HISTOGRAM_STEPS + step + 1) << (octave - 2);
+                if (retval > ev_ptr->max)
+                {
+                    retval = ev_ptr->max;
+                }
+            }
+        }
+    }
+    return retval;
+}
 
 void profileEventsTracePrint()
 {
 #ifdef XPROFILE_EVENTS
 
-            for (int i = 0;i < 10;i++)
+            for (int i = 0;i < EventProfileMax;i++)
             {
                 ProfilingTimedEvent* ev_ptr = profileTimedEventGet(i);
                 if (ev_ptr->count != 0)
                 {
-                    trace_printf("%d: %d uS per run\n",i, (ev_ptr->duration/(ev_ptr->count*168)));
+                    trace_printf("%d: %d uS per run (min %d, max %d, p99 %d cycles)\n",i, (ev_ptr->duration/(ev_ptr->count*168)),
+                            ev_ptr->min, ev_ptr->max, profileTimedEventPercentile(i, 990));
                 }
             }
+            trace_printf("audio deadlines missed: %d\n", eventProfile.audio_deadline_missed);
 #endif
 }
@@ -15,6 +15,9 @@
 #ifndef __PROFILING_H
 #define __PROFILING_H
 
+#include <stdint.h>
+#include <string.h>
+
 typedef enum {
     ProfileAudioInterrupt = 0,
     ProfileTP1,
@@ -28,24 +31,65 @@ typedef enum {
     ProfileTP9,
     ProfileFreeDV,
     FreeDVTXUnderrun,
+    // stages of the audio interrupt, RX
+    ProfileRxFrontEnd, // IQ split, IQ correction, spectrum capture and frequency conversion
+    ProfileRxNoiseBlanker,
+    ProfileRxDecimation,
+    ProfileRxHilbert,
+    ProfileRxDemod,
+    ProfileRxLms, // LMS notch and LMS noise reduction
+    ProfileRxFilter,
+    ProfileRxAgc,
+    ProfileRxNoiseReduction,
+    ProfileRxInterpolation,
+    // stages of the audio interrupt, TX
+    ProfileTxFilter,
+    ProfileTxCompressor,
+    ProfileTxHilbert,
+    ProfileTxFreqConversion,
+    ProfileTxIqCorrection,
+    // spectral noise reduction, runs outside of the audio interrupt
+    ProfileRxSpectralNr,
     EventProfileMax
 } ProfiledEventNames;
 
+// the duration histogram has 4 buckets per octave (i.e. a resolution of ~19%)
+// starting with 2^7 cycles, all shorter events go into the first bucket,
+// everything at or above 2^19 cycles goes into the last bucket
+#define PROFILE_HISTOGRAM_MIN_OCTAVE    7
+#define PROFILE_HISTOGRAM_STEPS         4
+#define PROFILE_HISTOGRAM_BUCKETS       (12 * PROFILE_HISTOGRAM_STEPS)
+
+// only the stages of the audio interrupt have a histogram, 96 bytes each
+#define PROFILE_HISTOGRAM_FIRST         ProfileRxFrontEnd
+#define PROFILE_HISTOGRAM_EVENTS        (ProfileTxIqCorrection - PROFILE_HISTOGRAM_FIRST + 1)
+
 typedef struct {
     uint32_t count;
     uint32_t start;
     uint32_t stop;
     uint64_t duration; // to get average divide duration by count
+    uint32_t min;
+    uint32_t max;
 } ProfilingTimedEvent;
 
+#define PROFILE_EVENTS
+
+// the histograms of the audio stages need ~1.4k RAM, we don't have that in the small build
+#ifndef IS_SMALL_BUILD
+#define PROFILE_HISTOGRAMS
+#endif
+
 typedef struct {
     ProfilingTimedEvent event[EventProfileMax];
+    uint32_t audio_deadline_missed; // number of audio blocks not processed before the DMA needed them
+#ifdef PROFILE_HISTOGRAMS
+    uint16_t histogram[PROFILE_HISTOGRAM_EVENTS][PROFILE_HISTOGRAM_BUCKETS]; // all buckets of an event get halved if one bucket is about to overflow
+#endif
 } EventProfile_t;
 
 extern EventProfile_t eventProfile;
 
-#define PROFILE_EVENTS
-
 inline void profileEvent(const ProfiledEventNames pe) {
 #ifdef PROFILE_EVENTS
     if (pe<EventProfileMax && pe >= 0) {
@@ -76,6 +120,7 @@ inline void profileEvent(const ProfiledEventNames pe) {
  */
 
 void profileEventsTracePrint();
+uint32_t profileTimedEventPercentile(const ProfiledEventNames pe, const uint16_t permille);
 
 
 inline void profileTimedEventInit();
@@ -83,10 +128,33 @@ inline void profileTimedEventStart(const ProfiledEventNames pe);
 inline void profileTimedEventStop(const ProfiledEventNames pe);
 inline void profileTimedEventReset(const ProfiledEventNames pe);
 inline  ProfilingTimedEvent* profileTimedEventGet(const ProfiledEventNames pe);
+inline uint16_t* profileTimedEventHistogram(const ProfiledEventNames pe);
 
 
 // INLINE IMPLEMENTATIONS
 
+#ifdef UHSDR_HOST_BUILD
+// on a workstation there is no DWT cycle counter, the host build
+// provides a free running counter with 1 tick == 1ns instead (see support/host)
+uint32_t HostProfile_GetCycleCount();
+
+inline void profileCycleCount_reset()
+{
+}
+
+inline void profileCycleCount_start()
+{
+}
+
+inline void profileCycleCount_stop()
+{
+}
+
+inline uint32_t profileCycleCount_get()
+{
+    return HostProfile_GetCycleCount();
+}
+#else
 #define DWT_CYCCNT    ((volatile uint32_t *)0xE0001004)
 #define DWT_CONTROL   ((volatile uint32_t *)0xE0001000)
 #define SCB_DEMCR     ((volatile uint32_t *)0xE000EDFC)
@@ -115,9 +183,16 @@ inline uint32_t profileCycleCount_get()
 {
     return *DWT_CYCCNT;
 }
+#endif
 
 inline void profileTimedEventInit()
 {
+    for (int pe = 0; pe < EventProfileMax; pe++)
+    {
+        profileTimedEventReset(pe);
+    }
+    eventProfile.audio_deadline_missed = 0;
+
     profileCycleCount_reset();
     profileCycleCount_start();
 }
@@ -131,15 +206,73 @@ inline void profileTimedEventStart(const ProfiledEventNames pe)
 #endif
 
 }
+/**
+ * @returns the duration histogram of the event, NULL if the event has none
+ */
+inline uint16_t* profileTimedEventHistogram(const ProfiledEventNames pe)
+{
+    uint16_t* retval = NULL;
+#if defined(PROFILE_EVENTS) && defined(PROFILE_HISTOGRAMS)
+    if (pe >= PROFILE_HISTOGRAM_FIRST && pe < PROFILE_HISTOGRAM_FIRST + PROFILE_HISTOGRAM_EVENTS)
+    {
+        retval = eventProfile.histogram[pe - PROFILE_HISTOGRAM_FIRST];
+    }
+#endif
+    return retval;
+}
+
+inline uint32_t profileHistogramBucket(const uint32_t cycles)
+{
+    uint32_t bucket = 0;
+    if (cycles >= (1 << PROFILE_HISTOGRAM_MIN_OCTAVE))
+    {
+        const uint32_t octave = 31 - __builtin_clz(cycles); // a single CLZ instruction on the Cortex M
+        // the two bits below the leading one select the step within the octave
+        bucket = (octave - PROFILE_HISTOGRAM_MIN_OCTAVE) * PROFILE_HISTOGRAM_STEPS + ((cycles >> (octave - 2)) & 0x03);
+        if (bucket >= PROFILE_HISTOGRAM_BUCKETS)
+        {
+            bucket = PROFILE_HISTOGRAM_BUCKETS - 1;
+        }
+    }
+    return bucket;
+}
+
 inline void profileTimedEventStop(const ProfiledEventNames pe)
 {
 
 #ifdef PROFILE_EVENTS
     uint32_t stop = profileCycleCount_get();
     if (pe<EventProfileMax && pe >= 0) {
-        eventProfile.event[pe].stop = stop;
-        eventProfile.event[pe].count++;
-        eventProfile.event[pe].duration += (eventProfile.event[pe].stop-eventProfile.event[pe].start);
+        ProfilingTimedEvent* ev = &eventProfile.event[pe];
+        const uint32_t cycles = stop - ev->start;
+
+        ev->stop = stop;
+        ev->count++;
+        ev->duration += cycles;
+
+        if (cycles < ev->min)
+        {
+            ev->min = cycles;
+        }
+        if (cycles > ev->max)
+        {
+            ev->max = cycles;
+        }
+
+        uint16_t* histogram = profileTimedEventHistogram(pe);
+        if (histogram != NULL)
+        {
+            uint16_t* bucket = &histogram[profileHistogramBucket(cycles)];
+            if (*bucket == UINT16_MAX)
+            {
+                // keep the shape of the distribution but make room for new events
+                for (int idx = 0; idx < PROFILE_HISTOGRAM_BUCKETS; idx++)
+                {
+                    histogram[idx] /= 2;
+                }
+            }
+            (*bucket)++;
+        }
     }
 #endif
 
@@ -152,6 +285,13 @@ inline void profileTimedEventReset(const ProfiledEventNames pe)
         eventProfile.event[pe].stop = 0;
         eventProfile.event[pe].count = 0;
         eventProfile.event[pe].duration = 0;
+        eventProfile.event[pe].min = UINT32_MAX;
+        eventProfile.event[pe].max = 0;
+        uint16_t* histogram = profileTimedEventHistogram(pe);
+        if (histogram != NULL)
+        {
+            memset(histogram, 0, PROFILE_HISTOGRAM_BUCKETS * sizeof(histogram[0]));
+        }
     }
 #endif
 }
@@ -0,0 +1,183 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     ring_buffer.h                                                   **
+ **  Description:   Lock free single producer single consumer ring buffers          **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#ifndef MISC_RING_BUFFER_H_
+#define MISC_RING_BUFFER_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "uhsdr_types.h"
+
+/*
+ * A ring has exactly one producer and one consumer, e.g. an interrupt and the main loop,
+ * so no locking is needed. Only the producer writes head, only the consumer writes tail.
+ *
+ * RING_BUFFER_DEFINE(name, type, size) defines the ring type name holding size elements of type
+ * and its functions name_Put(), name_Get() etc. size has to be a power of two, all size elements
+ * can be used.
+ * RING_BUFFER_BLOCK_DEFINE(name, type, num) defines a ring of pointers to num buffers of type which
+ * are handed over between producer and consumer. It holds at most num pointers, so the producer can
+ * cycle through its num buffers without ever overwriting one the consumer has not given back.
+ *
+ * head and tail count the elements written and read so far and wrap around at 2^32, the fill level
+ * is head - tail and the position in the ring is the count masked with size - 1.
+ * The element is written before head is published (release) and read after head has been seen (acquire),
+ * the same for tail in the other direction, so a slot is never reused before the consumer is done with it.
+ * On the Cortex-M these are dmb instructions, on the host build the matching fences of the CPU.
+ *
+ * Producer:  _Put, _Write, _Room
+ * Consumer:  _Get, _Peek, _Read, _Reset
+ * Both:      _Fill
+ * _Init must only be called while neither side uses the ring.
+ */
+
+typedef struct
+{
+    uint32_t head;          // elements written so far, written by the producer only
+    uint32_t tail;          // elements read so far, written by the consumer only
+    uint32_t fill_max;      // highest fill level after a write, producer
+    uint32_t overruns;      // elements the producer could not write into the full ring
+    uint32_t underruns;     // elements a _Read asked for but were not in the ring, _Get until empty is no underrun
+} RingBuffer_Index;
+
+#define RING_BUFFER_OWN(idx)            __atomic_load_n(&(idx), __ATOMIC_RELAXED)
+#define RING_BUFFER_ACQUIRE(idx)        __atomic_load_n(&(idx), __ATOMIC_ACQUIRE)
+#define RING_BUFFER_RELEASE(idx, val)   __atomic_store_n(&(idx), (val), __ATOMIC_RELEASE)
+
+// smallest power of two >= n for n <= 256
+#define RING_BUFFER_POW2_256(n) ((n) <= 1 ? 1 : (n) <= 2 ? 2 : (n) <= 4 ? 4 : (n) <= 8 ? 8 : (n) <= 16 ? 16 : \
+        (n) <= 32 ? 32 : (n) <= 64 ? 64 : (n) <= 128 ? 128 : 256)
+// smallest power of two >= n for n <= 65536, 0 (which fails the size check) above
+#define RING_BUFFER_POW2(n) ((n) <= 256 ? RING_BUFFER_POW2_256(n) : \
+        (n) <= 65536 ? 256 * RING_BUFFER_POW2_256(((n) + 255) / 256) : 0)
+
+// storage of size elements, power of two, at most capacity elements are in the ring
+#define RING_BUFFER_DEFINE_CAPACITY(name, type, size, capacity) \
+_Static_assert((size) > 0 && ((size) & ((size) - 1)) == 0, "size of " #name " is not a power of two"); \
+_Static_assert((capacity) > 0 && (capacity) <= (size), "capacity of " #name " does not fit"); \
+typedef struct \
+{ \
+    RingBuffer_Index idx; \
+    type data[size]; \
+} name; \
+\
+/* empties the ring and clears the statistics */ \
+static inline void name##_Init(name* r) \
+{ \
+    memset(&r->idx, 0, sizeof(r->idx)); \
+} \
+\
+/* number of elements in the ring */ \
+static inline uint32_t name##_Fill(name* r) \
+{ \
+    return RING_BUFFER_ACQUIRE(r->idx.head) - RING_BUFFER_ACQUIRE(r->idx.tail); \
+} \
+\
+/* number of elements which can be written */ \
+static inline uint32_t name##_Room(name* r) \
+{ \
+    return (capacity) - (RING_BUFFER_OWN(r->idx.head) - RING_BUFFER_ACQUIRE(r->idx.tail)); \
+} \
+\
+/* adds an element, false if the ring is full */ \
+static inline bool name##_Put(name* r, type elem) \
+{ \
+    const uint32_t head = RING_BUFFER_OWN(r->idx.head); \
+    const uint32_t fill = head - RING_BUFFER_ACQUIRE(r->idx.tail); \
+    bool retval = fill < (capacity); \
+    if (retval) \
+    { \
+        r->data[head & ((size) - 1)] = elem; \
+        RING_BUFFER_RELEASE(r->idx.head, head + 1); \
+        if (fill + 1 > r->idx.fill_max) \
+        { \
+            r->idx.fill_max = fill + 1; \
+        } \
+    } \
+    else \
+    { \
+        r->idx.overruns++; \
+    } \
+    return retval; \
+} \
+\
+/* adds up to len elements, returns the number of elements written */ \
+static inline uint32_t name##_Write(name* r, const type* src, uint32_t len) \
+{ \
+    const uint32_t head = RING_BUFFER_OWN(r->idx.head); \
+    const uint32_t fill = head - RING_BUFFER_ACQUIRE(r->idx.tail); \
+    const uint32_t count = len < (capacity) - fill ? len : (capacity) - fill; \
+    const uint32_t pos = head & ((size) - 1); \
+    const uint32_t first = count < (size) - pos ? count : (size) - pos; \
+    memcpy(&r->data[pos], src, first * sizeof(type)); \
+    memcpy(&r->data[0], &src[first], (count - first) * sizeof(type)); \
+    RING_BUFFER_RELEASE(r->idx.head, head + count); \
+    if (fill + count > r->idx.fill_max) \
+    { \
+        r->idx.fill_max = fill + count; \
+    } \
+    r->idx.overruns += len - count; \
+    return count; \
+} \
+\
+/* returns the oldest element without removing it, false if the ring is empty */ \
+static inline bool name##_Peek(name* r, type* elem) \
+{ \
+    const uint32_t tail = RING_BUFFER_OWN(r->idx.tail); \
+    bool retval = RING_BUFFER_ACQUIRE(r->idx.head) != tail; \
+    if (retval) \
+    { \
+        *elem = r->data[tail & ((size) - 1)]; \
+    } \
+    return retval; \
+} \
+\
+/* removes the oldest element, false if the ring is empty */ \
+static inline bool name##_Get(name* r, type* elem) \
+{ \
+    const uint32_t tail = RING_BUFFER_OWN(r->idx.tail); \
+    bool retval = RING_BUFFER_ACQUIRE(r->idx.head) != tail; \
+    if (retval) \
+    { \
+        *elem = r->data[tail & ((size) - 1)]; \
+        RING_BUFFER_RELEASE(r->idx.tail, tail + 1); \
+    } \
+    return retval; \
+} \
+\
+/* removes up to len elements, returns the number of elements read */ \
+static inline uint32_t name##_Read(name* r, type* dst, uint32_t len) \
+{ \
+    const uint32_t tail = RING_BUFFER_OWN(r->idx.tail); \
+    const uint32_t fill = RING_BUFFER_ACQUIRE(r->idx.head) - tail; \
+    const uint32_t count = len < fill ? len : fill; \
+    const uint32_t pos = tail & ((size) - 1); \
+    const uint32_t first = count < (size) - pos ? count : (size) - pos; \
+    memcpy(dst, &r->data[pos], first * sizeof(type)); \
+    memcpy(&dst[first], &r->data[0], (count - first) * sizeof(type)); \
+    RING_BUFFER_RELEASE(r->idx.tail, tail + count); \
+    r->idx.underruns += len - count; \
+    return count; \
+} \
+\
+/* drops all elements in the ring */ \
+static inline void name##_Reset(name* r) \
+{ \
+    RING_BUFFER_RELEASE(r->idx.tail, RING_BUFFER_ACQUIRE(r->idx.head)); \
+}
+
+#define RING_BUFFER_DEFINE(name, type, size) RING_BUFFER_DEFINE_CAPACITY(name, type, size, size)
+
+#define RING_BUFFER_BLOCK_DEFINE(name, type, num) RING_BUFFER_DEFINE_CAPACITY(name, type*, RING_BUFFER_POW2(num), num)
+
+#endif /* MISC_RING_BUFFER_H_ */
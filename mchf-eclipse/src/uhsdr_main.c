@@ -85,6 +85,21 @@ void HAL_GPIO_EXTI_Callback (uint16_t GPIO_Pin)
     }
 }
 
+// the backlight pwm must not switch on the display before the start up screen is drawn,
+// so the ui time keeping starts together with the audio processing
+static __IO bool ui_timekeeping_active = false;
+
+/**
+ * @brief called every 1ms from the SysTick interrupt
+ */
+void HAL_SYSTICK_Callback(void)
+{
+    if (ui_timekeeping_active)
+    {
+        UiDriver_TimeKeeping();
+    }
+}
+
 void TransceiverStateInit(void)
 {
     // Defaults always
@@ -137,6 +152,7 @@ void TransceiverStateInit(void)
     }
 
     ts.tune_freq		= 0;
+    ts.rx_nco_offset	= 0;
     //ts.tune_freq_old	= 0;
 
     //	ts.calib_mode		= 0;					// calibrate mode
@@ -216,7 +232,7 @@ void TransceiverStateInit(void)
 #endif
 #ifdef USE_LMS_AUTONOTCH
     ts.dsp_notch_numtaps = DSP_NOTCH_NUMTAPS_DEFAULT;		// default for number of FFT taps for notch filter
-    ts.dsp_notch_delaybuf_len =	DSP_NOTCH_DELAYBUF_DEFAULT;
+    ts.dsp_notch_delay = DSP_NOTCH_DELAY_DEFAULT;
     ts.dsp_notch_mu = DSP_NOTCH_MU_DEFAULT;
 #endif
     ts.dsp_inhibit		= 1;					// TRUE if DSP is to be inhibited - power up with DSP disabled
@@ -354,8 +370,7 @@ void TransceiverStateInit(void)
 //	ts.nr_vad_thresh = 4.0;
 //	ts.nr_vad_thresh_int = 4000;
 	ts.nr_enable = false;
-	ts.NR_FFT_L = 256;
-	ts.NR_FFT_LOOP_NO = 1;
+	ts.NR_FFT_L = NR_FFT_L_DEFAULT;
 //	ts.nr_gain_smooth_enable = false;
 //	ts.nr_gain_smooth_alpha = 0.25;
 //	ts.nr_gain_smooth_alpha_int = 250;
@@ -367,11 +382,9 @@ void TransceiverStateInit(void)
 	ts.nr_first_time = 1;
 //	ts.nr_vad_delay = 7;
 	ts.NR_decimation_enable = true;
-	ts.nr_fft_256_enable = true;
 	NR2.width = 4;
 	NR2.power_threshold = 0.40;
 	NR2.power_threshold_int = 40;
-	NR2.asnr = 30;
 
 
     ts.i2c_speed[I2C_BUS_1] = I2C1_SPEED_DEFAULT; // Si570, MCP9801
@@ -532,6 +545,7 @@ int mchfMain(void)
 
     // Audio HW init
     AudioDriver_Init();
+    ui_timekeeping_active = true;
 
     UiDriver_StartupScreen_LogIfProblem(ts.codec_present == false,
             "Audiocodec WM8731 NOT detected!");
@@ -0,0 +1,260 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     compositor_check.c                                              **
+ **  Description:   Checks that the compositor draws the same screen as direct      **
+ **                 drawing, with less pixels                                       **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+// A sequence of frames of widget updates is drawn twice on the virtual display: directly with the
+// display driver and through the compositor, flushed at the end of each frame. After each frame
+// both screens have to be identical. The frames cover the cases of the compositor: unchanged
+// widgets, single digits merged into one text, adjacent rectangles, a widget drawn twice in one
+// frame, a widget drawn over directly, more operations than the queue holds, more regions than it
+// remembers and a flush which runs out of time.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "uhsdr_board.h"
+#include "ui_lcd_hy28.h"
+#include "ui_compositor.h"
+#include "host_display.h"
+
+#define CHECK_FRAMES        16
+#define CHECK_WIDTH         320
+#define CHECK_HEIGHT        240
+
+static int failed;
+
+#define CHECK(cond) do { if (!(cond)) { printf("  FAILED line %d: %s\n", __LINE__, #cond); failed++; } } while(0)
+
+static bool direct;                 // draw with the display driver instead of the compositor
+static uint32_t flush_budget;       // of the flush at the end of the frame, 0 for no limit
+static uint32_t tick;
+static uint16_t screen[CHECK_FRAMES][CHECK_WIDTH * CHECK_HEIGHT];
+static HostDisplay_Counters frame_cnt[CHECK_FRAMES];
+
+// every call is a ms, so a flush with a budget ends after a few operations
+uint32_t HAL_GetTick(void)
+{
+    return tick++;
+}
+
+static void Check_PrintText(uint16_t x, uint16_t y, const char* str, uint16_t clr_fg, uint16_t clr_bg, uint8_t font)
+{
+    if (direct)
+    {
+        UiLcdHy28_PrintText(x, y, str, clr_fg, clr_bg, font);
+    }
+    else
+    {
+        UiCompositor_PrintText(x, y, str, clr_fg, clr_bg, font);
+    }
+}
+
+static void Check_PrintTextCentered(uint16_t x, uint16_t y, uint16_t bbW, const char* str, uint16_t clr_fg, uint16_t clr_bg, uint8_t font)
+{
+    if (direct)
+    {
+        UiLcdHy28_PrintTextCentered(x, y, bbW, str, clr_fg, clr_bg, font);
+    }
+    else
+    {
+        UiCompositor_PrintTextCentered(x, y, bbW, str, clr_fg, clr_bg, font);
+    }
+}
+
+static void Check_DrawFullRect(uint16_t x, uint16_t y, uint16_t h, uint16_t w, uint16_t color)
+{
+    if (direct)
+    {
+        UiLcdHy28_DrawFullRect(x, y, h, w, color);
+    }
+    else
+    {
+        UiCompositor_DrawFullRect(x, y, h, w, color);
+    }
+}
+
+/**
+ * @brief the frequency digit by digit from the right as the ui driver does it, font 1 is the large font
+ */
+static void Check_Frequency(const char* freq, uint16_t color)
+{
+    char digit[2] = { 0, 0 };
+    for (int idx = strlen(freq) - 1; idx >= 0; idx--)
+    {
+        digit[0] = freq[idx];
+        Check_PrintText(60 + idx * 16, 40, digit, color, Black, 1);
+    }
+}
+
+static void Check_Widgets(const char* freq, const char* volt, const char* agc, uint16_t agc_bg)
+{
+    Check_Frequency(freq, White);
+    Check_PrintText(4, 208, volt, White, Black, 0);
+    Check_PrintTextCentered(200, 10, 41, agc, White, agc_bg, 0);
+}
+
+static void Check_Frame(int frame)
+{
+    char text[64];
+
+    switch(frame)
+    {
+    case 0:
+        Check_Widgets("14074000", "13.8V", "AGC", Blue);
+        Check_DrawFullRect(0, 100, 5, 10, Red);
+        Check_DrawFullRect(10, 100, 5, 10, Red);
+        Check_DrawFullRect(20, 100, 5, 10, Green);
+        Check_DrawFullRect(0, 105, 5, 10, Red);
+        break;
+    case 1:
+    case 2:
+        // nothing changes
+        Check_Widgets("14074000", "13.8V", "AGC", Blue);
+        Check_DrawFullRect(0, 100, 5, 10, Red);
+        break;
+    case 3:
+        // two digits change
+        Check_Widgets("14074110", "13.8V", "AGC", Blue);
+        break;
+    case 4:
+        // drawn twice in a frame, the last one counts, the first one is overwritten completely
+        Check_PrintText(4, 208, "13.7V", White, Black, 0);
+        Check_Widgets("14074110", "13.6V", "AGC", Red);
+        break;
+    case 5:
+        // a larger text over several widgets, then the widgets again
+        Check_PrintText(44, 40, "          ", White, Black, 1);
+        Check_Frequency("14074110", White);
+        break;
+    case 6:
+        // drawn over directly, as the debug line over the text message line
+        UiLcdHy28_PrintText(4, 210, "enabled", Green, Black, 0);
+        UiCompositor_InvalidateRect(4, 210, UiLcdHy28_TextWidth("enabled", 0), UiLcdHy28_TextHeight(0));
+        Check_Widgets("14074110", "13.6V", "AGC", Red);
+        break;
+    case 7:
+        // more operations than the queue holds
+        for (int idx = 0; idx < 2 * UI_COMPOSITOR_OPS; idx++)
+        {
+            snprintf(text, sizeof(text), "%d", idx);
+            Check_PrintText(240 + (idx % 4) * 20, 30 + (idx / 4) * 12, text, Yellow, Black, 4);
+        }
+        break;
+    case 8:
+        // more text than the pool holds
+        for (int idx = 0; idx < 12; idx++)
+        {
+            snprintf(text, sizeof(text), "%02d ----------------------------------------", idx);
+            Check_PrintText(0, 120 + idx * 9, text, Cyan, Black, 4);
+        }
+        break;
+    case 9:
+        // more regions than it remembers, the same again in the next frame is drawn again
+    case 10:
+        for (int idx = 0; idx < 2 * UI_COMPOSITOR_REGIONS; idx++)
+        {
+            Check_DrawFullRect((idx % 16) * 20, 70 + (idx / 16) * 3, 2, 18, idx % 3 ? Grey : Blue);
+        }
+        break;
+    case 11:
+        // the flush runs out of time and continues in the next frame
+        flush_budget = 2;
+        Check_Widgets("21000000", "12.0V", "AGC-S", Magenta);
+        break;
+    case 12:
+        Check_Widgets("21000001", "12.0V", "AGC-S", Magenta);
+        flush_budget = 0;
+        break;
+    default:
+        Check_Widgets("7074000", "12.1V", "AGC", Blue);
+        break;
+    }
+}
+
+/**
+ * @brief draws all frames, the screen after each frame is compared or stored
+ */
+static void Check_Run(bool draw_direct)
+{
+    uint16_t width, height;
+
+    direct = draw_direct;
+    flush_budget = 0;
+    HostDisplay_Select(HOST_DISPLAY_ILI932X);
+    CHECK(UiLcdHy28_Init() != DISPLAY_NONE);
+    UiLcdHy28_LcdClear(Black);
+    UiCompositor_Reset();
+
+    for (int frame = 0; frame < CHECK_FRAMES; frame++)
+    {
+        HostDisplay_Counters cnt;
+
+        HostDisplay_CountersReset();
+        Check_Frame(frame);
+        if (direct == false)
+        {
+            UiCompositor_Flush(flush_budget);
+        }
+        HostDisplay_CountersGet(&cnt);
+
+        const uint16_t* fb = HostDisplay_Framebuffer(&width, &height);
+        CHECK(width == CHECK_WIDTH && height == CHECK_HEIGHT);
+
+        if (direct)
+        {
+            memcpy(screen[frame], fb, sizeof(screen[frame]));
+            frame_cnt[frame] = cnt;
+        }
+        else
+        {
+            printf("frame %2d: %6u pixels, %3u windows direct, %6u pixels, %3u windows composed\n", frame,
+                    frame_cnt[frame].pixels, frame_cnt[frame].windows, cnt.pixels, cnt.windows);
+
+            // the frame which ran out of time shows the rest only after the next frame
+            if (frame != 11)
+            {
+                CHECK(memcmp(fb, screen[frame], sizeof(screen[frame])) == 0);
+            }
+            CHECK(cnt.pixels <= frame_cnt[frame].pixels || frame == 12);
+
+            switch(frame)
+            {
+            case 1:
+            case 2:
+                CHECK(cnt.pixels == 0);
+                break;
+            case 3:
+                // only the two digits, drawn as one text
+                CHECK(cnt.pixels == 2 * UiLcdHy28_TextWidth("0", 1) * UiLcdHy28_TextHeight(1));
+                break;
+            case 6:
+                // the direct text and the voltage which it has drawn over
+                CHECK(cnt.pixels == UiLcdHy28_TextWidth("enabled13.6V", 0) * UiLcdHy28_TextHeight(0));
+                break;
+            case 11:
+                CHECK(cnt.pixels > 0 && cnt.pixels < frame_cnt[frame].pixels);
+                break;
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Check_Run(true);
+    Check_Run(false);
+
+    printf("%d compositor checks %s\n", failed, failed ? "FAILED" : "failed");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,306 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     conv_bench.c                                                    **
+ **  Description:   Response and speed of the convolution RX filter compared with   **
+ **                 Hilbert transform and audio IIR filter                          **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "uhsdr_board.h"
+#include "audio_driver.h"
+#include "audio_filter.h"
+#include "filters.h"
+#include "audio_management.h"
+#include "profiling.h"
+#include "host_platform.h"
+
+#define BENCH_SAMPLE_RATE   48000
+#define BENCH_STEP_HZ       10      // frequency grid, a tone has a whole number of periods in BENCH_DFT_LEN
+#define BENCH_F_MAX         4000
+#define BENCH_SETTLE_LEN    9600    // samples before the measurement of each tone, longer than the filter transients
+#define BENCH_DFT_LEN       4800
+#define BENCH_AMPLITUDE     160.0   // of the IQ tone, the output stays well below clipping with the AGC off
+#define BENCH_TIMING_LEN    48000   // samples of noise for the timing
+#define BENCH_RUNS          5       // the fastest timing run is reported
+
+typedef struct
+{
+    uint8_t dmod_mode;
+    uint16_t filter_path;
+} BenchPath;
+
+typedef struct
+{
+    double edge_low;        // -6dB points in Hz
+    double edge_high;
+    double ripple_db;       // peak to peak within the -6dB points, 10% of the bandwidth away from them
+    double skirt_db;        // worst level 200Hz beyond the -6dB points
+    double sideband_db;     // worst level of the opposite sideband, same range as the ripple
+    double delay_min_ms;    // group delay within the passband
+    double delay_max_ms;
+    double block_ns;        // average time of the replaced stages per audio block
+    bool conv;              // the convolution filter has been used
+} BenchResult;
+
+// level in dB and phase for the positive (sideband 0) and negative (sideband 1) audio frequencies of the grid
+#define BENCH_POINTS        (BENCH_F_MAX / BENCH_STEP_HZ + 1)
+static double level_db[2][BENCH_POINTS];
+static double phase[BENCH_POINTS];
+
+/**
+ * @brief all audio filters the convolution filter can replace, i.e. with decimated IQ processing, each with the
+ * first filter path using it in SSB or, if there is none, in CW
+ * @return number of filter paths
+ */
+static int Bench_FilterPaths(BenchPath* paths)
+{
+    static const uint8_t modes[] = { DEMOD_USB, DEMOD_CW };
+    int num = 0;
+
+    for (int id = 0; id < AUDIO_FILTER_NUM; id++)
+    {
+        bool found = false;
+        for (int m = 0; found == false && m < sizeof(modes); m++)
+        {
+            const uint16_t filter_mode = AudioFilter_GetFilterModeFromDemodMode(modes[m]);
+            for (int idx = 1; found == false && idx < AUDIO_FILTER_PATH_NUM; idx++)
+            {
+                if (FilterPathInfo[idx].id == id && FilterPathInfo[idx].FIR_I_coeff_file == i_rx_new_coeffs
+                        && AudioFilter_IsApplicableFilterPath(PATH_ALL_APPLICABLE, filter_mode, idx))
+                {
+                    paths[num].dmod_mode = modes[m];
+                    paths[num].filter_path = idx;
+                    num++;
+                    found = true;
+                }
+            }
+        }
+    }
+    return num;
+}
+
+/**
+ * @brief runs the RX audio chain for len samples of a complex tone, returns the DFT of the last BENCH_DFT_LEN output samples
+ * @param freq negative frequencies are on the opposite sideband
+ */
+static void Bench_Tone(double freq, int len, double* re, double* im)
+{
+    AudioSample_t iq[IQ_BLOCK_SIZE];
+    AudioSample_t audio[IQ_BLOCK_SIZE];
+    AudioSample_t audio_tx[IQ_BLOCK_SIZE];
+    const double w = 2 * M_PI * freq / BENCH_SAMPLE_RATE;
+
+    *re = 0;
+    *im = 0;
+    for (int n0 = 0; n0 < len; n0 += IQ_BLOCK_SIZE)
+    {
+        for (int idx = 0; idx < IQ_BLOCK_SIZE; idx++)
+        {
+            iq[idx].l = lrint(BENCH_AMPLITUDE * cos(w * (n0 + idx)));
+            iq[idx].r = lrint(BENCH_AMPLITUDE * sin(w * (n0 + idx)));
+        }
+        AudioDriver_I2SCallback((int16_t*)iq, (int16_t*)audio, (int16_t*)audio_tx, 2 * IQ_BLOCK_SIZE);
+        for (int idx = 0; idx < IQ_BLOCK_SIZE; idx++)
+        {
+            const int n = n0 + idx;
+            if (n >= len - BENCH_DFT_LEN)
+            {
+                *re += audio[idx].l * cos(fabs(w) * n);
+                *im -= audio[idx].l * sin(fabs(w) * n);
+            }
+        }
+    }
+}
+
+/**
+ * @brief average time per audio block of the stages the convolution filter replaces, white noise as input
+ */
+static double Bench_Timing()
+{
+    static const ProfiledEventNames events[] = { ProfileRxHilbert, ProfileRxDecimation, ProfileRxDemod, ProfileRxFilter };
+    AudioSample_t iq[IQ_BLOCK_SIZE];
+    AudioSample_t audio[IQ_BLOCK_SIZE];
+    AudioSample_t audio_tx[IQ_BLOCK_SIZE];
+    uint32_t rnd = 4711;
+    double retval = 1e30;
+
+    for (int run = 0; run < BENCH_RUNS; run++)
+    {
+        for (int e = 0; e < sizeof(events) / sizeof(events[0]); e++)
+        {
+            profileTimedEventReset(events[e]);
+        }
+        for (int n0 = 0; n0 < BENCH_TIMING_LEN; n0 += IQ_BLOCK_SIZE)
+        {
+            for (int idx = 0; idx < IQ_BLOCK_SIZE; idx++)
+            {
+                rnd = rnd * 1664525 + 1013904223;
+                iq[idx].l = (int16_t)(rnd >> 16) / 8;
+                rnd = rnd * 1664525 + 1013904223;
+                iq[idx].r = (int16_t)(rnd >> 16) / 8;
+            }
+            AudioDriver_I2SCallback((int16_t*)iq, (int16_t*)audio, (int16_t*)audio_tx, 2 * IQ_BLOCK_SIZE);
+        }
+        double ns = 0;
+        for (int e = 0; e < sizeof(events) / sizeof(events[0]); e++)
+        {
+            ns += profileTimedEventGet(events[e])->duration;
+        }
+        ns /= BENCH_TIMING_LEN / IQ_BLOCK_SIZE;
+        retval = ns < retval ? ns : retval;
+    }
+    return retval;
+}
+
+/**
+ * @returns the frequency of the -6dB point between the grid points idx and idx + step by linear interpolation of the levels
+ */
+static double Bench_Edge(int idx, int step)
+{
+    const double l0 = level_db[0][idx], l1 = level_db[0][idx + step];
+    return (idx + step * (-6.0 - l0) / (l1 - l0)) * BENCH_STEP_HZ;
+}
+
+static void Bench_Run(const BenchPath* bp, bool conv, BenchResult* res)
+{
+    ts.dmod_mode = bp->dmod_mode;
+    ts.filter_path_mem[AudioFilter_GetFilterModeFromDemodMode(bp->dmod_mode)][0] = bp->filter_path;
+    ts.flags2 = conv ? (ts.flags2 | FLAGS2_RX_CONV_FILTER) : (ts.flags2 & ~FLAGS2_RX_CONV_FILTER);
+    AudioDriver_SetRxAudioProcessing(bp->dmod_mode, true);
+
+    for (int sb = 0; sb < 2; sb++)
+    {
+        for (int idx = 1; idx < BENCH_POINTS; idx++)
+        {
+            double re, im;
+            Bench_Tone((sb == 0 ? 1 : -1) * idx * BENCH_STEP_HZ, BENCH_SETTLE_LEN + BENCH_DFT_LEN, &re, &im);
+            level_db[sb][idx] = 20 * log10(hypot(re, im) + 1e-3);
+            if (sb == 0)
+            {
+                phase[idx] = atan2(im, re);
+            }
+        }
+        level_db[sb][0] = -200;
+    }
+
+    // levels relative to the center of the passband
+    const int path = ts.filter_path;
+    const double width = FilterInfo[FilterPathInfo[path].id].width;
+    const double center = FilterPathInfo[path].offset != 0 ? FilterPathInfo[path].offset : width / 2;
+    const double ref = level_db[0][lrint(center / BENCH_STEP_HZ)];
+    for (int sb = 0; sb < 2; sb++)
+    {
+        for (int idx = 0; idx < BENCH_POINTS; idx++)
+        {
+            level_db[sb][idx] -= ref;
+        }
+    }
+
+    int low = lrint(center / BENCH_STEP_HZ), high = low;
+    while (low > 1 && level_db[0][low - 1] > -6.0)
+    {
+        low--;
+    }
+    while (high < BENCH_POINTS - 1 && level_db[0][high + 1] > -6.0)
+    {
+        high++;
+    }
+    res->edge_low = low > 1 ? Bench_Edge(low, -1) : 0;
+    res->edge_high = Bench_Edge(high, 1);
+
+    const int margin = lrint(0.1 * (res->edge_high - res->edge_low) / BENCH_STEP_HZ);
+    double lmin = 0, lmax = -200;
+    res->delay_min_ms = 1e30;
+    res->delay_max_ms = -1e30;
+    for (int idx = low + margin; idx <= high - margin; idx++)
+    {
+        lmin = level_db[0][idx] < lmin ? level_db[0][idx] : lmin;
+        lmax = level_db[0][idx] > lmax ? level_db[0][idx] : lmax;
+        if (idx < high - margin)
+        {
+            // the phase of a 10Hz step changes by less than pi for delays below 50ms
+            double dphi = phase[idx + 1] - phase[idx];
+            dphi -= 2 * M_PI * floor(dphi / (2 * M_PI) + 0.5);
+            const double delay_ms = -1000 * dphi / (2 * M_PI * BENCH_STEP_HZ);
+            res->delay_min_ms = delay_ms < res->delay_min_ms ? delay_ms : res->delay_min_ms;
+            res->delay_max_ms = delay_ms > res->delay_max_ms ? delay_ms : res->delay_max_ms;
+        }
+    }
+    res->ripple_db = lmax - lmin;
+
+    const int skirt = 200 / BENCH_STEP_HZ;
+    const int skirt_low = lrint(res->edge_low / BENCH_STEP_HZ) - skirt;
+    const int skirt_high = lrint(res->edge_high / BENCH_STEP_HZ) + skirt;
+    res->skirt_db = skirt_high < BENCH_POINTS ? level_db[0][skirt_high] : -200;
+    if (skirt_low > 0 && level_db[0][skirt_low] > res->skirt_db)
+    {
+        res->skirt_db = level_db[0][skirt_low];
+    }
+
+    res->sideband_db = -200;
+    for (int idx = low + margin; idx <= high - margin; idx++)
+    {
+        res->sideband_db = level_db[1][idx] > res->sideband_db ? level_db[1][idx] : res->sideband_db;
+    }
+
+    res->block_ns = Bench_Timing();
+    // the Hilbert transform is replaced by the convolution filter
+    res->conv = profileTimedEventGet(ProfileRxHilbert)->count == 0;
+}
+
+int main(int argc, char* argv[])
+{
+    HostPlatform_TransceiverStateInit();
+    AudioFilter_SetDefaultMemories();
+    profileTimedEventInit();
+    AudioDriver_Init();
+
+    // the filters alone: no AGC, no IQ correction, no frequency translation
+    ts.agc_wdsp_mode = 5;
+    ts.iq_freq_mode = FREQ_IQ_CONV_MODE_OFF;
+    ts.iq_auto_correction = 0;
+    for (int band = IQ_80M; band <= IQ_10M; band++)
+    {
+        ts.rx_iq_gain_balance[band].value[IQ_TRANS_ON] = 0;
+        ts.rx_iq_phase_balance[band].value[IQ_TRANS_ON] = 0;
+    }
+    AudioManagement_CalcIqPhaseGainAdjust(7000000);
+
+    static BenchPath paths[AUDIO_FILTER_NUM];
+    const int num = Bench_FilterPaths(paths);
+
+    printf("RX filter response at %d Hz steps, %d samples per block\n", BENCH_STEP_HZ, IQ_BLOCK_SIZE);
+    printf("%-16s %-9s %14s %8s %10s %10s %14s %10s %7s\n", "filter", "engine", "-6dB points", "ripple",
+            "skirt 200", "opp. sb", "delay ms", "ns/block", "load %");
+
+    const double block_period = 1e9 * IQ_BLOCK_SIZE / BENCH_SAMPLE_RATE;
+    for (int p = 0; p < num; p++)
+    {
+        const FilterPathDescriptor* fp = &FilterPathInfo[paths[p].filter_path];
+        char name[32];
+        snprintf(name, sizeof(name), "%s %s %s", paths[p].dmod_mode == DEMOD_CW ? "CW" : "SSB", FilterInfo[fp->id].name, fp->name);
+
+        for (int engine = 0; engine < 2; engine++)
+        {
+            BenchResult res;
+            Bench_Run(&paths[p], engine == 1, &res);
+            // narrow filters keep the IIR filters with the convolution filter switched on
+            printf("%-16s %-9s %6.0f %6.0f %5.2f dB %7.1f dB %7.1f dB %6.1f - %5.1f %10.0f %7.2f\n",
+                    name, engine == 0 ? "IIR" : res.conv ? "conv" : "conv->IIR", res.edge_low, res.edge_high, res.ripple_db,
+                    res.skirt_db, res.sideband_db, res.delay_min_ms, res.delay_max_ms, res.block_ns,
+                    100 * res.block_ns / block_period);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     glyph_cache_check.c                                             **
+ **  Description:   Checks that the glyph cache of the display driver draws the     **
+ **                 same pixels as rendering the characters directly                **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+// Each font is drawn on the virtual display with all its characters in several colours, first
+// rendered directly, then with every font going through the glyph cache and then with the cache
+// as in the firmware (large fonts only). Every screen is drawn three times, the first time in
+// other colours, so the characters come from the cache or have replaced others in it. The screens
+// and the number of pixels sent have to be identical.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "uhsdr_board.h"
+#include "ui_lcd_hy28.h"
+#include "ui_lcd_hy28_fonts.h"
+#include "host_display.h"
+
+// the ui uses font numbers only, so this is not in ui_lcd_hy28.h
+const sFONT* UiLcdHy28_Font(uint8_t font);
+
+#define CHECK_FONTS         6           // font numbers of the display driver
+#define CHECK_WIDTH         480
+#define CHECK_HEIGHT        320
+#define CHECK_LINE_CHARS    24          // 24 characters of the widest font fit into a line
+
+static int failed;
+
+#define CHECK(cond) do { if (!(cond)) { printf("  FAILED line %d: %s\n", __LINE__, #cond); failed++; } } while(0)
+
+static uint16_t reference[CHECK_WIDTH * CHECK_HEIGHT];
+
+typedef enum
+{
+    CACHE_OFF = 0,
+    CACHE_ALL_FONTS,
+    CACHE_FIRMWARE,
+    CACHE_MODES,
+} Check_CacheMode;
+
+static const char* cache_mode_name[CACHE_MODES] = { "no cache", "all fonts cached", "large fonts cached" };
+
+static const uint8_t cache_min_height[CACHE_MODES] =
+{
+    [CACHE_OFF] = UINT8_MAX,
+    [CACHE_ALL_FONTS] = 0,
+    [CACHE_FIRMWARE] = 16,             // GLYPH_CACHE_MIN_HEIGHT of ui_lcd_hy28.c
+};
+
+/**
+ * @returns the characters of the font, the 8 bit font has the frequency digits only
+ */
+static int Check_FontChars(uint8_t font, char* chars)
+{
+    const sFONT* cf = UiLcdHy28_Font(font);
+    int num = 0;
+
+    chars[num++] = ' ';
+    if (cf->BitCount == 8)
+    {
+        for (int code = cf->firstCode; code < cf->maxCode; code++)
+        {
+            chars[num++] = code;
+        }
+    }
+    else
+    {
+        for (int code = 0x21; code < 0x7f; code++)
+        {
+            chars[num++] = code;
+        }
+    }
+    chars[num] = '\0';
+    return num;
+}
+
+// each pair shares the foreground or the background with the next one
+static const uint16_t colours[][2] = { { White, Black }, { Yellow, Black }, { Yellow, Blue }, { White, Blue } };
+
+/**
+ * @brief all characters of the font in lines of CHECK_LINE_CHARS
+ */
+static void Check_Draw(uint8_t font, uint16_t clr_fg, uint16_t clr_bg)
+{
+    char chars[128];
+    char line[CHECK_LINE_CHARS + 1];
+
+    const int num = Check_FontChars(font, chars);
+    uint16_t y = 0;
+
+    for (int idx = 0; idx < num; idx += CHECK_LINE_CHARS)
+    {
+        const int len = num - idx < CHECK_LINE_CHARS ? num - idx : CHECK_LINE_CHARS;
+        memcpy(line, &chars[idx], len);
+        line[len] = '\0';
+        y = UiLcdHy28_PrintText(0, y, line, clr_fg, clr_bg, font);
+    }
+    // the frequency display, the same few characters over and over
+    UiLcdHy28_PrintText(0, y, "14.074.000 7.074.000", clr_fg, clr_bg, font);
+}
+
+static void Check_Font(uint8_t font, int clr)
+{
+    uint16_t width, height;
+    HostDisplay_Counters ref_cnt = { 0 }, cnt;
+
+    for (Check_CacheMode mode = CACHE_OFF; mode < CACHE_MODES; mode++)
+    {
+        UiLcdHost_GlyphCacheSelect(cache_min_height[mode]);
+        UiLcdHy28_LcdClear(Black);
+
+        HostDisplay_CountersReset();
+        // the same characters in other colours before must not come out of the cache
+        const int other = (clr + 1) % (sizeof(colours) / sizeof(colours[0]));
+        Check_Draw(font, colours[other][0], colours[other][1]);
+        Check_Draw(font, colours[clr][0], colours[clr][1]);
+        Check_Draw(font, colours[clr][0], colours[clr][1]);
+        HostDisplay_CountersGet(&cnt);
+
+        const uint16_t* screen = HostDisplay_Framebuffer(&width, &height);
+        CHECK(width == CHECK_WIDTH && height == CHECK_HEIGHT);
+
+        if (mode == CACHE_OFF)
+        {
+            memcpy(reference, screen, sizeof(reference));
+            ref_cnt = cnt;
+        }
+        else
+        {
+            const bool identical = memcmp(screen, reference, sizeof(reference)) == 0;
+            if (clr == 0 || identical == false)
+            {
+                printf("font %u (%2ux%2u, %u bit), %-18s: %6u pixels, %s\n", font, UiLcdHy28_Font(font)->Width, UiLcdHy28_Font(font)->Height,
+                        UiLcdHy28_Font(font)->BitCount, cache_mode_name[mode], cnt.pixels, identical ? "identical" : "DIFFERENT");
+            }
+            CHECK(identical);
+            CHECK(cnt.pixels == ref_cnt.pixels);
+            CHECK(cnt.windows == ref_cnt.windows);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    HostDisplay_Select(HOST_DISPLAY_ILI9486);
+    CHECK(UiLcdHy28_Init() != DISPLAY_NONE);
+
+    for (uint8_t font = 0; font < CHECK_FONTS; font++)
+    {
+        for (int clr = 0; clr < sizeof(colours) / sizeof(colours[0]); clr++)
+        {
+            Check_Font(font, clr);
+        }
+    }
+
+    printf("%d glyph cache checks %s\n", failed, failed ? "FAILED" : "failed");
+    return failed ? 1 : 0;
+}
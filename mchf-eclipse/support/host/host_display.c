@@ -0,0 +1,404 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     host_display.c                                                  **
+ **  Description:   Virtual display controller on the parallel bus of the host      **
+ **                 build of ui_lcd_hy28.c, with bus accounting                     **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+// The host build of ui_lcd_hy28.c sends the register and data accesses of the FSMC bus to
+// UiLcdHost_Bus...() instead of the memory mapped LCD_REG and LCD_RAM. The virtual controller
+// here decodes the commands the driver uses of the ILI932x or the ILI9486: the identification,
+// the window, the cursor and the display RAM write, everything else is only counted. The pixels
+// go to an RGB565 framebuffer.
+//
+// The SPI displays send the same commands with a different framing, the bytes they would have
+// needed are counted from the bus accesses:
+// ILI932x (HY28A/B SPI): index = start byte + 2 bytes, a data burst = start byte + 2 bytes per word
+// ILI9486 (RPi SPI): the RS pin selects index or data, index = 2 bytes, 2 bytes per data word
+//
+// Optionally the controller has a memory to bus DMA for the transfer queue of the driver. A transfer
+// started by UiLcdHost_DmaStart() ends after a number of UiLcdHost_DmaPoll() calls, which the driver
+// makes while it waits for the queue. Then the pixels go to the display RAM and the completion
+// "interrupt" UiLcdHost_DmaComplete() of the driver runs, just like the interrupt of the real DMA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "uhsdr_board.h"
+#include "host_display.h"
+
+#define HOST_DISPLAY_MAX_W  480
+#define HOST_DISPLAY_MAX_H  320
+
+// FSMC timing of fsmc.c at 168MHz, a write is ADDSET + DATAST + 1 = 22 HCLK cycles
+#define HOST_DISPLAY_FSMC_NS_PER_ACCESS     (22.0f * 1000.0f / 168.0f)
+// SPI2 at APB1 42MHz: HY28 SPI with SPI_PRESCALE_LCD_DEFAULT (4), RPi SPI with SPI_PRESCALE_LCD_HIGH (2)
+#define HOST_DISPLAY_SPI_HZ_ILI932X         (42000000.0f / 4)
+#define HOST_DISPLAY_SPI_HZ_ILI9486         (42000000.0f / 2)
+
+static struct
+{
+    HostDisplay_Controller controller;
+    uint16_t width;
+    uint16_t height;
+
+    uint16_t index;             // selected register
+    uint16_t param;             // data words written or read since the index
+    bool ram_write;             // data words go to the display RAM
+
+    uint16_t x_start;
+    uint16_t x_end;
+    uint16_t y_start;
+    uint16_t y_end;
+    uint16_t cursor_x;          // ILI932x only, the ILI9486 starts at the window origin
+    uint16_t cursor_y;
+    uint16_t x;                 // display RAM address
+    uint16_t y;
+
+    HostDisplay_Counters counters;
+
+    uint32_t dma_delay;         // polls until a DMA transfer is done, 0 if there is no DMA
+    uint32_t dma_countdown;
+    const uint16_t* dma_pixel;  // the running transfer, NULL if none
+    uint32_t dma_len;
+    HostDisplay_DmaStats dma_stats;
+
+    uint16_t framebuffer[HOST_DISPLAY_MAX_W * HOST_DISPLAY_MAX_H];
+} vdisp;
+
+/**
+ * @brief selects the controller the driver will find, has to be called before UiLcdHy28_Init()
+ */
+void HostDisplay_Select(HostDisplay_Controller controller)
+{
+    memset(&vdisp, 0, sizeof(vdisp));
+    vdisp.controller = controller;
+    vdisp.width = controller == HOST_DISPLAY_ILI9486 ? 480 : 320;
+    vdisp.height = controller == HOST_DISPLAY_ILI9486 ? 320 : 240;
+    vdisp.x_end = vdisp.width - 1;
+    vdisp.y_end = vdisp.height - 1;
+}
+
+/**
+ * @brief the driver sends pixels by DMA, each transfer takes delay polls, 0: no DMA
+ *
+ * Has to be called after HostDisplay_Select() and before UiLcdHy28_Init().
+ */
+void HostDisplay_DmaSelect(uint32_t delay)
+{
+    vdisp.dma_delay = delay;
+    memset(&vdisp.dma_stats, 0, sizeof(vdisp.dma_stats));
+    vdisp.dma_stats.free_min = UINT32_MAX;
+}
+
+void HostDisplay_DmaStatsGet(HostDisplay_DmaStats* stats)
+{
+    *stats = vdisp.dma_stats;
+}
+
+/**
+ * @brief finishes the running DMA transfer and all the driver starts from its completion, i.e. the whole queue
+ */
+void HostDisplay_DmaDrain()
+{
+    while (vdisp.dma_pixel != NULL)
+    {
+        vdisp.dma_countdown = 1;
+        UiLcdHost_DmaPoll();
+    }
+}
+
+/**
+ * @brief the display RGB565 pixels, width * height
+ */
+const uint16_t* HostDisplay_Framebuffer(uint16_t* width, uint16_t* height)
+{
+    *width = vdisp.width;
+    *height = vdisp.height;
+    return vdisp.framebuffer;
+}
+
+void HostDisplay_CountersReset()
+{
+    memset(&vdisp.counters, 0, sizeof(vdisp.counters));
+}
+
+void HostDisplay_CountersGet(HostDisplay_Counters* counters)
+{
+    *counters = vdisp.counters;
+}
+
+/**
+ * @brief time the FSMC bus needs for the accesses, the CPU time of the driver is not included
+ */
+float HostDisplay_FsmcTimeUs(const HostDisplay_Counters* counters)
+{
+    return (counters->fsmc_bytes / 2) * HOST_DISPLAY_FSMC_NS_PER_ACCESS / 1000.0f;
+}
+
+/**
+ * @brief time the SPI display of the same controller needs for the bytes, without gaps between the bytes
+ */
+float HostDisplay_SpiTimeUs(const HostDisplay_Counters* counters)
+{
+    const float spi_hz = vdisp.controller == HOST_DISPLAY_ILI9486 ? HOST_DISPLAY_SPI_HZ_ILI9486 : HOST_DISPLAY_SPI_HZ_ILI932X;
+    return counters->spi_bytes * 8 * 1000000.0f / spi_hz;
+}
+
+static void HostDisplay_RamWrite(uint16_t pixel)
+{
+    if (vdisp.x < vdisp.width && vdisp.y < vdisp.height)
+    {
+        vdisp.framebuffer[vdisp.y * vdisp.width + vdisp.x] = pixel;
+    }
+    // both controllers run through the window line by line in the orientation the driver sets up
+    if (vdisp.x < vdisp.x_end)
+    {
+        vdisp.x++;
+    }
+    else
+    {
+        vdisp.x = vdisp.x_start;
+        vdisp.y = vdisp.y < vdisp.y_end ? vdisp.y + 1 : vdisp.y_start;
+    }
+}
+
+static void HostDisplay_RegWrite_ILI932x(uint16_t data)
+{
+    switch (vdisp.index)
+    {
+    // the driver uses the display in landscape, the GRAM vertical addresses are the x coordinates
+    case 0x50:
+        vdisp.y_start = data;
+        break;
+    case 0x51:
+        vdisp.y_end = data;
+        break;
+    case 0x52:
+        vdisp.x_start = data;
+        break;
+    case 0x53:
+        vdisp.x_end = data;
+        break;
+    case 0x20:
+        vdisp.cursor_y = data;
+        break;
+    case 0x21:
+        vdisp.cursor_x = data;
+        break;
+    }
+}
+
+static void HostDisplay_RegWrite_ILI9486(uint16_t data)
+{
+    // column and page address set: start high, start low, end high, end low
+    if ((vdisp.index == 0x2a || vdisp.index == 0x2b) && vdisp.param < 4)
+    {
+        uint16_t* value;
+        if (vdisp.index == 0x2a)
+        {
+            value = vdisp.param < 2 ? &vdisp.x_start : &vdisp.x_end;
+        }
+        else
+        {
+            value = vdisp.param < 2 ? &vdisp.y_start : &vdisp.y_end;
+        }
+        *value = vdisp.param % 2 == 0 ? (data & 0xff) << 8 : (*value & 0xff00) | (data & 0xff);
+    }
+}
+
+void UiLcdHost_BusWriteIndex(uint16_t index)
+{
+    const bool ili932x = vdisp.controller == HOST_DISPLAY_ILI932X;
+
+    vdisp.counters.index_writes++;
+    vdisp.counters.fsmc_bytes += 2;
+    vdisp.counters.spi_bytes += ili932x ? 3 : 2;
+
+    vdisp.index = index;
+    vdisp.param = 0;
+    vdisp.ram_write = index == (ili932x ? 0x22 : 0x2c);
+
+    if (index == (ili932x ? 0x52 : 0x2a))
+    {
+        vdisp.counters.windows++;
+    }
+    if (vdisp.ram_write)
+    {
+        vdisp.x = ili932x ? vdisp.cursor_x : vdisp.x_start;
+        vdisp.y = ili932x ? vdisp.cursor_y : vdisp.y_start;
+    }
+}
+
+void UiLcdHost_BusWriteData(uint16_t data)
+{
+    const bool ili932x = vdisp.controller == HOST_DISPLAY_ILI932X;
+
+    vdisp.counters.data_words++;
+    vdisp.counters.fsmc_bytes += 2;
+    vdisp.counters.spi_bytes += ili932x && vdisp.param == 0 ? 3 : 2;
+
+    if (vdisp.ram_write)
+    {
+        vdisp.counters.pixels++;
+        HostDisplay_RamWrite(data);
+    }
+    else if (ili932x)
+    {
+        HostDisplay_RegWrite_ILI932x(data);
+    }
+    else
+    {
+        HostDisplay_RegWrite_ILI9486(data);
+    }
+    vdisp.param++;
+}
+
+uint16_t UiLcdHost_BusReadData()
+{
+    // ReadDisplayId_ILI9486() reads register 0xd3: dummy, dummy, 0x94, 0x86
+    static const uint16_t id_ili9486[] = { 0x00, 0x00, 0x94, 0x86 };
+    uint16_t retval = 0;
+
+    vdisp.counters.fsmc_bytes += 2;
+
+    if (vdisp.controller == HOST_DISPLAY_ILI932X && vdisp.index == 0x00)
+    {
+        retval = 0x9325;
+    }
+    else if (vdisp.controller == HOST_DISPLAY_ILI9486 && vdisp.index == 0xd3 && vdisp.param < 4)
+    {
+        retval = id_ili9486[vdisp.param];
+    }
+    vdisp.param++;
+    return retval;
+}
+
+bool UiLcdHost_DmaEnabled()
+{
+    return vdisp.dma_delay != 0;
+}
+
+bool UiLcdHost_DmaStart(const uint16_t* pixel, uint32_t len)
+{
+    // the driver must not start a transfer while one is running
+    bool retval = vdisp.dma_pixel == NULL;
+
+    if (retval)
+    {
+        vdisp.dma_pixel = pixel;
+        vdisp.dma_len = len;
+        vdisp.dma_countdown = vdisp.dma_delay;
+        vdisp.dma_stats.transfers++;
+    }
+    else
+    {
+        vdisp.dma_stats.errors++;
+    }
+    return retval;
+}
+
+void UiLcdHost_DmaPoll()
+{
+    uint32_t jobs_fill, jobs_room, free_buffers;
+
+    UiLcdHost_TransferFill(&jobs_fill, &jobs_room, &free_buffers);
+    if (jobs_fill > vdisp.dma_stats.jobs_max)
+    {
+        vdisp.dma_stats.jobs_max = jobs_fill;
+    }
+    if (free_buffers < vdisp.dma_stats.free_min)
+    {
+        vdisp.dma_stats.free_min = free_buffers;
+    }
+    vdisp.dma_stats.jobs_full += jobs_room == 0;
+
+    if (vdisp.dma_pixel != NULL && --vdisp.dma_countdown == 0)
+    {
+        const uint16_t* pixel = vdisp.dma_pixel;
+        vdisp.dma_pixel = NULL;
+        for (uint32_t idx = 0; idx < vdisp.dma_len; idx++)
+        {
+            UiLcdHost_BusWriteData(pixel[idx]);
+        }
+        // may start the next transfer
+        UiLcdHost_DmaComplete();
+    }
+}
+
+/**
+ * @brief writes the framebuffer as binary PPM (P6)
+ */
+bool HostDisplay_WritePpm(const char* filename)
+{
+    FILE* file = fopen(filename, "wb");
+    bool retval = file != NULL;
+
+    if (retval)
+    {
+        fprintf(file, "P6\n%u %u\n255\n", vdisp.width, vdisp.height);
+        for (uint32_t idx = 0; idx < (uint32_t)vdisp.width * vdisp.height; idx++)
+        {
+            const uint16_t pixel = vdisp.framebuffer[idx];
+            const uint8_t r = (pixel >> 11) & 0x1f, g = (pixel >> 5) & 0x3f, b = pixel & 0x1f;
+            const uint8_t rgb[3] = { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+            fwrite(rgb, 1, sizeof(rgb), file);
+        }
+        retval = fclose(file) == 0;
+    }
+    return retval;
+}
+
+// the HAL functions the display driver calls, there is no hardware behind them
+void HAL_Delay(uint32_t Delay)
+{
+}
+
+// the compositor limits its drawing time per flush, the compositor check counts its own ticks
+__weak uint32_t HAL_GetTick(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+void Error_Handler(void)
+{
+    fprintf(stderr, "Error_Handler() called\n");
+    exit(1);
+}
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData, uint16_t Size, uint32_t Timeout)
+{
+    memset(pRxData, 0, Size);
+    return HAL_OK;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef  *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+}
+
+HAL_StatusTypeDef HAL_SRAM_DeInit(SRAM_HandleTypeDef *hsram)
+{
+    return HAL_OK;
+}
+
+void MX_FSMC_Init(void)
+{
+}
+
+SPI_HandleTypeDef hspi2;
+SRAM_HandleTypeDef hsram1;
@@ -0,0 +1,76 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     host_display.h                                                  **
+ **  Description:   Virtual display controller on the parallel bus of the host      **
+ **                 build of ui_lcd_hy28.c, with bus accounting                     **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#ifndef SUPPORT_HOST_HOST_DISPLAY_H_
+#define SUPPORT_HOST_HOST_DISPLAY_H_
+
+#include "uhsdr_types.h"
+
+typedef enum
+{
+    HOST_DISPLAY_ILI932X,       // 320x240, HY28A/B, as SPI display with start byte framing
+    HOST_DISPLAY_ILI9486,       // 480x320, as SPI display the RPi 3.5" with RS pin
+} HostDisplay_Controller;
+
+/**
+ * what the display driver sent, both the FSMC and the SPI numbers are for the same drawing,
+ * the SPI bytes are those the SPI version of the display would have needed
+ */
+typedef struct
+{
+    uint32_t index_writes;      // register selections
+    uint32_t windows;           // window set commands
+    uint32_t data_words;        // all data words, register values and pixels
+    uint32_t pixels;            // data words written to the display RAM
+    uint32_t fsmc_bytes;
+    uint32_t spi_bytes;
+} HostDisplay_Counters;
+
+/**
+ * the DMA transfers of the transfer queue of the driver and the fill levels of the queue seen while the driver waited
+ */
+typedef struct
+{
+    uint32_t transfers;         // DMA transfers started
+    uint32_t errors;            // transfers started while one was running
+    uint32_t jobs_max;          // highest number of queued jobs
+    uint32_t jobs_full;         // polls with the job queue full
+    uint32_t free_min;          // lowest number of free pixel buffers
+} HostDisplay_DmaStats;
+
+void HostDisplay_Select(HostDisplay_Controller controller);
+void HostDisplay_DmaSelect(uint32_t delay);
+void HostDisplay_DmaStatsGet(HostDisplay_DmaStats* stats);
+void HostDisplay_DmaDrain(void);
+const uint16_t* HostDisplay_Framebuffer(uint16_t* width, uint16_t* height);
+
+void HostDisplay_CountersReset(void);
+void HostDisplay_CountersGet(HostDisplay_Counters* counters);
+float HostDisplay_FsmcTimeUs(const HostDisplay_Counters* counters);
+float HostDisplay_SpiTimeUs(const HostDisplay_Counters* counters);
+
+bool HostDisplay_WritePpm(const char* filename);
+
+// the driver side of the virtual display, see ui_lcd_hy28.c
+void UiLcdHost_BusWriteIndex(uint16_t index);
+void UiLcdHost_BusWriteData(uint16_t data);
+uint16_t UiLcdHost_BusReadData(void);
+bool UiLcdHost_DmaEnabled(void);
+bool UiLcdHost_DmaStart(const uint16_t* pixel, uint32_t len);
+void UiLcdHost_DmaPoll(void);
+void UiLcdHost_DmaComplete(void);
+void UiLcdHost_TransferFill(uint32_t* jobs_fill, uint32_t* jobs_room, uint32_t* free_buffers);
+void UiLcdHost_GlyphCacheSelect(uint8_t min_height);
+
+#endif /* SUPPORT_HOST_HOST_DISPLAY_H_ */
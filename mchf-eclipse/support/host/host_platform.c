@@ -0,0 +1,313 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     host_platform.c                                                 **
+ **  Description:   Workstation stand-ins for everything the audio chain calls      **
+ **                 outside of drivers/audio (hardware, ui, cat, codec2)            **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#include <time.h>
+#include <math.h>
+
+#include "uhsdr_board.h"
+#include "profiling.h"
+#include "audio_driver.h"
+#include "ui_driver.h"
+#include "ui_spectrum.h"
+#include "ui_lcd_hy28.h"
+#include "radio_management.h"
+#include "cat_driver.h"
+#include "codec.h"
+#include "uhsdr_hw_i2s.h"
+#include "usbd_audio_if.h"
+#include "freedv_api.h"
+#include "audio_nr.h"
+#include "audio_management.h"
+#include "ui_configuration.h"
+#include "cw_gen.h"
+#include "host_platform.h"
+
+// the global state normally living in modules which are not part of the host build
+__IO TransceiverState ts;
+// weak, lcd_bench links the ui driver, the spectrum and the display driver which have their own
+__weak __IO KeypadState ks;
+__weak SpectrumDisplay sd;
+__weak mchf_display_t mchf_display;    // all zero, i.e. a parallel bus display
+
+/**
+ * @brief sets the subset of TransceiverStateInit() defaults the audio chain depends on
+ */
+void HostPlatform_TransceiverStateInit()
+{
+    ts.txrx_mode        = TRX_MODE_RX;
+    ts.samp_rate        = I2S_AUDIOFREQ_48K;
+    ts.display          = &mchf_display;
+    ts.dmod_mode        = DEMOD_USB;
+    ts.rx_gain[RX_AUDIO_SPKR].value = AUDIO_GAIN_DEFAULT;
+    ts.rx_gain[RX_AUDIO_DIG].value  = DIG_GAIN_DEFAULT;
+    ts.rx_gain[RX_AUDIO_SPKR].max   = MAX_VOLUME_DEFAULT;
+    ts.rx_gain[RX_AUDIO_DIG].max    = DIG_GAIN_MAX;
+    ts.rx_gain[RX_AUDIO_SPKR].active_value = 1;
+    ts.rx_gain[RX_AUDIO_DIG].active_value = 1;
+    ts.rf_gain          = DEFAULT_RF_GAIN;
+
+    ts.cw_keyer_mode    = CW_KEYER_MODE_STRAIGHT;
+    ts.cw_keyer_speed   = CW_KEYER_SPEED_DEFAULT;
+    ts.cw_keyer_weight  = CW_KEYER_WEIGHT_DEFAULT;
+    ts.cw_rx_delay      = CW_TX2RX_DELAY_DEFAULT;
+    ts.cw_sidetone_freq = CW_SIDETONE_FREQ_DEFAULT;
+    ts.cw_offset_mode   = CW_OFFSET_USB_RX;
+
+    for (int i = 0; i < IQ_ADJUST_POINTS_NUM; i++)
+    {
+        for (int j = 0; j < IQ_TRANS_NUM; j++)
+        {
+            ts.rx_iq_gain_balance[i].value[j]   = IQ_BALANCE_OFF;
+            ts.rx_iq_phase_balance[i].value[j]  = IQ_BALANCE_OFF;
+        }
+    }
+    ts.iq_auto_correction = 1;
+    ts.twinpeaks_tested = 2;
+
+    ts.iq_freq_mode     = FREQ_IQ_CONV_MODE_DEFAULT;
+    ts.tx_audio_source  = TX_AUDIO_MIC;
+    ts.digital_mode     = DigitalMode_None;
+    ts.dsp_active       = 0;
+    ts.dsp_nr_strength  = 50;
+#ifdef USE_LMS_AUTONOTCH
+    ts.dsp_notch_numtaps = DSP_NOTCH_NUMTAPS_DEFAULT;
+    ts.dsp_notch_delay  = DSP_NOTCH_DELAY_DEFAULT;
+    ts.dsp_notch_mu     = DSP_NOTCH_MU_DEFAULT;
+#endif
+    ts.fm_sql_threshold = FM_SQUELCH_DEFAULT;
+    ts.beep_active      = 0;
+    ts.notch_frequency  = 800;
+    ts.peak_frequency   = 750;
+    ts.bass_gain        = 2;
+    ts.treble_gain      = 0;
+
+    ts.agc_wdsp_mode = 2;
+    ts.agc_wdsp_slope = 70;
+    ts.agc_wdsp_hang_enable = 0;
+    ts.agc_wdsp_hang_time = 500;
+    ts.agc_wdsp_hang_thresh = 45;
+    ts.agc_wdsp_thresh = 60;
+    ts.agc_wdsp_action = 0;
+    ts.agc_wdsp_switch_mode = 1;
+    ts.agc_wdsp_hang_action = 0;
+    ts.agc_wdsp_tau_decay[0] = 4000;
+    ts.agc_wdsp_tau_decay[1] = 2000;
+    ts.agc_wdsp_tau_decay[2] = 500;
+    ts.agc_wdsp_tau_decay[3] = 250;
+    ts.agc_wdsp_tau_decay[4] = 50;
+    ts.agc_wdsp_tau_decay[5] = 500;
+    ts.agc_wdsp_tau_hang_decay = 200;
+
+    ts.nr_alpha = 0.94;
+    ts.nr_alpha_int = 940;
+    ts.nr_beta = 0.96;
+    ts.nr_beta_int = 960;
+    ts.nr_first_time = 1;
+    ts.NR_FFT_L = NR_FFT_L_DEFAULT;
+    ts.NR_decimation_enable = true;
+    NR2.width = 4;
+    NR2.power_threshold = 0.40;
+    NR2.power_threshold_int = 40;
+
+    ads.pll_fmax_int = 2500;
+    ads.zeta_int = 65;
+    ads.omegaN_int = 250;
+    ads.fade_leveler = 1;
+    ads.sam_sideband = SAM_SIDEBAND_BOTH;
+
+    // let the no zoom spectrum collect samples as it does on the radio
+    sd.fft_iq_len = FFT_IQ_BUFF_LEN;
+    sd.magnify = 0;
+}
+
+uint32_t HostProfile_GetCycleCount()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec);
+}
+
+/*
+ * CMSIS DSP only has an assembly version of these (arm_bitreversal2.S),
+ * these are the plain C equivalents used by the CMSIS reference implementation
+ */
+void arm_bitreversal_32(uint32_t* pSrc, const uint16_t bitRevLen, const uint16_t* pBitRevTab)
+{
+    for (uint32_t i = 0; i < bitRevLen; i += 2)
+    {
+        const uint32_t a = pBitRevTab[i] >> 2;
+        const uint32_t b = pBitRevTab[i + 1] >> 2;
+        uint32_t tmp;
+
+        tmp = pSrc[a];
+        pSrc[a] = pSrc[b];
+        pSrc[b] = tmp;
+
+        tmp = pSrc[a+1];
+        pSrc[a+1] = pSrc[b+1];
+        pSrc[b+1] = tmp;
+    }
+}
+
+void arm_bitreversal_16(uint16_t* pSrc, const uint16_t bitRevLen, const uint16_t* pBitRevTab)
+{
+    for (uint32_t i = 0; i < bitRevLen; i += 2)
+    {
+        const uint32_t a = pBitRevTab[i] >> 2;
+        const uint32_t b = pBitRevTab[i + 1] >> 2;
+        uint16_t tmp;
+
+        tmp = pSrc[a];
+        pSrc[a] = pSrc[b];
+        pSrc[b] = tmp;
+
+        tmp = pSrc[a+1];
+        pSrc[a+1] = pSrc[b+1];
+        pSrc[b+1] = tmp;
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+    // paddles and ptt are active low, i.e. nothing is pressed
+    return GPIO_PIN_SET;
+}
+
+// codec / i2s
+uint32_t Codec_Reset(uint32_t AudioFreq,uint32_t word_size)
+{
+    return HAL_OK;
+}
+
+void Codec_RestartI2S()
+{
+}
+
+void UhsdrHwI2s_Codec_StartDMA()
+{
+}
+
+void UhsdrHwI2s_Codec_ClearTxDmaBuffer()
+{
+}
+
+// usb audio, there is no usb host on the other end
+void audio_in_put_buffer(int16_t sample)
+{
+}
+
+void audio_out_fill_tx_buffer(int16_t *buffer, uint32_t len)
+{
+    memset(buffer, 0, len * sizeof(*buffer));
+}
+
+// radio management, replaced by radio_management.c if it is linked
+__weak bool RadioManagement_CalculateCWSidebandMode()
+{
+    return false;
+}
+
+__weak bool RadioManagement_FmDevIs5khz()
+{
+    return (ts.flags2 & FLAGS2_FM_MODE_DEVIATION_5KHZ) != 0;
+}
+
+// cat
+bool CatDriver_CWKeyPressed()
+{
+    return false;
+}
+
+bool CatDriver_CatPttActive()
+{
+    return false;
+}
+
+// ui, decoded text is sent to stdout unless ui_driver.c is linked
+__weak void UiDriver_TextMsgPutChar(char ch)
+{
+    putchar(ch);
+}
+
+__weak void UiDriver_TextMsgPutSign(const char *s)
+{
+    fputs(s, stdout);
+}
+
+__weak void UiDriver_TextMsgDisplay()
+{
+}
+
+__weak void UiDriver_TextMsgClear()
+{
+}
+
+// the audio chain prints a few status texts, the display driver replaces the stubs if it is linked
+__weak uint16_t UiLcdHy28_PrintText(uint16_t Xpos, uint16_t Ypos, const char *str,const uint32_t Color, const uint32_t bkColor, uchar font)
+{
+    return Ypos;
+}
+
+__weak uint16_t UiLcdHy28_TextWidth(const char *str, uchar font)
+{
+    return 0;
+}
+
+// codec2 / freedv library is not part of the host build, freedv mode is not available
+struct freedv *freedv_open(int mode)
+{
+    return NULL;
+}
+
+void freedv_comptx(struct freedv *freedv, COMP mod_out[], short speech_in[])
+{
+}
+
+int freedv_nin(struct freedv *freedv)
+{
+    return 0;
+}
+
+int freedv_comprx(struct freedv *freedv, short speech_out[], COMP demod_in[])
+{
+    return 0;
+}
+
+void freedv_set_callback_txt(struct freedv *freedv, freedv_callback_rx rx, freedv_callback_tx tx, void *callback_state)
+{
+}
+
+void freedv_set_total_bit_errors(struct freedv *freedv, int val)
+{
+}
+
+void freedv_set_total_bits(struct freedv *freedv, int val)
+{
+}
+
+int freedv_get_total_bit_errors(struct freedv *freedv)
+{
+    return 0;
+}
+
+int freedv_get_total_bits(struct freedv *freedv)
+{
+    return 0;
+}
+
+void freedv_get_modem_stats(struct freedv *freedv, int *sync, float *snr_est)
+{
+    *sync = 0;
+    *snr_est = 0;
+}
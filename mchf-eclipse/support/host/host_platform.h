@@ -0,0 +1,19 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     host_platform.h                                                 **
+ **  Description:   Setup shared by the host programs running the audio chain       **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#ifndef SUPPORT_HOST_HOST_PLATFORM_H_
+#define SUPPORT_HOST_HOST_PLATFORM_H_
+
+void HostPlatform_TransceiverStateInit();
+
+#endif /* SUPPORT_HOST_HOST_PLATFORM_H_ */
@@ -0,0 +1,227 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     iir_biquad_check.c                                              **
+ **  Description:   Compares the RX audio IIR lattice filters with their biquad     **
+ **                 versions from iir_rx_biquad.c, using the CMSIS DSP functions    **
+ **                 the firmware uses                                               **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "uhsdr_board.h"
+#include "audio_driver.h"
+#include "audio_filter.h"
+#include "filters.h"
+
+// complex.h defines I, which clashes with the audio driver headers
+#include <complex.h>
+
+#define RESPONSE_LEN        16384   // impulse response length, all filters decay well within this
+#define GRID_POINTS         1024    // frequencies between 0 and fs/2
+#define NOISE_LEN           48000
+#define BLOCK_LEN           IIR_RXAUDIO_BLOCK_SIZE
+
+// limits for a biquad version to be considered identical to the lattice filter
+#define LIMIT_PASSBAND_DB   0.05    // magnitude deviation where the lattice filter is within 3dB of its peak
+#define LIMIT_PHASE_DEG     0.5     // phase deviation in the same range
+#define LIMIT_STOPBAND_DB   3.0     // loss of stopband attenuation, where the lattice filter is 40dB below its peak
+#define LIMIT_NOISE_SNR_DB  70.0    // output difference for white noise input, relative to the output
+
+// audio_filter.c refers to these, only its filter tables are used here
+__IO TransceiverState ts;
+AudioDriverState ads;
+
+// processing time of all filters for the noise input, host time of the CMSIS C implementation
+static double time_lattice, time_biquad;
+static uint32_t time_samples;
+
+static double IirBiquadCheck_Now()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+typedef struct
+{
+    double passband_db;
+    double phase_deg;
+    double stop_lattice_db;
+    double stop_biquad_db;
+    double noise_snr_db;
+} CheckResult;
+
+static void IirBiquadCheck_Run(const IIR_BiquadDescriptor* desc, const float32_t* in, float32_t* out_lattice, float32_t* out_biquad, int len, bool timed)
+{
+    static float32_t lattice_state[BLOCK_LEN + IIR_RXAUDIO_NUM_STAGES_MAX];
+    static float32_t biquad_state[2 * IIR_RX_BIQUAD_NUM_STAGES_MAX];
+
+    // the same way the RX processor sets the filters up, processing is done in blocks too
+    arm_iir_lattice_instance_f32 lattice =
+    {
+        .numStages = desc->lattice->numStages,
+        .pState = lattice_state,
+        .pkCoeffs = desc->lattice->pkCoeffs,
+        .pvCoeffs = desc->lattice->pvCoeffs,
+    };
+    arm_biquad_cascade_df2T_instance_f32 biquad;
+    arm_biquad_cascade_df2T_init_f32(&biquad, desc->numStages, (float32_t*)desc->pCoeffs, biquad_state);
+    memset(lattice_state, 0, sizeof(lattice_state));
+
+    const double start = IirBiquadCheck_Now();
+    for (int i = 0; i < len; i += BLOCK_LEN)
+    {
+        arm_iir_lattice_f32(&lattice, (float32_t*)&in[i], &out_lattice[i], BLOCK_LEN);
+    }
+    const double middle = IirBiquadCheck_Now();
+    for (int i = 0; i < len; i += BLOCK_LEN)
+    {
+        arm_biquad_cascade_df2T_f32(&biquad, (float32_t*)&in[i], &out_biquad[i], BLOCK_LEN);
+    }
+    const double end = IirBiquadCheck_Now();
+
+    if (timed)
+    {
+        time_lattice += middle - start;
+        time_biquad += end - middle;
+        time_samples += len;
+    }
+}
+
+static double complex IirBiquadCheck_Dft(const float32_t* x, int len, double w)
+{
+    double complex sum = 0;
+    const double complex step = cexp(-I * w);
+    double complex rot = 1;
+    for (int n = 0; n < len; n++)
+    {
+        sum += x[n] * rot;
+        rot *= step;
+        if ((n & 255) == 255)
+        {
+            rot /= cabs(rot);
+        }
+    }
+    return sum;
+}
+
+static void IirBiquadCheck_Filter(const IIR_BiquadDescriptor* desc, CheckResult* res)
+{
+    static float32_t impulse[RESPONSE_LEN], h_lattice[RESPONSE_LEN], h_biquad[RESPONSE_LEN];
+    static float32_t noise[NOISE_LEN], y_lattice[NOISE_LEN], y_biquad[NOISE_LEN];
+    static double complex resp_lattice[GRID_POINTS], resp_biquad[GRID_POINTS];
+
+    memset(impulse, 0, sizeof(impulse));
+    impulse[0] = 1.0;
+    // the decaying impulse response ends in denormals, which are slow on a workstation, so this is not timed
+    IirBiquadCheck_Run(desc, impulse, h_lattice, h_biquad, RESPONSE_LEN, false);
+
+    double peak = 0;
+    for (int k = 0; k < GRID_POINTS; k++)
+    {
+        const double w = M_PI * k / (GRID_POINTS - 1);
+        resp_lattice[k] = IirBiquadCheck_Dft(h_lattice, RESPONSE_LEN, w);
+        resp_biquad[k] = IirBiquadCheck_Dft(h_biquad, RESPONSE_LEN, w);
+        peak = fmax(peak, cabs(resp_lattice[k]));
+    }
+
+    double stop_lattice = 0, stop_biquad = 0;
+    memset(res, 0, sizeof(*res));
+    for (int k = 0; k < GRID_POINTS; k++)
+    {
+        const double mag = cabs(resp_lattice[k]);
+        if (mag >= peak * M_SQRT1_2)
+        {
+            res->passband_db = fmax(res->passband_db, fabs(20 * log10(cabs(resp_biquad[k]) / mag)));
+            res->phase_deg = fmax(res->phase_deg, fabs(carg(resp_biquad[k] / resp_lattice[k])) * 180 / M_PI);
+        }
+        else if (mag < peak * 0.01)
+        {
+            stop_lattice = fmax(stop_lattice, mag);
+            stop_biquad = fmax(stop_biquad, cabs(resp_biquad[k]));
+        }
+    }
+    res->stop_lattice_db = 20 * log10(stop_lattice / peak);
+    res->stop_biquad_db = 20 * log10(stop_biquad / peak);
+
+    // audio like levels, the difference includes the rounding noise of both float implementations
+    srand(1);
+    for (int n = 0; n < NOISE_LEN; n++)
+    {
+        noise[n] = ((float32_t)rand() / RAND_MAX - 0.5) * 0.5;
+    }
+    IirBiquadCheck_Run(desc, noise, y_lattice, y_biquad, NOISE_LEN, true);
+    double sig = 0, diff = 0;
+    for (int n = 0; n < NOISE_LEN; n++)
+    {
+        sig += (double)y_lattice[n] * y_lattice[n];
+        diff += ((double)y_biquad[n] - y_lattice[n]) * ((double)y_biquad[n] - y_lattice[n]);
+    }
+    res->noise_snr_db = 10 * log10(sig / fmax(diff, 1e-30));
+}
+
+static const char* IirBiquadCheck_FilterName(const arm_iir_lattice_instance_f32* lattice)
+{
+    for (int p = 0; p < AUDIO_FILTER_PATH_NUM; p++)
+    {
+        if (FilterPathInfo[p].pre_instance == lattice)
+        {
+            return FilterPathInfo[p].name;
+        }
+    }
+    return "unused";
+}
+
+int main(int argc, char* argv[])
+{
+    int failed = 0;
+
+    // every IIR filter of a filter path needs its biquad version
+    for (int p = 0; p < AUDIO_FILTER_PATH_NUM; p++)
+    {
+        bool found = FilterPathInfo[p].pre_instance == NULL;
+        for (int i = 0; i < IirRxBiquadInfo_num && found == false; i++)
+        {
+            found = IirRxBiquadInfo[i].lattice == FilterPathInfo[p].pre_instance;
+        }
+        if (found == false)
+        {
+            printf("filter path %d (%s): no biquad version of the IIR filter, run make iir_biquad\n", p, FilterPathInfo[p].name);
+            failed++;
+        }
+    }
+
+    printf("%-3s %-12s %6s %8s %10s %10s %10s %9s\n", "#", "used by", "stages", "pass dB", "phase deg", "stop lat", "stop biq", "noise SNR");
+    for (int i = 0; i < IirRxBiquadInfo_num; i++)
+    {
+        const IIR_BiquadDescriptor* desc = &IirRxBiquadInfo[i];
+        CheckResult res;
+
+        IirBiquadCheck_Filter(desc, &res);
+
+        const bool ok = res.passband_db <= LIMIT_PASSBAND_DB && res.phase_deg <= LIMIT_PHASE_DEG
+                && res.stop_biquad_db <= res.stop_lattice_db + LIMIT_STOPBAND_DB && res.noise_snr_db >= LIMIT_NOISE_SNR_DB;
+        printf("%-3d %-12s %2d->%-2d %8.4f %10.4f %10.1f %10.1f %9.1f %s\n", i, IirBiquadCheck_FilterName(desc->lattice),
+                desc->lattice->numStages, desc->numStages, res.passband_db, res.phase_deg, res.stop_lattice_db, res.stop_biquad_db,
+                res.noise_snr_db, ok ? "ok" : "FAILED");
+        if (ok == false)
+        {
+            failed++;
+        }
+    }
+
+    printf("host time per sample: lattice %.1f ns, biquad %.1f ns\n", time_lattice * 1e9 / time_samples, time_biquad * 1e9 / time_samples);
+    printf("%d of %d filters %s\n", failed, IirRxBiquadInfo_num, failed ? "FAILED" : "failed");
+    return failed ? 1 : 0;
+}
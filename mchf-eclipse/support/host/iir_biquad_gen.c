@@ -0,0 +1,508 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     iir_biquad_gen.c                                                **
+ **  Description:   Converts the RX audio IIR lattice filters used in FilterPathInfo**
+ **                 into cascaded biquads and writes drivers/audio/filters/         **
+ **                 iir_rx_biquad.c                                                 **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "uhsdr_board.h"
+#include "audio_driver.h"
+#include "audio_filter.h"
+#include "filters.h"
+
+// complex.h defines I, which clashes with the audio driver headers
+#include <complex.h>
+
+#define LATTICE_ORDER_MAX   IIR_RXAUDIO_NUM_STAGES_MAX
+#define GRID_POINTS         4096
+
+// audio_filter.c refers to these, only its filter tables are used here
+__IO TransceiverState ts;
+AudioDriverState ads;
+
+typedef struct
+{
+    const arm_iir_lattice_instance_f32* lattice;
+    const char* name;
+} LatticeFilter;
+
+#define LATTICE(x) { &x, #x }
+
+// every lattice filter referenced by FilterPathInfo has to be listed here, main() checks this
+static const LatticeFilter lattice_filters[] =
+{
+    LATTICE(IIR_1k4_LPF), LATTICE(IIR_1k4_BPF),
+    LATTICE(IIR_1k6_LPF), LATTICE(IIR_1k6_BPF),
+    LATTICE(IIR_1k8_LPF), LATTICE(IIR_1k8_1k125), LATTICE(IIR_1k8_1k275), LATTICE(IIR_1k8_1k425),
+    LATTICE(IIR_1k8_1k575), LATTICE(IIR_1k8_1k725),
+    LATTICE(IIR_2k1_LPF), LATTICE(IIR_2k1_BPF),
+    LATTICE(IIR_2k3_LPF), LATTICE(IIR_2k3_1k275), LATTICE(IIR_2k3_1k412), LATTICE(IIR_2k3_1k562),
+    LATTICE(IIR_2k3_1k712),
+    LATTICE(IIR_2k5_LPF), LATTICE(IIR_2k5_BPF),
+    LATTICE(IIR_2k7_LPF), LATTICE(IIR_2k7_BPF),
+    LATTICE(IIR_2k9_LPF), LATTICE(IIR_2k9_BPF),
+    LATTICE(IIR_3k2_LPF), LATTICE(IIR_3k2_BPF),
+    LATTICE(IIR_3k4_LPF), LATTICE(IIR_3k4_BPF),
+    LATTICE(IIR_3k6_LPF), LATTICE(IIR_3k6_BPF),
+    LATTICE(IIR_3k8_LPF), LATTICE(IIR_3k8_BPF),
+    LATTICE(IIR_300hz_500), LATTICE(IIR_300hz_550), LATTICE(IIR_300hz_600), LATTICE(IIR_300hz_650),
+    LATTICE(IIR_300hz_700), LATTICE(IIR_300hz_750), LATTICE(IIR_300hz_800), LATTICE(IIR_300hz_850),
+    LATTICE(IIR_300hz_900), LATTICE(IIR_300hz_950),
+    LATTICE(IIR_500hz_550), LATTICE(IIR_500hz_650), LATTICE(IIR_500hz_750), LATTICE(IIR_500hz_850),
+    LATTICE(IIR_500hz_950),
+    LATTICE(IIR_4k_LPF), LATTICE(IIR_4k2_LPF), LATTICE(IIR_4k4_LPF), LATTICE(IIR_4k6_LPF),
+    LATTICE(IIR_4k8_LPF),
+    LATTICE(IIR_5k_LPF), LATTICE(IIR_6k_LPF), LATTICE(IIR_7k5_LPF), LATTICE(IIR_10k_LPF),
+};
+
+#define LATTICE_FILTERS_NUM (sizeof(lattice_filters)/sizeof(lattice_filters[0]))
+
+// a first or second order section, polynomials in z^-1, b[2] = a[2] = 0 for first order sections
+typedef struct
+{
+    double b[3];
+    double a[3];
+    double complex pole;
+    bool first_order;
+} Section;
+
+/**
+ * Transfer function of a CMSIS lattice/ladder filter, see arm_iir_lattice_f32()
+ *
+ * CMSIS stage j is stage numStages-j of the textbook lattice, i.e. reflection and ladder coefficients
+ * are stored in reverse order. With the forward and backward polynomials A_m, B_m of stage m
+ * H(z) = sum(v_m * B_m(z)) / A_N(z)
+ *
+ * @param num numerator, numStages+1 coefficients of z^0 .. z^-numStages
+ * @param den denominator, numStages+1 coefficients, den[0] = 1
+ */
+static void IirBiquadGen_LatticeToTransferFunction(const arm_iir_lattice_instance_f32* lattice, double* num, double* den)
+{
+    const int order = lattice->numStages;
+    double a[LATTICE_ORDER_MAX + 1] = { 1.0 };
+    double b[LATTICE_ORDER_MAX + 1] = { 1.0 };
+
+    memset(num, 0, (order + 1) * sizeof(double));
+    num[0] = lattice->pvCoeffs[order];
+
+    for (int m = 1; m <= order; m++)
+    {
+        const double k = lattice->pkCoeffs[order - m];
+        double a_next[LATTICE_ORDER_MAX + 1];
+        double b_next[LATTICE_ORDER_MAX + 1];
+
+        for (int i = 0; i <= m; i++)
+        {
+            const double a_prev = i < m ? a[i] : 0.0;
+            const double b_delayed = i > 0 ? b[i - 1] : 0.0;
+            a_next[i] = a_prev + k * b_delayed;
+            b_next[i] = k * a_prev + b_delayed;
+        }
+        memcpy(a, a_next, sizeof(a));
+        memcpy(b, b_next, sizeof(b));
+
+        for (int i = 0; i <= m; i++)
+        {
+            num[i] += lattice->pvCoeffs[order - m] * b[i];
+        }
+    }
+    memcpy(den, a, (order + 1) * sizeof(double));
+}
+
+static double complex IirBiquadGen_PolyEval(const double* c, int degree, double complex z)
+{
+    double complex res = c[0];
+    for (int i = 1; i <= degree; i++)
+    {
+        res = res * z + c[i];
+    }
+    return res;
+}
+
+/**
+ * Roots of c[0] z^degree + c[1] z^(degree-1) + ... + c[degree] (Aberth-Ehrlich iteration)
+ *
+ * This is the same as the roots of c[0] + c[1] z^-1 + ... + c[degree] z^-degree
+ */
+static bool IirBiquadGen_PolyRoots(const double* c, int degree, double complex* roots)
+{
+    double deriv[LATTICE_ORDER_MAX + 1];
+    for (int i = 0; i < degree; i++)
+    {
+        deriv[i] = c[i] * (degree - i);
+    }
+
+    const double radius = pow(fabs(c[degree] / c[0]), 1.0 / degree);
+    for (int i = 0; i < degree; i++)
+    {
+        roots[i] = (radius > 0 ? radius : 1.0) * cexp(I * (2 * M_PI * i / degree + 0.4));
+    }
+
+    // close roots limit the accuracy to the rounding noise, this is where the iteration stops to improve
+    double max_step = 0;
+    for (int iter = 0; iter < 500; iter++)
+    {
+        max_step = 0;
+        for (int i = 0; i < degree; i++)
+        {
+            const double complex ratio = IirBiquadGen_PolyEval(c, degree, roots[i]) / IirBiquadGen_PolyEval(deriv, degree - 1, roots[i]);
+            double complex sum = 0;
+            for (int j = 0; j < degree; j++)
+            {
+                if (j != i)
+                {
+                    sum += 1.0 / (roots[i] - roots[j]);
+                }
+            }
+            const double complex step = ratio / (1.0 - ratio * sum);
+            roots[i] -= step;
+            max_step = fmax(max_step, cabs(step) / fmax(cabs(roots[i]), 1e-3));
+        }
+        if (max_step < 1e-15)
+        {
+            break;
+        }
+    }
+    return max_step < 1e-6;
+}
+
+/**
+ * Splits the roots into complex pairs (one root with positive imaginary part each) and real roots
+ * @return false if the roots are not conjugate symmetric
+ */
+static bool IirBiquadGen_SplitRoots(double complex* roots, int num, double complex* pairs, int* pairs_num, double* reals, int* reals_num)
+{
+    int neg = 0;
+    *pairs_num = 0;
+    *reals_num = 0;
+    for (int i = 0; i < num; i++)
+    {
+        if (fabs(cimag(roots[i])) <= 1e-9 * fmax(cabs(roots[i]), 1.0))
+        {
+            reals[(*reals_num)++] = creal(roots[i]);
+        }
+        else if (cimag(roots[i]) > 0)
+        {
+            pairs[(*pairs_num)++] = roots[i];
+        }
+        else
+        {
+            neg++;
+        }
+    }
+    return neg == *pairs_num;
+}
+
+static double complex IirBiquadGen_SectionResponse(const Section* s, double w)
+{
+    const double complex z1 = cexp(-I * w);
+    return (s->b[0] + s->b[1] * z1 + s->b[2] * z1 * z1) / (s->a[0] + s->a[1] * z1 + s->a[2] * z1 * z1);
+}
+
+static double complex IirBiquadGen_Response(const double* num, const double* den, int order, double w)
+{
+    const double complex z1 = cexp(-I * w);
+    double complex n = 0, d = 0, zk = 1;
+    for (int i = 0; i <= order; i++)
+    {
+        n += num[i] * zk;
+        d += den[i] * zk;
+        zk *= z1;
+    }
+    return n / d;
+}
+
+/**
+ * Factors the transfer function into first/second order sections
+ *
+ * Each pole pair gets the nearest zero pair, starting with the pole pair closest to the unit circle.
+ * The sections are ordered by increasing pole radius, so the most resonant section comes last.
+ * Each section is scaled so that the peak gain of the partial cascade equals the peak gain
+ * of the whole filter.
+ *
+ * @return number of sections, 0 on error
+ */
+static int IirBiquadGen_ToSections(const double* num, const double* den, int order, Section* sections)
+{
+    double complex zeros[LATTICE_ORDER_MAX], poles[LATTICE_ORDER_MAX];
+    double complex zero_pairs[LATTICE_ORDER_MAX], pole_pairs[LATTICE_ORDER_MAX];
+    double zero_reals[LATTICE_ORDER_MAX], pole_reals[LATTICE_ORDER_MAX];
+    int zp_num, zr_num, pp_num, pr_num;
+
+    if (num[0] == 0 || IirBiquadGen_PolyRoots(num, order, zeros) == false || IirBiquadGen_PolyRoots(den, order, poles) == false
+            || IirBiquadGen_SplitRoots(zeros, order, zero_pairs, &zp_num, zero_reals, &zr_num) == false
+            || IirBiquadGen_SplitRoots(poles, order, pole_pairs, &pp_num, pole_reals, &pr_num) == false)
+    {
+        return 0;
+    }
+
+    // group the roots into sections, real roots are combined into pairs where possible
+    typedef struct { double complex r[2]; int num; bool used; } Group;
+    Group zg[LATTICE_ORDER_MAX], pg[LATTICE_ORDER_MAX];
+    int zg_num = 0, pg_num = 0;
+
+    for (int i = 0; i < zp_num; i++)
+    {
+        zg[zg_num++] = (Group) { { zero_pairs[i], conj(zero_pairs[i]) }, 2, false };
+    }
+    for (int i = 0; i < zr_num; i += 2)
+    {
+        zg[zg_num++] = (Group) { { zero_reals[i], i + 1 < zr_num ? zero_reals[i + 1] : 0 }, i + 1 < zr_num ? 2 : 1, false };
+    }
+    for (int i = 0; i < pp_num; i++)
+    {
+        pg[pg_num++] = (Group) { { pole_pairs[i], conj(pole_pairs[i]) }, 2, false };
+    }
+    for (int i = 0; i < pr_num; i += 2)
+    {
+        pg[pg_num++] = (Group) { { pole_reals[i], i + 1 < pr_num ? pole_reals[i + 1] : 0 }, i + 1 < pr_num ? 2 : 1, false };
+    }
+    if (zg_num != pg_num)
+    {
+        return 0;
+    }
+
+    for (int s = 0; s < pg_num; s++)
+    {
+        // the pole group closest to the unit circle, which is not yet used
+        int p = -1;
+        for (int i = 0; i < pg_num; i++)
+        {
+            if (pg[i].used == false && (p < 0 || fabs(1 - cabs(pg[i].r[0])) < fabs(1 - cabs(pg[p].r[0]))))
+            {
+                p = i;
+            }
+        }
+        // the nearest zero group, a first order pole group takes the first order zero group
+        int z = -1;
+        for (int i = 0; i < zg_num; i++)
+        {
+            if (zg[i].used == false && (pg[p].num == 1) == (zg[i].num == 1)
+                    && (z < 0 || cabs(zg[i].r[0] - pg[p].r[0]) < cabs(zg[z].r[0] - pg[p].r[0])))
+            {
+                z = i;
+            }
+        }
+        if (z < 0)
+        {
+            return 0;
+        }
+        pg[p].used = zg[z].used = true;
+
+        // sections are filled from the end, the most resonant one is processed last
+        Section* sec = &sections[pg_num - 1 - s];
+        sec->pole = pg[p].r[0];
+        sec->first_order = pg[p].num == 1;
+        if (sec->first_order)
+        {
+            sec->b[0] = 1; sec->b[1] = -creal(zg[z].r[0]); sec->b[2] = 0;
+            sec->a[0] = 1; sec->a[1] = -creal(pg[p].r[0]); sec->a[2] = 0;
+        }
+        else
+        {
+            sec->b[0] = 1; sec->b[1] = -creal(zg[z].r[0] + zg[z].r[1]); sec->b[2] = creal(zg[z].r[0] * zg[z].r[1]);
+            sec->a[0] = 1; sec->a[1] = -creal(pg[p].r[0] + pg[p].r[1]); sec->a[2] = creal(pg[p].r[0] * pg[p].r[1]);
+        }
+    }
+
+    // peak gain and the frequency of it
+    double peak = 0, peak_w = 0;
+    for (int k = 0; k < GRID_POINTS; k++)
+    {
+        const double w = M_PI * k / (GRID_POINTS - 1);
+        const double mag = cabs(IirBiquadGen_Response(num, den, order, w));
+        if (mag > peak)
+        {
+            peak = mag;
+            peak_w = w;
+        }
+    }
+
+    static double complex partial[GRID_POINTS];
+    for (int k = 0; k < GRID_POINTS; k++)
+    {
+        partial[k] = 1;
+    }
+    for (int s = 0; s < pg_num; s++)
+    {
+        double partial_peak = 0;
+        for (int k = 0; k < GRID_POINTS; k++)
+        {
+            partial[k] *= IirBiquadGen_SectionResponse(&sections[s], M_PI * k / (GRID_POINTS - 1));
+            partial_peak = fmax(partial_peak, cabs(partial[k]));
+        }
+        const double scale = peak / partial_peak;
+        for (int i = 0; i < 3; i++)
+        {
+            sections[s].b[i] *= scale;
+        }
+        for (int k = 0; k < GRID_POINTS; k++)
+        {
+            partial[k] *= scale;
+        }
+    }
+
+    // the scaling only takes care of the magnitude, the sign is set by the last section
+    double complex cascade = 1;
+    for (int s = 0; s < pg_num; s++)
+    {
+        cascade *= IirBiquadGen_SectionResponse(&sections[s], peak_w);
+    }
+    if (creal(cascade * conj(IirBiquadGen_Response(num, den, order, peak_w))) < 0)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            sections[pg_num - 1].b[i] = -sections[pg_num - 1].b[i];
+        }
+    }
+
+    return pg_num;
+}
+
+static void IirBiquadGen_VarName(char* var, size_t len, const char* name)
+{
+    snprintf(var, len, "%s_biquad_coeffs", name);
+}
+
+static void IirBiquadGen_Write(FILE* out, const LatticeFilter* filters, const Section (*sections)[LATTICE_ORDER_MAX], const int* sections_num)
+{
+    fprintf(out,
+            "/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */\n"
+            "/************************************************************************************\n"
+            " **                                                                                 **\n"
+            " **                                        UHSDR                                    **\n"
+            " **               a powerful firmware for STM32 based SDR transceivers              **\n"
+            " **                                                                                 **\n"
+            " **---------------------------------------------------------------------------------**\n"
+            " **                                                                                 **\n"
+            " **  File name:     iir_rx_biquad.c                                                 **\n"
+            " **  Description:   RX audio IIR lattice filters converted to cascaded biquads      **\n"
+            " **  Licence:       GNU GPLv3                                                       **\n"
+            " ************************************************************************************/\n"
+            "\n"
+            "#include \"filters.h\"\n"
+            "//\n"
+            "// GENERATED FILE, DO NOT EDIT\n"
+            "// created by support/host/iir_biquad_gen from the lattice filters referenced in FilterPathInfo,\n"
+            "// rerun it after changing or adding RX audio IIR filters, support/host/iir_biquad_check verifies the result\n"
+            "//\n"
+            "// the responses are identical to the lattice filters, only the structure differs:\n"
+            "// second order sections in arm_biquad_cascade_df2T_f32() coefficient order { b0, b1, b2, a1, a2 },\n"
+            "// i.e. a1 and a2 have the inverted sign of the textbook denominator\n"
+            "// the most resonant section comes last, each partial cascade has the peak gain of the whole filter\n"
+            "//\n");
+
+    for (int f = 0; f < LATTICE_FILTERS_NUM; f++)
+    {
+        char var[64];
+        IirBiquadGen_VarName(var, sizeof(var), filters[f].name);
+        fprintf(out, "\n// %s, %d lattice stages\n", filters[f].name, (int)filters[f].lattice->numStages);
+        fprintf(out, "static const float32_t %s[%d*5] =\n{\n", var, sections_num[f]);
+        for (int s = 0; s < sections_num[f]; s++)
+        {
+            const Section* sec = &sections[f][s];
+            fprintf(out, "    %.9g, %.9g, %.9g, %.9g, %.9g,\n", sec->b[0], sec->b[1], sec->b[2], -sec->a[1], -sec->a[2]);
+        }
+        fprintf(out, "};\n");
+    }
+
+    fprintf(out, "\nconst IIR_BiquadDescriptor IirRxBiquadInfo[] =\n{\n");
+    for (int f = 0; f < LATTICE_FILTERS_NUM; f++)
+    {
+        char var[64];
+        IirBiquadGen_VarName(var, sizeof(var), filters[f].name);
+        fprintf(out, "    { &%s, %d, %s },\n", filters[f].name, sections_num[f], var);
+    }
+    fprintf(out, "};\n\nconst uint16_t IirRxBiquadInfo_num = sizeof(IirRxBiquadInfo)/sizeof(IirRxBiquadInfo[0]);\n");
+}
+
+int main(int argc, char* argv[])
+{
+    static Section sections[LATTICE_FILTERS_NUM][LATTICE_ORDER_MAX];
+    int sections_num[LATTICE_FILTERS_NUM];
+    bool filter_used[LATTICE_FILTERS_NUM] = { false };
+    int retval = 0;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s <output.c>\n", argv[0]);
+        fprintf(stderr, "  e.g. %s ../../drivers/audio/filters/iir_rx_biquad.c\n", argv[0]);
+        return 1;
+    }
+
+    // all RX lattice filters have to be known by name, otherwise we cannot reference them
+    for (int p = 0; p < AUDIO_FILTER_PATH_NUM; p++)
+    {
+        bool found = FilterPathInfo[p].pre_instance == NULL;
+        for (int f = 0; f < LATTICE_FILTERS_NUM && found == false; f++)
+        {
+            if (lattice_filters[f].lattice == FilterPathInfo[p].pre_instance)
+            {
+                found = filter_used[f] = true;
+            }
+        }
+        if (found == false)
+        {
+            fprintf(stderr, "filter path %d (%s): IIR filter is missing in lattice_filters[]\n", p, FilterPathInfo[p].name);
+            retval = 1;
+        }
+    }
+    // and we don't want to waste flash for filters nobody uses
+    for (int f = 0; f < LATTICE_FILTERS_NUM; f++)
+    {
+        if (filter_used[f] == false)
+        {
+            fprintf(stderr, "%s is not used by any filter path, remove it from lattice_filters[]\n", lattice_filters[f].name);
+            retval = 1;
+        }
+    }
+
+    for (int f = 0; f < LATTICE_FILTERS_NUM; f++)
+    {
+        const arm_iir_lattice_instance_f32* lattice = lattice_filters[f].lattice;
+        double num[LATTICE_ORDER_MAX + 1], den[LATTICE_ORDER_MAX + 1];
+
+        IirBiquadGen_LatticeToTransferFunction(lattice, num, den);
+        sections_num[f] = IirBiquadGen_ToSections(num, den, lattice->numStages, sections[f]);
+        if (sections_num[f] == 0 || sections_num[f] > IIR_RX_BIQUAD_NUM_STAGES_MAX)
+        {
+            fprintf(stderr, "%s: conversion failed\n", lattice_filters[f].name);
+            retval = 1;
+        }
+        else
+        {
+            double r_max = 0;
+            for (int s = 0; s < sections_num[f]; s++)
+            {
+                r_max = fmax(r_max, cabs(sections[f][s].pole));
+            }
+            printf("%-16s %2d stages -> %d biquads, max pole radius %.6f\n", lattice_filters[f].name, (int)lattice->numStages, sections_num[f], r_max);
+        }
+    }
+
+    if (retval == 0)
+    {
+        FILE* out = fopen(argv[1], "w");
+        if (out == NULL)
+        {
+            perror(argv[1]);
+            return 1;
+        }
+        IirBiquadGen_Write(out, lattice_filters, sections, sections_num);
+        fclose(out);
+    }
+    return retval;
+}
@@ -0,0 +1,276 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     iir_design_check.c                                              **
+ **  Description:   Compares the RX audio IIR filters designed from the             **
+ **                 specifications in iir_rx_design.c with the lattice filters      **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "uhsdr_board.h"
+#include "audio_driver.h"
+#include "audio_filter.h"
+#include "audio_iir_design.h"
+#include "filters.h"
+
+// complex.h defines I, which clashes with the audio driver headers
+#include <complex.h>
+
+#define GRID_POINTS         8192    // frequencies between 0 and fs/2
+#define DESIGN_RUNS         100     // designs per filter for the timing
+
+// limits for a designed filter to be considered a replacement of the lattice filter
+#define LIMIT_EDGE_HZ       2.0     // -6dB points
+#define LIMIT_EDGE_REL      0.03    // -6dB points, relative to the -6dB bandwidth, whichever is larger
+#define LIMIT_SKIRT_REL     0.10    // -50dB points, relative to the -6dB bandwidth, the designed filter may be steeper
+#define LIMIT_RIPPLE_DB     0.05    // passband ripple above the specified one
+#define LIMIT_ATTEN_DB      0.5     // stopband attenuation below the specified one
+
+#if defined(USE_RX_IIR_DESIGNER)
+#error "iir_design_check compares with the lattice filters, which FilterPathInfo does not refer to with USE_RX_IIR_DESIGNER"
+#endif
+
+// audio_filter.c refers to these, only its filter tables are used here
+__IO TransceiverState ts;
+AudioDriverState ads;
+
+typedef struct
+{
+    const char* name;
+    const arm_iir_lattice_instance_f32* lattice;
+    const IIR_DesignSpec* spec;
+} DesignedFilter;
+
+#define DESIGN(x) { #x, &x, &x##_spec }
+
+// every RX audio IIR filter of FilterPathInfo
+static const DesignedFilter designed_filters[] =
+{
+    DESIGN(IIR_300hz_500), DESIGN(IIR_300hz_550), DESIGN(IIR_300hz_600), DESIGN(IIR_300hz_650), DESIGN(IIR_300hz_700),
+    DESIGN(IIR_300hz_750), DESIGN(IIR_300hz_800), DESIGN(IIR_300hz_850), DESIGN(IIR_300hz_900), DESIGN(IIR_300hz_950),
+    DESIGN(IIR_500hz_550), DESIGN(IIR_500hz_650), DESIGN(IIR_500hz_750), DESIGN(IIR_500hz_850), DESIGN(IIR_500hz_950),
+    DESIGN(IIR_1k4_LPF), DESIGN(IIR_1k4_BPF), DESIGN(IIR_1k6_LPF), DESIGN(IIR_1k6_BPF),
+    DESIGN(IIR_1k8_1k125), DESIGN(IIR_1k8_1k275), DESIGN(IIR_1k8_1k425), DESIGN(IIR_1k8_1k575), DESIGN(IIR_1k8_1k725),
+    DESIGN(IIR_1k8_LPF), DESIGN(IIR_2k1_LPF), DESIGN(IIR_2k1_BPF),
+    DESIGN(IIR_2k3_1k275), DESIGN(IIR_2k3_1k412), DESIGN(IIR_2k3_1k562), DESIGN(IIR_2k3_1k712), DESIGN(IIR_2k3_LPF),
+    DESIGN(IIR_2k5_LPF), DESIGN(IIR_2k5_BPF), DESIGN(IIR_2k7_LPF), DESIGN(IIR_2k7_BPF), DESIGN(IIR_2k9_LPF), DESIGN(IIR_2k9_BPF),
+    DESIGN(IIR_3k2_LPF), DESIGN(IIR_3k2_BPF), DESIGN(IIR_3k4_LPF), DESIGN(IIR_3k4_BPF), DESIGN(IIR_3k6_LPF), DESIGN(IIR_3k6_BPF),
+    DESIGN(IIR_3k8_LPF), DESIGN(IIR_3k8_BPF), DESIGN(IIR_4k_LPF), DESIGN(IIR_4k2_LPF), DESIGN(IIR_4k4_LPF), DESIGN(IIR_4k6_LPF),
+    DESIGN(IIR_4k8_LPF), DESIGN(IIR_5k_LPF), DESIGN(IIR_6k_LPF), DESIGN(IIR_7k5_LPF), DESIGN(IIR_10k_LPF),
+};
+
+#define DESIGNED_FILTERS_NUM (sizeof(designed_filters) / sizeof(designed_filters[0]))
+
+typedef struct
+{
+    double edge6[2];    // -6dB points
+    double edge50[2];   // -50dB points
+    double ripple_db;   // between the passband edges of the specification
+    double atten_db;    // beyond the first minimum after the -50dB points
+} Response;
+
+static double IirDesignCheck_Now()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static double IirDesignCheck_Magnitude(const float32_t* coeffs, int stages, double w)
+{
+    const double complex z1 = cexp(-I * w);
+    double complex h = 1;
+    for (int s = 0; s < stages; s++)
+    {
+        const float32_t* c = &coeffs[5 * s];
+        h *= (c[0] + c[1] * z1 + c[2] * z1 * z1) / (1 - c[3] * z1 - c[4] * z1 * z1);
+    }
+    return cabs(h);
+}
+
+/**
+ * @brief measures the response, the passband is searched from the peak, which is within the passband of the specification
+ */
+static void IirDesignCheck_Measure(const float32_t* coeffs, int stages, const IIR_DesignSpec* spec, double fs, Response* res)
+{
+    static double mag[GRID_POINTS];
+    const double hz = fs / 2 / (GRID_POINTS - 1);
+    double peak = 0;
+    int ipk = 0;
+
+    for (int k = 0; k < GRID_POINTS; k++)
+    {
+        mag[k] = IirDesignCheck_Magnitude(coeffs, stages, M_PI * k / (GRID_POINTS - 1));
+        if (mag[k] > peak && k * hz >= spec->f_low && k * hz <= spec->f_high)
+        {
+            peak = mag[k];
+            ipk = k;
+        }
+    }
+
+    const double levels[2] = { 0.5, pow(10, -50 / 20.0) };
+    double* edges[2] = { res->edge6, res->edge50 };
+    int lo50 = 0, hi50 = GRID_POINTS - 1;
+    for (int l = 0; l < 2; l++)
+    {
+        int lo = ipk, hi = ipk;
+        while (lo > 0 && mag[lo] >= peak * levels[l])
+        {
+            lo--;
+        }
+        while (hi < GRID_POINTS - 1 && mag[hi] >= peak * levels[l])
+        {
+            hi++;
+        }
+        edges[l][0] = spec->f_low == 0 ? 0 : lo * hz;
+        edges[l][1] = hi * hz;
+        lo50 = lo;
+        hi50 = hi;
+    }
+    // the stopband starts at the first minimum
+    while (lo50 > 0 && mag[lo50 - 1] < mag[lo50])
+    {
+        lo50--;
+    }
+    while (hi50 < GRID_POINTS - 1 && mag[hi50 + 1] < mag[hi50])
+    {
+        hi50++;
+    }
+
+    double pass_min = peak, pass_max = 0, stop_max = 0;
+    for (int k = 0; k < GRID_POINTS; k++)
+    {
+        if (k * hz >= spec->f_low && k * hz <= spec->f_high)
+        {
+            pass_min = fmin(pass_min, mag[k]);
+            pass_max = fmax(pass_max, mag[k]);
+        }
+        if ((k <= lo50 && spec->f_low != 0) || k >= hi50)
+        {
+            stop_max = fmax(stop_max, mag[k]);
+        }
+    }
+    res->ripple_db = 20 * log10(pass_max / pass_min);
+    res->atten_db = -20 * log10(stop_max / peak);
+}
+
+static bool IirDesignCheck_Stable(const float32_t* coeffs, int stages)
+{
+    bool retval = stages > 0;
+    for (int s = 0; s < stages; s++)
+    {
+        // denominator 1 - a1 z^-1 - a2 z^-2 in CMSIS notation
+        const float32_t a1 = coeffs[5 * s + 3], a2 = coeffs[5 * s + 4];
+        retval = retval && fabs(a2) < 1 && fabs(a1) < 1 - a2;
+    }
+    return retval;
+}
+
+/**
+ * @return sample rate of the filter in the filter path using it, 0 if no filter path uses it
+ */
+static double IirDesignCheck_SampleRate(const arm_iir_lattice_instance_f32* lattice)
+{
+    for (int p = 0; p < AUDIO_FILTER_PATH_NUM; p++)
+    {
+        if (FilterPathInfo[p].pre_instance == lattice)
+        {
+            return (double)IQ_SAMPLE_RATE / FilterPathInfo[p].sample_rate_dec;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    int failed = 0;
+    double time_design = 0;
+
+    // every IIR filter of a filter path needs a specification
+    for (int p = 0; p < AUDIO_FILTER_PATH_NUM; p++)
+    {
+        bool found = FilterPathInfo[p].pre_instance == NULL;
+        for (int i = 0; i < DESIGNED_FILTERS_NUM && found == false; i++)
+        {
+            found = designed_filters[i].lattice == FilterPathInfo[p].pre_instance;
+        }
+        if (found == false)
+        {
+            printf("filter path %d (%s): IIR filter without specification, add it to iir_rx_design.c and here\n", p, FilterPathInfo[p].name);
+            failed++;
+        }
+    }
+
+    printf("%-14s %5s %-12s %-12s %-12s %-12s %6s %6s %s\n", "", "fs", "-6dB lattice", "-6dB design", "-50dB latt.", "-50dB design",
+            "ripple", "atten", "");
+    for (int i = 0; i < DESIGNED_FILTERS_NUM; i++)
+    {
+        const DesignedFilter* df = &designed_filters[i];
+        const double fs = IirDesignCheck_SampleRate(df->lattice);
+        if (fs == 0)
+        {
+            printf("%s is not used by FilterPathInfo, remove it\n", df->name);
+            failed++;
+            continue;
+        }
+
+        const IIR_BiquadDescriptor* ref = NULL;
+        for (int idx = 0; idx < IirRxBiquadInfo_num; idx++)
+        {
+            if (IirRxBiquadInfo[idx].lattice == df->lattice)
+            {
+                ref = &IirRxBiquadInfo[idx];
+            }
+        }
+
+        float32_t coeffs[5 * IIR_DESIGN_NUM_STAGES_MAX];
+        uint8_t stages = 0;
+        const double start = IirDesignCheck_Now();
+        for (int run = 0; run < DESIGN_RUNS; run++)
+        {
+            stages = AudioIirDesign_Biquads(df->spec, fs, coeffs);
+        }
+        time_design += IirDesignCheck_Now() - start;
+
+        if (ref == NULL || IirDesignCheck_Stable(coeffs, stages) == false)
+        {
+            printf("%-14s %s\n", df->name, ref == NULL ? "no biquad version of the lattice filter, run make iir_biquad" : "design FAILED");
+            failed++;
+            continue;
+        }
+
+        // the lattice filter through its biquad version, which iir_biquad_check has compared with it
+        Response lat, des;
+        IirDesignCheck_Measure(ref->pCoeffs, ref->numStages, df->spec, fs, &lat);
+        IirDesignCheck_Measure(coeffs, stages, df->spec, fs, &des);
+
+        const double width = lat.edge6[1] - lat.edge6[0];
+        const double limit_edge = fmax(LIMIT_EDGE_HZ, LIMIT_EDGE_REL * width);
+        const bool ok = fabs(des.edge6[0] - lat.edge6[0]) <= limit_edge && fabs(des.edge6[1] - lat.edge6[1]) <= limit_edge
+                && des.edge50[0] >= lat.edge50[0] - LIMIT_SKIRT_REL * width && des.edge50[1] <= lat.edge50[1] + LIMIT_SKIRT_REL * width
+                && des.ripple_db <= df->spec->ripple / 10.0 + LIMIT_RIPPLE_DB && des.atten_db >= df->spec->atten - LIMIT_ATTEN_DB;
+
+        printf("%-14s %5.0f %5.0f-%-6.0f %5.0f-%-6.0f %5.0f-%-6.0f %5.0f-%-6.0f %6.2f %6.1f %s\n", df->name, fs,
+                lat.edge6[0], lat.edge6[1], des.edge6[0], des.edge6[1], lat.edge50[0], lat.edge50[1], des.edge50[0], des.edge50[1],
+                des.ripple_db, des.atten_db, ok ? "ok" : "FAILED");
+        if (ok == false)
+        {
+            failed++;
+        }
+    }
+
+    printf("host time per design: %.1f us\n", time_design * 1e6 / (DESIGN_RUNS * DESIGNED_FILTERS_NUM));
+    printf("%d of %d filters %s\n", failed, (int)DESIGNED_FILTERS_NUM, failed ? "FAILED" : "failed");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,508 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     iq_replay.c                                                     **
+ **  Description:   Offline replay of recorded 48ksps IQ data through the RX audio  **
+ **                 chain of the firmware. Writes the demodulated audio and the     **
+ **                 time spent per audio block / profiled stage.                    **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "uhsdr_board.h"
+#include "profiling.h"
+#include "audio_driver.h"
+#include "audio_filter.h"
+#include "audio_nr.h"
+#include "ui_spectrum.h"
+#include "ui_lcd_hy28.h"
+#include "ui_configuration.h"
+#include "audio_management.h"
+#include "radio_management.h"
+#include "cw_gen.h"
+#include "host_platform.h"
+
+#define REPLAY_SAMPLE_RATE 48000
+#define REPLAY_SWITCH_MAX 8     // filter path changes (-w)
+
+typedef struct
+{
+    const char* name;
+    uint8_t dmod_mode;
+} ReplayMode;
+
+static const ReplayMode replay_modes[] =
+{
+    { "usb", DEMOD_USB },
+    { "lsb", DEMOD_LSB },
+    { "cw",  DEMOD_CW },
+    { "am",  DEMOD_AM },
+    { "sam", DEMOD_SAM },
+    { "fm",  DEMOD_FM },
+    { NULL,  0 }
+};
+
+static const char* profile_event_names[EventProfileMax] =
+{
+    [ProfileAudioInterrupt] = "AudioInterrupt",
+    [ProfileTP1] = "TP1",
+    [ProfileTP2] = "TP2",
+    [ProfileTP3] = "TP3",
+    [ProfileTP4] = "TP4",
+    [ProfileTP5] = "TP5",
+    [ProfileTP6] = "TP6",
+    [ProfileTP7] = "TP7",
+    [ProfileTP8] = "TP8",
+    [ProfileTP9] = "TP9",
+    [ProfileFreeDV] = "FreeDV",
+    [FreeDVTXUnderrun] = "FreeDVTXUnderrun",
+    [ProfileRxFrontEnd] = "RxFrontEnd",
+    [ProfileRxNoiseBlanker] = "RxNoiseBlanker",
+    [ProfileRxDecimation] = "RxDecimation",
+    [ProfileRxHilbert] = "RxHilbert",
+    [ProfileRxDemod] = "RxDemod",
+    [ProfileRxLms] = "RxLms",
+    [ProfileRxFilter] = "RxFilter",
+    [ProfileRxAgc] = "RxAgc",
+    [ProfileRxNoiseReduction] = "RxNoiseReduction",
+    [ProfileRxInterpolation] = "RxInterpolation",
+    [ProfileTxFilter] = "TxFilter",
+    [ProfileTxCompressor] = "TxCompressor",
+    [ProfileTxHilbert] = "TxHilbert",
+    [ProfileTxFreqConversion] = "TxFreqConversion",
+    [ProfileTxIqCorrection] = "TxIqCorrection",
+    [ProfileRxSpectralNr] = "RxSpectralNr",
+};
+
+static void IqReplay_Usage(const char* prog)
+{
+    fprintf(stderr,
+            "usage: %s [options] <iq input> <audio output>\n"
+            "  iq input:      16bit stereo wav or raw file, 48ksps, left = I, right = Q\n"
+            "  audio output:  16bit stereo wav, 48ksps, left = speaker, right = line out\n"
+            "options:\n"
+            "  -m <mode>      usb (default), lsb, cw, am, sam, fm\n"
+            "  -c <conv>      iq frequency conversion 0=off, 1=+6k, 2=-6k, 3=+12k, 4=-12k (default)\n"
+            "  -f <path>      filter path index, default is the first path of the mode\n"
+            "  -l             list the filter paths of the mode and exit\n"
+            "  -n             enable spectral noise reduction\n"
+            "  -r <len>       spectral noise reduction frame length 128, 256 (default) or 512\n"
+            "  -a             enable automatic notch\n"
+            "  -k             use the convolution filter as RX bandpass in ssb, cw and digital modes\n"
+            "  -b <level>     noise blanker setting\n"
+            "  -q <g>:<p>     manual IQ gain and phase balance (menu values), default is automatic IQ correction\n"
+            "  -o <hz>        DSP NCO offset, added to the frequency conversion of -c\n"
+            "  -s <n>         fm tone squelch with entry n of the subaudible tone table (squelch level 1)\n"
+            "  -p <z>:<w>     sam pll step response zeta * 100 and bandwidth omegaN, default 65:250\n"
+            "  -e <sb>        sam sideband 0=both (default), 1=lsb, 2=usb\n"
+            "  -w <path>:<ms> switch to filter path <path> after <ms> ms of input, up to 8 times\n"
+            "  -t <file>      write time spent per audio block in ns as csv\n",
+            prog);
+}
+
+/**
+ * @brief the audio related part of UiDriver_TaskHandler_HighPrioTasks(), run after each audio block
+ */
+static void IqReplay_HighPrioTasks()
+{
+#ifdef USE_ALTERNATE_NR
+    if ((ts.nb_setting > 0 || (ts.dsp_active & DSP_NR_ENABLE)) && (ads.decimation_rate == 4))
+    {
+        alternateNR_handle();
+    }
+#endif
+}
+
+/**
+ * @brief positions the file on the first sample of a 16bit stereo wav file, raw files are left untouched
+ * @returns false if the file is a wav file in a format we cannot replay
+ */
+static bool IqReplay_SkipWavHeader(FILE* f)
+{
+    uint8_t riff[12];
+    bool retval = true;
+
+    if (fread(riff, 1, sizeof(riff), f) != sizeof(riff) || memcmp(riff, "RIFF", 4) != 0 || memcmp(&riff[8], "WAVE", 4) != 0)
+    {
+        rewind(f);
+    }
+    else
+    {
+        uint8_t chunk[8];
+        bool found = false;
+
+        while (retval == true && found == false && fread(chunk, 1, sizeof(chunk), f) == sizeof(chunk))
+        {
+            uint32_t len = chunk[4] | chunk[5] << 8 | chunk[6] << 16 | (uint32_t)chunk[7] << 24;
+
+            if (memcmp(chunk, "fmt ", 4) == 0)
+            {
+                uint8_t fmt[16];
+                if (len < sizeof(fmt) || fread(fmt, 1, sizeof(fmt), f) != sizeof(fmt))
+                {
+                    retval = false;
+                }
+                else
+                {
+                    const uint16_t format   = fmt[0] | fmt[1] << 8;
+                    const uint16_t channels = fmt[2] | fmt[3] << 8;
+                    const uint32_t rate     = fmt[4] | fmt[5] << 8 | fmt[6] << 16 | (uint32_t)fmt[7] << 24;
+                    const uint16_t bits     = fmt[14] | fmt[15] << 8;
+
+                    if (format != 1 || channels != 2 || bits != 16)
+                    {
+                        fprintf(stderr, "only 16bit stereo PCM wav files are supported\n");
+                        retval = false;
+                    }
+                    else if (rate != REPLAY_SAMPLE_RATE)
+                    {
+                        fprintf(stderr, "warning: sample rate is %u, replaying as %u\n", rate, REPLAY_SAMPLE_RATE);
+                    }
+                    fseek(f, (len - sizeof(fmt) + 1) & ~1, SEEK_CUR);
+                }
+            }
+            else if (memcmp(chunk, "data", 4) == 0)
+            {
+                found = true;
+            }
+            else
+            {
+                fseek(f, (len + 1) & ~1, SEEK_CUR);
+            }
+        }
+        retval = retval && found;
+    }
+    return retval;
+}
+
+static void IqReplay_WriteWavHeader(FILE* f, uint32_t frames)
+{
+    const uint32_t data_len = frames * sizeof(AudioSample_t);
+    const uint32_t rate = REPLAY_SAMPLE_RATE;
+    const uint32_t byte_rate = REPLAY_SAMPLE_RATE * sizeof(AudioSample_t);
+    uint8_t hdr[44] =
+    {
+        'R','I','F','F', 0,0,0,0, 'W','A','V','E',
+        'f','m','t',' ', 16,0,0,0, 1,0, 2,0, 0,0,0,0, 0,0,0,0, sizeof(AudioSample_t),0, 16,0,
+        'd','a','t','a', 0,0,0,0
+    };
+
+    for (int i = 0; i < 4; i++)
+    {
+        hdr[4 + i]  = ((data_len + 36) >> (8*i)) & 0xff;
+        hdr[24 + i] = (rate >> (8*i)) & 0xff;
+        hdr[28 + i] = (byte_rate >> (8*i)) & 0xff;
+        hdr[40 + i] = (data_len >> (8*i)) & 0xff;
+    }
+    fwrite(hdr, 1, sizeof(hdr), f);
+}
+
+int main(int argc, char* argv[])
+{
+    uint8_t dmod_mode = DEMOD_USB;
+    uint8_t iq_freq_mode = FREQ_IQ_CONV_MODE_DEFAULT;
+    uint8_t dsp_active = 0;
+    uint8_t nb_setting = 0;
+    int nr_fft_l = NR_FFT_L_DEFAULT;
+    bool conv_filter = false;
+    int filter_path = -1;
+    bool list_paths = false;
+    const char* timing_name = NULL;
+    bool iq_manual = false;
+    int iq_gain_balance = 0;
+    int iq_phase_balance = 0;
+    int32_t rx_nco_offset = 0;
+    int tone_det_select = 0;
+    int sam_zeta = -1;
+    int sam_omegaN = -1;
+    int sam_sideband = SAM_SIDEBAND_BOTH;
+    int switch_path[REPLAY_SWITCH_MAX];
+    int switch_ms[REPLAY_SWITCH_MAX];
+    int switch_num = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "m:c:f:lnr:akb:q:o:s:p:e:w:t:h")) != -1)
+    {
+        switch(opt)
+        {
+        case 'm':
+        {
+            const ReplayMode* m;
+            for (m = replay_modes; m->name != NULL && strcmp(m->name, optarg) != 0; m++);
+            if (m->name == NULL)
+            {
+                fprintf(stderr, "unknown mode %s\n", optarg);
+                return 1;
+            }
+            dmod_mode = m->dmod_mode;
+            break;
+        }
+        case 'c':
+            iq_freq_mode = atoi(optarg);
+            break;
+        case 'f':
+            filter_path = atoi(optarg);
+            break;
+        case 'l':
+            list_paths = true;
+            break;
+        case 'n':
+            dsp_active |= DSP_NR_ENABLE;
+            break;
+        case 'r':
+            nr_fft_l = atoi(optarg);
+            break;
+        case 'a':
+            dsp_active |= DSP_NOTCH_ENABLE;
+            break;
+        case 'k':
+            conv_filter = true;
+            break;
+        case 'b':
+            nb_setting = atoi(optarg);
+            break;
+        case 'q':
+            if (sscanf(optarg, "%d:%d", &iq_gain_balance, &iq_phase_balance) != 2)
+            {
+                IqReplay_Usage(argv[0]);
+                return 1;
+            }
+            iq_manual = true;
+            break;
+        case 'o':
+            rx_nco_offset = atoi(optarg);
+            break;
+        case 's':
+            tone_det_select = atoi(optarg);
+            break;
+        case 'p':
+            if (sscanf(optarg, "%d:%d", &sam_zeta, &sam_omegaN) != 2)
+            {
+                IqReplay_Usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'e':
+            sam_sideband = atoi(optarg);
+            break;
+        case 'w':
+            if (switch_num == REPLAY_SWITCH_MAX || sscanf(optarg, "%d:%d", &switch_path[switch_num], &switch_ms[switch_num]) != 2
+                    || switch_path[switch_num] <= 0 || switch_path[switch_num] >= AUDIO_FILTER_PATH_NUM
+                    || (switch_num > 0 && switch_ms[switch_num] < switch_ms[switch_num - 1]))
+            {
+                IqReplay_Usage(argv[0]);
+                return 1;
+            }
+            switch_num++;
+            break;
+        case 't':
+            timing_name = optarg;
+            break;
+        default:
+            IqReplay_Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (list_paths == true)
+    {
+        const uint16_t filter_mode = AudioFilter_GetFilterModeFromDemodMode(dmod_mode);
+        for (int idx = 1; idx < AUDIO_FILTER_PATH_NUM; idx++)
+        {
+            if (AudioFilter_IsApplicableFilterPath(PATH_ALL_APPLICABLE, filter_mode, idx))
+            {
+                const char* filter_names[2];
+                AudioFilter_GetNamesOfFilterPath(idx, filter_names);
+                printf("%2d: %s %s\n", idx, filter_names[0], filter_names[1]);
+            }
+        }
+        return 0;
+    }
+
+    if (argc - optind != 2 || iq_freq_mode > FREQ_IQ_CONV_M12KHZ || filter_path >= AUDIO_FILTER_PATH_NUM
+            || (nr_fft_l != 128 && nr_fft_l != 256 && nr_fft_l != 512)
+            || tone_det_select < 0 || tone_det_select >= NUM_SUBAUDIBLE_TONES
+            || sam_sideband < SAM_SIDEBAND_BOTH || sam_sideband > SAM_SIDEBAND_USB)
+    {
+        IqReplay_Usage(argv[0]);
+        return 1;
+    }
+
+    FILE* in = fopen(argv[optind], "rb");
+    FILE* out = fopen(argv[optind + 1], "wb");
+    FILE* timing = timing_name != NULL ? fopen(timing_name, "w") : NULL;
+
+    if (in == NULL || out == NULL || (timing_name != NULL && timing == NULL))
+    {
+        perror("cannot open file");
+        return 1;
+    }
+    if (IqReplay_SkipWavHeader(in) == false)
+    {
+        return 1;
+    }
+
+    HostPlatform_TransceiverStateInit();
+    AudioFilter_SetDefaultMemories();
+
+    profileTimedEventInit();
+    AudioDriver_Init();
+
+    ts.dmod_mode = dmod_mode;
+    ts.iq_freq_mode = iq_freq_mode;
+    ts.dsp_active = dsp_active;
+    ts.NR_FFT_L = nr_fft_l;
+    ts.nb_setting = nb_setting;
+    if (conv_filter)
+    {
+        ts.flags2 |= FLAGS2_RX_CONV_FILTER;
+    }
+    if (nb_setting > 0)
+    {
+        ts.dsp_active |= DSP_NB_ENABLE;
+    }
+    ts.rx_nco_offset = rx_nco_offset;
+    if (tone_det_select > 0)
+    {
+        ts.fm_subaudible_tone_det_select = tone_det_select;
+        ts.fm_sql_threshold = 1;
+        AudioManagement_CalcSubaudibleDetFreq();
+    }
+    if (sam_zeta >= 0)
+    {
+        ads.zeta_int = sam_zeta;
+        ads.omegaN_int = sam_omegaN;
+    }
+    ads.sam_sideband = sam_sideband;
+    if (iq_manual)
+    {
+        ts.iq_auto_correction = 0;
+        for (int band = IQ_80M; band <= IQ_10M; band++)
+        {
+            ts.rx_iq_gain_balance[band].value[IQ_TRANS_ON] = iq_gain_balance;
+            ts.rx_iq_phase_balance[band].value[IQ_TRANS_ON] = iq_phase_balance;
+        }
+        AudioManagement_CalcIqPhaseGainAdjust(7000000);
+    }
+    if (filter_path > 0)
+    {
+        ts.filter_path_mem[AudioFilter_GetFilterModeFromDemodMode(dmod_mode)][0] = filter_path;
+    }
+    AudioDriver_SetRxAudioProcessing(dmod_mode, true);
+
+    const char* filter_names[2];
+    AudioFilter_GetNamesOfFilterPath(ts.filter_path, filter_names);
+    fprintf(stderr, "filter path %d: %s %s, decimation %u\n", ts.filter_path, filter_names[0], filter_names[1], ads.decimation_rate);
+
+    for (int pe = 0; pe < EventProfileMax; pe++)
+    {
+        profileTimedEventReset(pe);
+    }
+    eventProfile.audio_deadline_missed = 0;
+
+    IqReplay_WriteWavHeader(out, 0);
+    if (timing != NULL)
+    {
+        fprintf(timing, "block,ns\n");
+    }
+
+    // the time budget of one audio block in ns
+    const double block_period = 1e9 * IQ_BLOCK_SIZE / REPLAY_SAMPLE_RATE;
+
+    AudioSample_t iq[IQ_BLOCK_SIZE];
+    AudioSample_t audio[IQ_BLOCK_SIZE];
+    AudioSample_t audio_tx[IQ_BLOCK_SIZE];
+    uint32_t blocks = 0;
+    int switch_idx = 0;
+    uint32_t block_max = 0;
+    uint32_t block_min = UINT32_MAX;
+    double worker_done = 0; // time at which the audio worker of the firmware would finish its last block
+    size_t frames;
+
+    while ((frames = fread(iq, sizeof(AudioSample_t), IQ_BLOCK_SIZE, in)) > 0)
+    {
+        memset(&iq[frames], 0, (IQ_BLOCK_SIZE - frames) * sizeof(AudioSample_t));
+
+        while (switch_idx < switch_num && blocks == (uint32_t)switch_ms[switch_idx] * REPLAY_SAMPLE_RATE / 1000 / IQ_BLOCK_SIZE)
+        {
+            // as the filter selection of the radio does it, between two audio blocks
+            ts.filter_path_mem[AudioFilter_GetFilterModeFromDemodMode(dmod_mode)][0] = switch_path[switch_idx++];
+            AudioDriver_SetRxAudioProcessing(dmod_mode, false);
+            AudioFilter_GetNamesOfFilterPath(ts.filter_path, filter_names);
+            fprintf(stderr, "block %u: filter path %d: %s %s, decimation %u\n", blocks, ts.filter_path, filter_names[0], filter_names[1], ads.decimation_rate);
+        }
+
+        profileTimedEventStart(ProfileAudioInterrupt);
+        AudioDriver_I2SCallback((int16_t*)iq, (int16_t*)audio, (int16_t*)audio_tx, 2 * IQ_BLOCK_SIZE);
+        profileTimedEventStop(ProfileAudioInterrupt);
+
+        const ProfilingTimedEvent* ev = profileTimedEventGet(ProfileAudioInterrupt);
+        const uint32_t duration = ev->stop - ev->start;
+        block_max = duration > block_max ? duration : block_max;
+        block_min = duration < block_min ? duration : block_min;
+        // on the radio the worker starts a block when it arrives and the previous one is done,
+        // the DMA needs the result AUDIO_BLOCK_NUM blocks after its arrival
+        const double block_arrival = blocks * block_period;
+        const double block_deadline = block_arrival + AUDIO_BLOCK_NUM * block_period;
+        worker_done = (worker_done > block_arrival ? worker_done : block_arrival) + duration;
+        if (worker_done > block_deadline)
+        {
+            eventProfile.audio_deadline_missed++;
+            worker_done = block_deadline;
+        }
+
+        if (timing != NULL)
+        {
+            fprintf(timing, "%u,%u\n", blocks, duration);
+        }
+
+        IqReplay_HighPrioTasks();
+
+        fwrite(audio, sizeof(AudioSample_t), IQ_BLOCK_SIZE, out);
+        blocks++;
+    }
+
+    rewind(out);
+    IqReplay_WriteWavHeader(out, blocks * IQ_BLOCK_SIZE);
+    fclose(out);
+    fclose(in);
+    if (timing != NULL)
+    {
+        fclose(timing);
+    }
+
+    fprintf(stderr, "%u blocks of %u samples, block min %u ns max %u ns (budget %.0f ns), %u deadlines missed\n",
+            blocks, IQ_BLOCK_SIZE, block_min, block_max, block_period, eventProfile.audio_deadline_missed);
+    if (dmod_mode == DEMOD_SAM)
+    {
+        fprintf(stderr, "sam carrier offset %d Hz\n", ads.carrier_freq_offset);
+    }
+    fprintf(stderr, "%-20s %10s %12s %10s %10s %10s %8s\n", "event", "count", "avg ns", "min ns", "p99 ns", "max ns", "load %");
+    for (int pe = 0; pe < EventProfileMax; pe++)
+    {
+        const ProfilingTimedEvent* ev = profileTimedEventGet(pe);
+        if (ev->count != 0)
+        {
+            // only the audio stages have a histogram for the percentile
+            char p99[12] = "-";
+            if (profileTimedEventHistogram(pe) != NULL)
+            {
+                snprintf(p99, sizeof(p99), "%u", profileTimedEventPercentile(pe, 990));
+            }
+            fprintf(stderr, "%-20s %10u %12.0f %10u %10s %10u %8.2f\n", profile_event_names[pe], ev->count,
+                    (double)ev->duration / ev->count, ev->min, p99, ev->max,
+                    100.0 * ev->duration / (blocks * block_period));
+        }
+    }
+
+    return 0;
+}
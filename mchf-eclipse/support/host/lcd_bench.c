@@ -0,0 +1,265 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     lcd_bench.c                                                     **
+ **  Description:   Draw cost of the display driver, the compositor and the         **
+ **                 spectrum for each screen layout on the virtual display          **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+
+#include "uhsdr_board.h"
+#include "audio_driver.h"
+#include "radio_management.h"
+#include "ui_lcd_hy28.h"
+#include "ui_lcd_layouts.h"
+#include "ui_compositor.h"
+#include "ui_spectrum.h"
+#include "ui_menu.h"
+#include "ui_configuration.h"
+#include "ui_driver.h"
+#include "ui_vkeybrd.h"
+#include "host_platform.h"
+#include "host_display.h"
+
+#define BENCH_FREQ          14074000
+#define BENCH_WARMUP        50          // spectrum frames until the display AGC settled
+#define BENCH_FRAMES        100
+
+typedef struct
+{
+    HostDisplay_Controller controller;
+    const char* name;
+    const char* ppm;
+} BenchDisplay;
+
+static const BenchDisplay bench_displays[] =
+{
+    { HOST_DISPLAY_ILI932X, "ILI932x", "lcd_bench_320x240.ppm" },
+    { HOST_DISPLAY_ILI9486, "ILI9486", "lcd_bench_480x320.ppm" },
+};
+
+static struct timespec bench_start;
+
+static void Bench_Start()
+{
+    HostDisplay_CountersReset();
+    clock_gettime(CLOCK_MONOTONIC, &bench_start);
+}
+
+/**
+ * @brief prints what was sent since Bench_Start(), divided by the number of runs
+ */
+static void Bench_Report(const char* name, int runs)
+{
+    struct timespec end;
+    HostDisplay_Counters cnt;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    HostDisplay_CountersGet(&cnt);
+
+    const double host_us = ((end.tv_sec - bench_start.tv_sec) * 1e9 + (end.tv_nsec - bench_start.tv_nsec)) / 1e3;
+
+    printf("%-28s %8.1f %8.1f %9.0f %10.0f %9.0f %10.0f %9.0f %9.1f\n", name,
+            (double)cnt.index_writes / runs, (double)cnt.windows / runs, (double)cnt.pixels / runs,
+            (double)cnt.fsmc_bytes / runs, HostDisplay_FsmcTimeUs(&cnt) / runs,
+            (double)cnt.spi_bytes / runs, HostDisplay_SpiTimeUs(&cnt) / runs, host_us / runs);
+}
+
+/**
+ * @brief tunes to a new dial frequency the way the main loop does and draws the frequency display
+ */
+static void Bench_Tune(uint32_t freq, bool full_update)
+{
+    df.tune_new = freq * TUNE_MULT;
+    UiDriver_FrequencyUpdateLOandDisplay(full_update);
+    UiCompositor_Flush(UI_COMPOSITOR_FRAME_BUDGET);
+}
+
+/**
+ * @brief text for the text message line, as a decoder sends it
+ */
+static void Bench_TextMsg(const char* text)
+{
+    for (const char* ch = text; *ch != '\0'; ch++)
+    {
+        UiDriver_TextMsgPutChar(*ch);
+    }
+    UiDriver_TextMsgDisplay();
+    UiCompositor_Flush(UI_COMPOSITOR_FRAME_BUDGET);
+}
+
+/**
+ * @brief a new block of IQ data for the spectrum: noise and a few carriers, one of them drifting
+ */
+static void Bench_SpectrumInput(int frame)
+{
+    static uint32_t rnd = 4711;
+    const float32_t carriers[] = { 0.05, -0.11, 0.2 + 0.001 * (frame % 100), -0.3 };
+
+    for (uint32_t idx = 0; idx < sd.fft_iq_len / 2; idx++)
+    {
+        float32_t i = 0, q = 0;
+        for (int c = 0; c < sizeof(carriers) / sizeof(carriers[0]); c++)
+        {
+            i += 1000 * cosf(2 * PI * carriers[c] * idx);
+            q += 1000 * sinf(2 * PI * carriers[c] * idx);
+        }
+        rnd = rnd * 1103515245 + 12345;
+        i += (float32_t)((rnd >> 16) & 0xff) - 128;
+        rnd = rnd * 1103515245 + 12345;
+        q += (float32_t)((rnd >> 16) & 0xff) - 128;
+        // the audio driver stores Q first
+        sd.FFT_RingBuffer[2 * idx] = q;
+        sd.FFT_RingBuffer[2 * idx + 1] = i;
+    }
+    sd.samp_ptr = 0;
+}
+
+/**
+ * @brief one update of scope and waterfall, i.e. the state machine of UiSpectrum_Redraw() once through
+ */
+static void Bench_SpectrumFrame(int frame)
+{
+    Bench_SpectrumInput(frame);
+    ts.scope_scheduler = 0;
+    ts.waterfall.scheduler = 0;
+    do
+    {
+        UiSpectrum_Redraw();
+    } while (sd.state != 0);
+}
+
+/**
+ * @brief the spectrum related settings of TransceiverStateInit()
+ */
+static void Bench_SpectrumStateInit()
+{
+    ts.flags1 |= FLAGS1_WFALL_ENABLED | FLAGS1_SCOPE_ENABLED;
+    ts.spectrum_filter = SPECTRUM_FILTER_DEFAULT;
+    ts.spectrum_centre_line_colour = SPEC_COLOUR_GRID_DEFAULT;
+    ts.spectrum_freqscale_colour = SPEC_COLOUR_SCALE_DEFAULT;
+    ts.spectrum_db_scale = DB_DIV_10;
+    ts.spectrum_size = SPECTRUM_SIZE_DEFAULT;
+    ts.spectrum_agc_rate = SPECTRUM_SCOPE_AGC_DEFAULT;
+    ts.scope_trace_colour = SPEC_COLOUR_TRACE_DEFAULT;
+    ts.scope_trace_BW_colour = SPEC_COLOUR_TRACEBW_DEFAULT;
+    ts.scope_backgr_BW_colour = SPEC_COLOUR_BACKGRBW_DEFAULT;
+    ts.scope_grid_colour = SPEC_COLOUR_GRID_DEFAULT;
+    ts.scope_speed = SPECTRUM_SCOPE_SPEED_DEFAULT;
+    ts.waterfall.speed = WATERFALL_SPEED_DEFAULT;
+    ts.waterfall.color_scheme = WATERFALL_COLOR_DEFAULT;
+    ts.waterfall.vert_step_size = WATERFALL_STEP_SIZE_DEFAULT;
+    ts.waterfall.contrast = WATERFALL_CONTRAST_DEFAULT;
+    ts.filter_disp_colour = FILTER_DISP_COLOUR_DEFAULT;
+    // set by the audio driver from the codec gain, the spectrum divides by it
+    ads.codec_gain_calc = 1;
+}
+
+static void Bench_Display(const BenchDisplay* bd)
+{
+    HostDisplay_Select(bd->controller);
+    if (UiLcdHy28_Init() == DISPLAY_NONE)
+    {
+        printf("%s: display not detected\n", bd->name);
+        return;
+    }
+
+    printf("\n%s %ux%u\n", bd->name, ts.Layout->Size.x, ts.Layout->Size.y);
+    printf("%-28s %8s %8s %9s %10s %9s %10s %9s %9s\n", "operation", "index", "windows", "pixels",
+            "FSMC bytes", "FSMC us", "SPI bytes", "SPI us", "host us");
+
+    Bench_Start();
+    UiLcdHy28_LcdClear(Black);
+    Bench_Report("clear screen", 1);
+
+    UiCompositor_Reset();
+
+    Bench_Start();
+    Bench_Tune(BENCH_FREQ, true);
+    Bench_Report("frequency, full update", 1);
+
+    Bench_Start();
+    Bench_Tune(BENCH_FREQ + 10, false);
+    Bench_Report("tune 10Hz", 1);
+
+    Bench_Start();
+    for (uint32_t step = 1; step <= 100; step++)
+    {
+        Bench_Tune(BENCH_FREQ + 10 + step * 10, false);
+    }
+    Bench_Report("tune 100 x 10Hz, per step", 100);
+    Bench_Tune(BENCH_FREQ, false);
+
+    UiDriver_TextMsgClear();
+    UiCompositor_Flush(UI_COMPOSITOR_FRAME_BUDGET);
+
+    Bench_Start();
+    Bench_TextMsg("CQ CQ DE DB4PLE DB4PLE K ... UHSDR HOST BENCH ...........");
+    Bench_Report("text line", 1);
+
+    Bench_Start();
+    Bench_TextMsg("K");
+    Bench_Report("text line, one more char", 1);
+
+    Bench_SpectrumStateInit();
+    Bench_Start();
+    UiSpectrum_Init();
+    Bench_Report("spectrum init", 1);
+
+    for (int frame = 0; frame < BENCH_WARMUP; frame++)
+    {
+        Bench_SpectrumFrame(frame);
+    }
+    Bench_Start();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++)
+    {
+        Bench_SpectrumFrame(BENCH_WARMUP + frame);
+    }
+    Bench_Report("scope + waterfall frame", BENCH_FRAMES);
+
+    if (HostDisplay_WritePpm(bd->ppm) == false)
+    {
+        printf("could not write %s\n", bd->ppm);
+    }
+
+    // the first frame after switching draws all lines, the others only the new line
+    ts.flags2 |= FLAGS2_WFALL_WIPE;
+    Bench_SpectrumFrame(BENCH_WARMUP + BENCH_FRAMES);
+    Bench_Start();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++)
+    {
+        Bench_SpectrumFrame(BENCH_WARMUP + BENCH_FRAMES + 1 + frame);
+    }
+    Bench_Report("scope + waterfall, wipe mode", BENCH_FRAMES);
+
+    Bench_Tune(BENCH_FREQ + 1000, false);
+    Bench_Start();
+    Bench_SpectrumFrame(BENCH_WARMUP + 2 * BENCH_FRAMES + 1);
+    Bench_Report("wipe mode, tuned 1kHz", 1);
+    Bench_Tune(BENCH_FREQ, false);
+    ts.flags2 &= ~FLAGS2_WFALL_WIPE;
+}
+
+int main(int argc, char* argv[])
+{
+    HostPlatform_TransceiverStateInit();
+
+    printf("Display bus cost per operation, FSMC and SPI numbers are for the same drawing\n");
+    printf("FSMC us: bus time with the timing of fsmc.c, SPI us: SPI display of the same controller\n");
+    printf("host us: workstation time of the drawing code, only useful for comparisons\n");
+
+    for (int idx = 0; idx < sizeof(bench_displays) / sizeof(bench_displays[0]); idx++)
+    {
+        Bench_Display(&bench_displays[idx]);
+    }
+    return 0;
+}
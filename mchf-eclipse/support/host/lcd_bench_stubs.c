@@ -0,0 +1,182 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     lcd_bench_stubs.c                                               **
+ **  Description:   The radio below the ui driver for the host build of lcd_bench   **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+// lcd_bench links the real ui driver, menu and radio management. Everything they call which
+// talks to hardware other than the display is replaced here: the oscillator accepts every
+// frequency, the codec, CAT, keyboard, configuration storage and the RTC do nothing.
+
+#include "uhsdr_board.h"
+#include "adc.h"
+#include "codec.h"
+#include "uhsdr_hw_i2s.h"
+#include "uhsdr_hw_i2c.h"
+#include "uhsdr_rtc.h"
+#include "cat_driver.h"
+#include "config_storage.h"
+#include "serial_eeprom.h"
+#include "ui_rotary.h"
+#include "osc_interface.h"
+#include "osc_si570.h"
+#include "osc_si5351a.h"
+#include "soft_tcxo.h"
+#include "usb_host.h"
+#include "usbh_core.h"
+#include "usbh_hid_keybd.h"
+
+// the local oscillator
+static void HostOsc_Init() { }
+static bool HostOsc_IsPresent() { return true; }
+static void HostOsc_SetPPM(float32_t ppm) { }
+static Oscillator_ResultCodes_t HostOsc_PrepareNextFrequency(ulong freq, int temp_factor) { return OSC_OK; }
+static Oscillator_ResultCodes_t HostOsc_ChangeToNextFrequency() { return OSC_OK; }
+static bool HostOsc_IsNextStepLarge() { return false; }
+
+static const OscillatorInterface_t host_osc =
+{
+    .init = HostOsc_Init,
+    .isPresent = HostOsc_IsPresent,
+    .setPPM = HostOsc_SetPPM,
+    .prepareNextFrequency = HostOsc_PrepareNextFrequency,
+    .changeToNextFrequency = HostOsc_ChangeToNextFrequency,
+    .isNextStepLarge = HostOsc_IsNextStepLarge,
+};
+
+const OscillatorInterface_t *osc = &host_osc;
+
+bool Si570_IsPresent() { return false; }
+uint8_t Si570_GetI2CAddress() { return 0; }
+float32_t Si570_GetStartupFrequency() { return 0; }
+bool Si5351a_IsPresent() { return false; }
+
+LoTcxo lo;
+
+bool SoftTcxo_HandleLoTemperatureDrift() { return false; }
+
+// the board
+void Board_HandlePowerDown() { }
+void Board_PostInit() { }
+void Board_Powerdown() { }
+void Board_Reboot() { }
+void Board_SelectLpfBpf(uint8_t group) { }
+void mchf_hw_i2c1_init() { }
+void mchf_hw_i2c2_init() { }
+
+ADC_HandleTypeDef hadc1;
+ADC_HandleTypeDef hadc2;
+ADC_HandleTypeDef hadc3;
+DAC_HandleTypeDef hdac;
+RTC_HandleTypeDef hrtc;
+
+uint32_t HAL_ADC_GetValue(ADC_HandleTypeDef* hadc)
+{
+    return 0;
+}
+
+HAL_StatusTypeDef HAL_DAC_SetValue(DAC_HandleTypeDef* hdac, uint32_t Channel, uint32_t Alignment, uint32_t Data)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_SetTime(RTC_HandleTypeDef *hrtc, RTC_TimeTypeDef *sTime, uint32_t Format)
+{
+    return HAL_OK;
+}
+
+void MchfRtc_FullReset() { }
+void MchfRtc_Start() { }
+bool MchfRtc_SetPpm(int16_t ppm) { return false; }
+
+void MchfRtc_GetTime(RTC_HandleTypeDef *hrtc, RTC_TimeTypeDef *sTime, uint32_t Format)
+{
+    memset(sTime, 0, sizeof(*sTime));
+}
+
+int UiDriverEncoderRead(const uint32_t encId)
+{
+    return 0;
+}
+
+// the codec
+void Codec_IQInGainAdj(uint8_t gain) { }
+void Codec_LineInGainAdj(uint8_t gain) { }
+void Codec_MuteDAC(bool state) { }
+void Codec_PrepareTx(uint8_t current_txrx_mode) { }
+void Codec_SwitchMicTxRxMode(uint8_t mode) { }
+void Codec_SwitchTxRxMode(uint8_t txrx_mode) { }
+void Codec_TxSidetoneSetgain(uint8_t mode) { }
+void Codec_VolumeLineOut(uint8_t txrx_mode) { }
+void Codec_VolumeSpkr(uint8_t vol) { }
+
+uint32_t UhsdrHwI2s_GetBlockCycles()
+{
+    return 0;
+}
+
+// CAT and the USB keyboard
+void CatDriver_HandleProtocol() { }
+bool CatDriver_CloneInStart() { return false; }
+bool CatDriver_CloneOutStart() { return false; }
+
+USBH_HandleTypeDef hUsbHostHS;
+
+void MX_USB_HOST_Process(void) { }
+
+HID_TypeTypeDef USBH_HID_GetDeviceType(USBH_HandleTypeDef *phost)
+{
+    return HID_UNKNOWN;
+}
+
+HID_KEYBD_Info_TypeDef *USBH_HID_GetKeybdInfo(USBH_HandleTypeDef *phost)
+{
+    return NULL;
+}
+
+uint8_t USBH_HID_GetASCIICode(HID_KEYBD_Info_TypeDef *info)
+{
+    return 0;
+}
+
+// the configuration storage, nothing is stored
+const SerialEEPROM_EEPROMTypeDescriptor SerialEEPROM_eepromTypeDescs[SERIAL_EEPROM_DESC_NUM];
+
+bool SerialEEPROM_24xx_Exists() { return false; }
+void SerialEEPROM_Clear_Signature() { }
+
+uint16_t ConfigStorage_ReadVariable(uint16_t addr, uint16_t *value)
+{
+    return 1;
+}
+
+uint16_t ConfigStorage_WriteVariable(uint16_t addr, uint16_t value)
+{
+    return 0;
+}
+
+void ConfigStorage_CopyFlash2Serial(void) { }
+void ConfigStorage_CopySerial2Flash(void) { }
+void ConfigStorage_CopySerial2RAMCache() { }
+
+uint16_t ConfigStorage_CopyRAMCache2Serial()
+{
+    return 0;
+}
+
+uint16_t ConfigStorage_CopyArray2Serial(uint32_t Addr, const uint8_t *buffer, uint16_t length)
+{
+    return 0;
+}
+
+void ConfigStorage_CopySerial2Array(uint32_t Addr, uint8_t *buffer, uint16_t length)
+{
+    memset(buffer, 0, length);
+}
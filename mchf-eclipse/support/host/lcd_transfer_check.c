@@ -0,0 +1,145 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     lcd_transfer_check.c                                            **
+ **  Description:   Checks the display transfer queue of ui_lcd_hy28.c with the     **
+ **                 DMA of the virtual display                                      **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+// The same screen is drawn without DMA, i.e. the driver sends every pixel itself, and with the DMA of
+// the virtual display at different speeds. The screens have to be identical. A slow DMA fills the
+// job queue and takes all pixel buffers, i.e. the driver has to wait for both, and thousands of jobs
+// and buffers go around both rings.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "uhsdr_board.h"
+#include "ui_lcd_hy28.h"
+#include "host_display.h"
+
+#define CHECK_FONTS         6           // font numbers of the display driver
+#define CHECK_RUNS          20          // the screen is drawn this often per DMA speed
+
+static int failed;
+
+#define CHECK(cond) do { if (!(cond)) { printf("  FAILED line %d: %s\n", __LINE__, #cond); failed++; } } while(0)
+
+static uint16_t reference[480 * 320];
+
+/**
+ * @brief a screen with all kinds of transfers: large and odd sized fills, many small characters, lines and bulk pixels
+ */
+static void Check_Draw(int run)
+{
+    uint16_t pixel[700];
+    char text[64];
+
+    UiLcdHy28_LcdClear(run % 2 ? Blue : Black);
+    UiLcdHy28_DrawFullRect(3, 5, 23, 37, Red);          // 851 pixels, a full and a partial buffer
+    UiLcdHy28_DrawFullRect(100, 40, 100, 200, Green);   // a multiple of the buffer size plus a rest
+    UiLcdHy28_DrawFullRect(0, 0, 1, 1, White);
+    UiLcdHy28_DrawEmptyRect(50, 60, 30, 40, Yellow);
+    UiLcdHy28_DrawStraightLine(10, 200, 150, LCD_DIR_HORIZONTAL, Cyan);
+    UiLcdHy28_DrawStraightLine(5, 10, 180, LCD_DIR_VERTICAL, Magenta);
+
+    for (int font = 0; font < CHECK_FONTS; font++)
+    {
+        snprintf(text, sizeof(text), "%d: 14.074.%03d kHz", font, run);
+        UiLcdHy28_PrintText(20, 30 + font * 25, text, White, run % 2 ? Blue : Black, font);
+    }
+
+    // pixel data of different lengths, the buffer is reused right after each call
+    UiLcdHy28_BulkPixel_OpenWrite(200, 100, 220, 50);
+    for (uint32_t len = 1, sent = 0; sent < 100 * 50; sent += len, len = len * 3 % 701 + 1)
+    {
+        if (len > 100 * 50 - sent)
+        {
+            len = 100 * 50 - sent;
+        }
+        for (uint32_t idx = 0; idx < len; idx++)
+        {
+            pixel[idx] = (sent + idx) * 37 + run;
+        }
+        UiLcdHy28_BulkPixel_PutBuffer(pixel, len);
+    }
+    UiLcdHy28_BulkPixel_CloseWrite();
+
+    UiLcdHy28_BulkPixel_OpenWrite(300, 17, 10, 13);
+    for (uint32_t idx = 0; idx < 17 * 13; idx++)
+    {
+        UiLcdHy28_BulkPixel_Put(idx * 101 + run);
+    }
+    UiLcdHy28_BulkPixel_CloseWrite();
+}
+
+/**
+ * @brief draws the screens with a DMA of the given speed, 0 without DMA, and returns the last screen
+ */
+static const uint16_t* Check_Run(HostDisplay_Controller controller, uint32_t dma_delay, HostDisplay_Counters* cnt, HostDisplay_DmaStats* stats)
+{
+    uint16_t width, height;
+
+    HostDisplay_Select(controller);
+    HostDisplay_DmaSelect(dma_delay);
+    CHECK(UiLcdHy28_Init() != DISPLAY_NONE);
+
+    HostDisplay_CountersReset();
+    for (int run = 0; run < CHECK_RUNS; run++)
+    {
+        Check_Draw(run);
+    }
+    HostDisplay_DmaDrain();
+
+    HostDisplay_CountersGet(cnt);
+    HostDisplay_DmaStatsGet(stats);
+    return HostDisplay_Framebuffer(&width, &height);
+}
+
+static void Check_Controller(HostDisplay_Controller controller, const char* name)
+{
+    static const uint32_t dma_delays[] = { 1, 2, 5, 40 };
+    HostDisplay_Counters ref_cnt, cnt;
+    HostDisplay_DmaStats stats;
+
+    const uint16_t* screen = Check_Run(controller, 0, &ref_cnt, &stats);
+    CHECK(stats.transfers == 0);
+    memcpy(reference, screen, sizeof(reference));
+
+    for (int idx = 0; idx < sizeof(dma_delays) / sizeof(dma_delays[0]); idx++)
+    {
+        screen = Check_Run(controller, dma_delays[idx], &cnt, &stats);
+
+        printf("%s DMA delay %2u: %6u transfers, jobs max %u, job queue full %6u, free buffers min %u\n", name,
+                dma_delays[idx], stats.transfers, stats.jobs_max, stats.jobs_full, stats.free_min);
+
+        CHECK(memcmp(screen, reference, sizeof(reference)) == 0);
+        CHECK(cnt.pixels == ref_cnt.pixels);
+        CHECK(cnt.windows == ref_cnt.windows);
+        CHECK(stats.errors == 0);
+        // the pixel buffers and the jobs went around their rings many times
+        CHECK(stats.transfers > 100 * 8);
+        if (dma_delays[idx] >= 5)
+        {
+            // the driver had to wait for a free buffer and for room in the job queue
+            CHECK(stats.free_min == 0);
+            CHECK(stats.jobs_full > 0);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Check_Controller(HOST_DISPLAY_ILI932X, "ILI932x");
+    Check_Controller(HOST_DISPLAY_ILI9486, "ILI9486");
+
+    printf("%d transfer checks %s\n", failed, failed ? "FAILED" : "failed");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,283 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     nr_bench.c                                                      **
+ **  Description:   Quality and speed of the spectral noise reduction for all       **
+ **                 frame lengths and both NR sample rates                          **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "uhsdr_board.h"
+#include "audio_driver.h"
+#include "audio_filter.h"
+#include "audio_nr.h"
+
+#define BENCH_SECONDS       12      // length of the test signal
+#define BENCH_SKIP_SECONDS  2       // not evaluated, the noise estimate settles
+#define BENCH_RUNS          5       // the signal is processed this often
+#define BENCH_BATCH         64      // calls timed together, the fastest batch is reported
+#define BENCH_MAX_DELAY     2048    // samples searched for the delay of the NR
+#define BENCH_SNR_DB        6.0     // speech to noise ratio of the input, both in the filter passband
+
+// the test signal: "syllables" of a harmonic tone with a gliding pitch, separated by pauses,
+// plus stationary noise limited to the filter passband as it arrives from the audio filter
+#define SYLLABLE_MS         280
+#define PAUSE_MS            170
+#define NOISE_LINES         2000    // random phase sinusoids making up the noise
+
+typedef struct
+{
+    const char* name;
+    float32_t sample_rate;
+    bool decimation;        // ts.NR_decimation_enable
+    uint8_t filter_id;      // the LPF path of this SSB filter is used, its width decides about the NR sample rate
+} BenchRate;
+
+static const BenchRate bench_rates[] =
+{
+    { "2.7k LPF,  6ksps", 6000, true, AUDIO_2P7KHZ },
+    { "2.9k LPF, 12ksps", 12000, true, AUDIO_2P9KHZ },
+};
+
+static const uint16_t bench_fft_l[] = { 128, 256, 512 };
+
+typedef struct
+{
+    double block_ns;        // average time of a NR_FFT_SIZE block in the fastest batch
+    int delay;              // in samples
+    double snr_in_db;
+    double snr_out_db;      // the scaled clean signal counts as signal, everything else as noise
+    double speech_db;       // level change of the speech
+    double pause_db;        // level change of the noise in the pauses
+} BenchResult;
+
+static double Bench_Now()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+/**
+ * @returns a uniformly distributed random number 0...1, reproducible for every run
+ */
+static double Bench_Random(uint32_t* state)
+{
+    *state = *state * 1664525 + 1013904223;
+    return (*state >> 8) / 16777216.0;
+}
+
+static int Bench_FindFilterPath(uint8_t filter_id)
+{
+    int retval = -1;
+    for (int idx = 1; retval == -1 && idx < AUDIO_FILTER_PATH_NUM; idx++)
+    {
+        if (FilterPathInfo[idx].id == filter_id && FilterPathInfo[idx].filter_select_id == 1
+                && (FilterPathInfo[idx].mode & (1 << FILTER_MODE_SSB)) != 0)
+        {
+            retval = idx;
+        }
+    }
+    return retval;
+}
+
+/**
+ * @brief fills speech with the clean signal, noise with the noise, both with the given power, voiced marks the syllables
+ */
+static void Bench_Signal(float32_t* speech, float32_t* noise, bool* voiced, int len, float32_t sample_rate, float32_t f_low, float32_t f_high)
+{
+    uint32_t rnd = 4711;
+    double phase = 0;
+
+    for (int idx = 0; idx < len; idx++)
+    {
+        const double t = idx / sample_rate;
+        const double period = (SYLLABLE_MS + PAUSE_MS) / 1000.0;
+        const double pos = fmod(t, period);
+        const int syllable = t / period;
+        voiced[idx] = pos < SYLLABLE_MS / 1000.0;
+
+        // raised cosine envelope for each syllable, the pitch glides from 110 to 190Hz and back
+        const double env = voiced[idx] ? 0.5 - 0.5 * cos(2 * M_PI * pos / (SYLLABLE_MS / 1000.0)) : 0.0;
+        const double f0 = 150 + 40 * sin(2 * M_PI * 0.37 * t + syllable);
+        phase += 2 * M_PI * f0 / sample_rate;
+
+        double sample = 0;
+        for (int harm = 1; harm * f0 < f_high; harm++)
+        {
+            // two formant like bumps around 600 and 1800Hz
+            const double f = harm * f0;
+            const double amp = 1.0 / (1.0 + pow((f - 600) / 300, 2)) + 0.5 / (1.0 + pow((f - 1800) / 400, 2));
+            if (f > f_low)
+            {
+                sample += amp * sin(harm * phase);
+            }
+        }
+        speech[idx] = env * sample;
+        noise[idx] = 0;
+    }
+
+    // noise: sinusoids with random frequency and phase within the passband, run as rotating phasors
+    for (int line = 0; line < NOISE_LINES; line++)
+    {
+        const double f = f_low + (f_high - f_low) * Bench_Random(&rnd);
+        const double w = 2 * M_PI * f / sample_rate;
+        const double cw = cos(w), sw = sin(w);
+        double re = cos(2 * M_PI * Bench_Random(&rnd)), im = sin(2 * M_PI * Bench_Random(&rnd));
+        const double norm = sqrt(re * re + im * im);
+        re /= norm; im /= norm;
+        for (int idx = 0; idx < len; idx++)
+        {
+            noise[idx] += re;
+            const double re_next = re * cw - im * sw;
+            im = re * sw + im * cw;
+            re = re_next;
+        }
+    }
+
+    double p_speech = 0, p_noise = 0;
+    for (int idx = 0; idx < len; idx++)
+    {
+        p_speech += speech[idx] * speech[idx];
+        p_noise += noise[idx] * noise[idx];
+    }
+    // speech normalized to an rms of 0.1 over the whole signal, noise set for BENCH_SNR_DB
+    const double s_scale = 0.1 / sqrt(p_speech / len);
+    const double n_scale = 0.1 / sqrt(p_noise / len) * pow(10, -BENCH_SNR_DB / 20);
+    for (int idx = 0; idx < len; idx++)
+    {
+        speech[idx] *= s_scale;
+        noise[idx] *= n_scale;
+    }
+}
+
+static void Bench_Run(const BenchRate* rate, uint16_t fft_l, BenchResult* res)
+{
+    const int len = (BENCH_SECONDS * (int)rate->sample_rate) / NR_FFT_SIZE * NR_FFT_SIZE;
+    const int skip = BENCH_SKIP_SECONDS * (int)rate->sample_rate;
+    const int path = Bench_FindFilterPath(rate->filter_id);
+    const float32_t width = FilterInfo[FilterPathInfo[path].id].width;
+    const float32_t offset = FilterPathInfo[path].offset;
+
+    float32_t* speech = malloc(len * sizeof(float32_t));
+    float32_t* noise = malloc(len * sizeof(float32_t));
+    float32_t* out = malloc(len * sizeof(float32_t));
+    bool* voiced = malloc(len * sizeof(bool));
+
+    Bench_Signal(speech, noise, voiced, len, rate->sample_rate, offset - width / 2, offset + width / 2);
+
+    ts.filter_path = path;
+    ts.NR_decimation_enable = rate->decimation;
+    ts.NR_FFT_L = fft_l;
+
+    res->block_ns = 1e30;
+    for (int run = 0; run < BENCH_RUNS; run++)
+    {
+        for (int idx = 0; idx < len; idx++)
+        {
+            out[idx] = speech[idx] + noise[idx];
+        }
+        ts.nr_first_time = 1;
+
+        // the time of a whole run varies with the load of the workstation, the fastest batch of the runs is stable
+        double start = Bench_Now();
+        for (int idx = 0, calls = 0; idx < len; idx += NR_FFT_SIZE)
+        {
+            AudioNr_SpectralNoiseReduction(&out[idx]);
+            if (++calls == BENCH_BATCH)
+            {
+                const double now = Bench_Now();
+                if ((now - start) / BENCH_BATCH < res->block_ns)
+                {
+                    res->block_ns = (now - start) / BENCH_BATCH;
+                }
+                calls = 0;
+                start = now;
+            }
+        }
+    }
+
+    // delay of the NR: best correlation of the output with the clean speech
+    double best = -1;
+    for (int delay = 0; delay < BENCH_MAX_DELAY; delay++)
+    {
+        double corr = 0;
+        for (int idx = skip; idx < len - delay; idx++)
+        {
+            corr += out[idx + delay] * speech[idx];
+        }
+        if (corr > best)
+        {
+            best = corr;
+            res->delay = delay;
+        }
+    }
+
+    // least squares gain of the speech in the output, all other output is noise or distortion
+    double ss = 0, sy = 0, nn = 0, pause_in = 0, pause_out = 0;
+    for (int idx = skip; idx < len - res->delay; idx++)
+    {
+        const double y = out[idx + res->delay];
+        ss += speech[idx] * speech[idx];
+        sy += speech[idx] * y;
+        nn += noise[idx] * noise[idx];
+        if (voiced[idx] == false)
+        {
+            pause_in += noise[idx] * noise[idx];
+            pause_out += y * y;
+        }
+    }
+    const double gain = sy / ss;
+    double err = 0;
+    for (int idx = skip; idx < len - res->delay; idx++)
+    {
+        const double e = out[idx + res->delay] - gain * speech[idx];
+        err += e * e;
+    }
+    res->snr_in_db = 10 * log10(ss / nn);
+    res->snr_out_db = 10 * log10(gain * gain * ss / err);
+    res->speech_db = 20 * log10(gain);
+    res->pause_db = 10 * log10(pause_out / pause_in);
+
+    free(speech);
+    free(noise);
+    free(out);
+    free(voiced);
+}
+
+int main(int argc, char* argv[])
+{
+    NR2.width = 4;
+    NR2.power_threshold_int = 40;
+    ts.nr_alpha = 0.94;
+
+    printf("spectral NR, %d dB SNR in the passband, %d samples per call\n", (int)BENCH_SNR_DB, NR_FFT_SIZE);
+    printf("%-18s %6s %10s %7s %9s %9s %9s %9s %10s\n", "filter", "frame", "ns/call", "load %", "delay ms",
+            "SNR in", "SNR out", "speech", "pauses");
+
+    for (int r = 0; r < sizeof(bench_rates) / sizeof(bench_rates[0]); r++)
+    {
+        for (int f = 0; f < sizeof(bench_fft_l) / sizeof(bench_fft_l[0]); f++)
+        {
+            BenchResult res = { 0 };
+            Bench_Run(&bench_rates[r], bench_fft_l[f], &res);
+
+            const double call_ns = NR_FFT_SIZE * 1e9 / bench_rates[r].sample_rate;
+            printf("%-18s %6d %10.0f %7.2f %9.1f %6.1f dB %6.1f dB %6.1f dB %7.1f dB\n", bench_rates[r].name, bench_fft_l[f],
+                    res.block_ns, 100 * res.block_ns / call_ns, 1000.0 * res.delay / bench_rates[r].sample_rate,
+                    res.snr_in_db, res.snr_out_db, res.speech_db, res.pause_db);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,351 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     ring_check.c                                                    **
+ **  Description:   Checks the ring buffers of misc/ring_buffer.h, single threaded  **
+ **                 and with a producer and a consumer thread                       **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "ring_buffer.h"
+
+#define STRESS_ELEMENTS     20000000    // elements through the element ring
+#define STRESS_BLOCKS       1000000     // blocks through the block ring
+#define CHUNK_MAX           80          // longest bulk write / read, longer than the ring
+
+RING_BUFFER_DEFINE(CheckRing, uint32_t, 64)
+RING_BUFFER_DEFINE_CAPACITY(CheckCapacityRing, uint8_t, 8, 5)
+
+typedef struct
+{
+    uint32_t seq;
+    uint32_t data[63];
+} CheckBlock;
+
+#define CHECK_BLOCK_NUM 3
+RING_BUFFER_BLOCK_DEFINE(CheckBlockRing, CheckBlock, CHECK_BLOCK_NUM)
+
+static int failed;
+
+#define CHECK(cond) do { if (!(cond)) { printf("  FAILED line %d: %s\n", __LINE__, #cond); failed++; } } while(0)
+
+static double now_s()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// xorshift, each thread has its own state
+static uint32_t rand_next(uint32_t* state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void check_single()
+{
+    static CheckRing ring;
+    uint32_t buf[CHUNK_MAX];
+
+    CheckRing_Init(&ring);
+    CHECK(CheckRing_Fill(&ring) == 0);
+    CHECK(CheckRing_Room(&ring) == 64);
+
+    // all slots are usable, the next element is an overrun
+    for (uint32_t i = 0; i < 64; i++)
+    {
+        CHECK(CheckRing_Put(&ring, i));
+    }
+    CHECK(CheckRing_Put(&ring, 64) == false);
+    CHECK(CheckRing_Room(&ring) == 0);
+    CHECK(ring.idx.fill_max == 64);
+    CHECK(ring.idx.overruns == 1);
+
+    uint32_t elem;
+    CHECK(CheckRing_Peek(&ring, &elem) && elem == 0);
+    CHECK(CheckRing_Get(&ring, &elem) && elem == 0);
+
+    // bulk read across the end of the storage, asking for more than there is
+    CHECK(CheckRing_Read(&ring, buf, 10) == 10);
+    CHECK(buf[0] == 1 && buf[9] == 10);
+    for (uint32_t i = 0; i < 11; i++)
+    {
+        buf[i] = 100 + i;
+    }
+    CHECK(CheckRing_Write(&ring, buf, 11) == 11);
+    CHECK(CheckRing_Write(&ring, buf, 3) == 0);
+    CHECK(ring.idx.overruns == 4);
+    CHECK(CheckRing_Read(&ring, buf, CHUNK_MAX) == 64);
+    CHECK(buf[0] == 11 && buf[52] == 63 && buf[53] == 100 && buf[63] == 110);
+    CHECK(ring.idx.underruns == CHUNK_MAX - 64);
+    CHECK(CheckRing_Get(&ring, &elem) == false);
+
+    // the counters wrap around at 2^32
+    CheckRing_Init(&ring);
+    ring.idx.head = ring.idx.tail = UINT32_MAX - 5;
+    for (uint32_t i = 0; i < 20; i++)
+    {
+        buf[i] = i;
+    }
+    CHECK(CheckRing_Write(&ring, buf, 20) == 20);
+    CHECK(CheckRing_Fill(&ring) == 20);
+    CHECK(CheckRing_Read(&ring, buf, 20) == 20);
+    CHECK(buf[0] == 0 && buf[19] == 19);
+    CHECK(CheckRing_Fill(&ring) == 0);
+
+    CheckRing_Put(&ring, 1);
+    CheckRing_Put(&ring, 2);
+    CheckRing_Reset(&ring);
+    CHECK(CheckRing_Fill(&ring) == 0);
+
+    // a ring may hold fewer elements than its storage
+    static CheckCapacityRing cap;
+    const uint8_t bytes[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    uint8_t out[8];
+    CheckCapacityRing_Init(&cap);
+    CHECK(CheckCapacityRing_Room(&cap) == 5);
+    CHECK(CheckCapacityRing_Write(&cap, bytes, 8) == 5);
+    CHECK(CheckCapacityRing_Put(&cap, 9) == false);
+    CHECK(cap.idx.overruns == 4);
+    CHECK(CheckCapacityRing_Read(&cap, out, 3) == 3);
+    CHECK(CheckCapacityRing_Write(&cap, &bytes[5], 3) == 3);
+    CHECK(CheckCapacityRing_Read(&cap, out, 8) == 5);
+    CHECK(out[0] == 4 && out[4] == 8);
+
+    // block rings hold as many pointers as there are blocks
+    static CheckBlockRing blocks;
+    static CheckBlock block[CHECK_BLOCK_NUM + 1];
+    CheckBlockRing_Init(&blocks);
+    CHECK(CheckBlockRing_Room(&blocks) == CHECK_BLOCK_NUM);
+    for (uint32_t i = 0; i < CHECK_BLOCK_NUM; i++)
+    {
+        CHECK(CheckBlockRing_Put(&blocks, &block[i]));
+    }
+    CHECK(CheckBlockRing_Put(&blocks, &block[CHECK_BLOCK_NUM]) == false);
+    CheckBlock* bp;
+    CHECK(CheckBlockRing_Get(&blocks, &bp) && bp == &block[0]);
+
+    // storage sizes, e.g. of the USB audio ring (1536 samples)
+    for (uint32_t n = 1; n <= 65536; n++)
+    {
+        const uint32_t pow2 = RING_BUFFER_POW2(n);
+        CHECK((pow2 & (pow2 - 1)) == 0 && pow2 >= n && pow2 / 2 < n);
+    }
+    CHECK(RING_BUFFER_POW2(1536) == 2048);
+    CHECK(RING_BUFFER_POW2(65537) == 0);
+}
+
+static CheckRing stress_ring;
+static uint32_t producer_yields, consumer_yields;
+
+static void* stress_producer(void* arg)
+{
+    uint32_t rnd = 0x12345678;
+    uint32_t seq = 0;
+    uint32_t buf[CHUNK_MAX];
+
+    while (seq < STRESS_ELEMENTS)
+    {
+        uint32_t r = rand_next(&rnd);
+        if (r & 1)
+        {
+            if (CheckRing_Put(&stress_ring, seq))
+            {
+                seq++;
+            }
+            else
+            {
+                producer_yields++;
+                sched_yield();
+            }
+        }
+        else
+        {
+            uint32_t len = 1 + (r >> 8) % CHUNK_MAX;
+            if (len > STRESS_ELEMENTS - seq)
+            {
+                len = STRESS_ELEMENTS - seq;
+            }
+            for (uint32_t i = 0; i < len; i++)
+            {
+                buf[i] = seq + i;
+            }
+            uint32_t count = CheckRing_Write(&stress_ring, buf, len);
+            seq += count;
+            if (count < len)
+            {
+                producer_yields++;
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
+
+static void* stress_consumer(void* arg)
+{
+    uint32_t rnd = 0x9abcdef0;
+    uint32_t expected = 0;
+    uint32_t buf[CHUNK_MAX];
+    uint32_t errors = 0;
+
+    while (expected < STRESS_ELEMENTS)
+    {
+        uint32_t r = rand_next(&rnd);
+        uint32_t count = 0;
+        uint32_t elem;
+
+        switch (r & 3)
+        {
+        case 0:
+            if (CheckRing_Peek(&stress_ring, &elem))
+            {
+                // a peeked element stays in the ring until it is removed
+                uint32_t again = 0;
+                errors += CheckRing_Peek(&stress_ring, &again) == false || again != elem;
+                errors += CheckRing_Get(&stress_ring, &again) == false || again != elem;
+                buf[0] = elem;
+                count = 1;
+            }
+            break;
+        case 1:
+            count = CheckRing_Get(&stress_ring, &buf[0]);
+            break;
+        default:
+            count = CheckRing_Read(&stress_ring, buf, 1 + (r >> 8) % CHUNK_MAX);
+            break;
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (buf[i] != expected)
+            {
+                if (errors < 10)
+                {
+                    printf("  got %u, expected %u\n", buf[i], expected);
+                }
+                errors++;
+                expected = buf[i];
+            }
+            expected++;
+        }
+        if (count == 0)
+        {
+            consumer_yields++;
+            sched_yield();
+        }
+    }
+    return (void*)(uintptr_t)errors;
+}
+
+static CheckBlockRing block_ring;
+static CheckBlock stress_blocks[CHECK_BLOCK_NUM];
+
+// the pattern of the audio driver: a block is filled, handed over, used while it is still
+// in the ring (peek) and only given back (get) when the consumer is done with it
+static void* block_producer(void* arg)
+{
+    uint32_t idx = 0;
+
+    for (uint32_t seq = 0; seq < STRESS_BLOCKS; )
+    {
+        if (CheckBlockRing_Room(&block_ring))
+        {
+            CheckBlock* b = &stress_blocks[idx];
+            b->seq = seq;
+            for (uint32_t i = 0; i < sizeof(b->data)/sizeof(b->data[0]); i++)
+            {
+                b->data[i] = seq * 7 + i;
+            }
+            CheckBlockRing_Put(&block_ring, b);
+            idx = (idx + 1) % CHECK_BLOCK_NUM;
+            seq++;
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void* block_consumer(void* arg)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t seq = 0; seq < STRESS_BLOCKS; )
+    {
+        CheckBlock* b;
+        if (CheckBlockRing_Peek(&block_ring, &b))
+        {
+            errors += b->seq != seq;
+            for (uint32_t i = 0; i < sizeof(b->data)/sizeof(b->data[0]); i++)
+            {
+                errors += b->data[i] != seq * 7 + i;
+            }
+            CheckBlockRing_Get(&block_ring, &b);
+            seq++;
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+    return (void*)(uintptr_t)errors;
+}
+
+static void check_threads(const char* name, void* (*producer)(void*), void* (*consumer)(void*), uint32_t num)
+{
+    pthread_t prod, cons;
+    void* errors;
+
+    double start = now_s();
+    pthread_create(&cons, NULL, consumer, NULL);
+    pthread_create(&prod, NULL, producer, NULL);
+    pthread_join(prod, NULL);
+    pthread_join(cons, &errors);
+    double elapsed = now_s() - start;
+
+    printf("%-8s %9u through the ring in %.2f s, %.1f ns each, %s\n", name, num, elapsed, elapsed * 1e9 / num,
+            errors ? "FAILED" : "ok");
+    if (errors)
+    {
+        failed++;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    check_single();
+    printf("single threaded checks %s\n", failed ? "FAILED" : "ok");
+
+    CheckRing_Init(&stress_ring);
+    check_threads("elements", stress_producer, stress_consumer, STRESS_ELEMENTS);
+    printf("         fill max %u, overruns %u, underruns %u, producer waits %u, consumer waits %u\n",
+            stress_ring.idx.fill_max, stress_ring.idx.overruns, stress_ring.idx.underruns,
+            producer_yields, consumer_yields);
+    CHECK(stress_ring.idx.fill_max <= 64);
+    CHECK(CheckRing_Fill(&stress_ring) == 0);
+
+    CheckBlockRing_Init(&block_ring);
+    check_threads("blocks", block_producer, block_consumer, STRESS_BLOCKS);
+
+    printf("%d ring checks %s\n", failed, failed ? "FAILED" : "failed");
+    return failed ? 1 : 0;
+}
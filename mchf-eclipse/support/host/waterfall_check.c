@@ -0,0 +1,283 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     waterfall_check.c                                               **
+ **  Description:   Checks that the wipe mode waterfall draws only the new lines    **
+ **                 and the same lines as the scrolling waterfall                   **
+ **  Licence:       GNU GPLv3                                                       **
+ ************************************************************************************/
+
+// The spectrum runs in wipe mode on the virtual display. Before each frame the process forks, the
+// child draws the same frame in the normal scrolling mode and sends its waterfall area through a
+// pipe. In wipe mode only the rows of the new lines may change, they have to move up through the
+// area, and the new lines have to be the top lines of the scrolling waterfall. After a change of the
+// centre frequency, a PTT request or a cleared spectrum, the whole waterfall is drawn again and has
+// to be identical to the scrolling one.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "uhsdr_board.h"
+#include "audio_driver.h"
+#include "ui_lcd_hy28.h"
+#include "ui_spectrum.h"
+#include "ui_configuration.h"
+#include "host_platform.h"
+#include "host_display.h"
+
+#define CHECK_FREQ          14074000
+#define CHECK_WARMUP        20
+
+static int failed;
+
+#define CHECK(cond) do { if (!(cond)) { printf("  FAILED line %d: %s\n", __LINE__, #cond); failed++; } } while(0)
+
+static uint16_t before[480 * 320];
+static uint16_t scrolled[480 * 320];
+
+/**
+ * @brief a new block of IQ data for the spectrum: noise and a few carriers, one of them drifting
+ */
+static void Check_SpectrumInput(int frame, uint32_t freq)
+{
+    static uint32_t rnd = 4711;
+    const float32_t carriers[] = { 0.05, -0.11, 0.2 + 0.003 * (frame % 50), -0.3 };
+
+    for (uint32_t idx = 0; idx < sd.fft_iq_len / 2; idx++)
+    {
+        float32_t i = 0, q = 0;
+        for (int c = 0; c < sizeof(carriers) / sizeof(carriers[0]); c++)
+        {
+            i += 1000 * cosf(2 * PI * carriers[c] * idx);
+            q += 1000 * sinf(2 * PI * carriers[c] * idx);
+        }
+        rnd = rnd * 1103515245 + 12345;
+        i += (float32_t)((rnd >> 16) & 0xff) - 128;
+        rnd = rnd * 1103515245 + 12345;
+        q += (float32_t)((rnd >> 16) & 0xff) - 128;
+        // the audio driver stores Q first
+        sd.FFT_RingBuffer[2 * idx] = q;
+        sd.FFT_RingBuffer[2 * idx + 1] = i;
+    }
+    sd.samp_ptr = 0;
+    sd.FFT_frequency = freq;
+}
+
+/**
+ * @brief one update of scope and waterfall, i.e. the state machine of UiSpectrum_Redraw() once through
+ */
+static void Check_SpectrumFrame(int frame, uint32_t freq)
+{
+    Check_SpectrumInput(frame, freq);
+    ts.scope_scheduler = 0;
+    ts.waterfall.scheduler = 0;
+    do
+    {
+        UiSpectrum_Redraw();
+    } while (sd.state != 0);
+}
+
+/**
+ * @brief copies rows of the waterfall area of the screen
+ */
+static void Check_CopyRows(uint16_t* dst, const uint16_t* screen, uint16_t width, uint16_t row, uint16_t rows)
+{
+    const UiArea_t* wfall = &sd.Slayout->wfall;
+    for (uint16_t idx = 0; idx < rows; idx++)
+    {
+        memcpy(&dst[idx * wfall->w], &screen[(wfall->y + row + idx) * width + wfall->x], wfall->w * sizeof(uint16_t));
+    }
+}
+
+/**
+ * @brief draws the frame in wipe mode and in a child process in scrolling mode, the waterfall area of the child is returned in scrolled
+ */
+static void Check_Frame(int frame, uint32_t freq)
+{
+    const UiArea_t* wfall = &sd.Slayout->wfall;
+    const size_t area_bytes = wfall->w * wfall->h * sizeof(uint16_t);
+    uint16_t width, height;
+    int fds[2];
+
+    fflush(stdout);
+    CHECK(pipe(fds) == 0);
+    const pid_t pid = fork();
+    if (pid == 0)
+    {
+        close(fds[0]);
+        ts.flags2 &= ~FLAGS2_WFALL_WIPE;
+        Check_SpectrumFrame(frame, freq);
+        const uint16_t* screen = HostDisplay_Framebuffer(&width, &height);
+        Check_CopyRows(scrolled, screen, width, 0, wfall->h);
+        const int written = write(fds[1], scrolled, area_bytes);
+        _exit(written == area_bytes ? 0 : 1);
+    }
+
+    close(fds[1]);
+    size_t received = 0;
+    for (ssize_t len = 1; len > 0 && received < area_bytes; received += len)
+    {
+        len = read(fds[0], (uint8_t*)scrolled + received, area_bytes - received);
+        if (len < 0)
+        {
+            len = 0;
+        }
+    }
+    close(fds[0]);
+    int status = -1;
+    waitpid(pid, &status, 0);
+    CHECK(received == area_bytes && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    Check_SpectrumFrame(frame, freq);
+}
+
+/**
+ * @brief a frame which has to draw the whole waterfall, it is identical to the scrolling waterfall
+ */
+static void Check_Repaint(int frame, uint32_t freq)
+{
+    const UiArea_t* wfall = &sd.Slayout->wfall;
+    uint16_t width, height;
+
+    // the frame which completes the step
+    sd.wfall_line_update = ts.waterfall.vert_step_size - 1;
+    Check_Frame(frame, freq);
+    const uint16_t* screen = HostDisplay_Framebuffer(&width, &height);
+    Check_CopyRows(before, screen, width, 0, wfall->h);
+    CHECK(memcmp(before, scrolled, wfall->w * wfall->h * sizeof(uint16_t)) == 0);
+    CHECK(sd.wfall_wipe_valid == true && sd.wfall_wipe_row == 0);
+}
+
+/**
+ * @brief frames with new lines only, they are drawn at the rows above the previous newest line
+ */
+static void Check_Wipe(int first_frame, int frames, uint32_t freq)
+{
+    const UiArea_t* wfall = &sd.Slayout->wfall;
+    const uint16_t lines = ts.waterfall.vert_step_size;
+    uint16_t width, height;
+
+    for (int frame = first_frame; frame < first_frame + frames; frame++)
+    {
+        const uint16_t* screen = HostDisplay_Framebuffer(&width, &height);
+        memcpy(before, screen, width * height * sizeof(uint16_t));
+        const uint16_t prev_row = sd.wfall_wipe_row;
+        const bool update = sd.wfall_line_update == lines - 1;
+
+        Check_Frame(frame, freq);
+
+        const uint16_t row = update ? (prev_row + wfall->h - lines) % wfall->h : prev_row;
+        CHECK(sd.wfall_wipe_valid == true && sd.wfall_wipe_row == row);
+
+        // the rows of the new lines, all others are unchanged
+        for (uint16_t y = 0; y < wfall->h; y++)
+        {
+            const uint16_t age = (y + wfall->h - row) % wfall->h;
+            const bool changed = memcmp(&before[(wfall->y + y) * width + wfall->x], &screen[(wfall->y + y) * width + wfall->x],
+                    wfall->w * sizeof(uint16_t)) != 0;
+            if (update == false || age >= lines)
+            {
+                CHECK(changed == false);
+            }
+            else
+            {
+                // the new lines are the top lines of the scrolling waterfall
+                CHECK(memcmp(&screen[(wfall->y + y) * width + wfall->x], &scrolled[age * wfall->w], wfall->w * sizeof(uint16_t)) == 0);
+            }
+        }
+    }
+}
+
+static void Check_Display(HostDisplay_Controller controller, const char* name)
+{
+    HostDisplay_Select(controller);
+    CHECK(UiLcdHy28_Init() != DISPLAY_NONE);
+
+    // the spectrum related settings of TransceiverStateInit()
+    ts.flags1 |= FLAGS1_WFALL_ENABLED | FLAGS1_SCOPE_ENABLED;
+    ts.flags2 &= ~FLAGS2_WFALL_WIPE;
+    ts.spectrum_filter = SPECTRUM_FILTER_DEFAULT;
+    ts.spectrum_centre_line_colour = SPEC_COLOUR_GRID_DEFAULT;
+    ts.spectrum_freqscale_colour = SPEC_COLOUR_SCALE_DEFAULT;
+    ts.spectrum_db_scale = DB_DIV_10;
+    ts.spectrum_size = SPECTRUM_SIZE_DEFAULT;
+    ts.spectrum_agc_rate = SPECTRUM_SCOPE_AGC_DEFAULT;
+    ts.scope_trace_colour = SPEC_COLOUR_TRACE_DEFAULT;
+    ts.scope_trace_BW_colour = SPEC_COLOUR_TRACEBW_DEFAULT;
+    ts.scope_backgr_BW_colour = SPEC_COLOUR_BACKGRBW_DEFAULT;
+    ts.scope_grid_colour = SPEC_COLOUR_GRID_DEFAULT;
+    ts.scope_speed = SPECTRUM_SCOPE_SPEED_DEFAULT;
+    ts.waterfall.speed = WATERFALL_SPEED_DEFAULT;
+    ts.waterfall.color_scheme = WATERFALL_COLOR_DEFAULT;
+    ts.waterfall.vert_step_size = WATERFALL_STEP_SIZE_DEFAULT;
+    ts.waterfall.contrast = WATERFALL_CONTRAST_DEFAULT;
+    ts.filter_disp_colour = FILTER_DISP_COLOUR_DEFAULT;
+    UiSpectrum_Init();
+
+    for (int frame = 0; frame < CHECK_WARMUP; frame++)
+    {
+        Check_SpectrumFrame(frame, CHECK_FREQ);
+    }
+
+    const UiArea_t* wfall = &sd.Slayout->wfall;
+    printf("%s: waterfall %ux%u, %u buffer lines, each line drawn %u times\n", name, wfall->w, wfall->h, sd.wfall_size,
+            sd.repeatWaterfallLine + 1);
+
+    int frame = CHECK_WARMUP;
+
+    ts.flags2 |= FLAGS2_WFALL_WIPE;
+    Check_Repaint(frame++, CHECK_FREQ);
+    // around the waterfall more than twice
+    Check_Wipe(frame, 2 * wfall->h + 7, CHECK_FREQ);
+    frame += 2 * wfall->h + 7;
+
+    // the centre frequency moves
+    Check_Repaint(frame++, CHECK_FREQ + 1000);
+    Check_Wipe(frame, 10, CHECK_FREQ + 1000);
+    frame += 10;
+
+    // more lines per update, some of them wrap around from the top to the bottom of the area
+    ts.waterfall.vert_step_size = 3;
+    sd.wfall_line_update = 0;
+    Check_Wipe(frame, 3 * (wfall->h + 5), CHECK_FREQ + 1000);
+    frame += 3 * (wfall->h + 5);
+
+    // a ptt request skips an update, the next update draws all lines
+    ts.waterfall.vert_step_size = 1;
+    ts.ptt_req = true;
+    Check_SpectrumFrame(frame++, CHECK_FREQ + 1000);
+    CHECK(sd.wfall_wipe_valid == false);
+    ts.ptt_req = false;
+    Check_Repaint(frame++, CHECK_FREQ + 1000);
+    Check_Wipe(frame, 10, CHECK_FREQ + 1000);
+    frame += 10;
+
+    // something else was drawn in the spectrum area
+    UiSpectrum_Clear();
+    Check_Repaint(frame++, CHECK_FREQ + 1000);
+    Check_Wipe(frame, 10, CHECK_FREQ + 1000);
+
+    ts.flags2 &= ~FLAGS2_WFALL_WIPE;
+}
+
+int main(int argc, char* argv[])
+{
+    HostPlatform_TransceiverStateInit();
+    // set by the audio driver from the codec gain, the spectrum divides by it
+    ads.codec_gain_calc = 1;
+
+    Check_Display(HOST_DISPLAY_ILI932X, "ILI932x");
+    Check_Display(HOST_DISPLAY_ILI9486, "ILI9486");
+
+    printf("%d waterfall checks %s\n", failed, failed ? "FAILED" : "failed");
+    return failed ? 1 : 0;
+}